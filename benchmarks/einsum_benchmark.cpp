@@ -0,0 +1,156 @@
+#include <benchmark/benchmark.h>
+#include <sdfg/structured_sdfg.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <symengine/integer.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "fixtures/einsum.h"
+#include "sdfg/einsum/einsum_autotuner.h"
+#include "sdfg/einsum/einsum_node.h"
+#include "sdfg/einsum/einsum_tuning.h"
+
+using namespace sdfg;
+
+namespace {
+
+struct Fixture {
+    std::string name;
+    std::function<std::pair<std::unique_ptr<StructuredSDFG>, einsum::EinsumNode*>()> build;
+
+    // Value of every size symbol of the einsum
+    std::vector<long long> sizes;
+};
+
+const std::vector<Fixture>& fixtures() {
+    static const std::vector<Fixture> fixtures = {
+        {"matrix_matrix_mult", matrix_matrix_mult, {64, 128, 256, 512, 1024}},
+        {"tensor_contraction_3d", tensor_contraction_3d, {8, 16, 24, 32}},
+        {"matrix_vector_mult", matrix_vector_mult, {256, 1024, 4096, 8192}},
+        {"diagonal_extraction", diagonal_extraction, {1024, 4096, 16384}},
+        {"matrix_trace", matrix_trace, {1024, 4096, 16384}},
+        {"matrix_copy", matrix_copy, {256, 1024, 4096}},
+        {"matrix_transpose", matrix_transpose, {256, 1024, 4096}},
+        {"dot_product", dot_product, {1 << 16, 1 << 20, 1 << 24}},
+        {"matrix_elementwise_mult", matrix_elementwise_mult, {256, 1024, 4096}},
+        {"vector_scaling", vector_scaling, {1 << 16, 1 << 20, 1 << 24}},
+    };
+    return fixtures;
+}
+
+einsum::EinsumAutotunerOptions autotuner_options(const einsum::EinsumNode& einsum_node,
+                                                 long long size) {
+    einsum::EinsumAutotunerOptions options;
+
+    // All symbols in the map bounds get the same value
+    std::unordered_set<std::string> indvars;
+    for (auto& map : einsum_node.maps()) indvars.insert(map.first->get_name());
+    for (auto& symbol : einsum_node.symbols()) {
+        if (!indvars.contains(symbol->get_name())) options.sizes.insert({symbol->get_name(), size});
+    }
+
+    if (const char* compile_command = std::getenv("SDFG_EINSUM_BENCHMARK_COMPILE_COMMAND"))
+        options.compile_command = compile_command;
+    if (const char* work_dir = std::getenv("SDFG_EINSUM_BENCHMARK_WORK_DIR"))
+        options.work_dir = work_dir;
+    return options;
+}
+
+// Number of elements of an operand with the given indices
+double elements(const einsum::EinsumNode& einsum_node, const data_flow::Subset& indices,
+                const einsum::EinsumAutotunerOptions& options) {
+    double result = 1.0;
+    for (auto& index : indices) {
+        for (size_t i = 0; i < einsum_node.maps().size(); ++i) {
+            if (!symbolic::eq(index, einsum_node.indvar(i))) continue;
+
+            symbolic::Expression bound = einsum_node.num_iteration(i);
+            for (auto& size : options.sizes) {
+                bound = symbolic::subs(bound, symbolic::symbol(size.first),
+                                       symbolic::integer(size.second));
+            }
+            if (bound->get_type_code() == SymEngine::TypeID::SYMENGINE_INTEGER)
+                result *= SymEngine::rcp_static_cast<const SymEngine::Integer>(bound)->as_int();
+            break;
+        }
+    }
+    return result;
+}
+
+void run(benchmark::State& state, const Fixture& fixture, const einsum::EinsumVariant& variant,
+         long long size) {
+    auto sdfg_and_node = fixture.build();
+    auto& einsum_node = *sdfg_and_node.second;
+    auto options = autotuner_options(einsum_node, size);
+
+    // Every iteration multiplies the inputs and accumulates into the output
+    data_flow::Subset all_indices;
+    for (size_t i = 0; i < einsum_node.maps().size(); ++i)
+        all_indices.push_back(einsum_node.indvar(i));
+    double iterations = elements(einsum_node, all_indices, options);
+    long long factors = static_cast<long long>(einsum_node.inputs().size());
+    if (einsum_node.getOutInputIndex() >= 0) --factors;
+    double flops_per_iteration = static_cast<double>(factors > 0 ? factors - 1 : 0);
+    if (einsum_node.getOutInputIndex() >= 0) flops_per_iteration += 1.0;
+
+    // Every operand is moved once, the output is read as well if it accumulates
+    double bytes = elements(einsum_node, einsum_node.out_indices(), options) * sizeof(float);
+    for (size_t i = 0; i < einsum_node.inputs().size(); ++i)
+        bytes += elements(einsum_node, einsum_node.in_indices(i), options) * sizeof(float);
+
+    einsum::EinsumAutotuner autotuner(*sdfg_and_node.first, einsum_node, options);
+    double time = autotuner.measure(variant);
+    if (time <= 0.0) {
+        state.SkipWithError("Benchmark could not be generated, compiled, or run");
+        return;
+    }
+
+    for (auto _ : state) state.SetIterationTime(time);
+    state.counters["GFLOP/s"] = flops_per_iteration * iterations / time * 1e-9;
+    state.counters["GB/s"] = bytes / time * 1e-9;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+
+    for (auto& fixture : fixtures()) {
+        // The naive loop nest of the EinsumDispatcher and every matching BLAS routine
+        std::vector<einsum::EinsumVariant> variants = {einsum::EinsumVariant()};
+        {
+            auto sdfg_and_node = fixture.build();
+            auto options = autotuner_options(*sdfg_and_node.second, fixture.sizes.front());
+            einsum::EinsumAutotuner autotuner(*sdfg_and_node.first, *sdfg_and_node.second,
+                                              options);
+            for (auto& variant : autotuner.variants()) {
+                if (!variant.lowering.empty()) variants.push_back(variant);
+            }
+        }
+
+        for (auto& variant : variants) {
+            for (long long size : fixture.sizes) {
+                std::string name =
+                    fixture.name + "/" + variant.toStr() + "/" + std::to_string(size);
+                benchmark::RegisterBenchmark(name.c_str(),
+                                             [&fixture, variant, size](benchmark::State& state) {
+                                                 run(state, fixture, variant, size);
+                                             })
+                    ->Iterations(1)
+                    ->UseManualTime()
+                    ->Unit(benchmark::kMillisecond);
+            }
+        }
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cstddef>
+
 #include "sdfg/blas/blas_dispatcher_axpy.h"
 #include "sdfg/blas/blas_dispatcher_copy.h"
 #include "sdfg/blas/blas_dispatcher_dot.h"
 #include "sdfg/blas/blas_dispatcher_gemm.h"
+#include "sdfg/blas/blas_dispatcher_gemm_batched.h"
 #include "sdfg/blas/blas_dispatcher_gemv.h"
 #include "sdfg/blas/blas_dispatcher_ger.h"
 #include "sdfg/blas/blas_dispatcher_symm.h"
@@ -15,17 +18,21 @@
 namespace sdfg {
 namespace blas {
 
-// This function must be called by the application using the plugin
-inline void register_blas_dispatchers(BLASImplementation impl = BLASImplementation_CBLAS) {
+// This function must be called by the application using the plugin. Gemms of constant size with at
+// most unroll_max_size multiply-adds, e.g., 4x4 blocks with 64, are unrolled instead of calling the
+// library.
+inline void register_blas_dispatchers(BLASImplementation impl = BLASImplementation_CBLAS,
+                                      size_t unroll_max_size = 0) {
     register_blas_dispatcher_axpy(impl);
     register_blas_dispatcher_copy(impl);
-    register_blas_dispatcher_dot();
+    register_blas_dispatcher_dot(impl);
     register_blas_dispatcher_gemv(impl);
-    register_blas_dispatcher_symv();
-    register_blas_dispatcher_ger();
-    register_blas_dispatcher_syr();
-    register_blas_dispatcher_gemm(impl);
-    register_blas_dispatcher_symm();
+    register_blas_dispatcher_symv(impl);
+    register_blas_dispatcher_ger(impl);
+    register_blas_dispatcher_syr(impl);
+    register_blas_dispatcher_gemm(impl, unroll_max_size);
+    register_blas_dispatcher_gemm_batched(impl);
+    register_blas_dispatcher_symm(impl);
     register_blas_dispatcher_syrk(impl);
 }
 
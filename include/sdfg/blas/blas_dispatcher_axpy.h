@@ -20,6 +20,7 @@ class BLASDispatcherAxpy : public codegen::LibraryNodeDispatcher {
 
     void dispatchCBLAS(codegen::PrettyPrinter& stream, const BLASNodeAxpy& blas_node);
     void dispatchCUBLAS(codegen::PrettyPrinter& stream, const BLASNodeAxpy& blas_node);
+    void dispatchNative(codegen::PrettyPrinter& stream, const BLASNodeAxpy& blas_node);
 
    public:
     BLASDispatcherAxpy(codegen::LanguageExtension& language_extension, const Function& function,
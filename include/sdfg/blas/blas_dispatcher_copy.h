@@ -20,6 +20,7 @@ class BLASDispatcherCopy : public codegen::LibraryNodeDispatcher {
 
     void dispatchCBLAS(codegen::PrettyPrinter& stream, const BLASNodeCopy& blas_node);
     void dispatchCUBLAS(codegen::PrettyPrinter& stream, const BLASNodeCopy& blas_node);
+    void dispatchNative(codegen::PrettyPrinter& stream, const BLASNodeCopy& blas_node);
 
    public:
     BLASDispatcherCopy(codegen::LanguageExtension& language_extension, const Function& function,
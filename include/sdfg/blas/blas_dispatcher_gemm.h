@@ -8,6 +8,7 @@
 #include <sdfg/data_flow/library_node.h>
 #include <sdfg/function.h>
 
+#include <cstddef>
 #include <memory>
 
 #include "sdfg/blas/blas_node.h"
@@ -20,26 +21,37 @@ class BLASDispatcherGemm : public codegen::LibraryNodeDispatcher {
    private:
     const BLASImplementation impl_;
 
+    // Maximum number of multiply-adds of a gemm of constant size that is unrolled, 0 disables it
+    const size_t unroll_max_size_;
+
     void dispatchCBLAS(codegen::PrettyPrinter& stream, const BLASNodeGemm& blas_node);
     void dispatchCUBLAS(codegen::PrettyPrinter& stream, const BLASNodeGemm& blas_node);
+    void dispatchNative(codegen::PrettyPrinter& stream, const BLASNodeGemm& blas_node);
+
+    // Straight-line code for constant m, n, and k of at most unroll_max_size_ multiply-adds
+    void dispatchUnrolled(codegen::PrettyPrinter& stream, const BLASNodeGemm& blas_node, size_t m,
+                          size_t n, size_t k);
 
    public:
     BLASDispatcherGemm(codegen::LanguageExtension& language_extension, const Function& function,
                        const data_flow::DataFlowGraph& data_flow_graph,
-                       const data_flow::LibraryNode& node, const BLASImplementation impl);
+                       const data_flow::LibraryNode& node, const BLASImplementation impl,
+                       size_t unroll_max_size = 0);
 
     virtual void dispatch(codegen::PrettyPrinter& stream) override;
 };
 
 // This function must be called by the application using the plugin
-inline void register_blas_dispatcher_gemm(BLASImplementation impl) {
+inline void register_blas_dispatcher_gemm(BLASImplementation impl, size_t unroll_max_size = 0) {
     codegen::LibraryNodeDispatcherRegistry::instance().register_library_node_dispatcher(
         LibraryNodeType_BLAS_gemm.value(),
-        [impl](codegen::LanguageExtension& language_extension, const Function& function,
-               const data_flow::DataFlowGraph& data_flow_graph,
-               const data_flow::LibraryNode& node) {
+        [impl, unroll_max_size](codegen::LanguageExtension& language_extension,
+                                const Function& function,
+                                const data_flow::DataFlowGraph& data_flow_graph,
+                                const data_flow::LibraryNode& node) {
             return std::make_unique<BLASDispatcherGemm>(language_extension, function,
-                                                        data_flow_graph, node, impl);
+                                                        data_flow_graph, node, impl,
+                                                        unroll_max_size);
         });
 }
 
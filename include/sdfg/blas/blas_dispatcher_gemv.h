@@ -8,6 +8,9 @@
 #include <sdfg/data_flow/library_node.h>
 #include <sdfg/function.h>
 
+#include <memory>
+#include <string>
+
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_gemv.h"
 
@@ -18,8 +21,12 @@ class BLASDispatcherGemv : public codegen::LibraryNodeDispatcher {
    private:
     const BLASImplementation impl_;
 
+    // Number of elements of y
+    static std::string y_size(const BLASNodeGemv& blas_node);
+
     void dispatchCBLAS(codegen::PrettyPrinter& stream, const BLASNodeGemv& blas_node);
     void dispatchCUBLAS(codegen::PrettyPrinter& stream, const BLASNodeGemv& blas_node);
+    void dispatchNative(codegen::PrettyPrinter& stream, const BLASNodeGemv& blas_node);
 
    public:
     BLASDispatcherGemv(codegen::LanguageExtension& language_extension, const Function& function,
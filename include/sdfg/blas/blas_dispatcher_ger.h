@@ -8,27 +8,35 @@
 #include <sdfg/data_flow/library_node.h>
 #include <sdfg/function.h>
 
+#include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_ger.h"
 
 namespace sdfg {
 namespace blas {
 
 class BLASDispatcherGer : public codegen::LibraryNodeDispatcher {
+   private:
+    const BLASImplementation impl_;
+
+    void dispatchCBLAS(codegen::PrettyPrinter& stream, const BLASNodeGer& blas_node);
+    void dispatchNative(codegen::PrettyPrinter& stream, const BLASNodeGer& blas_node);
+
    public:
     BLASDispatcherGer(codegen::LanguageExtension& language_extension, const Function& function,
                       const data_flow::DataFlowGraph& data_flow_graph,
-                      const data_flow::LibraryNode& node);
+                      const data_flow::LibraryNode& node, const BLASImplementation impl);
 
     virtual void dispatch(codegen::PrettyPrinter& stream) override;
 };
 
-inline void register_blas_dispatcher_ger() {
+inline void register_blas_dispatcher_ger(BLASImplementation impl) {
     codegen::LibraryNodeDispatcherRegistry::instance().register_library_node_dispatcher(
         LibraryNodeType_BLAS_ger.value(),
-        [](codegen::LanguageExtension& language_extension, const Function& function,
-           const data_flow::DataFlowGraph& data_flow_graph, const data_flow::LibraryNode& node) {
+        [impl](codegen::LanguageExtension& language_extension, const Function& function,
+               const data_flow::DataFlowGraph& data_flow_graph,
+               const data_flow::LibraryNode& node) {
             return std::make_unique<BLASDispatcherGer>(language_extension, function,
-                                                       data_flow_graph, node);
+                                                       data_flow_graph, node, impl);
         });
 }
 
@@ -10,27 +10,35 @@
 
 #include <memory>
 
+#include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_symm.h"
 
 namespace sdfg {
 namespace blas {
 
 class BLASDispatcherSymm : public codegen::LibraryNodeDispatcher {
+   private:
+    const BLASImplementation impl_;
+
+    void dispatchCBLAS(codegen::PrettyPrinter& stream, const BLASNodeSymm& blas_node);
+    void dispatchNative(codegen::PrettyPrinter& stream, const BLASNodeSymm& blas_node);
+
    public:
     BLASDispatcherSymm(codegen::LanguageExtension& language_extension, const Function& function,
                        const data_flow::DataFlowGraph& data_flow_graph,
-                       const data_flow::LibraryNode& node);
+                       const data_flow::LibraryNode& node, const BLASImplementation impl);
 
     virtual void dispatch(codegen::PrettyPrinter& stream) override;
 };
 
-inline void register_blas_dispatcher_symm() {
+inline void register_blas_dispatcher_symm(BLASImplementation impl) {
     codegen::LibraryNodeDispatcherRegistry::instance().register_library_node_dispatcher(
         LibraryNodeType_BLAS_symm.value(),
-        [](codegen::LanguageExtension& language_extension, const Function& function,
-           const data_flow::DataFlowGraph& data_flow_graph, const data_flow::LibraryNode& node) {
+        [impl](codegen::LanguageExtension& language_extension, const Function& function,
+               const data_flow::DataFlowGraph& data_flow_graph,
+               const data_flow::LibraryNode& node) {
             return std::make_unique<BLASDispatcherSymm>(language_extension, function,
-                                                        data_flow_graph, node);
+                                                        data_flow_graph, node, impl);
         });
 }
 
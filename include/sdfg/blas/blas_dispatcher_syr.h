@@ -8,27 +8,35 @@
 #include <sdfg/data_flow/library_node.h>
 #include <sdfg/function.h>
 
+#include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_syr.h"
 
 namespace sdfg {
 namespace blas {
 
 class BLASDispatcherSyr : public codegen::LibraryNodeDispatcher {
+   private:
+    const BLASImplementation impl_;
+
+    void dispatchCBLAS(codegen::PrettyPrinter& stream, const BLASNodeSyr& blas_node);
+    void dispatchNative(codegen::PrettyPrinter& stream, const BLASNodeSyr& blas_node);
+
    public:
     BLASDispatcherSyr(codegen::LanguageExtension& language_extension, const Function& function,
                       const data_flow::DataFlowGraph& data_flow_graph,
-                      const data_flow::LibraryNode& node);
+                      const data_flow::LibraryNode& node, const BLASImplementation impl);
 
     virtual void dispatch(codegen::PrettyPrinter& stream) override;
 };
 
-inline void register_blas_dispatcher_syr() {
+inline void register_blas_dispatcher_syr(BLASImplementation impl) {
     codegen::LibraryNodeDispatcherRegistry::instance().register_library_node_dispatcher(
         LibraryNodeType_BLAS_syr.value(),
-        [](codegen::LanguageExtension& language_extension, const Function& function,
-           const data_flow::DataFlowGraph& data_flow_graph, const data_flow::LibraryNode& node) {
+        [impl](codegen::LanguageExtension& language_extension, const Function& function,
+               const data_flow::DataFlowGraph& data_flow_graph,
+               const data_flow::LibraryNode& node) {
             return std::make_unique<BLASDispatcherSyr>(language_extension, function,
-                                                       data_flow_graph, node);
+                                                       data_flow_graph, node, impl);
         });
 }
 
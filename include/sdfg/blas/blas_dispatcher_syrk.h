@@ -22,6 +22,7 @@ class BLASDispatcherSyrk : public codegen::LibraryNodeDispatcher {
 
     void dispatchCBLAS(codegen::PrettyPrinter& stream, const BLASNodeSyrk& blas_node);
     void dispatchCUBLAS(codegen::PrettyPrinter& stream, const BLASNodeSyrk& blas_node);
+    void dispatchNative(codegen::PrettyPrinter& stream, const BLASNodeSyrk& blas_node);
 
    public:
     BLASDispatcherSyrk(codegen::LanguageExtension& language_extension, const Function& function,
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <sdfg/codegen/language_extension.h>
+#include <sdfg/codegen/utils.h>
+#include <sdfg/data_flow/data_flow_graph.h>
+#include <sdfg/data_flow/library_node.h>
+#include <sdfg/function.h>
+#include <sdfg/symbolic/symbolic.h>
+
+#include <cstddef>
+#include <string>
+
+namespace sdfg {
+namespace blas {
+
+/**
+ * @brief Emits the CUDA_CHECK and CUBLAS_CHECK fallbacks and fetches the shared cuBLAS handle
+ *
+ * The handle and device buffers are provided by sdfg/blas/runtime/sdfg_cublas.h.
+ */
+void cublas_prologue(codegen::PrettyPrinter& stream);
+
+/**
+ * @brief Determines the key of the device buffer of a connector
+ *
+ * The key is the name of the container connected to the connector. If the container is connected
+ * to several connectors of the node, the connector name is appended to keep the buffers apart.
+ */
+std::string cublas_buffer_key(const data_flow::DataFlowGraph& data_flow_graph,
+                              const data_flow::LibraryNode& node, const std::string& conn);
+
+/**
+ * @brief Checks whether a connector of the node points to a nested array, e.g., float **
+ *
+ * Elements of nested matrices are accessed as [row][col] instead of [row * ld + col].
+ */
+bool nested_connector(const Function& function, const data_flow::DataFlowGraph& data_flow_graph,
+                      const data_flow::LibraryNode& node, const std::string& conn);
+
+/**
+ * @brief Matches an epilogue of the form min(max(scale * out + shift, lower), upper)
+ *
+ * Both bounds are optional. On success, the arguments scale, shift, lower, and upper of the
+ * *_epilogue routines of sdfg/blas/runtime/sdfg_blas.h are returned as a comma-separated list.
+ */
+bool native_epilogue(codegen::LanguageExtension& language_extension,
+                     const symbolic::Expression& epilogue, const std::string& out,
+                     std::string& args);
+
+/**
+ * @brief Determines the value of a size if it is an integer constant
+ */
+bool constant_size(const symbolic::Expression& size, size_t& value);
+
+/**
+ * @brief Emits a loop nest which applies an epilogue to every element of a row-major matrix
+ *
+ * The epilogue is an expression in the output connector out, which points to the matrix. Nested
+ * matrices are indexed by row and column, flat ones with the leading dimension ld.
+ */
+void epilogue_loop(codegen::LanguageExtension& language_extension, codegen::PrettyPrinter& stream,
+                   const symbolic::Expression& epilogue, const std::string& out,
+                   const std::string& rows, const std::string& cols, const std::string& ld,
+                   bool nested = false);
+
+}  // namespace blas
+}  // namespace sdfg
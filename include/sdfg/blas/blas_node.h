@@ -8,6 +8,7 @@
 #include <sdfg/symbolic/symbolic.h>
 
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace sdfg {
@@ -24,6 +25,25 @@ constexpr const char* blasType2String(const BLASType type) {
     }
 }
 
+// Literals of the scalar type, e.g., for default alpha and beta values
+constexpr const char* blasOne(const BLASType type) {
+    switch (type) {
+        case BLASType_real:
+            return "1.0f";
+        case BLASType_double:
+            return "1.0";
+    }
+}
+
+constexpr const char* blasZero(const BLASType type) {
+    switch (type) {
+        case BLASType_real:
+            return "0.0f";
+        case BLASType_double:
+            return "0.0";
+    }
+}
+
 enum BLASTranspose { BLASTranspose_No, BLASTranspose_Transpose };
 
 constexpr const char* blasTranspose2String(const BLASTranspose transpose) {
@@ -57,10 +77,17 @@ constexpr const char* blasSide2String(const BLASSide side) {
     }
 }
 
-enum BLASImplementation { BLASImplementation_CBLAS, BLASImplementation_CUBLAS };
+// Native calls the bundled runtime in sdfg/blas/runtime/sdfg_blas.h
+enum BLASImplementation {
+    BLASImplementation_CBLAS,
+    BLASImplementation_CUBLAS,
+    BLASImplementation_Native
+};
 
 class BLASNode : public data_flow::LibraryNode {
     BLASType type_;
+    std::unordered_set<std::string> resident_inputs_;
+    std::unordered_set<std::string> resident_outputs_;
 
    public:
     BLASNode(size_t element_id, const DebugInfo& debug_info, const graph::Vertex vertex,
@@ -75,6 +102,22 @@ class BLASNode : public data_flow::LibraryNode {
 
     BLASType type() const;
 
+    /**
+     * @brief Checks if the data of an input connector is already on the device
+     *
+     * Set by the BLASResidency transformation. The CUBLAS dispatchers skip the upload.
+     */
+    bool resident_input(const std::string& conn) const;
+    void set_resident_input(const std::string& conn, bool resident);
+
+    /**
+     * @brief Checks if the data of an output connector stays on the device for a later BLAS node
+     *
+     * Set by the BLASResidency transformation. The CUBLAS dispatchers skip the download.
+     */
+    bool resident_output(const std::string& conn) const;
+    void set_resident_output(const std::string& conn, bool resident);
+
     virtual symbolic::SymbolSet symbols() const override;
 
     virtual void validate() const override;
@@ -19,11 +19,15 @@ inline data_flow::LibraryNodeCode LibraryNodeType_BLAS_axpy("BLAS axpy");
 
 class BLASNodeAxpy : public BLASNode {
     symbolic::Expression n_;
+    symbolic::Expression incx_;
+    symbolic::Expression incy_;
 
    public:
     BLASNodeAxpy(size_t element_id, const DebugInfo& debug_info, const graph::Vertex vertex,
                  data_flow::DataFlowGraph& parent, const BLASType type, symbolic::Expression n,
-                 std::string alpha, std::string x, std::string y);
+                 std::string alpha, std::string x, std::string y,
+                 symbolic::Expression incx = symbolic::one(),
+                 symbolic::Expression incy = symbolic::one());
 
     BLASNodeAxpy(const BLASNodeAxpy&) = delete;
     BLASNodeAxpy& operator=(const BLASNodeAxpy&) = delete;
@@ -36,6 +40,9 @@ class BLASNodeAxpy : public BLASNode {
     std::string x() const;
     std::string y() const;
 
+    symbolic::Expression incx() const;
+    symbolic::Expression incy() const;
+
     virtual std::unique_ptr<data_flow::DataFlowNode> clone(
         size_t element_id, const graph::Vertex vertex,
         data_flow::DataFlowGraph& parent) const override;
@@ -19,11 +19,14 @@ inline data_flow::LibraryNodeCode LibraryNodeType_BLAS_copy("BLAS copy");
 
 class BLASNodeCopy : public BLASNode {
     symbolic::Expression n_;
+    symbolic::Expression incx_;
+    symbolic::Expression incy_;
 
    public:
     BLASNodeCopy(size_t element_id, const DebugInfo& debug_info, const graph::Vertex vertex,
                  data_flow::DataFlowGraph& parent, const BLASType type, symbolic::Expression n,
-                 std::string x, std::string y);
+                 std::string x, std::string y, symbolic::Expression incx = symbolic::one(),
+                 symbolic::Expression incy = symbolic::one());
 
     BLASNodeCopy(const BLASNodeCopy&) = delete;
     BLASNodeCopy& operator=(const BLASNodeCopy&) = delete;
@@ -35,6 +38,9 @@ class BLASNodeCopy : public BLASNode {
     std::string x() const;
     std::string y() const;
 
+    symbolic::Expression incx() const;
+    symbolic::Expression incy() const;
+
     virtual std::unique_ptr<data_flow::DataFlowNode> clone(
         size_t element_id, const graph::Vertex vertex,
         data_flow::DataFlowGraph& parent) const override;
@@ -19,11 +19,15 @@ inline data_flow::LibraryNodeCode LibraryNodeType_BLAS_dot("BLAS dot");
 
 class BLASNodeDot : public BLASNode {
     symbolic::Expression n_;
+    symbolic::Expression incx_;
+    symbolic::Expression incy_;
 
    public:
     BLASNodeDot(size_t element_id, const DebugInfo& debug_info, const graph::Vertex vertex,
                 data_flow::DataFlowGraph& parent, std::string result, const BLASType type,
-                symbolic::Expression n, std::string x, std::string y);
+                symbolic::Expression n, std::string x, std::string y,
+                symbolic::Expression incx = symbolic::one(),
+                symbolic::Expression incy = symbolic::one());
 
     BLASNodeDot(const BLASNodeDot&) = delete;
     BLASNodeDot& operator=(const BLASNodeDot&) = delete;
@@ -37,6 +41,9 @@ class BLASNodeDot : public BLASNode {
     std::string x() const;
     std::string y() const;
 
+    symbolic::Expression incx() const;
+    symbolic::Expression incy() const;
+
     virtual std::unique_ptr<data_flow::DataFlowNode> clone(
         size_t element_id, const graph::Vertex vertex,
         data_flow::DataFlowGraph& parent) const override;
@@ -19,13 +19,18 @@ inline data_flow::LibraryNodeCode LibraryNodeType_BLAS_gemm("BLAS gemm");
 class BLASNodeGemm : public BLASNode {
     BLASTranspose transA_, transB_;
     symbolic::Expression m_, n_, k_;
+    symbolic::Expression lda_, ldb_, ldc_;
+    symbolic::Expression epilogue_;
 
    public:
     BLASNodeGemm(size_t element_id, const DebugInfo& debug_info, const graph::Vertex vertex,
                  data_flow::DataFlowGraph& parent, const BLASType type, BLASTranspose transA,
                  BLASTranspose transB, symbolic::Expression m, symbolic::Expression n,
                  symbolic::Expression k, std::string alpha, std::string A, std::string B,
-                 std::string C);
+                 std::string C, symbolic::Expression lda = symbolic::Expression(),
+                 symbolic::Expression ldb = symbolic::Expression(),
+                 symbolic::Expression ldc = symbolic::Expression(), std::string beta = "",
+                 symbolic::Expression epilogue = symbolic::Expression());
 
     BLASNodeGemm(const BLASNodeGemm&) = delete;
     BLASNodeGemm& operator=(const BLASNodeGemm&) = delete;
@@ -44,6 +49,24 @@ class BLASNodeGemm : public BLASNode {
     std::string B() const;
     std::string C() const;
 
+    /**
+     * @brief Scaling factor of C; defaults to 1.0, i.e., the product is accumulated onto C
+     */
+    std::string beta() const;
+
+    /**
+     * @brief Distances between two rows of A, B, and C; default to the packed layout
+     */
+    symbolic::Expression lda() const;
+    symbolic::Expression ldb() const;
+    symbolic::Expression ldc() const;
+
+    /**
+     * @brief Element-wise expression in C which is stored instead of each final element of C;
+     * null if the elements are stored unchanged
+     */
+    symbolic::Expression epilogue() const;
+
     virtual std::unique_ptr<data_flow::DataFlowNode> clone(
         size_t element_id, const graph::Vertex vertex,
         data_flow::DataFlowGraph& parent) const override;
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <sdfg/data_flow/data_flow_graph.h>
+#include <sdfg/data_flow/data_flow_node.h>
+#include <sdfg/data_flow/library_node.h>
+#include <sdfg/element.h>
+#include <sdfg/graph/graph.h>
+#include <sdfg/symbolic/symbolic.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sdfg/blas/blas_node.h"
+
+namespace sdfg {
+namespace blas {
+
+inline data_flow::LibraryNodeCode LibraryNodeType_BLAS_gemm_batched("BLAS gemm batched");
+
+/**
+ * @brief A batch of independent gemm calls C[b] = alpha * A[b] * B[b] + beta * C[b]
+ *
+ * The batch indices are given as pairs of indvar and bound. They are the leading indices of A, B,
+ * and C.
+ */
+class BLASNodeGemmBatched : public BLASNode {
+    BLASTranspose transA_, transB_;
+    std::vector<std::pair<symbolic::Symbol, symbolic::Expression>> batch_;
+    symbolic::Expression m_, n_, k_;
+
+   public:
+    BLASNodeGemmBatched(size_t element_id, const DebugInfo& debug_info, const graph::Vertex vertex,
+                        data_flow::DataFlowGraph& parent, const BLASType type, BLASTranspose transA,
+                        BLASTranspose transB,
+                        const std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>& batch,
+                        symbolic::Expression m, symbolic::Expression n, symbolic::Expression k,
+                        std::string alpha, std::string A, std::string B, std::string C,
+                        std::string beta = "");
+
+    BLASNodeGemmBatched(const BLASNodeGemmBatched&) = delete;
+    BLASNodeGemmBatched& operator=(const BLASNodeGemmBatched&) = delete;
+
+    virtual ~BLASNodeGemmBatched() = default;
+
+    BLASTranspose transA() const;
+    BLASTranspose transB() const;
+
+    const std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>& batch() const;
+    const symbolic::Symbol& batch_indvar(size_t index) const;
+    const symbolic::Expression& batch_size(size_t index) const;
+
+    symbolic::Expression m() const;
+    symbolic::Expression n() const;
+    symbolic::Expression k() const;
+
+    std::string alpha() const;
+    std::string A() const;
+    std::string B() const;
+    std::string C() const;
+    std::string beta() const;
+
+    virtual std::unique_ptr<data_flow::DataFlowNode> clone(
+        size_t element_id, const graph::Vertex vertex,
+        data_flow::DataFlowGraph& parent) const override;
+
+    virtual std::string toStr() const override;
+};
+
+}  // namespace blas
+}  // namespace sdfg
@@ -20,12 +20,18 @@ inline data_flow::LibraryNodeCode LibraryNodeType_BLAS_gemv("BLAS gemv");
 class BLASNodeGemv : public BLASNode {
     BLASTranspose trans_;
     symbolic::Expression m_, n_;
+    symbolic::Expression lda_;
+    symbolic::Expression incx_, incy_;
+    symbolic::Expression epilogue_;
 
    public:
     BLASNodeGemv(size_t element_id, const DebugInfo& debug_info, const graph::Vertex vertex,
                  data_flow::DataFlowGraph& parent, const BLASType type, BLASTranspose trans,
                  symbolic::Expression m, symbolic::Expression n, std::string alpha, std::string A,
-                 std::string x, std::string y);
+                 std::string x, std::string y, symbolic::Expression lda = symbolic::Expression(),
+                 symbolic::Expression incx = symbolic::one(),
+                 symbolic::Expression incy = symbolic::one(), std::string beta = "",
+                 symbolic::Expression epilogue = symbolic::Expression());
 
     BLASNodeGemv(const BLASNodeGemv&) = delete;
     BLASNodeGemv& operator=(const BLASNodeGemv&) = delete;
@@ -42,6 +48,24 @@ class BLASNodeGemv : public BLASNode {
     std::string x() const;
     std::string y() const;
 
+    /**
+     * @brief Scaling factor of y; defaults to 1.0, i.e., the product is accumulated onto y
+     */
+    std::string beta() const;
+
+    /**
+     * @brief Distance between two rows of A; defaults to n for a packed matrix
+     */
+    symbolic::Expression lda() const;
+    symbolic::Expression incx() const;
+    symbolic::Expression incy() const;
+
+    /**
+     * @brief Element-wise expression in y which is stored instead of each final element of y;
+     * null if the elements are stored unchanged
+     */
+    symbolic::Expression epilogue() const;
+
     virtual std::unique_ptr<data_flow::DataFlowNode> clone(
         size_t element_id, const graph::Vertex vertex,
         data_flow::DataFlowGraph& parent) const override;
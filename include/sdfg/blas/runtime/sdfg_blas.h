@@ -0,0 +1,140 @@
+/*
+ * Self-contained BLAS subset for generated code (BLASImplementation_Native)
+ *
+ * All routines operate on row-major data and take transposition and triangle flags as the
+ * characters 'N'/'T' and 'U'/'L'. gemm follows the BLIS design: op(A) and op(B) are packed into
+ * cache-sized blocks and a register-blocked micro-kernel computes MR x NR tiles of C. The
+ * micro-kernel is written against a small vector abstraction that maps to AVX-512, AVX2+FMA, or
+ * NEON depending on the target flags of the compiler, and to scalar code otherwise.
+ *
+ * gemm_epilogue and gemv_epilogue additionally apply min(max(scale * x + shift, lower), upper) to
+ * every element of the output when it is stored for the last time, so that an element-wise
+ * epilogue such as a scaling, a bias, or a ReLU does not need another pass over the output.
+ *
+ * The header is valid C99 and C++ and has no dependencies besides the C standard library.
+ */
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define SDFG_BLAS_ISA_AVX512
+#elif defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define SDFG_BLAS_ISA_AVX2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SDFG_BLAS_ISA_NEON
+#endif
+
+// Rows of a micro-tile and vectors per micro-tile row
+#define SDFG_BLAS_MR 6
+#if defined(SDFG_BLAS_ISA_AVX512) || defined(SDFG_BLAS_ISA_AVX2) || defined(SDFG_BLAS_ISA_NEON)
+#define SDFG_BLAS_NR_VECTORS 2
+#else
+#define SDFG_BLAS_NR_VECTORS 4
+#endif
+
+// Cache blocking of op(A) (MC x KC) and op(B) (KC x NC)
+#define SDFG_BLAS_MC (SDFG_BLAS_MR * 24)
+#define SDFG_BLAS_KC 256
+#define SDFG_BLAS_NC 4096
+
+/* Single precision */
+
+#if defined(SDFG_BLAS_ISA_AVX512)
+#define SDFG_BLAS_VEC __m512
+#define SDFG_BLAS_VLEN 16
+#define SDFG_BLAS_VZERO() _mm512_setzero_ps()
+#define SDFG_BLAS_VSET1(x) _mm512_set1_ps(x)
+#define SDFG_BLAS_VLOAD(p) _mm512_loadu_ps(p)
+#define SDFG_BLAS_VSTORE(p, v) _mm512_storeu_ps(p, v)
+#define SDFG_BLAS_VFMA(a, b, c) _mm512_fmadd_ps(a, b, c)
+#elif defined(SDFG_BLAS_ISA_AVX2)
+#define SDFG_BLAS_VEC __m256
+#define SDFG_BLAS_VLEN 8
+#define SDFG_BLAS_VZERO() _mm256_setzero_ps()
+#define SDFG_BLAS_VSET1(x) _mm256_set1_ps(x)
+#define SDFG_BLAS_VLOAD(p) _mm256_loadu_ps(p)
+#define SDFG_BLAS_VSTORE(p, v) _mm256_storeu_ps(p, v)
+#define SDFG_BLAS_VFMA(a, b, c) _mm256_fmadd_ps(a, b, c)
+#elif defined(SDFG_BLAS_ISA_NEON)
+#define SDFG_BLAS_VEC float32x4_t
+#define SDFG_BLAS_VLEN 4
+#define SDFG_BLAS_VZERO() vdupq_n_f32(0.0f)
+#define SDFG_BLAS_VSET1(x) vdupq_n_f32(x)
+#define SDFG_BLAS_VLOAD(p) vld1q_f32(p)
+#define SDFG_BLAS_VSTORE(p, v) vst1q_f32(p, v)
+#define SDFG_BLAS_VFMA(a, b, c) vfmaq_f32(c, a, b)
+#else
+#define SDFG_BLAS_VEC float
+#define SDFG_BLAS_VLEN 1
+#define SDFG_BLAS_VZERO() 0.0f
+#define SDFG_BLAS_VSET1(x) (x)
+#define SDFG_BLAS_VLOAD(p) (*(p))
+#define SDFG_BLAS_VSTORE(p, v) (*(p) = (v))
+#define SDFG_BLAS_VFMA(a, b, c) ((a) * (b) + (c))
+#endif
+#define SDFG_BLAS_T float
+#define SDFG_BLAS_NAME(name) sdfg_blas_s##name
+#include "sdfg/blas/runtime/sdfg_blas_impl.h"
+#undef SDFG_BLAS_NAME
+#undef SDFG_BLAS_T
+#undef SDFG_BLAS_VFMA
+#undef SDFG_BLAS_VSTORE
+#undef SDFG_BLAS_VLOAD
+#undef SDFG_BLAS_VSET1
+#undef SDFG_BLAS_VZERO
+#undef SDFG_BLAS_VLEN
+#undef SDFG_BLAS_VEC
+
+/* Double precision */
+
+#if defined(SDFG_BLAS_ISA_AVX512)
+#define SDFG_BLAS_VEC __m512d
+#define SDFG_BLAS_VLEN 8
+#define SDFG_BLAS_VZERO() _mm512_setzero_pd()
+#define SDFG_BLAS_VSET1(x) _mm512_set1_pd(x)
+#define SDFG_BLAS_VLOAD(p) _mm512_loadu_pd(p)
+#define SDFG_BLAS_VSTORE(p, v) _mm512_storeu_pd(p, v)
+#define SDFG_BLAS_VFMA(a, b, c) _mm512_fmadd_pd(a, b, c)
+#elif defined(SDFG_BLAS_ISA_AVX2)
+#define SDFG_BLAS_VEC __m256d
+#define SDFG_BLAS_VLEN 4
+#define SDFG_BLAS_VZERO() _mm256_setzero_pd()
+#define SDFG_BLAS_VSET1(x) _mm256_set1_pd(x)
+#define SDFG_BLAS_VLOAD(p) _mm256_loadu_pd(p)
+#define SDFG_BLAS_VSTORE(p, v) _mm256_storeu_pd(p, v)
+#define SDFG_BLAS_VFMA(a, b, c) _mm256_fmadd_pd(a, b, c)
+#elif defined(SDFG_BLAS_ISA_NEON)
+#define SDFG_BLAS_VEC float64x2_t
+#define SDFG_BLAS_VLEN 2
+#define SDFG_BLAS_VZERO() vdupq_n_f64(0.0)
+#define SDFG_BLAS_VSET1(x) vdupq_n_f64(x)
+#define SDFG_BLAS_VLOAD(p) vld1q_f64(p)
+#define SDFG_BLAS_VSTORE(p, v) vst1q_f64(p, v)
+#define SDFG_BLAS_VFMA(a, b, c) vfmaq_f64(c, a, b)
+#else
+#define SDFG_BLAS_VEC double
+#define SDFG_BLAS_VLEN 1
+#define SDFG_BLAS_VZERO() 0.0
+#define SDFG_BLAS_VSET1(x) (x)
+#define SDFG_BLAS_VLOAD(p) (*(p))
+#define SDFG_BLAS_VSTORE(p, v) (*(p) = (v))
+#define SDFG_BLAS_VFMA(a, b, c) ((a) * (b) + (c))
+#endif
+#define SDFG_BLAS_T double
+#define SDFG_BLAS_NAME(name) sdfg_blas_d##name
+#include "sdfg/blas/runtime/sdfg_blas_impl.h"
+#undef SDFG_BLAS_NAME
+#undef SDFG_BLAS_T
+#undef SDFG_BLAS_VFMA
+#undef SDFG_BLAS_VSTORE
+#undef SDFG_BLAS_VLOAD
+#undef SDFG_BLAS_VSET1
+#undef SDFG_BLAS_VZERO
+#undef SDFG_BLAS_VLEN
+#undef SDFG_BLAS_VEC
@@ -0,0 +1,342 @@
+/*
+ * Routines of sdfg_blas.h for one scalar type
+ *
+ * This file is included once per scalar type by sdfg_blas.h with SDFG_BLAS_T, SDFG_BLAS_NAME, and
+ * the SDFG_BLAS_V* vector operations defined. It must not be included directly.
+ */
+
+#define SDFG_BLAS_NR (SDFG_BLAS_VLEN * SDFG_BLAS_NR_VECTORS)
+
+// min(max(scale * x + shift, lower), upper) for an epilogue {scale, shift, lower, upper}
+static inline SDFG_BLAS_T SDFG_BLAS_NAME(apply_epilogue)(SDFG_BLAS_T x,
+                                                         const SDFG_BLAS_T* epilogue) {
+    x = epilogue[0] * x + epilogue[1];
+    if (x < epilogue[2]) x = epilogue[2];
+    if (x > epilogue[3]) x = epilogue[3];
+    return x;
+}
+
+/* Level 1 */
+
+static inline void SDFG_BLAS_NAME(axpy)(size_t n, SDFG_BLAS_T alpha, const SDFG_BLAS_T* x,
+                                        size_t incx, SDFG_BLAS_T* y, size_t incy) {
+    if (incx == 1 && incy == 1) {
+#pragma omp simd
+        for (size_t i = 0; i < n; i++) y[i] += alpha * x[i];
+    } else {
+        for (size_t i = 0; i < n; i++) y[i * incy] += alpha * x[i * incx];
+    }
+}
+
+static inline void SDFG_BLAS_NAME(copy)(size_t n, const SDFG_BLAS_T* x, size_t incx,
+                                        SDFG_BLAS_T* y, size_t incy) {
+    if (incx == 1 && incy == 1) {
+#pragma omp simd
+        for (size_t i = 0; i < n; i++) y[i] = x[i];
+    } else {
+        for (size_t i = 0; i < n; i++) y[i * incy] = x[i * incx];
+    }
+}
+
+static inline SDFG_BLAS_T SDFG_BLAS_NAME(dot)(size_t n, const SDFG_BLAS_T* x, size_t incx,
+                                             const SDFG_BLAS_T* y, size_t incy) {
+    SDFG_BLAS_T sum = 0;
+    if (incx == 1 && incy == 1) {
+#pragma omp simd reduction(+ : sum)
+        for (size_t i = 0; i < n; i++) sum += x[i] * y[i];
+    } else {
+        for (size_t i = 0; i < n; i++) sum += x[i * incx] * y[i * incy];
+    }
+    return sum;
+}
+
+/* Level 2 */
+
+// The epilogue is applied to every element of y if it is not NULL
+static inline void SDFG_BLAS_NAME(gemv_impl)(char trans, size_t m, size_t n, SDFG_BLAS_T alpha,
+                                             const SDFG_BLAS_T* A, size_t lda,
+                                             const SDFG_BLAS_T* x, size_t incx, SDFG_BLAS_T beta,
+                                             SDFG_BLAS_T* y, size_t incy,
+                                             const SDFG_BLAS_T* epilogue) {
+    if (trans == 'N') {
+        // y[i] = beta * y[i] + alpha * dot(A[i][:], x); the rows are independent
+#pragma omp parallel for
+        for (size_t i = 0; i < m; i++) {
+            SDFG_BLAS_T sum = 0;
+            if (incx == 1) {
+#pragma omp simd reduction(+ : sum)
+                for (size_t j = 0; j < n; j++) sum += A[i * lda + j] * x[j];
+            } else {
+                for (size_t j = 0; j < n; j++) sum += A[i * lda + j] * x[j * incx];
+            }
+            SDFG_BLAS_T value = (beta == 0 ? 0 : beta * y[i * incy]) + alpha * sum;
+            y[i * incy] = epilogue ? SDFG_BLAS_NAME(apply_epilogue)(value, epilogue) : value;
+        }
+    } else {
+        // y = beta * y + alpha * A^T x, accumulated row by row to stream through A
+        for (size_t j = 0; j < n; j++) y[j * incy] = (beta == 0 ? 0 : beta * y[j * incy]);
+        for (size_t i = 0; i < m; i++) {
+            SDFG_BLAS_NAME(axpy)(n, alpha * x[i * incx], A + i * lda, 1, y, incy);
+        }
+        if (epilogue) {
+            for (size_t j = 0; j < n; j++)
+                y[j * incy] = SDFG_BLAS_NAME(apply_epilogue)(y[j * incy], epilogue);
+        }
+    }
+}
+
+static inline void SDFG_BLAS_NAME(gemv)(char trans, size_t m, size_t n, SDFG_BLAS_T alpha,
+                                        const SDFG_BLAS_T* A, size_t lda, const SDFG_BLAS_T* x,
+                                        size_t incx, SDFG_BLAS_T beta, SDFG_BLAS_T* y,
+                                        size_t incy) {
+    SDFG_BLAS_NAME(gemv_impl)(trans, m, n, alpha, A, lda, x, incx, beta, y, incy, NULL);
+}
+
+static inline void SDFG_BLAS_NAME(gemv_epilogue)(char trans, size_t m, size_t n,
+                                                 SDFG_BLAS_T alpha, const SDFG_BLAS_T* A,
+                                                 size_t lda, const SDFG_BLAS_T* x, size_t incx,
+                                                 SDFG_BLAS_T beta, SDFG_BLAS_T* y, size_t incy,
+                                                 SDFG_BLAS_T scale, SDFG_BLAS_T shift,
+                                                 SDFG_BLAS_T lower, SDFG_BLAS_T upper) {
+    const SDFG_BLAS_T epilogue[4] = {scale, shift, lower, upper};
+    SDFG_BLAS_NAME(gemv_impl)(trans, m, n, alpha, A, lda, x, incx, beta, y, incy, epilogue);
+}
+
+// y = beta * y + alpha * A x for a symmetric A of which only the triangle selected by uplo is
+// referenced
+static inline void SDFG_BLAS_NAME(symv)(char uplo, size_t n, SDFG_BLAS_T alpha,
+                                        const SDFG_BLAS_T* A, size_t lda, const SDFG_BLAS_T* x,
+                                        size_t incx, SDFG_BLAS_T beta, SDFG_BLAS_T* y,
+                                        size_t incy) {
+#pragma omp parallel for
+    for (size_t i = 0; i < n; i++) {
+        // Row i of A is read from the stored part of row i and of column i
+        size_t j_begin = (uplo == 'U') ? i : 0;
+        size_t j_end = (uplo == 'U') ? n : i + 1;
+        SDFG_BLAS_T sum = 0;
+        for (size_t j = 0; j < j_begin; j++) sum += A[j * lda + i] * x[j * incx];
+        for (size_t j = j_begin; j < j_end; j++) sum += A[i * lda + j] * x[j * incx];
+        for (size_t j = j_end; j < n; j++) sum += A[j * lda + i] * x[j * incx];
+        y[i * incy] = (beta == 0 ? 0 : beta * y[i * incy]) + alpha * sum;
+    }
+}
+
+// A += alpha * x y^T
+static inline void SDFG_BLAS_NAME(ger)(size_t m, size_t n, SDFG_BLAS_T alpha,
+                                       const SDFG_BLAS_T* x, size_t incx, const SDFG_BLAS_T* y,
+                                       size_t incy, SDFG_BLAS_T* A, size_t lda) {
+#pragma omp parallel for
+    for (size_t i = 0; i < m; i++) {
+        SDFG_BLAS_NAME(axpy)(n, alpha * x[i * incx], y, incy, A + i * lda, 1);
+    }
+}
+
+// A += alpha * x x^T on the triangle selected by uplo
+static inline void SDFG_BLAS_NAME(syr)(char uplo, size_t n, SDFG_BLAS_T alpha,
+                                       const SDFG_BLAS_T* x, size_t incx, SDFG_BLAS_T* A,
+                                       size_t lda) {
+#pragma omp parallel for
+    for (size_t i = 0; i < n; i++) {
+        size_t j_begin = (uplo == 'U') ? i : 0;
+        size_t j_end = (uplo == 'U') ? n : i + 1;
+        SDFG_BLAS_NAME(axpy)(j_end - j_begin, alpha * x[i * incx], x + j_begin * incx, incx,
+                             A + i * lda + j_begin, 1);
+    }
+}
+
+/* Level 3 */
+
+// Packs an mc x kc block of op(A) into row panels of MR rows, zero-padding the last panel
+static inline void SDFG_BLAS_NAME(pack_a)(char trans, size_t mc, size_t kc, const SDFG_BLAS_T* A,
+                                          size_t lda, size_t row, size_t col, SDFG_BLAS_T* buf) {
+    for (size_t ir = 0; ir < mc; ir += SDFG_BLAS_MR) {
+        for (size_t p = 0; p < kc; p++) {
+            for (size_t i = 0; i < SDFG_BLAS_MR; i++) {
+                if (ir + i >= mc)
+                    *buf++ = 0;
+                else if (trans == 'N')
+                    *buf++ = A[(row + ir + i) * lda + col + p];
+                else
+                    *buf++ = A[(col + p) * lda + row + ir + i];
+            }
+        }
+    }
+}
+
+// Packs a kc x nc block of op(B) into column panels of NR columns, zero-padding the last panel
+static inline void SDFG_BLAS_NAME(pack_b)(char trans, size_t kc, size_t nc, const SDFG_BLAS_T* B,
+                                          size_t ldb, size_t row, size_t col, SDFG_BLAS_T* buf) {
+    for (size_t jr = 0; jr < nc; jr += SDFG_BLAS_NR) {
+        for (size_t p = 0; p < kc; p++) {
+            for (size_t j = 0; j < SDFG_BLAS_NR; j++) {
+                if (jr + j >= nc)
+                    *buf++ = 0;
+                else if (trans == 'N')
+                    *buf++ = B[(row + p) * ldb + col + jr + j];
+                else
+                    *buf++ = B[(col + jr + j) * ldb + row + p];
+            }
+        }
+    }
+}
+
+// C[0:mr][0:nr] += alpha * a * b for one MR panel of packed A and one NR panel of packed B. The
+// epilogue is applied while storing C if it is not NULL, i.e., for the last KC block.
+static inline void SDFG_BLAS_NAME(micro_kernel)(size_t kc, SDFG_BLAS_T alpha, const SDFG_BLAS_T* a,
+                                                const SDFG_BLAS_T* b, SDFG_BLAS_T* C, size_t ldc,
+                                                size_t mr, size_t nr,
+                                                const SDFG_BLAS_T* epilogue) {
+    SDFG_BLAS_VEC acc[SDFG_BLAS_MR][SDFG_BLAS_NR_VECTORS];
+    for (size_t i = 0; i < SDFG_BLAS_MR; i++)
+        for (size_t j = 0; j < SDFG_BLAS_NR_VECTORS; j++) acc[i][j] = SDFG_BLAS_VZERO();
+
+    for (size_t p = 0; p < kc; p++) {
+        SDFG_BLAS_VEC bv[SDFG_BLAS_NR_VECTORS];
+        for (size_t j = 0; j < SDFG_BLAS_NR_VECTORS; j++)
+            bv[j] = SDFG_BLAS_VLOAD(b + j * SDFG_BLAS_VLEN);
+        for (size_t i = 0; i < SDFG_BLAS_MR; i++) {
+            SDFG_BLAS_VEC av = SDFG_BLAS_VSET1(a[i]);
+            for (size_t j = 0; j < SDFG_BLAS_NR_VECTORS; j++)
+                acc[i][j] = SDFG_BLAS_VFMA(av, bv[j], acc[i][j]);
+        }
+        a += SDFG_BLAS_MR;
+        b += SDFG_BLAS_NR;
+    }
+
+    SDFG_BLAS_T tile[SDFG_BLAS_MR * SDFG_BLAS_NR];
+    for (size_t i = 0; i < SDFG_BLAS_MR; i++)
+        for (size_t j = 0; j < SDFG_BLAS_NR_VECTORS; j++)
+            SDFG_BLAS_VSTORE(tile + i * SDFG_BLAS_NR + j * SDFG_BLAS_VLEN, acc[i][j]);
+    if (epilogue) {
+        for (size_t i = 0; i < mr; i++)
+            for (size_t j = 0; j < nr; j++)
+                C[i * ldc + j] = SDFG_BLAS_NAME(apply_epilogue)(
+                    C[i * ldc + j] + alpha * tile[i * SDFG_BLAS_NR + j], epilogue);
+    } else {
+        for (size_t i = 0; i < mr; i++)
+            for (size_t j = 0; j < nr; j++) C[i * ldc + j] += alpha * tile[i * SDFG_BLAS_NR + j];
+    }
+}
+
+// The epilogue is applied to every element of C if it is not NULL
+static inline void SDFG_BLAS_NAME(gemm_impl)(char transA, char transB, size_t m, size_t n,
+                                             size_t k, SDFG_BLAS_T alpha, const SDFG_BLAS_T* A,
+                                             size_t lda, const SDFG_BLAS_T* B, size_t ldb,
+                                             SDFG_BLAS_T beta, SDFG_BLAS_T* C, size_t ldc,
+                                             const SDFG_BLAS_T* epilogue) {
+    // Apply beta once up front so that the micro-kernel only accumulates
+    if (beta != 1) {
+        for (size_t i = 0; i < m; i++)
+            for (size_t j = 0; j < n; j++)
+                C[i * ldc + j] = (beta == 0 ? 0 : beta * C[i * ldc + j]);
+    }
+    if (alpha == 0 || k == 0) {
+        if (epilogue) {
+            for (size_t i = 0; i < m; i++)
+                for (size_t j = 0; j < n; j++)
+                    C[i * ldc + j] = SDFG_BLAS_NAME(apply_epilogue)(C[i * ldc + j], epilogue);
+        }
+        return;
+    }
+
+    SDFG_BLAS_T* buf_a = (SDFG_BLAS_T*)malloc(sizeof(SDFG_BLAS_T) * SDFG_BLAS_MC * SDFG_BLAS_KC);
+    SDFG_BLAS_T* buf_b = (SDFG_BLAS_T*)malloc(sizeof(SDFG_BLAS_T) * SDFG_BLAS_KC * SDFG_BLAS_NC);
+
+    for (size_t jc = 0; jc < n; jc += SDFG_BLAS_NC) {
+        size_t nc = (n - jc < SDFG_BLAS_NC) ? n - jc : SDFG_BLAS_NC;
+        for (size_t pc = 0; pc < k; pc += SDFG_BLAS_KC) {
+            size_t kc = (k - pc < SDFG_BLAS_KC) ? k - pc : SDFG_BLAS_KC;
+            const SDFG_BLAS_T* kc_epilogue = (pc + kc == k) ? epilogue : NULL;
+            SDFG_BLAS_NAME(pack_b)(transB, kc, nc, B, ldb, pc, jc, buf_b);
+            for (size_t ic = 0; ic < m; ic += SDFG_BLAS_MC) {
+                size_t mc = (m - ic < SDFG_BLAS_MC) ? m - ic : SDFG_BLAS_MC;
+                SDFG_BLAS_NAME(pack_a)(transA, mc, kc, A, lda, ic, pc, buf_a);
+
+                // The column panels write disjoint parts of C
+#pragma omp parallel for
+                for (size_t jr = 0; jr < nc; jr += SDFG_BLAS_NR) {
+                    size_t nr = (nc - jr < SDFG_BLAS_NR) ? nc - jr : SDFG_BLAS_NR;
+                    for (size_t ir = 0; ir < mc; ir += SDFG_BLAS_MR) {
+                        size_t mr = (mc - ir < SDFG_BLAS_MR) ? mc - ir : SDFG_BLAS_MR;
+                        SDFG_BLAS_NAME(micro_kernel)(kc, alpha, buf_a + ir * kc, buf_b + jr * kc,
+                                                     C + (ic + ir) * ldc + jc + jr, ldc, mr, nr,
+                                                     kc_epilogue);
+                    }
+                }
+            }
+        }
+    }
+
+    free(buf_a);
+    free(buf_b);
+}
+
+static inline void SDFG_BLAS_NAME(gemm)(char transA, char transB, size_t m, size_t n, size_t k,
+                                        SDFG_BLAS_T alpha, const SDFG_BLAS_T* A, size_t lda,
+                                        const SDFG_BLAS_T* B, size_t ldb, SDFG_BLAS_T beta,
+                                        SDFG_BLAS_T* C, size_t ldc) {
+    SDFG_BLAS_NAME(gemm_impl)(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, NULL);
+}
+
+static inline void SDFG_BLAS_NAME(gemm_epilogue)(char transA, char transB, size_t m, size_t n,
+                                                 size_t k, SDFG_BLAS_T alpha, const SDFG_BLAS_T* A,
+                                                 size_t lda, const SDFG_BLAS_T* B, size_t ldb,
+                                                 SDFG_BLAS_T beta, SDFG_BLAS_T* C, size_t ldc,
+                                                 SDFG_BLAS_T scale, SDFG_BLAS_T shift,
+                                                 SDFG_BLAS_T lower, SDFG_BLAS_T upper) {
+    const SDFG_BLAS_T epilogue[4] = {scale, shift, lower, upper};
+    SDFG_BLAS_NAME(gemm_impl)(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc,
+                              epilogue);
+}
+
+static inline void SDFG_BLAS_NAME(syrk)(char uplo, char trans, size_t n, size_t k,
+                                        SDFG_BLAS_T alpha, const SDFG_BLAS_T* A, size_t lda,
+                                        SDFG_BLAS_T beta, SDFG_BLAS_T* C, size_t ldc) {
+    // Only the triangle selected by uplo is referenced
+#pragma omp parallel for
+    for (size_t i = 0; i < n; i++) {
+        size_t j_begin = (uplo == 'U') ? i : 0;
+        size_t j_end = (uplo == 'U') ? n : i + 1;
+        for (size_t j = j_begin; j < j_end; j++) {
+            SDFG_BLAS_T sum = 0;
+            if (trans == 'N') {
+                for (size_t p = 0; p < k; p++) sum += A[i * lda + p] * A[j * lda + p];
+            } else {
+                for (size_t p = 0; p < k; p++) sum += A[p * lda + i] * A[p * lda + j];
+            }
+            C[i * ldc + j] = (beta == 0 ? 0 : beta * C[i * ldc + j]) + alpha * sum;
+        }
+    }
+}
+
+// C = beta * C + alpha * A B (side 'L') or alpha * B A (side 'R') for a symmetric A of which only
+// the triangle selected by uplo is referenced
+static inline void SDFG_BLAS_NAME(symm)(char side, char uplo, size_t m, size_t n,
+                                        SDFG_BLAS_T alpha, const SDFG_BLAS_T* A, size_t lda,
+                                        const SDFG_BLAS_T* B, size_t ldb, SDFG_BLAS_T beta,
+                                        SDFG_BLAS_T* C, size_t ldc) {
+#pragma omp parallel for
+    for (size_t i = 0; i < m; i++) {
+        SDFG_BLAS_T* c = C + i * ldc;
+        for (size_t j = 0; j < n; j++) c[j] = (beta == 0 ? 0 : beta * c[j]);
+        if (side == 'L') {
+            // C[i][:] += alpha * A[i][p] * B[p][:], streaming through the rows of B
+            for (size_t p = 0; p < m; p++) {
+                int stored = (uplo == 'U') ? (i <= p) : (p <= i);
+                SDFG_BLAS_T a = stored ? A[i * lda + p] : A[p * lda + i];
+                SDFG_BLAS_NAME(axpy)(n, alpha * a, B + p * ldb, 1, c, 1);
+            }
+        } else {
+            // C[i][:] += alpha * B[i][p] * A[p][:]
+            for (size_t p = 0; p < n; p++) {
+                SDFG_BLAS_T b = alpha * B[i * ldb + p];
+                for (size_t j = 0; j < n; j++) {
+                    int stored = (uplo == 'U') ? (p <= j) : (j <= p);
+                    c[j] += b * (stored ? A[p * lda + j] : A[j * lda + p]);
+                }
+            }
+        }
+    }
+}
+
+#undef SDFG_BLAS_NR
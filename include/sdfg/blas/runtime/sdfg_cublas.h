@@ -0,0 +1,81 @@
+/*
+ * Shared cuBLAS state for generated code (BLASImplementation_CUBLAS)
+ *
+ * The CUBLAS dispatchers fetch one lazily created handle and device buffers keyed by container
+ * name from here instead of creating and destroying them in every BLAS node. Buffers only grow,
+ * and everything is released at program exit or by sdfg_cublas_release(). The state is per
+ * translation unit and not thread-safe.
+ */
+#pragma once
+
+#include <cublas_v2.h>
+#include <cuda_runtime.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef SDFG_CUBLAS_MAX_BUFFERS
+#define SDFG_CUBLAS_MAX_BUFFERS 64
+#endif
+
+typedef struct {
+    const char* name;
+    void* data;
+    size_t bytes;
+} sdfg_cublas_buffer_t;
+
+typedef struct {
+    int initialized;
+    cublasHandle_t handle;
+    size_t num_buffers;
+    sdfg_cublas_buffer_t buffers[SDFG_CUBLAS_MAX_BUFFERS];
+} sdfg_cublas_state_t;
+
+static inline sdfg_cublas_state_t* sdfg_cublas_state(void) {
+    static sdfg_cublas_state_t state;
+    return &state;
+}
+
+static inline void sdfg_cublas_release(void) {
+    sdfg_cublas_state_t* state = sdfg_cublas_state();
+    for (size_t i = 0; i < state->num_buffers; i++) cudaFree(state->buffers[i].data);
+    state->num_buffers = 0;
+    if (state->initialized) cublasDestroy(state->handle);
+    state->initialized = 0;
+}
+
+static inline cublasHandle_t sdfg_cublas_handle(void) {
+    sdfg_cublas_state_t* state = sdfg_cublas_state();
+    if (!state->initialized) {
+        cublasCreate(&state->handle);
+        state->initialized = 1;
+        atexit(sdfg_cublas_release);
+    }
+    return state->handle;
+}
+
+// Returns a device buffer of at least the given size; name must outlive the program
+static inline void* sdfg_cublas_buffer(const char* name, size_t bytes) {
+    sdfg_cublas_state_t* state = sdfg_cublas_state();
+    for (size_t i = 0; i < state->num_buffers; i++) {
+        sdfg_cublas_buffer_t* buffer = &state->buffers[i];
+        if (strcmp(buffer->name, name) != 0) continue;
+        if (buffer->bytes < bytes) {
+            cudaFree(buffer->data);
+            cudaMalloc(&buffer->data, bytes);
+            buffer->bytes = bytes;
+        }
+        return buffer->data;
+    }
+
+    if (state->num_buffers == SDFG_CUBLAS_MAX_BUFFERS) {
+        fprintf(stderr, "sdfg_cublas_buffer: more than %d buffers\n", SDFG_CUBLAS_MAX_BUFFERS);
+        abort();
+    }
+    sdfg_cublas_buffer_t* buffer = &state->buffers[state->num_buffers++];
+    buffer->name = name;
+    buffer->bytes = bytes;
+    cudaMalloc(&buffer->data, bytes);
+    return buffer->data;
+}
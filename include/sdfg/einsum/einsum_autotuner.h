@@ -0,0 +1,76 @@
+#pragma once
+
+#include <sdfg/structured_sdfg.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sdfg/blas/blas_node.h"
+#include "sdfg/einsum/einsum_node.h"
+#include "sdfg/einsum/einsum_tuning.h"
+
+namespace sdfg {
+namespace einsum {
+
+/**
+ * @brief Options for the measurements of the EinsumAutotuner
+ */
+struct EinsumAutotunerOptions {
+    // Representative values of the symbols in the map bounds
+    std::unordered_map<std::string, long long> sizes;
+
+    // Command that compiles a benchmark, "{src}" and "{bin}" are replaced by the paths
+    std::string compile_command = "cc -O3 -march=native -fopenmp {src} -o {bin} -lcblas -lm";
+
+    // Backend of the BLAS variants
+    blas::BLASImplementation blas_implementation = blas::BLASImplementation_CBLAS;
+
+    // Number of timed runs after a warm-up run, the fastest one counts
+    size_t repetitions = 5;
+
+    // Directory for the benchmark sources and binaries, the temporary directory if empty
+    std::string work_dir;
+};
+
+/**
+ * @brief Offline autotuner for the lowering of an Einsum node
+ *
+ * Every variant (each applicable Einsum2BLAS routine and the loop nest with different dispatcher
+ * options) is generated into a standalone micro-benchmark that runs the einsum on buffers of the
+ * representative sizes. The benchmarks are compiled and run with the system compiler and the
+ * fastest variant is recorded in a tuning database.
+ *
+ * The operands must be accessed as a whole (empty memlet subsets) with plain map variables as
+ * indices. Generating a benchmark registers the dispatchers of the variant until its code is
+ * generated and restores the previous dispatchers afterwards.
+ */
+class EinsumAutotuner {
+    StructuredSDFG& sdfg_;
+    EinsumNode& einsum_node_;
+    const EinsumAutotunerOptions options_;
+
+    std::unique_ptr<StructuredSDFG> benchmark_sdfg(EinsumNode*& einsum_node,
+                                                   std::vector<std::string>& arguments);
+    bool extents(const data_flow::Subset& indices, std::vector<long long>& result);
+
+   public:
+    EinsumAutotuner(StructuredSDFG& sdfg, EinsumNode& einsum_node,
+                    const EinsumAutotunerOptions& options);
+
+    std::vector<EinsumVariant> variants();
+
+    // C source of the benchmark, or an empty string if the variant cannot be generated
+    std::string benchmark_source(const EinsumVariant& variant);
+
+    // Fastest run time in seconds, or a negative value if the benchmark failed
+    double measure(const EinsumVariant& variant);
+
+    // Measures all variants, records them, and returns the best entry of the database
+    const EinsumVariant* tune(EinsumTuningDatabase& database);
+};
+
+}  // namespace einsum
+}  // namespace sdfg
@@ -2,9 +2,14 @@
 
 #include <sdfg/codegen/dispatchers/block_dispatcher.h>
 #include <sdfg/codegen/dispatchers/node_dispatcher_registry.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/types/type.h>
 
 #include <cstddef>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "sdfg/einsum/einsum_node.h"
@@ -12,28 +17,107 @@
 namespace sdfg {
 namespace einsum {
 
+class EinsumTuningDatabase;
+
+/**
+ * @brief Options for the code generation of Einsum nodes
+ */
+struct EinsumDispatcherOptions {
+    // Split the maps into tile and point loops
+    bool tiling = false;
+
+    // Number of bytes (e.g., size of L1 or L2 cache) the tiles of all operands have to fit in
+    size_t tiling_cache_size = 32768;
+
+    // Reorder the outer and inner maps such that the innermost loops walk unit stride
+    bool loop_interchange = false;
+
+    // Vectorize the innermost loop of accumulating einsums with a SIMD reduction on the output
+    bool vectorize = false;
+
+    // Fully unroll loop nests with constant bounds and at most this many iterations, 0 disables it
+    size_t unroll_iterations = 0;
+
+    // Tuned options per einsum override the ones above if the database has a loop nest entry
+    const EinsumTuningDatabase* database = nullptr;
+};
+
 class EinsumDispatcher : public codegen::LibraryNodeDispatcher {
+    // Values of the indvars in one iteration of the loop nest
+    using Iteration = std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>;
+
+    const EinsumDispatcherOptions options_;
+
+    static EinsumDispatcherOptions tuned_options(const Function& function,
+                                                 const data_flow::DataFlowGraph& data_flow_graph,
+                                                 const data_flow::LibraryNode& node,
+                                                 const EinsumDispatcherOptions& options);
+
     std::vector<size_t> get_outer_maps(const EinsumNode& einsum_node);
+    std::vector<size_t> get_outer_maps(const EinsumNode& einsum_node,
+                                       const data_flow::Subset& out_indices);
     std::vector<size_t> get_inner_maps(const EinsumNode& einsum_node);
+    size_t get_stride_cost(const EinsumNode& einsum_node, size_t map);
+    void interchange_maps(const EinsumNode& einsum_node, std::vector<size_t>& maps);
+    std::unordered_map<size_t, size_t> get_tile_sizes(const EinsumNode& einsum_node,
+                                                      const std::vector<size_t>& outer_maps,
+                                                      const std::vector<size_t>& inner_maps,
+                                                      types::PrimitiveType primitive_type);
+    static std::string reduction_identity(ReductionType reduction,
+                                          types::PrimitiveType primitive_type);
+    static std::string reduction_operator(ReductionType reduction);
+
+    static data_flow::Subset substitute(const data_flow::Subset& subset,
+                                        const Iteration& iteration);
+
+    /**
+     * @brief Extends every iteration by all values of the indvars of the maps
+     *
+     * Returns false if a bound is not an integer constant for one of the iterations or if there
+     * are more than max_iterations iterations.
+     */
+    bool expand_iterations(const EinsumNode& einsum_node, const std::vector<size_t>& maps,
+                           size_t max_iterations, std::vector<Iteration>& iterations);
+
+    // Sum of the terms of an output and the update of the output with it in an iteration
+    std::string term_value(const EinsumNode& einsum_node, size_t output,
+                           const std::unordered_map<std::string, const types::IType&>& src_types,
+                           const Iteration& iteration);
+    std::string reduction_update(
+        const EinsumNode& einsum_node, size_t output, const std::string& out,
+        const std::unordered_map<std::string, const types::IType&>& src_types,
+        const Iteration& iteration);
+
+    /**
+     * @brief Generates the loop nest of an einsum node whose outputs have different out indices
+     *
+     * All maps form a single loop nest in which every output is updated in memory, e.g., A is
+     * read once for y[i] = y[i] + A[i,j] * x[j] and z[j] = z[j] + A[i,j] * w[i]. The outermost
+     * loop is only parallel if it indexes every output, and tiling and vectorization do not apply.
+     */
+    void dispatch_sequential(codegen::PrettyPrinter& stream, const EinsumNode& einsum_node);
 
    public:
     EinsumDispatcher(codegen::LanguageExtension& language_extension, const Function& function,
                      const data_flow::DataFlowGraph& data_flow_graph,
-                     const data_flow::LibraryNode& node);
+                     const data_flow::LibraryNode& node,
+                     const EinsumDispatcherOptions& options = EinsumDispatcherOptions());
 
     virtual void dispatch(codegen::PrettyPrinter& stream) override;
 };
 
 // This function must be called by the application using the plugin
-inline void register_einsum_dispatcher() {
+inline void register_einsum_dispatcher(
+    const EinsumDispatcherOptions& options = EinsumDispatcherOptions()) {
     codegen::LibraryNodeDispatcherRegistry::instance().register_library_node_dispatcher(
         LibraryNodeType_Einsum.value(),
-        [](codegen::LanguageExtension& language_extension, const Function& function,
-           const data_flow::DataFlowGraph& data_flow_graph, const data_flow::LibraryNode& node) {
+        [options](codegen::LanguageExtension& language_extension, const Function& function,
+                  const data_flow::DataFlowGraph& data_flow_graph,
+                  const data_flow::LibraryNode& node) {
             return std::make_unique<EinsumDispatcher>(language_extension, function, data_flow_graph,
-                                                      node);
+                                                      node, options);
         });
 }
 
 }  // namespace einsum
-}  // namespace sdfg
\ No newline at end of file
+}  // namespace sdfg
@@ -13,26 +13,84 @@ namespace einsum {
 
 inline data_flow::LibraryNodeCode LibraryNodeType_Einsum("Einsum");
 
+enum ReductionType { ReductionType_Sum, ReductionType_Max, ReductionType_Min, ReductionType_Prod };
+
+constexpr const char* reductionType2String(const ReductionType type) {
+    switch (type) {
+        case ReductionType_Sum:
+            return "sum";
+        case ReductionType_Max:
+            return "max";
+        case ReductionType_Min:
+            return "min";
+        case ReductionType_Prod:
+            return "prod";
+    }
+}
+
 /**
  * @brief Einsum node
  *
  * This node enables the use of Einstein summation notation as library nodes in
  * the SDFG.
+ *
+ * The computation is a sum of product terms, optionally plus the output. Each term lists the
+ * positions of the inputs it multiplies, e.g., {{0, 1}, {2, 3}} for
+ * C[i,j] = C[i,j] + A[i,k] * B[k,j] + D[i,k] * E[k,j]. Without explicit terms all inputs except
+ * the output form a single product.
+ *
+ * The reduction combines the output with the value of the terms, e.g., a max reduction computes
+ * m[i] = max(m[i], A[i,j]). It is a sum unless stated otherwise.
+ *
+ * An optional epilogue is applied element-wise when the output is written back, e.g.,
+ * max(_out, 0) for C[i,j] = max(C[i,j] + A[i,k] * B[k,j], 0). It is an expression in the output
+ * connector and evaluated once per output element after the reduction has finished.
+ *
+ * Several outputs may share the maps, e.g., y[i] = y[i] + A[i,j] * x[j] and
+ * z[j] = z[j] + A[i,j] * w[i] in one sweep over A. Every output has its own out indices and every
+ * term belongs to one output, which is given by the term outputs. Either all or none of the
+ * outputs are read.
  */
 class EinsumNode : public data_flow::LibraryNode {
    private:
     std::vector<std::pair<symbolic::Symbol, symbolic::Expression>> maps_;
 
-    data_flow::Subset out_indices_;
+    std::vector<data_flow::Subset> out_indices_;
     std::vector<data_flow::Subset> in_indices_;
 
+    std::vector<std::vector<size_t>> terms_;
+
+    ReductionType reduction_;
+
+    symbolic::Expression epilogue_;
+
+    std::vector<size_t> term_outputs_;
+
    public:
     EinsumNode(size_t element_id, const DebugInfo& debug_info, const graph::Vertex vertex,
                data_flow::DataFlowGraph& parent, const std::vector<std::string>& outputs,
                const std::vector<std::string>& inputs,
                const std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>& maps,
                const data_flow::Subset& out_indices,
-               const std::vector<data_flow::Subset>& in_indices);
+               const std::vector<data_flow::Subset>& in_indices,
+               const std::vector<std::vector<size_t>>& terms = {},
+               ReductionType reduction = ReductionType_Sum,
+               const symbolic::Expression& epilogue = symbolic::Expression(),
+               const std::vector<size_t>& term_outputs = {});
+
+    /**
+     * @brief Einsum node with one list of out indices per output
+     */
+    EinsumNode(size_t element_id, const DebugInfo& debug_info, const graph::Vertex vertex,
+               data_flow::DataFlowGraph& parent, const std::vector<std::string>& outputs,
+               const std::vector<std::string>& inputs,
+               const std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>& maps,
+               const std::vector<data_flow::Subset>& out_indices,
+               const std::vector<data_flow::Subset>& in_indices,
+               const std::vector<std::vector<size_t>>& terms,
+               ReductionType reduction = ReductionType_Sum,
+               const symbolic::Expression& epilogue = symbolic::Expression(),
+               const std::vector<size_t>& term_outputs = {});
 
     EinsumNode(const EinsumNode&) = delete;
     EinsumNode& operator=(const EinsumNode&) = delete;
@@ -49,14 +107,42 @@ class EinsumNode : public data_flow::LibraryNode {
 
     const data_flow::Subset& out_indices() const;
 
+    const data_flow::Subset& out_indices(size_t output) const;
+
     const symbolic::Expression& out_index(size_t index) const;
 
+    /**
+     * @brief True if all outputs have the same out indices
+     */
+    bool shared_out_indices() const;
+
     const std::vector<data_flow::Subset>& in_indices() const;
 
     const data_flow::Subset& in_indices(size_t index) const;
 
     const symbolic::Expression& in_index(size_t index1, size_t index2) const;
 
+    const std::vector<std::vector<size_t>>& terms() const;
+
+    const std::vector<size_t>& term(size_t index) const;
+
+    /**
+     * @brief Positions of the outputs which the terms are added to; all zero for a single output
+     */
+    const std::vector<size_t>& term_outputs() const;
+
+    size_t term_output(size_t index) const;
+
+    ReductionType reduction() const;
+
+    /**
+     * @brief Element-wise expression in the output connector which is written back instead of
+     * the reduced value; null if the value is written back unchanged
+     */
+    const symbolic::Expression& epilogue() const;
+
+    bool has_epilogue() const;
+
     virtual std::unique_ptr<data_flow::DataFlowNode> clone(
         size_t element_id, const graph::Vertex vertex,
         data_flow::DataFlowGraph& parent) const override;
@@ -70,7 +156,7 @@ class EinsumNode : public data_flow::LibraryNode {
 
     virtual std::string toStr() const override;
 
-    long long getOutInputIndex() const;
+    long long getOutInputIndex(size_t output = 0) const;
 };
 
 }  // namespace einsum
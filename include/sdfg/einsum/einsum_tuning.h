@@ -0,0 +1,63 @@
+#pragma once
+
+#include <sdfg/data_flow/data_flow_graph.h>
+#include <sdfg/function.h>
+
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "sdfg/einsum/einsum_dispatcher.h"
+#include "sdfg/einsum/einsum_node.h"
+
+namespace sdfg {
+namespace einsum {
+
+/**
+ * @brief A way to lower an Einsum node
+ */
+struct EinsumVariant {
+    // Name of the Einsum2BLAS* transformation, or empty for the loop nest of the EinsumDispatcher
+    std::string lowering;
+
+    // Options of the loop nest. The database pointer is ignored.
+    EinsumDispatcherOptions options;
+
+    std::string toStr() const;
+};
+
+void to_json(nlohmann::json& j, const EinsumVariant& variant);
+void from_json(const nlohmann::json& j, EinsumVariant& variant);
+
+/**
+ * @brief Fastest measured variants of Einsum nodes
+ *
+ * Entries are keyed by the element type of the output and the einsum in connector notation, so
+ * einsums that only differ in their containers share an entry. The database is written by the
+ * EinsumAutotuner and consulted by Einsum2BLAS and the EinsumDispatcher.
+ */
+class EinsumTuningDatabase {
+    std::unordered_map<std::string, std::pair<EinsumVariant, double>> entries_;
+
+   public:
+    static std::string key(const Function& function,
+                           const data_flow::DataFlowGraph& data_flow_graph,
+                           const EinsumNode& einsum_node);
+
+    const EinsumVariant* lookup(const std::string& key) const;
+
+    // Measured time of the entry in seconds, or a negative value if there is none
+    double time(const std::string& key) const;
+
+    // Keeps the variant if it is faster than the current entry and returns whether it was kept
+    bool record(const std::string& key, const EinsumVariant& variant, double time);
+
+    size_t size() const;
+
+    void load(const std::string& path);
+    void save(const std::string& path) const;
+};
+
+}  // namespace einsum
+}  // namespace sdfg
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/structured_control_flow/sequence.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/transformations/transformation.h>
+
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+#include <vector>
+
+#include "sdfg/blas/blas_node.h"
+
+namespace sdfg {
+namespace transformations {
+
+/**
+ * @brief Keeps containers on the device between consecutive BLAS nodes of a sequence
+ *
+ * A run is a maximal range of children of the sequence that are blocks containing a single axpy,
+ * copy, gemv, gemm, or syrk node and whose transitions have no assignments. Inside a run, an
+ * operand is not uploaded if the previous node left the same container on the device, and an
+ * output is not downloaded if a later node of the run writes the container again. Only operands
+ * that are passed as a whole, packed, and bound to a single connector are considered.
+ *
+ * The flags are only honored by the CUBLAS dispatchers and are not copied with the nodes, so the
+ * transformation should run right before code generation.
+ */
+class BLASResidency : public Transformation {
+    struct Operand {
+        std::string conn;
+        symbolic::Expression size;
+        bool packed;
+        bool read;
+        bool written;
+    };
+
+    structured_control_flow::Sequence& sequence_;
+
+    blas::BLASNode* blas_node(structured_control_flow::ControlFlowNode& node);
+    std::vector<Operand> operands(blas::BLASNode& blas_node);
+    bool eligible(blas::BLASNode& blas_node, const Operand& operand, std::string& container);
+    std::vector<std::vector<blas::BLASNode*>> runs();
+
+   public:
+    BLASResidency(structured_control_flow::Sequence& sequence);
+
+    virtual std::string name() const override;
+
+    virtual bool can_be_applied(builder::StructuredSDFGBuilder& builder,
+                                analysis::AnalysisManager& analysis_manager) override;
+
+    virtual void apply(builder::StructuredSDFGBuilder& builder,
+                       analysis::AnalysisManager& analysis_manager) override;
+
+    virtual void to_json(nlohmann::json& j) const override;
+
+    static BLASResidency from_json(builder::StructuredSDFGBuilder& builder,
+                                   const nlohmann::json& j);
+};
+
+}  // namespace transformations
+}  // namespace sdfg
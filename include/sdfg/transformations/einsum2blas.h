@@ -4,26 +4,47 @@
 #include <sdfg/builder/structured_sdfg_builder.h>
 #include <sdfg/transformations/transformation.h>
 
+#include <cstddef>
 #include <nlohmann/json_fwd.hpp>
 #include <string>
+#include <vector>
 
 #include "sdfg/einsum/einsum_node.h"
+#include "sdfg/einsum/einsum_tuning.h"
 #include "sdfg/transformations/einsum2blas_axpy.h"
 #include "sdfg/transformations/einsum2blas_copy.h"
 #include "sdfg/transformations/einsum2blas_dot.h"
 #include "sdfg/transformations/einsum2blas_gemm.h"
+#include "sdfg/transformations/einsum2blas_gemm_batched.h"
 #include "sdfg/transformations/einsum2blas_gemv.h"
 #include "sdfg/transformations/einsum2blas_ger.h"
 #include "sdfg/transformations/einsum2blas_symm.h"
 #include "sdfg/transformations/einsum2blas_symv.h"
 #include "sdfg/transformations/einsum2blas_syr.h"
 #include "sdfg/transformations/einsum2blas_syrk.h"
+#include "sdfg/transformations/einsum2blas_ttgt.h"
 
 namespace sdfg {
 namespace transformations {
 
+/**
+ * @brief Replaces an einsum node with the first matching BLAS node
+ *
+ * With a nonzero threshold, the block of the einsum node is guarded by a runtime check instead:
+ * if every map has fewer iterations than the threshold (i.e., m, n, and k of a gemm), the einsum
+ * is kept and dispatched as a loop nest, otherwise the BLAS node is called. This avoids the call
+ * and packing overhead of BLAS libraries for tiny symbolic sizes. The einsum node must be the only
+ * one in its block.
+ *
+ * The routine can be fixed by its transformation name (e.g., "Einsum2BLASSymm") or looked up in a
+ * tuning database written by the EinsumAutotuner. If the database prefers the loop nest, the
+ * transformation is not applicable.
+ */
 class Einsum2BLAS : public Transformation {
     einsum::EinsumNode& einsum_node_;
+    size_t threshold_;
+    std::string routine_;
+    const einsum::EinsumTuningDatabase* database_;
     Einsum2BLASAxpy axpy_;
     Einsum2BLASCopy copy_;
     Einsum2BLASDot dot_;
@@ -32,20 +53,38 @@ class Einsum2BLAS : public Transformation {
     Einsum2BLASGer ger_;
     Einsum2BLASSyr syr_;
     Einsum2BLASGemm gemm_;
+    Einsum2BLASGemmBatched gemm_batched_;
     Einsum2BLASSymm symm_;
     Einsum2BLASSyrk syrk_;
+    Einsum2BLASTTGT ttgt_;
+
+    std::vector<Transformation*> routines();
+    std::string routine(builder::StructuredSDFGBuilder& builder);
+    void apply_hybrid(builder::StructuredSDFGBuilder& builder,
+                      analysis::AnalysisManager& analysis_manager);
 
    public:
-    Einsum2BLAS(einsum::EinsumNode& einsum_node);
+    Einsum2BLAS(einsum::EinsumNode& einsum_node, size_t threshold = 0,
+                const std::string& routine = "");
+    Einsum2BLAS(einsum::EinsumNode& einsum_node, const einsum::EinsumTuningDatabase& database,
+                size_t threshold = 0);
 
     virtual std::string name() const override;
 
+    // Names of all routines that match the einsum node, in the order they are tried
+    std::vector<std::string> candidates(builder::StructuredSDFGBuilder& builder,
+                                        analysis::AnalysisManager& analysis_manager);
+
     virtual bool can_be_applied(builder::StructuredSDFGBuilder& builder,
                                 analysis::AnalysisManager& analysis_manager) override;
 
     virtual void apply(builder::StructuredSDFGBuilder& builder,
                        analysis::AnalysisManager& analysis_manager) override;
 
+    size_t threshold() const;
+
+    const std::string& routine() const;
+
     virtual void to_json(nlohmann::json& j) const override;
 
     static Einsum2BLAS from_json(builder::StructuredSDFGBuilder& builder, const nlohmann::json& j);
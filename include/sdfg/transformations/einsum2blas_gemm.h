@@ -18,10 +18,10 @@ class Einsum2BLASGemm : public Transformation {
     einsum::EinsumNode& einsum_node_;
 
     bool check_indvars(size_t indvar1, size_t indvar2);
-    bool check_matrix_indices(const symbolic::Expression& mat_index1,
-                              const symbolic::Expression& mat_index2,
-                              const symbolic::Symbol& loop_index1,
-                              const symbolic::Symbol& loop_index2);
+    bool uses_indvar(size_t input, const symbolic::Symbol& indvar);
+    void get_input_positions(const symbolic::Symbol& indvar_outer_1,
+                             const symbolic::Symbol& indvar_outer_2, long long& alpha, long long& A,
+                             long long& B);
 
    public:
     Einsum2BLASGemm(einsum::EinsumNode& einsum_node);
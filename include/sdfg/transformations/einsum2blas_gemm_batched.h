@@ -0,0 +1,54 @@
+#pragma once
+
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/data_flow/memlet.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/transformations/transformation.h>
+
+#include <cstddef>
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+#include <vector>
+
+#include "sdfg/einsum/einsum_node.h"
+
+namespace sdfg {
+namespace transformations {
+
+/**
+ * @brief Lowers an einsum with leading batch indices to a batched gemm
+ *
+ * Matches C[b...][i][j] = alpha * A[b...][i][k] * B[b...][k][j] (+ C[b...][i][j]), where A and B
+ * may be transposed. The batch indices must be the leading indices of all matrix operands.
+ */
+class Einsum2BLASGemmBatched : public Transformation {
+    einsum::EinsumNode& einsum_node_;
+
+    bool get_indvars(std::vector<size_t>& batch, size_t& outer_1, size_t& outer_2, size_t& inner);
+    bool batch_prefix(size_t input, const std::vector<size_t>& batch);
+    data_flow::Subset matrix_indices(size_t input, size_t num_batch);
+    void get_input_positions(const std::vector<size_t>& batch,
+                             const symbolic::Symbol& indvar_outer_1,
+                             const symbolic::Symbol& indvar_outer_2, long long& alpha, long long& A,
+                             long long& B);
+
+   public:
+    Einsum2BLASGemmBatched(einsum::EinsumNode& einsum_node);
+
+    virtual std::string name() const override;
+
+    virtual bool can_be_applied(builder::StructuredSDFGBuilder& builder,
+                                analysis::AnalysisManager& analysis_manager) override;
+
+    virtual void apply(builder::StructuredSDFGBuilder& builder,
+                       analysis::AnalysisManager& analysis_manager) override;
+
+    virtual void to_json(nlohmann::json& j) const override;
+
+    static Einsum2BLASGemmBatched from_json(builder::StructuredSDFGBuilder& builder,
+                                            const nlohmann::json& j);
+};
+
+}  // namespace transformations
+}  // namespace sdfg
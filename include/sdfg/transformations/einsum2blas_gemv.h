@@ -5,6 +5,7 @@
 #include <sdfg/symbolic/symbolic.h>
 #include <sdfg/transformations/transformation.h>
 
+#include <cstddef>
 #include <nlohmann/json_fwd.hpp>
 #include <string>
 
@@ -16,10 +17,9 @@ namespace transformations {
 class Einsum2BLASGemv : public Transformation {
     einsum::EinsumNode& einsum_node_;
 
-    bool check_matrix_indices(const symbolic::Expression& mat_index1,
-                              const symbolic::Expression& mat_index2,
-                              const symbolic::Symbol& loop_index1,
-                              const symbolic::Symbol& loop_index2);
+    bool get_indvars(size_t& outer, size_t& inner);
+    void get_input_positions(const symbolic::Symbol& indvar_outer, long long& alpha, long long& A,
+                             long long& x);
 
    public:
     Einsum2BLASGemv(einsum::EinsumNode& einsum_node);
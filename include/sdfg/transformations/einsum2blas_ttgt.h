@@ -0,0 +1,55 @@
+#pragma once
+
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/data_flow/memlet.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/transformations/transformation.h>
+
+#include <cstddef>
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+#include <vector>
+
+#include "sdfg/blas/blas_node.h"
+#include "sdfg/einsum/einsum_node.h"
+
+namespace sdfg {
+namespace transformations {
+
+/**
+ * @brief Lowers a tensor contraction to a single gemm by flattening index groups
+ *
+ * Matches contractions such as C[a][b][c] += A[a][k][l] * B[k][l][b][c], where the free indices
+ * of A, the free indices of B, and the contracted indices each form a contiguous group. The groups
+ * are flattened into M, N, and K of a row-major gemm. A group may precede or follow the contracted
+ * indices in an operand, which is expressed as a transposition of that operand.
+ */
+class Einsum2BLASTTGT : public Transformation {
+    einsum::EinsumNode& einsum_node_;
+
+    bool as_maps(const data_flow::Subset& indices, std::vector<size_t>& maps);
+    bool get_groups(long long& alpha, long long& A, long long& B, std::vector<size_t>& free_A,
+                    std::vector<size_t>& free_B, std::vector<size_t>& contracted,
+                    blas::BLASTranspose& transA, blas::BLASTranspose& transB);
+    symbolic::Expression flattened_size(const std::vector<size_t>& group);
+
+   public:
+    Einsum2BLASTTGT(einsum::EinsumNode& einsum_node);
+
+    virtual std::string name() const override;
+
+    virtual bool can_be_applied(builder::StructuredSDFGBuilder& builder,
+                                analysis::AnalysisManager& analysis_manager) override;
+
+    virtual void apply(builder::StructuredSDFGBuilder& builder,
+                       analysis::AnalysisManager& analysis_manager) override;
+
+    virtual void to_json(nlohmann::json& j) const override;
+
+    static Einsum2BLASTTGT from_json(builder::StructuredSDFGBuilder& builder,
+                                     const nlohmann::json& j);
+};
+
+}  // namespace transformations
+}  // namespace sdfg
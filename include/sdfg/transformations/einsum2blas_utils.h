@@ -0,0 +1,38 @@
+#pragma once
+
+#include <sdfg/data_flow/memlet.h>
+#include <sdfg/symbolic/symbolic.h>
+
+namespace sdfg {
+namespace transformations {
+
+/**
+ * @brief Decomposes an index into stride * indvar + offset
+ *
+ * Returns false if the index is not affine in indvar or if the stride depends on indvar.
+ */
+bool affine_index(const symbolic::Expression& index, const symbolic::Symbol& indvar,
+                  symbolic::Expression& stride, symbolic::Expression& offset);
+
+/**
+ * @brief Checks if two subsets consist of the same indices
+ */
+bool same_indices(const data_flow::Subset& indices1, const data_flow::Subset& indices2);
+
+/**
+ * @brief Checks if the indices access a vector as x[inc * indvar] and determines the increment
+ */
+bool vector_access(const data_flow::Subset& indices, const symbolic::Symbol& indvar,
+                   symbolic::Expression& inc);
+
+/**
+ * @brief Checks if the indices access a row-major matrix as A[row][col] or A[row * ld + col]
+ *
+ * For A[row][col], ld is left null, i.e., the matrix is treated as packed. For the flattened form,
+ * ld is set to the distance between two rows.
+ */
+bool matrix_access(const data_flow::Subset& indices, const symbolic::Symbol& row,
+                   const symbolic::Symbol& col, symbolic::Expression& ld);
+
+}  // namespace transformations
+}  // namespace sdfg
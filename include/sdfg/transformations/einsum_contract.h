@@ -0,0 +1,74 @@
+#pragma once
+
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/transformations/transformation.h>
+
+#include <cstddef>
+#include <nlohmann/json_fwd.hpp>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sdfg/einsum/einsum_node.h"
+
+namespace sdfg {
+namespace transformations {
+
+/**
+ * @brief Splits an einsum node with three or more tensor inputs into a sequence of pairwise einsum
+ * nodes with temporaries
+ *
+ * The contraction order is chosen by a cost model counting the iterations of each pairwise
+ * einsum and the size of the temporaries. The cheapest order is found by an exhaustive search for
+ * up to six tensor inputs and by a greedy heuristic otherwise. The temporaries are allocated on
+ * the stack, so the transformation is only applied if their sizes are small constants.
+ */
+class EinsumContract : public Transformation {
+    einsum::EinsumNode& einsum_node_;
+    bool greedy_;
+
+    std::vector<size_t> tensor_inputs() const;
+    std::set<size_t> used_maps(const data_flow::Subset& subset) const;
+    double size(const std::set<size_t>& maps) const;
+    std::set<size_t> contract(const std::vector<std::set<size_t>>& operands, size_t operand1,
+                              size_t operand2) const;
+    double cost(const std::vector<std::set<size_t>>& operands, size_t operand1,
+                size_t operand2) const;
+    void search(std::vector<std::set<size_t>>& operands, double current_cost,
+                std::vector<std::pair<size_t, size_t>>& current_path, double& best_cost,
+                std::vector<std::pair<size_t, size_t>>& best_path) const;
+
+   public:
+    EinsumContract(einsum::EinsumNode& einsum_node, bool greedy = false);
+
+    virtual std::string name() const override;
+
+    virtual bool can_be_applied(builder::StructuredSDFGBuilder& builder,
+                                analysis::AnalysisManager& analysis_manager) override;
+
+    virtual void apply(builder::StructuredSDFGBuilder& builder,
+                       analysis::AnalysisManager& analysis_manager) override;
+
+    virtual void to_json(nlohmann::json& j) const override;
+
+    static EinsumContract from_json(builder::StructuredSDFGBuilder& builder,
+                                    const nlohmann::json& j);
+
+    /**
+     * @brief Contraction path over the tensor inputs
+     *
+     * Each step contracts the two operands at the given positions of the current operand list.
+     * Both are removed from the list and the result is appended to its end.
+     */
+    std::vector<std::pair<size_t, size_t>> path() const;
+
+    /**
+     * @brief Estimated cost of the contraction path
+     */
+    double path_cost() const;
+};
+
+}  // namespace transformations
+}  // namespace sdfg
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <sdfg/analysis/analysis.h>
+#include <sdfg/analysis/users.h>
 #include <sdfg/builder/structured_sdfg_builder.h>
 #include <sdfg/data_flow/memlet.h>
 #include <sdfg/structured_control_flow/control_flow_node.h>
@@ -9,8 +10,12 @@
 #include <sdfg/transformations/transformation.h>
 
 #include <nlohmann/json_fwd.hpp>
+#include <cstddef>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "sdfg/einsum/einsum_node.h"
 
@@ -18,11 +23,15 @@ namespace sdfg {
 namespace transformations {
 
 class EinsumExpand : public Transformation {
+    // Element ids of the reads and writes of each container
+    using Uses = std::unordered_map<std::string, std::vector<std::pair<size_t, analysis::Use>>>;
+
     structured_control_flow::StructuredLoop& loop_;
     einsum::EinsumNode& einsum_node_;
 
     void visitElements(std::set<size_t>& elements,
                        const structured_control_flow::ControlFlowNode& node);
+    void visitUses(Uses& uses, const structured_control_flow::ControlFlowNode& node);
     bool subsetContainsSymbol(const data_flow::Subset& subset, const symbolic::Symbol& symbol);
 
    public:
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/structured_control_flow/block.h>
+#include <sdfg/structured_control_flow/sequence.h>
+#include <sdfg/transformations/transformation.h>
+
+#include <cstddef>
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+
+#include "sdfg/einsum/einsum_node.h"
+
+namespace sdfg {
+namespace transformations {
+
+/**
+ * @brief Fuses two einsum nodes in consecutive blocks into one einsum node with several outputs
+ *
+ * Both einsum nodes must have the same maps and out indices up to a renaming of the indvars, the
+ * same reduction and no epilogue. The second einsum node must neither read nor write the outputs
+ * of the first one and must not write its inputs. The fused einsum node computes all outputs in a
+ * single loop nest, e.g., y[i] = y[i] + A[i,j] * x[j] and z[i] = z[i] + B[i,j] * x[j] stream x
+ * only once and open one parallel region instead of two.
+ *
+ * Optionally, the out indices may differ, e.g., y[i] = y[i] + A[i,j] * x[j] and
+ * z[j] = z[j] + A[i,j] * w[i] read A only once. The loop nest of such an einsum node is
+ * generally not parallel, so this is only worthwhile if the shared operands dominate.
+ */
+class EinsumFuse : public Transformation {
+    einsum::EinsumNode& first_;
+    einsum::EinsumNode& second_;
+    bool allow_different_out_indices_;
+
+    structured_control_flow::Block* block(einsum::EinsumNode& einsum_node) const;
+    size_t position(structured_control_flow::Sequence& parent,
+                    structured_control_flow::Block& block) const;
+
+   public:
+    EinsumFuse(einsum::EinsumNode& first, einsum::EinsumNode& second,
+               bool allow_different_out_indices = false);
+
+    virtual std::string name() const override;
+
+    virtual bool can_be_applied(builder::StructuredSDFGBuilder& builder,
+                                analysis::AnalysisManager& analysis_manager) override;
+
+    virtual void apply(builder::StructuredSDFGBuilder& builder,
+                       analysis::AnalysisManager& analysis_manager) override;
+
+    virtual void to_json(nlohmann::json& j) const override;
+
+    static EinsumFuse from_json(builder::StructuredSDFGBuilder& builder, const nlohmann::json& j);
+};
+
+}  // namespace transformations
+}  // namespace sdfg
@@ -2,9 +2,13 @@
 
 #include <sdfg/symbolic/symbolic.h>
 
+#include <cstddef>
 #include <functional>
 #include <nlohmann/json_fwd.hpp>
+#include <optional>
 #include <string>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "sdfg/analysis/analysis.h"
@@ -18,14 +22,57 @@ namespace sdfg {
 namespace transformations {
 
 class EinsumLift : public Transformation {
+    // Calculation captured from the tasklets of the comp block, shared by can_be_applied and apply
+    struct Capture {
+        // Element ids of the tasklets and memlets the capture was computed from and the subsets of
+        // the memlets
+        std::string signature;
+
+        // False if a tasklet is not supported
+        bool valid = false;
+
+        std::vector<std::string> outputs, inputs;
+        std::unordered_set<std::string> input_conns;
+        std::vector<data_flow::Subset> out_indicess, in_indices;
+
+        // Result of the fixed point iteration
+        bool all_used = false;
+        symbolic::Symbol comp_out;
+        symbolic::Expression comp;
+        std::string output;
+        data_flow::Subset out_indices;
+
+        // Simplified calculation, computed on first use
+        bool simplified = false;
+        symbolic::Expression scomp;
+    };
+
+    // Input container or constant with its indices, multiplied in a term of the einsum
+    using Factor = std::pair<std::string, data_flow::Subset>;
+
     std::vector<std::reference_wrapper<structured_control_flow::StructuredLoop>> loops_;
     structured_control_flow::Block& comp_block_;
+    std::optional<Capture> capture_;
 
+    std::string signature();
+    Capture& capture();
+    const symbolic::Expression& simplified(Capture& capture);
+    bool checkLoops();
+    bool normalizeLoop(const structured_control_flow::StructuredLoop& loop,
+                       symbolic::Expression& init, long long& stride,
+                       symbolic::Expression& num_iteration);
+    bool checkSpan(const symbolic::Expression& span);
+    bool containsRational(const symbolic::Expression& expr);
+    bool checkAffine(const symbolic::Expression& expr);
     symbolic::Expression taskletCode2Expr(const data_flow::TaskletCode code,
                                           const std::vector<symbolic::Expression>& args);
     std::string createAccessExpr(const std::string& container, const data_flow::Subset& subset);
     bool checkMulExpr(const symbolic::Expression expr);
     bool containsNegation(const symbolic::Expression& expr);
+    symbolic::Expression reductionOperand(const symbolic::Expression& expr,
+                                          const symbolic::Symbol& comp_out);
+    bool collectTerms(const Capture& capture, const symbolic::Expression& expr,
+                      std::vector<std::vector<Factor>>& terms);
 
    public:
     EinsumLift(std::vector<std::reference_wrapper<structured_control_flow::StructuredLoop>> loops,
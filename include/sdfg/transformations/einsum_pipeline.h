@@ -0,0 +1,117 @@
+#pragma once
+
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/structured_control_flow/block.h>
+#include <sdfg/structured_control_flow/control_flow_node.h>
+#include <sdfg/structured_control_flow/structured_loop.h>
+#include <sdfg/structured_sdfg.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sdfg/einsum/einsum_node.h"
+#include "sdfg/einsum/einsum_tuning.h"
+
+namespace sdfg {
+namespace transformations {
+
+/**
+ * @brief Options of the EinsumPipeline
+ */
+struct EinsumPipelineOptions {
+    // Move lifted einsum nodes out of enclosing loops with EinsumExpand
+    bool expand = true;
+
+    // Replace einsum nodes with BLAS nodes with Einsum2BLAS
+    bool blas = true;
+
+    // Runtime size threshold of Einsum2BLAS
+    size_t threshold = 0;
+
+    // Tuning database consulted by Einsum2BLAS, may be null
+    const einsum::EinsumTuningDatabase* database = nullptr;
+
+    // Fuse the remaining einsum nodes in consecutive blocks with EinsumFuse
+    bool fuse = true;
+};
+
+/**
+ * @brief Summary of an EinsumPipeline run
+ */
+struct EinsumPipelineReport {
+    size_t lifted = 0;
+    size_t expanded = 0;
+    size_t lowered = 0;
+    size_t fused = 0;
+
+    // Number of einsum nodes lowered per Einsum2BLAS routine
+    std::map<std::string, size_t> routines;
+
+    EinsumPipelineReport& operator+=(const EinsumPipelineReport& other);
+
+    std::string toStr() const;
+};
+
+/**
+ * @brief Lifts all loop nests of an SDFG to einsum nodes and lowers them
+ *
+ * One traversal of the structured control flow collects every block of tasklets together with the
+ * chain of perfectly nested loops around it. EinsumLift is tried on the longest chain first and on
+ * shorter chains otherwise. Lifted einsum nodes are moved out of their enclosing loops with
+ * EinsumExpand, and lifting and expanding are repeated until nothing changes. Then, every
+ * einsum node is handed to Einsum2BLAS. Finally, the einsum nodes which remain are fused with their
+ * successors by EinsumFuse, so that they share one loop nest.
+ *
+ * Functions are independent, so run() may process several of them on parallel threads. This
+ * requires a thread-safe build of SymEngine.
+ */
+class EinsumPipeline {
+    struct LiftCandidate {
+        // Perfectly nested loops around the block, outermost first
+        std::vector<structured_control_flow::StructuredLoop*> loops;
+        structured_control_flow::Block* block;
+    };
+
+    struct EinsumCandidate {
+        // Loop whose body contains the block of the einsum node, or null
+        structured_control_flow::StructuredLoop* loop;
+        einsum::EinsumNode* einsum_node;
+    };
+
+    const EinsumPipelineOptions options_;
+
+    void discover(structured_control_flow::ControlFlowNode& node,
+                  std::vector<structured_control_flow::StructuredLoop*>& loops,
+                  std::vector<LiftCandidate>* lift_candidates,
+                  std::vector<EinsumCandidate>* einsum_candidates);
+
+    bool lift(builder::StructuredSDFGBuilder& builder, analysis::AnalysisManager& analysis_manager,
+              EinsumPipelineReport& report);
+    bool expand(builder::StructuredSDFGBuilder& builder,
+                analysis::AnalysisManager& analysis_manager,
+                std::set<std::pair<size_t, size_t>>& failed, EinsumPipelineReport& report);
+    void lower(builder::StructuredSDFGBuilder& builder, analysis::AnalysisManager& analysis_manager,
+               EinsumPipelineReport& report);
+    bool fuse(builder::StructuredSDFGBuilder& builder, analysis::AnalysisManager& analysis_manager,
+              EinsumPipelineReport& report);
+
+   public:
+    EinsumPipeline(const EinsumPipelineOptions& options = EinsumPipelineOptions());
+
+    EinsumPipelineReport run(builder::StructuredSDFGBuilder& builder,
+                             analysis::AnalysisManager& analysis_manager);
+
+    // Runs the pipeline on every function with up to the given number of threads (0 = hardware
+    // concurrency) and returns the combined report
+    EinsumPipelineReport run(std::vector<std::unique_ptr<StructuredSDFG>>& sdfgs,
+                             size_t threads = 0);
+};
+
+}  // namespace transformations
+}  // namespace sdfg
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/transformations/transformation.h>
+
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+
+#include "sdfg/einsum/einsum_node.h"
+
+namespace sdfg {
+namespace transformations {
+
+/**
+ * @brief Splits an einsum node with a sum of product terms into one einsum node per term
+ *
+ * The first term keeps the original output semantics and every further term accumulates into the
+ * output in its own block, so each term can be lowered to BLAS on its own. The term einsums are
+ * placed before the original one, which is replaced by the last term.
+ */
+class EinsumSplit : public Transformation {
+    einsum::EinsumNode& einsum_node_;
+
+   public:
+    EinsumSplit(einsum::EinsumNode& einsum_node);
+
+    virtual std::string name() const override;
+
+    virtual bool can_be_applied(builder::StructuredSDFGBuilder& builder,
+                                analysis::AnalysisManager& analysis_manager) override;
+
+    virtual void apply(builder::StructuredSDFGBuilder& builder,
+                       analysis::AnalysisManager& analysis_manager) override;
+
+    virtual void to_json(nlohmann::json& j) const override;
+
+    static EinsumSplit from_json(builder::StructuredSDFGBuilder& builder, const nlohmann::json& j);
+};
+
+}  // namespace transformations
+}  // namespace sdfg
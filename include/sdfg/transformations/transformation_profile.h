@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <string>
+
+namespace sdfg {
+namespace transformations {
+
+/**
+ * @brief Accumulated measurements of one phase of a transformation
+ */
+struct TransformationProfilePhase {
+    size_t calls = 0;
+    double seconds = 0.0;
+};
+
+/**
+ * @brief Global time and call count instrumentation of the einsum transformations
+ *
+ * Phases are named "<Transformation>.<phase>", e.g., "EinsumLift.simplify". Recording is disabled
+ * by default and then costs a single check per phase.
+ */
+class TransformationProfile {
+   public:
+    static void enable(bool enabled = true);
+    static bool enabled();
+
+    static void record(const std::string& phase, double seconds);
+
+    // Counts a call without a duration, e.g., a cache hit
+    static void count(const std::string& phase);
+
+    static TransformationProfilePhase phase(const std::string& phase);
+    static std::map<std::string, TransformationProfilePhase> phases();
+
+    static void reset();
+
+    // One line per phase with the call count, the total and the average time
+    static std::string toStr();
+};
+
+/**
+ * @brief Records the lifetime of the scope as a call of a phase
+ */
+class TransformationProfileScope {
+    const char* phase_;
+    bool active_;
+    std::chrono::steady_clock::time_point start_;
+
+   public:
+    explicit TransformationProfileScope(const char* phase);
+    ~TransformationProfileScope();
+
+    TransformationProfileScope(const TransformationProfileScope&) = delete;
+    TransformationProfileScope& operator=(const TransformationProfileScope&) = delete;
+};
+
+}  // namespace transformations
+}  // namespace sdfg
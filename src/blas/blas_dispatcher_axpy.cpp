@@ -10,6 +10,7 @@
 
 #include <string>
 
+#include "sdfg/blas/blas_dispatcher_utils.h"
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_axpy.h"
 
@@ -19,8 +20,17 @@ namespace blas {
 void BLASDispatcherAxpy::dispatchCBLAS(codegen::PrettyPrinter& stream,
                                        const BLASNodeAxpy& blas_node) {
     stream << "cblas_" << blasType2String(blas_node.type()) << "axpy(" << blas_node.n()->__str__()
-           << ", " << blas_node.alpha() << ", " << blas_node.x() << ", 1, " << blas_node.y()
-           << ", 1);" << std::endl;
+           << ", " << blas_node.alpha() << ", " << blas_node.x() << ", "
+           << blas_node.incx()->__str__() << ", " << blas_node.y() << ", "
+           << blas_node.incy()->__str__() << ");" << std::endl;
+}
+
+void BLASDispatcherAxpy::dispatchNative(codegen::PrettyPrinter& stream,
+                                        const BLASNodeAxpy& blas_node) {
+    stream << "sdfg_blas_" << blasType2String(blas_node.type()) << "axpy("
+           << blas_node.n()->__str__() << ", " << blas_node.alpha() << ", " << blas_node.x() << ", "
+           << blas_node.incx()->__str__() << ", " << blas_node.y() << ", "
+           << blas_node.incy()->__str__() << ");" << std::endl;
 }
 
 void BLASDispatcherAxpy::dispatchCUBLAS(codegen::PrettyPrinter& stream,
@@ -42,42 +52,35 @@ void BLASDispatcherAxpy::dispatchCUBLAS(codegen::PrettyPrinter& stream,
     const std::string dx = "d" + x;
     const std::string y = blas_node.y();
     const std::string dy = "d" + y;
-
-    stream << "#ifndef CUDA_CHECK" << std::endl
-           << "#define CUDA_CHECK(X) X" << std::endl
-           << "#endif" << std::endl
-           << "#ifndef CUBLAS_CHECK" << std::endl
-           << "#define CUBLAS_CHECK(X) X" << std::endl
-           << "#endif" << std::endl
-           << std::endl
-           << "cublasHandle_t handle;" << std::endl
-           << "CUBLAS_CHECK(cublasCreate(&handle));" << std::endl
-           << std::endl
-           << type << " *" << dx << ", *" << dy << ";" << std::endl
-           << std::endl
-           << "CUDA_CHECK(cudaMalloc(&" << dx << ", " << n << " * sizeof(" << type << ")));"
-           << std::endl
-           << "CUDA_CHECK(cudaMalloc(&" << dy << ", " << n << " * sizeof(" << type << ")));"
-           << std::endl
-           << std::endl
-           << type << " alpha = " << alpha << ";" << std::endl
-           << "CUBLAS_CHECK(cublasSetVector(" << n << ", sizeof(" << type << "), " << x << ", 1, "
-           << dx << ", 1));" << std::endl
-           << "CUBLAS_CHECK(cublasSetVector(" << n << ", sizeof(" << type << "), " << y << ", 1, "
-           << dy << ", 1));" << std::endl
-           << std::endl
+    const std::string incx = blas_node.incx()->__str__();
+    const std::string incy = blas_node.incy()->__str__();
+    const std::string key_x = cublas_buffer_key(this->data_flow_graph_, this->node_, x);
+    const std::string key_y = cublas_buffer_key(this->data_flow_graph_, this->node_, y);
+
+    cublas_prologue(stream);
+    stream << type << " *" << dx << " = (" << type << " *)sdfg_cublas_buffer(\"" << key_x
+           << "\", " << n << " * sizeof(" << type << "));" << std::endl;
+    stream << type << " *" << dy << " = (" << type << " *)sdfg_cublas_buffer(\"" << key_y
+           << "\", " << n << " * sizeof(" << type << "));" << std::endl;
+    stream << std::endl << type << " alpha = " << alpha << ";" << std::endl;
+    if (!blas_node.resident_input(x)) {
+        stream << "CUBLAS_CHECK(cublasSetVector(" << n << ", sizeof(" << type << "), " << x
+               << ", " << incx << ", " << dx << ", 1));" << std::endl;
+    }
+    if (!blas_node.resident_input(y)) {
+        stream << "CUBLAS_CHECK(cublasSetVector(" << n << ", sizeof(" << type << "), " << y
+               << ", " << incy << ", " << dy << ", 1));" << std::endl;
+    }
+    stream << std::endl
            << "CUBLAS_CHECK(cublas" << type2 << "axpy(handle, " << n << ", &alpha, " << dx
-           << ", 1, " << dy << ", 1));" << std::endl
-           << std::endl
-           << "CUDA_CHECK(cudaDeviceSynchronize());" << std::endl
-           << std::endl
-           << "CUBLAS_CHECK(cublasGetVector(" << n << ", sizeof(" << type << "), " << dy << ", 1, "
-           << y << ", 1));" << std::endl
-           << std::endl
-           << "CUDA_CHECK(cudaFree(" << dx << "));" << std::endl
-           << "CUDA_CHECK(cudaFree(" << dy << "));" << std::endl
-           << std::endl
-           << "CUBLAS_CHECK(cublasDestroy(handle));" << std::endl;
+           << ", 1, " << dy << ", 1));" << std::endl;
+    if (!blas_node.resident_output(y)) {
+        stream << std::endl
+               << "CUDA_CHECK(cudaDeviceSynchronize());" << std::endl
+               << std::endl
+               << "CUBLAS_CHECK(cublasGetVector(" << n << ", sizeof(" << type << "), " << dy
+               << ", 1, " << y << ", " << incy << "));" << std::endl;
+    }
 }
 
 BLASDispatcherAxpy::BLASDispatcherAxpy(codegen::LanguageExtension& language_extension,
@@ -114,6 +117,9 @@ void BLASDispatcherAxpy::dispatch(codegen::PrettyPrinter& stream) {
         case BLASImplementation_CUBLAS:
             this->dispatchCUBLAS(stream, blas_node);
             break;
+        case BLASImplementation_Native:
+            this->dispatchNative(stream, blas_node);
+            break;
     }
 
     stream.setIndent(stream.indent() - 4);
@@ -9,6 +9,7 @@
 #include <sdfg/function.h>
 #include <sdfg/types/type.h>
 
+#include "sdfg/blas/blas_dispatcher_utils.h"
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_copy.h"
 
@@ -18,7 +19,16 @@ namespace blas {
 void BLASDispatcherCopy::dispatchCBLAS(codegen::PrettyPrinter& stream,
                                        const BLASNodeCopy& blas_node) {
     stream << "cblas_" << blasType2String(blas_node.type()) << "copy(" << blas_node.n()->__str__()
-           << ", " << blas_node.x() << ", 1, " << blas_node.y() << ", 1);" << std::endl;
+           << ", " << blas_node.x() << ", " << blas_node.incx()->__str__() << ", "
+           << blas_node.y() << ", " << blas_node.incy()->__str__() << ");" << std::endl;
+}
+
+void BLASDispatcherCopy::dispatchNative(codegen::PrettyPrinter& stream,
+                                        const BLASNodeCopy& blas_node) {
+    stream << "sdfg_blas_" << blasType2String(blas_node.type()) << "copy("
+           << blas_node.n()->__str__() << ", " << blas_node.x() << ", "
+           << blas_node.incx()->__str__() << ", " << blas_node.y() << ", "
+           << blas_node.incy()->__str__() << ");" << std::endl;
 }
 
 void BLASDispatcherCopy::dispatchCUBLAS(codegen::PrettyPrinter& stream,
@@ -39,41 +49,35 @@ void BLASDispatcherCopy::dispatchCUBLAS(codegen::PrettyPrinter& stream,
     const std::string dx = "d" + x;
     const std::string y = blas_node.y();
     const std::string dy = "d" + y;
-
-    stream << "#ifndef CUDA_CHECK" << std::endl
-           << "#define CUDA_CHECK(X) X" << std::endl
-           << "#endif" << std::endl
-           << "#ifndef CUBLAS_CHECK" << std::endl
-           << "#define CUBLAS_CHECK(X) X" << std::endl
-           << "#endif" << std::endl
-           << std::endl
-           << "cublasHandle_t handle;" << std::endl
-           << "CUBLAS_CHECK(cublasCreate(&handle));" << std::endl
-           << std::endl
-           << type << " *" << dx << ", *" << dy << ";" << std::endl
-           << std::endl
-           << "CUDA_CHECK(cudaMalloc(&" << dx << ", " << n << " * sizeof(" << type << ")));"
-           << std::endl
-           << "CUDA_CHECK(cudaMalloc(&" << dy << ", " << n << " * sizeof(" << type << ")));"
-           << std::endl
-           << std::endl
-           << "CUBLAS_CHECK(cublasSetVector(" << n << ", sizeof(" << type << "), " << x << ", 1, "
-           << dx << ", 1));" << std::endl
-           << "CUBLAS_CHECK(cublasSetVector(" << n << ", sizeof(" << type << "), " << y << ", 1, "
-           << dy << ", 1));" << std::endl
-           << std::endl
+    const std::string incx = blas_node.incx()->__str__();
+    const std::string incy = blas_node.incy()->__str__();
+    const std::string key_x = cublas_buffer_key(this->data_flow_graph_, this->node_, x);
+    const std::string key_y = cublas_buffer_key(this->data_flow_graph_, this->node_, y);
+
+    cublas_prologue(stream);
+    stream << type << " *" << dx << " = (" << type << " *)sdfg_cublas_buffer(\"" << key_x
+           << "\", " << n << " * sizeof(" << type << "));" << std::endl;
+    stream << type << " *" << dy << " = (" << type << " *)sdfg_cublas_buffer(\"" << key_y
+           << "\", " << n << " * sizeof(" << type << "));" << std::endl;
+    stream << std::endl;
+    if (!blas_node.resident_input(x)) {
+        stream << "CUBLAS_CHECK(cublasSetVector(" << n << ", sizeof(" << type << "), " << x
+               << ", " << incx << ", " << dx << ", 1));" << std::endl;
+    }
+    if (!blas_node.resident_input(y)) {
+        stream << "CUBLAS_CHECK(cublasSetVector(" << n << ", sizeof(" << type << "), " << y
+               << ", " << incy << ", " << dy << ", 1));" << std::endl;
+    }
+    stream << std::endl
            << "CUBLAS_CHECK(cublas" << type2 << "copy(handle, " << n << ", " << dx << ", 1, " << dy
-           << ", 1));" << std::endl
-           << std::endl
-           << "CUDA_CHECK(cudaDeviceSynchronize());" << std::endl
-           << std::endl
-           << "CUBLAS_CHECK(cublasGetVector(" << n << ", sizeof(" << type << "), " << dy << ", 1, "
-           << y << ", 1));" << std::endl
-           << std::endl
-           << "CUDA_CHECK(cudaFree(" << dx << "));" << std::endl
-           << "CUDA_CHECK(cudaFree(" << dy << "));" << std::endl
-           << std::endl
-           << "CUBLAS_CHECK(cublasDestroy(handle));" << std::endl;
+           << ", 1));" << std::endl;
+    if (!blas_node.resident_output(y)) {
+        stream << std::endl
+               << "CUDA_CHECK(cudaDeviceSynchronize());" << std::endl
+               << std::endl
+               << "CUBLAS_CHECK(cublasGetVector(" << n << ", sizeof(" << type << "), " << dy
+               << ", 1, " << y << ", " << incy << "));" << std::endl;
+    }
 }
 
 BLASDispatcherCopy::BLASDispatcherCopy(codegen::LanguageExtension& language_extension,
@@ -121,6 +125,9 @@ void BLASDispatcherCopy::dispatch(codegen::PrettyPrinter& stream) {
         case BLASImplementation_CUBLAS:
             this->dispatchCUBLAS(stream, blas_node);
             break;
+        case BLASImplementation_Native:
+            this->dispatchNative(stream, blas_node);
+            break;
     }
 
     stream.setIndent(stream.indent() - 4);
@@ -14,11 +14,29 @@
 namespace sdfg {
 namespace blas {
 
+void BLASDispatcherDot::dispatchCBLAS(codegen::PrettyPrinter& stream,
+                                      const BLASNodeDot& blas_node) {
+    stream << blas_node.result() << " = " << blas_node.result() << " + cblas_"
+           << blasType2String(blas_node.type()) << "dot(" << blas_node.n()->__str__() << ", "
+           << blas_node.x() << ", " << blas_node.incx()->__str__() << ", " << blas_node.y() << ", "
+           << blas_node.incy()->__str__() << ");" << std::endl;
+}
+
+void BLASDispatcherDot::dispatchNative(codegen::PrettyPrinter& stream,
+                                       const BLASNodeDot& blas_node) {
+    stream << blas_node.result() << " = " << blas_node.result() << " + sdfg_blas_"
+           << blasType2String(blas_node.type()) << "dot(" << blas_node.n()->__str__() << ", "
+           << blas_node.x() << ", " << blas_node.incx()->__str__() << ", " << blas_node.y() << ", "
+           << blas_node.incy()->__str__() << ");" << std::endl;
+}
+
 BLASDispatcherDot::BLASDispatcherDot(codegen::LanguageExtension& language_extension,
                                      const Function& function,
                                      const data_flow::DataFlowGraph& data_flow_graph,
-                                     const data_flow::LibraryNode& node)
-    : codegen::LibraryNodeDispatcher(language_extension, function, data_flow_graph, node) {}
+                                     const data_flow::LibraryNode& node,
+                                     const BLASImplementation impl)
+    : codegen::LibraryNodeDispatcher(language_extension, function, data_flow_graph, node),
+      impl_(impl) {}
 
 void BLASDispatcherDot::dispatch(codegen::PrettyPrinter& stream) {
     stream << "{" << std::endl;
@@ -39,10 +57,17 @@ void BLASDispatcherDot::dispatch(codegen::PrettyPrinter& stream) {
 
     auto& blas_node = dynamic_cast<const BLASNodeDot&>(this->node_);
 
-    stream << blas_node.result() << " = " << blas_node.result() << " + cblas_"
-           << blasType2String(blas_node.type()) << "dot(" << blas_node.n()->__str__() << ", "
-           << blas_node.x() << ", 1, " << blas_node.y() << ", 1);" << std::endl
-           << std::endl;
+    switch (this->impl_) {
+        // There is no cuBLAS variant, the host library is called instead
+        case BLASImplementation_CBLAS:
+        case BLASImplementation_CUBLAS:
+            this->dispatchCBLAS(stream, blas_node);
+            break;
+        case BLASImplementation_Native:
+            this->dispatchNative(stream, blas_node);
+            break;
+    }
+    stream << std::endl;
 
     for (auto& oedge : this->data_flow_graph_.out_edges(this->node_)) {
         auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
@@ -7,11 +7,17 @@
 #include <sdfg/data_flow/data_flow_graph.h>
 #include <sdfg/data_flow/library_node.h>
 #include <sdfg/function.h>
+#include <sdfg/symbolic/symbolic.h>
 #include <sdfg/types/type.h>
 #include <sdfg/types/utils.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
 #include <string>
+#include <utility>
 
+#include "sdfg/blas/blas_dispatcher_utils.h"
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_gemm.h"
 
@@ -43,36 +49,113 @@ void BLASDispatcherGemm::dispatchCBLAS(codegen::PrettyPrinter& stream,
             break;
     }
     stream << ", " << m << ", " << n << ", " << k << ", " << blas_node.alpha() << ", "
-           << blas_node.A() << ", ";
-    if (blas_node.transA() == BLASTranspose_No)
-        stream << k;
-    else
-        stream << m;
-    stream << ", " << blas_node.B() << ", ";
-    if (blas_node.transB() == BLASTranspose_No)
-        stream << n;
-    else
-        stream << k;
-    stream << ", 1.0";
-    if (blas_node.type() == BLASType_real) stream << "f";
-    stream << ", " << blas_node.C() << ", " << n << ");" << std::endl;
+           << blas_node.A() << ", " << blas_node.lda()->__str__() << ", " << blas_node.B() << ", "
+           << blas_node.ldb()->__str__() << ", " << blas_node.beta() << ", " << blas_node.C()
+           << ", " << blas_node.ldc()->__str__() << ");" << std::endl;
+    if (!blas_node.epilogue().is_null()) {
+        epilogue_loop(this->language_extension_, stream, blas_node.epilogue(), blas_node.C(), m, n,
+                      blas_node.ldc()->__str__(),
+                      nested_connector(this->function_, this->data_flow_graph_, this->node_,
+                                       blas_node.C()));
+    }
+}
+
+void BLASDispatcherGemm::dispatchNative(codegen::PrettyPrinter& stream,
+                                        const BLASNodeGemm& blas_node) {
+    // Epilogues of the runtime's form are fused into the micro-kernel store
+    std::string epilogue_args;
+    bool fused = !blas_node.epilogue().is_null() &&
+                 native_epilogue(this->language_extension_, blas_node.epilogue(), blas_node.C(),
+                                 epilogue_args);
+
+    stream << "sdfg_blas_" << blasType2String(blas_node.type())
+           << (fused ? "gemm_epilogue(" : "gemm(")
+           << blasTranspose2String(blas_node.transA()) << ", "
+           << blasTranspose2String(blas_node.transB()) << ", " << blas_node.m()->__str__() << ", "
+           << blas_node.n()->__str__() << ", " << blas_node.k()->__str__() << ", "
+           << blas_node.alpha() << ", " << blas_node.A() << ", " << blas_node.lda()->__str__()
+           << ", " << blas_node.B() << ", " << blas_node.ldb()->__str__() << ", "
+           << blas_node.beta() << ", " << blas_node.C() << ", " << blas_node.ldc()->__str__();
+    if (fused) stream << ", " << epilogue_args;
+    stream << ");" << std::endl;
+    if (!blas_node.epilogue().is_null() && !fused) {
+        epilogue_loop(this->language_extension_, stream, blas_node.epilogue(), blas_node.C(),
+                      blas_node.m()->__str__(), blas_node.n()->__str__(),
+                      blas_node.ldc()->__str__(),
+                      nested_connector(this->function_, this->data_flow_graph_, this->node_,
+                                       blas_node.C()));
+    }
+}
+
+void BLASDispatcherGemm::dispatchUnrolled(codegen::PrettyPrinter& stream,
+                                          const BLASNodeGemm& blas_node, size_t m, size_t n,
+                                          size_t k) {
+    const std::string one = blasOne(blas_node.type());
+    const std::string zero = blasZero(blas_node.type());
+
+    // Element of a row-major matrix, whose row and column are swapped if it is transposed. Nested
+    // matrices are indexed by row and column, flat ones with the leading dimension.
+    auto element = [&](const std::string& matrix, const symbolic::Expression& ld,
+                       BLASTranspose trans, size_t row, size_t col) {
+        if (trans == BLASTranspose_Transpose) std::swap(row, col);
+        if (nested_connector(this->function_, this->data_flow_graph_, this->node_, matrix))
+            return matrix + "[" + std::to_string(row) + "][" + std::to_string(col) + "]";
+        auto index =
+            symbolic::add(symbolic::mul(symbolic::integer(row), ld), symbolic::integer(col));
+        return matrix + "[" + this->language_extension_.expression(index) + "]";
+    };
+
+    // Every element of C is computed by one statement, so that it stays in a register
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            const std::string c =
+                element(blas_node.C(), blas_node.ldc(), BLASTranspose_No, i, j);
+            std::stringstream sum;
+            for (size_t p = 0; p < k; ++p) {
+                if (p > 0) sum << " + ";
+                sum << element(blas_node.A(), blas_node.lda(), blas_node.transA(), i, p) << " * "
+                    << element(blas_node.B(), blas_node.ldb(), blas_node.transB(), p, j);
+            }
+            if (k == 0) sum << zero;
+
+            stream << c << " = ";
+            if (blas_node.alpha() == one)
+                stream << sum.str();
+            else if (k > 1)
+                stream << blas_node.alpha() << " * (" << sum.str() << ")";
+            else
+                stream << blas_node.alpha() << " * " << sum.str();
+            if (blas_node.beta() != zero) {
+                stream << " + ";
+                if (blas_node.beta() != one) stream << blas_node.beta() << " * ";
+                stream << c;
+            }
+            stream << ";" << std::endl;
+
+            if (!blas_node.epilogue().is_null()) {
+                auto value = symbolic::subs(blas_node.epilogue(), symbolic::symbol(blas_node.C()),
+                                            symbolic::symbol(c));
+                stream << c << " = " << this->language_extension_.expression(value) << ";"
+                       << std::endl;
+            }
+        }
+    }
 }
 
 void BLASDispatcherGemm::dispatchCUBLAS(codegen::PrettyPrinter& stream,
                                         const BLASNodeGemm& blas_node) {
-    std::string type, type2, beta;
+    std::string type, type2;
     switch (blas_node.type()) {
         case BLASType_real:
             type = "float ";
             type2 = "S";
-            beta = "1.0f";
             break;
         case BLASType_double:
             type = "double";
             type2 = "D";
-            beta = "1.0";
             break;
     }
+    const std::string beta = blas_node.beta();
     const std::string m = blas_node.m()->__str__();
     const std::string n = blas_node.n()->__str__();
     const std::string k = blas_node.k()->__str__();
@@ -105,57 +188,89 @@ void BLASDispatcherGemm::dispatchCUBLAS(codegen::PrettyPrinter& stream,
     const std::string C = blas_node.C();
     const std::string dC = "d" + C;
 
-    stream << "#ifndef CUDA_CHECK" << std::endl
-           << "#define CUDA_CHECK(X) X" << std::endl
-           << "#endif" << std::endl
-           << "#ifndef CUBLAS_CHECK" << std::endl
-           << "#define CUBLAS_CHECK(X) X" << std::endl
-           << "#endif" << std::endl
-           << std::endl
-           << "cublasHandle_t handle;" << std::endl
-           << "CUBLAS_CHECK(cublasCreate(&handle));" << std::endl
-           << std::endl
-           << type << " *" << dA << ", *" << dB << ", *" << dC << ";" << std::endl
-           << std::endl
-           << "CUDA_CHECK(cudaMalloc(&" << dA << ", " << m << " * " << k << " * sizeof(" << type
-           << ")));" << std::endl
-           << "CUDA_CHECK(cudaMalloc(&" << dB << ", " << k << " * " << n << " * sizeof(" << type
-           << ")));" << std::endl
-           << "CUDA_CHECK(cudaMalloc(&" << dC << ", " << m << " * " << n << " * sizeof(" << type
-           << ")));" << std::endl
-           << std::endl
+    // Strided host matrices are packed while they are copied to the device. Rows and columns
+    // refer to the row-major host layout.
+    auto copy_args = [&type](const std::string& rows, const std::string& cols,
+                             const symbolic::Expression& cols_expr, const symbolic::Expression& ld,
+                             const std::string& src, const std::string& dst, bool to_device) {
+        std::stringstream args;
+        if (symbolic::eq(ld, cols_expr)) {
+            args << rows << ", " << cols << ", sizeof(" << type << "), " << src << ", " << rows
+                 << ", " << dst << ", " << rows;
+        } else if (to_device) {
+            args << cols << ", " << rows << ", sizeof(" << type << "), " << src << ", "
+                 << ld->__str__() << ", " << dst << ", " << cols;
+        } else {
+            args << cols << ", " << rows << ", sizeof(" << type << "), " << src << ", " << cols
+                 << ", " << dst << ", " << ld->__str__();
+        }
+        return args.str();
+    };
+    std::string set_A, set_B;
+    if (blas_node.transA() == BLASTranspose_No) {
+        set_A = copy_args(m, k, blas_node.k(), blas_node.lda(), A, dA, true);
+    } else {
+        set_A = copy_args(k, m, blas_node.m(), blas_node.lda(), A, dA, true);
+    }
+    if (blas_node.transB() == BLASTranspose_No) {
+        set_B = copy_args(k, n, blas_node.n(), blas_node.ldb(), B, dB, true);
+    } else {
+        set_B = copy_args(n, k, blas_node.k(), blas_node.ldb(), B, dB, true);
+    }
+    const std::string set_C = copy_args(m, n, blas_node.n(), blas_node.ldc(), C, dC, true);
+    const std::string get_C = copy_args(m, n, blas_node.n(), blas_node.ldc(), dC, C, false);
+    const std::string key_A = cublas_buffer_key(this->data_flow_graph_, this->node_, A);
+    const std::string key_B = cublas_buffer_key(this->data_flow_graph_, this->node_, B);
+    const std::string key_C = cublas_buffer_key(this->data_flow_graph_, this->node_, C);
+
+    cublas_prologue(stream);
+    stream << type << " *" << dA << " = (" << type << " *)sdfg_cublas_buffer(\"" << key_A
+           << "\", " << m << " * " << k << " * sizeof(" << type << "));" << std::endl;
+    stream << type << " *" << dB << " = (" << type << " *)sdfg_cublas_buffer(\"" << key_B
+           << "\", " << k << " * " << n << " * sizeof(" << type << "));" << std::endl;
+    stream << type << " *" << dC << " = (" << type << " *)sdfg_cublas_buffer(\"" << key_C
+           << "\", " << m << " * " << n << " * sizeof(" << type << "));" << std::endl;
+    stream << std::endl
            << type << " alpha = " << alpha << ";" << std::endl
-           << type << " beta = " << beta << ";" << std::endl
-           << "CUBLAS_CHECK(cublasSetMatrix(" << m << ", " << k << ", sizeof(" << type << "), " << A
-           << ", " << m << ", " << dA << ", " << m << "));" << std::endl
-           << "CUBLAS_CHECK(cublasSetMatrix(" << k << ", " << n << ", sizeof(" << type << "), " << B
-           << ", " << k << ", " << dB << ", " << k << "));" << std::endl
-           << "CUBLAS_CHECK(cublasSetMatrix(" << m << ", " << n << ", sizeof(" << type << "), " << C
-           << ", " << m << ", " << dC << ", " << m << "));" << std::endl
-           << std::endl
+           << type << " beta = " << beta << ";" << std::endl;
+    if (!blas_node.resident_input(A)) {
+        stream << "CUBLAS_CHECK(cublasSetMatrix(" << set_A << "));" << std::endl;
+    }
+    if (!blas_node.resident_input(B)) {
+        stream << "CUBLAS_CHECK(cublasSetMatrix(" << set_B << "));" << std::endl;
+    }
+    // C is not read if beta is zero
+    if (!blas_node.resident_input(C) && beta != blasZero(blas_node.type())) {
+        stream << "CUBLAS_CHECK(cublasSetMatrix(" << set_C << "));" << std::endl;
+    }
+    stream << std::endl
            << "CUBLAS_CHECK(cublas" << type2 << "gemm(handle, " << transA << ", " << transB << ", "
            << n << ", " << m << ", " << k << ", &alpha, " << dB << ", " << ldB << ", " << dA << ", "
-           << ldA << ", &beta, " << dC << ", " << n << "));" << std::endl
-           << std::endl
-           << "CUDA_CHECK(cudaDeviceSynchronize());" << std::endl
-           << std::endl
-           << "CUBLAS_CHECK(cublasGetMatrix(" << m << ", " << n << ", sizeof(" << type << "), "
-           << dC << ", " << m << ", " << C << ", " << m << "));" << std::endl
-           << std::endl
-           << "CUDA_CHECK(cudaFree(" << dA << "));" << std::endl
-           << "CUDA_CHECK(cudaFree(" << dB << "));" << std::endl
-           << "CUDA_CHECK(cudaFree(" << dC << "));" << std::endl
-           << std::endl
-           << "CUBLAS_CHECK(cublasDestroy(handle));" << std::endl;
+           << ldA << ", &beta, " << dC << ", " << n << "));" << std::endl;
+    if (!blas_node.resident_output(C)) {
+        stream << std::endl
+               << "CUDA_CHECK(cudaDeviceSynchronize());" << std::endl
+               << std::endl
+               << "CUBLAS_CHECK(cublasGetMatrix(" << get_C << "));" << std::endl;
+    }
+
+    // The epilogue is applied on the host. BLASResidency keeps outputs with an epilogue off the
+    // device.
+    if (!blas_node.epilogue().is_null()) {
+        epilogue_loop(this->language_extension_, stream, blas_node.epilogue(), C, m, n,
+                      blas_node.ldc()->__str__(),
+                      nested_connector(this->function_, this->data_flow_graph_, this->node_, C));
+    }
 }
 
 BLASDispatcherGemm::BLASDispatcherGemm(codegen::LanguageExtension& language_extension,
                                        const Function& function,
                                        const data_flow::DataFlowGraph& data_flow_graph,
                                        const data_flow::LibraryNode& node,
-                                       const BLASImplementation impl)
+                                       const BLASImplementation impl, size_t unroll_max_size)
     : codegen::LibraryNodeDispatcher(language_extension, function, data_flow_graph, node),
-      impl_(impl) {}
+      impl_(impl),
+      unroll_max_size_(unroll_max_size) {}
 
 void BLASDispatcherGemm::dispatch(codegen::PrettyPrinter& stream) {
     stream << "{" << std::endl;
@@ -173,10 +288,45 @@ void BLASDispatcherGemm::dispatch(codegen::PrettyPrinter& stream) {
                << this->language_extension_.subset(this->function_, src_type, iedge.subset()) << ";"
                << std::endl;
     }
+    // The output is not an input if it is overwritten
+    for (auto& oedge : this->data_flow_graph_.out_edges(this->node_)) {
+        bool is_input = false;
+        for (auto& iedge : this->data_flow_graph_.in_edges(this->node_)) {
+            if (iedge.dst_conn() == oedge.src_conn()) {
+                is_input = true;
+                break;
+            }
+        }
+        if (is_input) continue;
+
+        auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+        const types::IType& dst_type = this->function_.type(dst.data());
+
+        auto& conn_name = oedge.src_conn();
+        auto& conn_type = types::infer_type(this->function_, dst_type, oedge.subset());
+
+        stream << this->language_extension_.declaration(conn_name, conn_type) << " = " << dst.data()
+               << this->language_extension_.subset(this->function_, dst_type, oedge.subset()) << ";"
+               << std::endl;
+    }
     stream << std::endl;
 
     auto& blas_node = dynamic_cast<const BLASNodeGemm&>(this->node_);
 
+    // Small gemms of constant size are unrolled on the host instead of calling the library
+    size_t m, n, k;
+    bool unroll = this->impl_ != BLASImplementation_CUBLAS && constant_size(blas_node.m(), m) &&
+                  constant_size(blas_node.n(), n) && constant_size(blas_node.k(), k) &&
+                  m <= this->unroll_max_size_ && n <= this->unroll_max_size_ &&
+                  k <= this->unroll_max_size_ &&
+                  m * n * std::max<size_t>(k, 1) <= this->unroll_max_size_;
+    if (unroll) {
+        this->dispatchUnrolled(stream, blas_node, m, n, k);
+        stream.setIndent(stream.indent() - 4);
+        stream << "}" << std::endl;
+        return;
+    }
+
     switch (this->impl_) {
         case BLASImplementation_CBLAS:
             this->dispatchCBLAS(stream, blas_node);
@@ -184,6 +334,9 @@ void BLASDispatcherGemm::dispatch(codegen::PrettyPrinter& stream) {
         case BLASImplementation_CUBLAS:
             this->dispatchCUBLAS(stream, blas_node);
             break;
+        case BLASImplementation_Native:
+            this->dispatchNative(stream, blas_node);
+            break;
     }
 
     stream.setIndent(stream.indent() - 4);
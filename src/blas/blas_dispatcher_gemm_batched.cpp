@@ -0,0 +1,149 @@
+#include "sdfg/blas/blas_dispatcher_gemm_batched.h"
+
+#include <sdfg/codegen/dispatchers/node_dispatcher_registry.h>
+#include <sdfg/codegen/language_extension.h>
+#include <sdfg/codegen/utils.h>
+#include <sdfg/data_flow/access_node.h>
+#include <sdfg/data_flow/data_flow_graph.h>
+#include <sdfg/data_flow/library_node.h>
+#include <sdfg/function.h>
+#include <sdfg/types/type.h>
+#include <sdfg/types/utils.h>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+#include "sdfg/blas/blas_node.h"
+#include "sdfg/blas/blas_node_gemm_batched.h"
+
+namespace sdfg {
+namespace blas {
+
+BLASDispatcherGemmBatched::BLASDispatcherGemmBatched(
+    codegen::LanguageExtension& language_extension, const Function& function,
+    const data_flow::DataFlowGraph& data_flow_graph, const data_flow::LibraryNode& node,
+    const BLASImplementation impl)
+    : codegen::LibraryNodeDispatcher(language_extension, function, data_flow_graph, node),
+      impl_(impl) {}
+
+void BLASDispatcherGemmBatched::dispatch(codegen::PrettyPrinter& stream) {
+    stream << "{" << std::endl;
+    stream.setIndent(stream.indent() + 4);
+
+    // Input connector declarations
+    for (auto& iedge : this->data_flow_graph_.in_edges(this->node_)) {
+        auto& src = dynamic_cast<const data_flow::AccessNode&>(iedge.src());
+        const types::IType& src_type = this->function_.type(src.data());
+
+        auto& conn_name = iedge.dst_conn();
+        auto& conn_type = types::infer_type(this->function_, src_type, iedge.subset());
+
+        stream << this->language_extension_.declaration(conn_name, conn_type) << " = " << src.data()
+               << this->language_extension_.subset(this->function_, src_type, iedge.subset()) << ";"
+               << std::endl;
+    }
+
+    // The output is not an input if it is overwritten
+    for (auto& oedge : this->data_flow_graph_.out_edges(this->node_)) {
+        bool is_input = false;
+        for (auto& iedge : this->data_flow_graph_.in_edges(this->node_)) {
+            if (iedge.dst_conn() == oedge.src_conn()) {
+                is_input = true;
+                break;
+            }
+        }
+        if (is_input) continue;
+
+        auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+        const types::IType& dst_type = this->function_.type(dst.data());
+
+        auto& conn_name = oedge.src_conn();
+        auto& conn_type = types::infer_type(this->function_, dst_type, oedge.subset());
+
+        stream << this->language_extension_.declaration(conn_name, conn_type) << " = " << dst.data()
+               << this->language_extension_.subset(this->function_, dst_type, oedge.subset()) << ";"
+               << std::endl;
+    }
+    stream << std::endl;
+
+    auto& blas_node = dynamic_cast<const BLASNodeGemmBatched&>(this->node_);
+
+    const std::string m = blas_node.m()->__str__();
+    const std::string n = blas_node.n()->__str__();
+    const std::string k = blas_node.k()->__str__();
+
+    // Batch loops; the gemm calls of a batch are independent
+    std::stringstream batch_indices;
+    stream << "#pragma omp parallel for private(";
+    for (size_t i = 0; i < blas_node.batch().size(); ++i) {
+        if (i > 0) stream << ", ";
+        stream << blas_node.batch_indvar(i)->__str__();
+        batch_indices << "[" << blas_node.batch_indvar(i)->__str__() << "]";
+    }
+    stream << ")";
+    if (blas_node.batch().size() > 1) stream << " collapse(" << blas_node.batch().size() << ")";
+    stream << std::endl;
+    for (size_t i = 0; i < blas_node.batch().size(); ++i) {
+        const std::string indvar = blas_node.batch_indvar(i)->__str__();
+        stream << "for (" << indvar << " = 0; " << indvar << " < "
+               << blas_node.batch_size(i)->__str__() << "; " << indvar << "++)" << std::endl;
+        stream << "{" << std::endl;
+        stream.setIndent(stream.indent() + 4);
+    }
+
+    switch (this->impl_) {
+        // There is no cuBLAS variant, the host library is called instead
+        case BLASImplementation_CBLAS:
+        case BLASImplementation_CUBLAS:
+            stream << "cblas_" << blasType2String(blas_node.type()) << "gemm(CblasRowMajor, ";
+            switch (blas_node.transA()) {
+                case BLASTranspose_No:
+                    stream << "CblasNoTrans";
+                    break;
+                case BLASTranspose_Transpose:
+                    stream << "CblasTrans";
+                    break;
+            }
+            stream << ", ";
+            switch (blas_node.transB()) {
+                case BLASTranspose_No:
+                    stream << "CblasNoTrans";
+                    break;
+                case BLASTranspose_Transpose:
+                    stream << "CblasTrans";
+                    break;
+            }
+            stream << ", ";
+            break;
+        case BLASImplementation_Native:
+            stream << "sdfg_blas_" << blasType2String(blas_node.type()) << "gemm("
+                   << blasTranspose2String(blas_node.transA()) << ", "
+                   << blasTranspose2String(blas_node.transB()) << ", ";
+            break;
+    }
+    stream << m << ", " << n << ", " << k << ", " << blas_node.alpha() << ", " << blas_node.A()
+           << batch_indices.str() << ", ";
+    if (blas_node.transA() == BLASTranspose_No)
+        stream << k;
+    else
+        stream << m;
+    stream << ", " << blas_node.B() << batch_indices.str() << ", ";
+    if (blas_node.transB() == BLASTranspose_No)
+        stream << n;
+    else
+        stream << k;
+    stream << ", " << blas_node.beta() << ", " << blas_node.C() << batch_indices.str() << ", " << n
+           << ");" << std::endl;
+
+    for (size_t i = 0; i < blas_node.batch().size(); ++i) {
+        stream.setIndent(stream.indent() - 4);
+        stream << "}" << std::endl;
+    }
+
+    stream.setIndent(stream.indent() - 4);
+    stream << "}" << std::endl;
+}
+
+}  // namespace blas
+}  // namespace sdfg
@@ -7,7 +7,14 @@
 #include <sdfg/data_flow/data_flow_graph.h>
 #include <sdfg/data_flow/library_node.h>
 #include <sdfg/function.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/types/type.h>
+#include <sdfg/types/utils.h>
 
+#include <sstream>
+#include <string>
+
+#include "sdfg/blas/blas_dispatcher_utils.h"
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_gemv.h"
 
@@ -26,27 +33,53 @@ void BLASDispatcherGemv::dispatchCBLAS(codegen::PrettyPrinter& stream,
             break;
     }
     stream << ", " << blas_node.m()->__str__() << ", " << blas_node.n()->__str__() << ", "
-           << blas_node.alpha() << ", " << blas_node.A() << ", " << blas_node.n()->__str__() << ", "
-           << blas_node.x() << ", 1, 1.0";
-    if (blas_node.type() == BLASType_real) stream << "f";
-    stream << ", " << blas_node.y() << ", 1);" << std::endl;
+           << blas_node.alpha() << ", " << blas_node.A() << ", " << blas_node.lda()->__str__()
+           << ", " << blas_node.x() << ", " << blas_node.incx()->__str__() << ", "
+           << blas_node.beta() << ", " << blas_node.y() << ", " << blas_node.incy()->__str__()
+           << ");" << std::endl;
+    if (!blas_node.epilogue().is_null()) {
+        epilogue_loop(this->language_extension_, stream, blas_node.epilogue(), blas_node.y(),
+                      this->y_size(blas_node), "1", blas_node.incy()->__str__());
+    }
+}
+
+void BLASDispatcherGemv::dispatchNative(codegen::PrettyPrinter& stream,
+                                        const BLASNodeGemv& blas_node) {
+    // Epilogues of the runtime's form are fused into the store of y
+    std::string epilogue_args;
+    bool fused = !blas_node.epilogue().is_null() &&
+                 native_epilogue(this->language_extension_, blas_node.epilogue(), blas_node.y(),
+                                 epilogue_args);
+
+    stream << "sdfg_blas_" << blasType2String(blas_node.type())
+           << (fused ? "gemv_epilogue(" : "gemv(")
+           << blasTranspose2String(blas_node.trans()) << ", " << blas_node.m()->__str__() << ", "
+           << blas_node.n()->__str__() << ", " << blas_node.alpha() << ", " << blas_node.A()
+           << ", " << blas_node.lda()->__str__() << ", " << blas_node.x() << ", "
+           << blas_node.incx()->__str__() << ", " << blas_node.beta() << ", " << blas_node.y()
+           << ", " << blas_node.incy()->__str__();
+    if (fused) stream << ", " << epilogue_args;
+    stream << ");" << std::endl;
+    if (!blas_node.epilogue().is_null() && !fused) {
+        epilogue_loop(this->language_extension_, stream, blas_node.epilogue(), blas_node.y(),
+                      this->y_size(blas_node), "1", blas_node.incy()->__str__());
+    }
 }
 
 void BLASDispatcherGemv::dispatchCUBLAS(codegen::PrettyPrinter& stream,
                                         const BLASNodeGemv& blas_node) {
-    std::string type, type2, beta;
+    std::string type, type2;
     switch (blas_node.type()) {
         case BLASType_real:
             type = "float ";
             type2 = "S";
-            beta = "1.0f";
             break;
         case BLASType_double:
             type = "double";
             type2 = "D";
-            beta = "1.0";
             break;
     }
+    const std::string beta = blas_node.beta();
     const std::string m = blas_node.m()->__str__();
     const std::string n = blas_node.n()->__str__();
     std::string trans, x_size, y_size;
@@ -69,49 +102,71 @@ void BLASDispatcherGemv::dispatchCUBLAS(codegen::PrettyPrinter& stream,
     const std::string dx = "d" + x;
     const std::string y = blas_node.y();
     const std::string dy = "d" + y;
+    const std::string incx = blas_node.incx()->__str__();
+    const std::string incy = blas_node.incy()->__str__();
 
-    stream << "#ifndef CUDA_CHECK" << std::endl
-           << "#define CUDA_CHECK(X) X" << std::endl
-           << "#endif" << std::endl
-           << "#ifndef CUBLAS_CHECK" << std::endl
-           << "#define CUBLAS_CHECK(X) X" << std::endl
-           << "#endif" << std::endl
-           << std::endl
-           << "cublasHandle_t handle;" << std::endl
-           << "CUBLAS_CHECK(cublasCreate(&handle));" << std::endl
-           << std::endl
-           << type << " *" << dA << ", *" << dx << ", *" << dy << ";" << std::endl
-           << std::endl
-           << "CUDA_CHECK(cudaMalloc(&" << dA << ", " << m << " * " << n << " * sizeof(" << type
-           << ")));" << std::endl
-           << "CUDA_CHECK(cudaMalloc(&" << dx << ", " << x_size << " * sizeof(" << type << ")));"
-           << std::endl
-           << "CUDA_CHECK(cudaMalloc(&" << dy << ", " << y_size << " * sizeof(" << type << ")));"
-           << std::endl
-           << std::endl
+    // A strided host matrix is packed while it is copied to the device
+    std::stringstream set_A;
+    if (symbolic::eq(blas_node.lda(), blas_node.n())) {
+        set_A << m << ", " << n << ", sizeof(" << type << "), " << A << ", " << m << ", " << dA
+              << ", " << m;
+    } else {
+        set_A << n << ", " << m << ", sizeof(" << type << "), " << A << ", "
+              << blas_node.lda()->__str__() << ", " << dA << ", " << n;
+    }
+    const std::string key_A = cublas_buffer_key(this->data_flow_graph_, this->node_, A);
+    const std::string key_x = cublas_buffer_key(this->data_flow_graph_, this->node_, x);
+    const std::string key_y = cublas_buffer_key(this->data_flow_graph_, this->node_, y);
+
+    cublas_prologue(stream);
+    stream << type << " *" << dA << " = (" << type << " *)sdfg_cublas_buffer(\"" << key_A
+           << "\", " << m << " * " << n << " * sizeof(" << type << "));" << std::endl;
+    stream << type << " *" << dx << " = (" << type << " *)sdfg_cublas_buffer(\"" << key_x
+           << "\", " << x_size << " * sizeof(" << type << "));" << std::endl;
+    stream << type << " *" << dy << " = (" << type << " *)sdfg_cublas_buffer(\"" << key_y
+           << "\", " << y_size << " * sizeof(" << type << "));" << std::endl;
+    stream << std::endl
            << type << " alpha = " << alpha << ";" << std::endl
-           << type << " beta = " << beta << ";" << std::endl
-           << "CUBLAS_CHECK(cublasSetMatrix(" << m << ", " << n << ", sizeof(" << type << "), " << A
-           << ", " << m << ", " << dA << ", " << m << "));" << std::endl
-           << "CUBLAS_CHECK(cublasSetVector(" << x_size << ", sizeof(" << type << "), " << x
-           << ", 1, " << dx << ", 1));" << std::endl
-           << "CUBLAS_CHECK(cublasSetVector(" << y_size << ", sizeof(" << type << "), " << y
-           << ", 1, " << dy << ", 1));" << std::endl
-           << std::endl
+           << type << " beta = " << beta << ";" << std::endl;
+    if (!blas_node.resident_input(A)) {
+        stream << "CUBLAS_CHECK(cublasSetMatrix(" << set_A.str() << "));" << std::endl;
+    }
+    if (!blas_node.resident_input(x)) {
+        stream << "CUBLAS_CHECK(cublasSetVector(" << x_size << ", sizeof(" << type << "), " << x
+               << ", " << incx << ", " << dx << ", 1));" << std::endl;
+    }
+    if (!blas_node.resident_input(y)) {
+        stream << "CUBLAS_CHECK(cublasSetVector(" << y_size << ", sizeof(" << type << "), " << y
+               << ", " << incy << ", " << dy << ", 1));" << std::endl;
+    }
+    stream << std::endl
            << "CUBLAS_CHECK(cublas" << type2 << "gemv(handle, " << trans << ", " << n << ", " << m
            << ", &alpha, " << dA << ", " << n << ", " << dx << ", 1, &beta, " << dy << ", 1));"
-           << std::endl
-           << std::endl
-           << "CUDA_CHECK(cudaDeviceSynchronize());" << std::endl
-           << std::endl
-           << "CUBLAS_CHECK(cublasGetVector(" << y_size << ", sizeof(" << type << "), " << dy
-           << ", 1, " << y << ", 1));" << std::endl
-           << std::endl
-           << "CUDA_CHECK(cudaFree(" << dA << "));" << std::endl
-           << "CUDA_CHECK(cudaFree(" << dx << "));" << std::endl
-           << "CUDA_CHECK(cudaFree(" << dy << "));" << std::endl
-           << std::endl
-           << "CUBLAS_CHECK(cublasDestroy(handle));" << std::endl;
+           << std::endl;
+    if (!blas_node.resident_output(y)) {
+        stream << std::endl
+               << "CUDA_CHECK(cudaDeviceSynchronize());" << std::endl
+               << std::endl
+               << "CUBLAS_CHECK(cublasGetVector(" << y_size << ", sizeof(" << type << "), " << dy
+               << ", 1, " << y << ", " << incy << "));" << std::endl;
+    }
+
+    // The epilogue is applied on the host. BLASResidency keeps outputs with an epilogue off the
+    // device.
+    if (!blas_node.epilogue().is_null()) {
+        epilogue_loop(this->language_extension_, stream, blas_node.epilogue(), y, y_size, "1",
+                      incy);
+    }
+}
+
+std::string BLASDispatcherGemv::y_size(const BLASNodeGemv& blas_node) {
+    switch (blas_node.trans()) {
+        case BLASTranspose_No:
+            return blas_node.m()->__str__();
+        case BLASTranspose_Transpose:
+            return blas_node.n()->__str__();
+    }
+    return blas_node.m()->__str__();
 }
 
 BLASDispatcherGemv::BLASDispatcherGemv(codegen::LanguageExtension& language_extension,
@@ -137,6 +192,27 @@ void BLASDispatcherGemv::dispatch(codegen::PrettyPrinter& stream) {
                << this->language_extension_.subset(this->function_, src_type, iedge.subset()) << ";"
                << std::endl;
     }
+    // The output is not an input if it is overwritten
+    for (auto& oedge : this->data_flow_graph_.out_edges(this->node_)) {
+        bool is_input = false;
+        for (auto& iedge : this->data_flow_graph_.in_edges(this->node_)) {
+            if (iedge.dst_conn() == oedge.src_conn()) {
+                is_input = true;
+                break;
+            }
+        }
+        if (is_input) continue;
+
+        auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+        const types::IType& dst_type = this->function_.type(dst.data());
+
+        auto& conn_name = oedge.src_conn();
+        auto& conn_type = types::infer_type(this->function_, dst_type, oedge.subset());
+
+        stream << this->language_extension_.declaration(conn_name, conn_type) << " = " << dst.data()
+               << this->language_extension_.subset(this->function_, dst_type, oedge.subset()) << ";"
+               << std::endl;
+    }
     stream << std::endl;
 
     auto& blas_node = dynamic_cast<const BLASNodeGemv&>(this->node_);
@@ -148,6 +224,9 @@ void BLASDispatcherGemv::dispatch(codegen::PrettyPrinter& stream) {
         case BLASImplementation_CUBLAS:
             this->dispatchCUBLAS(stream, blas_node);
             break;
+        case BLASImplementation_Native:
+            this->dispatchNative(stream, blas_node);
+            break;
     }
 
     stream.setIndent(stream.indent() - 4);
@@ -14,11 +14,29 @@
 namespace sdfg {
 namespace blas {
 
+void BLASDispatcherGer::dispatchCBLAS(codegen::PrettyPrinter& stream,
+                                      const BLASNodeGer& blas_node) {
+    stream << "cblas_" << blasType2String(blas_node.type()) << "ger(CblasRowMajor, "
+           << blas_node.m()->__str__() << ", " << blas_node.n()->__str__() << ", "
+           << blas_node.alpha() << ", " << blas_node.x() << ", 1, " << blas_node.y() << ", 1, "
+           << blas_node.A() << ", " << blas_node.n()->__str__() << ");" << std::endl;
+}
+
+void BLASDispatcherGer::dispatchNative(codegen::PrettyPrinter& stream,
+                                       const BLASNodeGer& blas_node) {
+    stream << "sdfg_blas_" << blasType2String(blas_node.type()) << "ger("
+           << blas_node.m()->__str__() << ", " << blas_node.n()->__str__() << ", "
+           << blas_node.alpha() << ", " << blas_node.x() << ", 1, " << blas_node.y() << ", 1, "
+           << blas_node.A() << ", " << blas_node.n()->__str__() << ");" << std::endl;
+}
+
 BLASDispatcherGer::BLASDispatcherGer(codegen::LanguageExtension& language_extension,
                                      const Function& function,
                                      const data_flow::DataFlowGraph& data_flow_graph,
-                                     const data_flow::LibraryNode& node)
-    : codegen::LibraryNodeDispatcher(language_extension, function, data_flow_graph, node) {}
+                                     const data_flow::LibraryNode& node,
+                                     const BLASImplementation impl)
+    : codegen::LibraryNodeDispatcher(language_extension, function, data_flow_graph, node),
+      impl_(impl) {}
 
 void BLASDispatcherGer::dispatch(codegen::PrettyPrinter& stream) {
     stream << "{" << std::endl;
@@ -39,10 +57,16 @@ void BLASDispatcherGer::dispatch(codegen::PrettyPrinter& stream) {
 
     auto& blas_node = dynamic_cast<const BLASNodeGer&>(this->node_);
 
-    stream << "cblas_" << blasType2String(blas_node.type()) << "ger(CblasRowMajor, "
-           << blas_node.m()->__str__() << ", " << blas_node.n()->__str__() << ", "
-           << blas_node.alpha() << ", " << blas_node.x() << ", 1, " << blas_node.y() << ", 1, "
-           << blas_node.A() << ", " << blas_node.n()->__str__() << ");" << std::endl;
+    switch (this->impl_) {
+        // There is no cuBLAS variant, the host library is called instead
+        case BLASImplementation_CBLAS:
+        case BLASImplementation_CUBLAS:
+            this->dispatchCBLAS(stream, blas_node);
+            break;
+        case BLASImplementation_Native:
+            this->dispatchNative(stream, blas_node);
+            break;
+    }
 
     stream.setIndent(stream.indent() - 4);
     stream << "}" << std::endl;
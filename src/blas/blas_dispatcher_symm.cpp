@@ -17,32 +17,8 @@
 namespace sdfg {
 namespace blas {
 
-BLASDispatcherSymm::BLASDispatcherSymm(codegen::LanguageExtension& language_extension,
-                                       const Function& function,
-                                       const data_flow::DataFlowGraph& data_flow_graph,
-                                       const data_flow::LibraryNode& node)
-    : codegen::LibraryNodeDispatcher(language_extension, function, data_flow_graph, node) {}
-
-void BLASDispatcherSymm::dispatch(codegen::PrettyPrinter& stream) {
-    stream << "{" << std::endl;
-    stream.setIndent(stream.indent() + 4);
-
-    // Input connector declarations
-    for (auto& iedge : this->data_flow_graph_.in_edges(this->node_)) {
-        auto& src = dynamic_cast<const data_flow::AccessNode&>(iedge.src());
-        const types::IType& src_type = this->function_.type(src.data());
-
-        auto& conn_name = iedge.dst_conn();
-        auto& conn_type = types::infer_type(this->function_, src_type, iedge.subset());
-
-        stream << this->language_extension_.declaration(conn_name, conn_type) << " = " << src.data()
-               << this->language_extension_.subset(this->function_, src_type, iedge.subset()) << ";"
-               << std::endl;
-    }
-    stream << std::endl;
-
-    auto& blas_node = dynamic_cast<const BLASNodeSymm&>(this->node_);
-
+void BLASDispatcherSymm::dispatchCBLAS(codegen::PrettyPrinter& stream,
+                                       const BLASNodeSymm& blas_node) {
     const std::string m = blas_node.m()->__str__();
     const std::string n = blas_node.n()->__str__();
 
@@ -72,6 +48,63 @@ void BLASDispatcherSymm::dispatch(codegen::PrettyPrinter& stream) {
     stream << ", " << blas_node.B() << ", " << m << ", 1.0";
     if (blas_node.type() == BLASType_real) stream << "f";
     stream << ", " << blas_node.C() << ", " << m << ");" << std::endl;
+}
+
+void BLASDispatcherSymm::dispatchNative(codegen::PrettyPrinter& stream,
+                                        const BLASNodeSymm& blas_node) {
+    const std::string m = blas_node.m()->__str__();
+    const std::string n = blas_node.n()->__str__();
+
+    // B and C are m x n row-major matrices
+    stream << "sdfg_blas_" << blasType2String(blas_node.type()) << "symm("
+           << blasSide2String(blas_node.side()) << ", " << blasTriangular2String(blas_node.uplo())
+           << ", " << m << ", " << n << ", " << blas_node.alpha() << ", " << blas_node.A() << ", ";
+    if (blas_node.side() == BLASSide_Left)
+        stream << m;
+    else
+        stream << n;
+    stream << ", " << blas_node.B() << ", " << n << ", " << blasOne(blas_node.type()) << ", "
+           << blas_node.C() << ", " << n << ");" << std::endl;
+}
+
+BLASDispatcherSymm::BLASDispatcherSymm(codegen::LanguageExtension& language_extension,
+                                       const Function& function,
+                                       const data_flow::DataFlowGraph& data_flow_graph,
+                                       const data_flow::LibraryNode& node,
+                                       const BLASImplementation impl)
+    : codegen::LibraryNodeDispatcher(language_extension, function, data_flow_graph, node),
+      impl_(impl) {}
+
+void BLASDispatcherSymm::dispatch(codegen::PrettyPrinter& stream) {
+    stream << "{" << std::endl;
+    stream.setIndent(stream.indent() + 4);
+
+    // Input connector declarations
+    for (auto& iedge : this->data_flow_graph_.in_edges(this->node_)) {
+        auto& src = dynamic_cast<const data_flow::AccessNode&>(iedge.src());
+        const types::IType& src_type = this->function_.type(src.data());
+
+        auto& conn_name = iedge.dst_conn();
+        auto& conn_type = types::infer_type(this->function_, src_type, iedge.subset());
+
+        stream << this->language_extension_.declaration(conn_name, conn_type) << " = " << src.data()
+               << this->language_extension_.subset(this->function_, src_type, iedge.subset()) << ";"
+               << std::endl;
+    }
+    stream << std::endl;
+
+    auto& blas_node = dynamic_cast<const BLASNodeSymm&>(this->node_);
+
+    switch (this->impl_) {
+        // There is no cuBLAS variant, the host library is called instead
+        case BLASImplementation_CBLAS:
+        case BLASImplementation_CUBLAS:
+            this->dispatchCBLAS(stream, blas_node);
+            break;
+        case BLASImplementation_Native:
+            this->dispatchNative(stream, blas_node);
+            break;
+    }
 
     stream.setIndent(stream.indent() - 4);
     stream << "}" << std::endl;
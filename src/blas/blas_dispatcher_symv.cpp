@@ -14,11 +14,39 @@
 namespace sdfg {
 namespace blas {
 
+void BLASDispatcherSymv::dispatchCBLAS(codegen::PrettyPrinter& stream,
+                                       const BLASNodeSymv& blas_node) {
+    stream << "cblas_" << blasType2String(blas_node.type()) << "symv(CblasRowMajor, ";
+    switch (blas_node.uplo()) {
+        case BLASTriangular_Upper:
+            stream << "CblasUpper";
+            break;
+        case BLASTriangular_Lower:
+            stream << "CblasLower";
+            break;
+    }
+    stream << ", " << blas_node.n()->__str__() << ", " << blas_node.alpha() << ", " << blas_node.A()
+           << ", " << blas_node.n()->__str__() << ", " << blas_node.x() << ", 1, 1.0";
+    if (blas_node.type() == BLASType_real) stream << "f";
+    stream << ", " << blas_node.y() << ", 1);" << std::endl;
+}
+
+void BLASDispatcherSymv::dispatchNative(codegen::PrettyPrinter& stream,
+                                        const BLASNodeSymv& blas_node) {
+    stream << "sdfg_blas_" << blasType2String(blas_node.type()) << "symv("
+           << blasTriangular2String(blas_node.uplo()) << ", " << blas_node.n()->__str__() << ", "
+           << blas_node.alpha() << ", " << blas_node.A() << ", " << blas_node.n()->__str__() << ", "
+           << blas_node.x() << ", 1, " << blasOne(blas_node.type()) << ", " << blas_node.y()
+           << ", 1);" << std::endl;
+}
+
 BLASDispatcherSymv::BLASDispatcherSymv(codegen::LanguageExtension& language_extension,
                                        const Function& function,
                                        const data_flow::DataFlowGraph& data_flow_graph,
-                                       const data_flow::LibraryNode& node)
-    : codegen::LibraryNodeDispatcher(language_extension, function, data_flow_graph, node) {}
+                                       const data_flow::LibraryNode& node,
+                                       const BLASImplementation impl)
+    : codegen::LibraryNodeDispatcher(language_extension, function, data_flow_graph, node),
+      impl_(impl) {}
 
 void BLASDispatcherSymv::dispatch(codegen::PrettyPrinter& stream) {
     stream << "{" << std::endl;
@@ -39,19 +67,16 @@ void BLASDispatcherSymv::dispatch(codegen::PrettyPrinter& stream) {
 
     auto& blas_node = dynamic_cast<const BLASNodeSymv&>(this->node_);
 
-    stream << "cblas_" << blasType2String(blas_node.type()) << "symv(CblasRowMajor, ";
-    switch (blas_node.uplo()) {
-        case BLASTriangular_Upper:
-            stream << "CblasUpper";
+    switch (this->impl_) {
+        // There is no cuBLAS variant, the host library is called instead
+        case BLASImplementation_CBLAS:
+        case BLASImplementation_CUBLAS:
+            this->dispatchCBLAS(stream, blas_node);
             break;
-        case BLASTriangular_Lower:
-            stream << "CblasLower";
+        case BLASImplementation_Native:
+            this->dispatchNative(stream, blas_node);
             break;
     }
-    stream << ", " << blas_node.n()->__str__() << ", " << blas_node.alpha() << ", " << blas_node.A()
-           << ", " << blas_node.n()->__str__() << ", " << blas_node.x() << ", 1, 1.0";
-    if (blas_node.type() == BLASType_real) stream << "f";
-    stream << ", " << blas_node.y() << ", 1);" << std::endl;
 
     stream.setIndent(stream.indent() - 4);
     stream << "}" << std::endl;
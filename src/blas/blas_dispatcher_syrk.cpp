@@ -12,6 +12,7 @@
 
 #include <string>
 
+#include "sdfg/blas/blas_dispatcher_utils.h"
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_syrk.h"
 
@@ -51,6 +52,23 @@ void BLASDispatcherSyrk::dispatchCBLAS(codegen::PrettyPrinter& stream,
     stream << ", " << blas_node.C() << ", " << n << ");" << std::endl;
 }
 
+void BLASDispatcherSyrk::dispatchNative(codegen::PrettyPrinter& stream,
+                                        const BLASNodeSyrk& blas_node) {
+    const std::string n = blas_node.n()->__str__();
+    const std::string k = blas_node.k()->__str__();
+
+    stream << "sdfg_blas_" << blasType2String(blas_node.type()) << "syrk("
+           << blasTriangular2String(blas_node.uplo()) << ", "
+           << blasTranspose2String(blas_node.trans()) << ", " << n << ", " << k << ", "
+           << blas_node.alpha() << ", " << blas_node.A() << ", ";
+    if (blas_node.trans() == BLASTranspose_No)
+        stream << k;
+    else
+        stream << n;
+    stream << ", " << blasOne(blas_node.type()) << ", " << blas_node.C() << ", " << n << ");"
+           << std::endl;
+}
+
 void BLASDispatcherSyrk::dispatchCUBLAS(codegen::PrettyPrinter& stream,
                                         const BLASNodeSyrk& blas_node) {
     std::string type, type2, beta;
@@ -93,44 +111,36 @@ void BLASDispatcherSyrk::dispatchCUBLAS(codegen::PrettyPrinter& stream,
     const std::string dA = "d" + A;
     const std::string C = blas_node.C();
     const std::string dC = "d" + C;
-
-    stream << "#ifndef CUDA_CHECK" << std::endl
-           << "#define CUDA_CHECK(X) X" << std::endl
-           << "#endif" << std::endl
-           << "#ifndef CUBLAS_CHECK" << std::endl
-           << "#define CUBLAS_CHECK(X) X" << std::endl
-           << "#endif" << std::endl
-           << std::endl
-           << "cublasHandle_t handle;" << std::endl
-           << "CUBLAS_CHECK(cublasCreate(&handle));" << std::endl
-           << std::endl
-           << type << " *" << dA << ", *" << dC << ";" << std::endl
-           << std::endl
-           << "CUDA_CHECK(cudaMalloc(&" << dA << ", " << n << " * " << k << " * sizeof(" << type
-           << ")));" << std::endl
-           << "CUDA_CHECK(cudaMalloc(&" << dC << ", " << n << " * " << n << " * sizeof(" << type
-           << ")));" << std::endl
-           << std::endl
+    const std::string key_A = cublas_buffer_key(this->data_flow_graph_, this->node_, A);
+    const std::string key_C = cublas_buffer_key(this->data_flow_graph_, this->node_, C);
+
+    cublas_prologue(stream);
+    stream << type << " *" << dA << " = (" << type << " *)sdfg_cublas_buffer(\"" << key_A
+           << "\", " << n << " * " << k << " * sizeof(" << type << "));" << std::endl;
+    stream << type << " *" << dC << " = (" << type << " *)sdfg_cublas_buffer(\"" << key_C
+           << "\", " << n << " * " << n << " * sizeof(" << type << "));" << std::endl;
+    stream << std::endl
            << type << " alpha = " << alpha << ";" << std::endl
-           << type << " beta = " << beta << ";" << std::endl
-           << "CUBLAS_CHECK(cublasSetMatrix(" << n << ", " << k << ", sizeof(" << type << "), " << A
-           << ", " << n << ", " << dA << ", " << n << "));" << std::endl
-           << "CUBLAS_CHECK(cublasSetMatrix(" << n << ", " << n << ", sizeof(" << type << "), " << C
-           << ", " << n << ", " << dC << ", " << n << "));" << std::endl
-           << std::endl
+           << type << " beta = " << beta << ";" << std::endl;
+    if (!blas_node.resident_input(A)) {
+        stream << "CUBLAS_CHECK(cublasSetMatrix(" << n << ", " << k << ", sizeof(" << type
+               << "), " << A << ", " << n << ", " << dA << ", " << n << "));" << std::endl;
+    }
+    if (!blas_node.resident_input(C)) {
+        stream << "CUBLAS_CHECK(cublasSetMatrix(" << n << ", " << n << ", sizeof(" << type
+               << "), " << C << ", " << n << ", " << dC << ", " << n << "));" << std::endl;
+    }
+    stream << std::endl
            << "CUBLAS_CHECK(cublas" << type2 << "syrk(handle, " << uplo << ", " << trans << ", "
            << n << ", " << k << ", &alpha, " << dA << ", " << ldA << ", &beta, " << dC << ", " << n
-           << "));" << std::endl
-           << std::endl
-           << "CUDA_CHECK(cudaDeviceSynchronize());" << std::endl
-           << std::endl
-           << "CUBLAS_CHECK(cublasGetMatrix(" << n << ", " << n << ", sizeof(" << type << "), "
-           << dC << ", " << n << ", " << C << ", " << n << "));" << std::endl
-           << std::endl
-           << "CUDA_CHECK(cudaFree(" << dA << "));" << std::endl
-           << "CUDA_CHECK(cudaFree(" << dC << "));" << std::endl
-           << std::endl
-           << "CUBLAS_CHECK(cublasDestroy(handle));" << std::endl;
+           << "));" << std::endl;
+    if (!blas_node.resident_output(C)) {
+        stream << std::endl
+               << "CUDA_CHECK(cudaDeviceSynchronize());" << std::endl
+               << std::endl
+               << "CUBLAS_CHECK(cublasGetMatrix(" << n << ", " << n << ", sizeof(" << type
+               << "), " << dC << ", " << n << ", " << C << ", " << n << "));" << std::endl;
+    }
 }
 
 BLASDispatcherSyrk::BLASDispatcherSyrk(codegen::LanguageExtension& language_extension,
@@ -168,6 +178,9 @@ void BLASDispatcherSyrk::dispatch(codegen::PrettyPrinter& stream) {
         case BLASImplementation_CUBLAS:
             this->dispatchCUBLAS(stream, blas_node);
             break;
+        case BLASImplementation_Native:
+            this->dispatchNative(stream, blas_node);
+            break;
     }
 
     stream.setIndent(stream.indent() - 4);
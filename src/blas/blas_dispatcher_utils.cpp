@@ -0,0 +1,153 @@
+#include "sdfg/blas/blas_dispatcher_utils.h"
+
+#include <sdfg/codegen/language_extension.h>
+#include <sdfg/codegen/utils.h>
+#include <sdfg/data_flow/access_node.h>
+#include <sdfg/data_flow/data_flow_graph.h>
+#include <sdfg/data_flow/library_node.h>
+#include <sdfg/function.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/types/pointer.h>
+#include <sdfg/types/type.h>
+#include <sdfg/types/utils.h>
+#include <symengine/integer.h>
+
+#include <cstddef>
+#include <string>
+
+namespace sdfg {
+namespace blas {
+
+void cublas_prologue(codegen::PrettyPrinter& stream) {
+    stream << "#ifndef CUDA_CHECK" << std::endl
+           << "#define CUDA_CHECK(X) X" << std::endl
+           << "#endif" << std::endl
+           << "#ifndef CUBLAS_CHECK" << std::endl
+           << "#define CUBLAS_CHECK(X) X" << std::endl
+           << "#endif" << std::endl
+           << std::endl
+           << "cublasHandle_t handle = sdfg_cublas_handle();" << std::endl
+           << std::endl;
+}
+
+std::string cublas_buffer_key(const data_flow::DataFlowGraph& data_flow_graph,
+                              const data_flow::LibraryNode& node, const std::string& conn) {
+    // Find the container of the connector
+    std::string container;
+    for (auto& iedge : data_flow_graph.in_edges(node)) {
+        if (iedge.dst_conn() == conn) {
+            container = dynamic_cast<const data_flow::AccessNode&>(iedge.src()).data();
+        }
+    }
+    for (auto& oedge : data_flow_graph.out_edges(node)) {
+        if (oedge.src_conn() == conn) {
+            container = dynamic_cast<const data_flow::AccessNode&>(oedge.dst()).data();
+        }
+    }
+
+    // Check if another connector uses the same container
+    for (auto& iedge : data_flow_graph.in_edges(node)) {
+        if (iedge.dst_conn() != conn &&
+            dynamic_cast<const data_flow::AccessNode&>(iedge.src()).data() == container) {
+            return container + "." + conn;
+        }
+    }
+    for (auto& oedge : data_flow_graph.out_edges(node)) {
+        if (oedge.src_conn() != conn &&
+            dynamic_cast<const data_flow::AccessNode&>(oedge.dst()).data() == container) {
+            return container + "." + conn;
+        }
+    }
+
+    return container;
+}
+
+bool nested_connector(const Function& function, const data_flow::DataFlowGraph& data_flow_graph,
+                      const data_flow::LibraryNode& node, const std::string& conn) {
+    // Infer the type of the connector from its memlet
+    const types::IType* type = nullptr;
+    for (auto& iedge : data_flow_graph.in_edges(node)) {
+        if (iedge.dst_conn() != conn) continue;
+        auto& src = dynamic_cast<const data_flow::AccessNode&>(iedge.src());
+        type = &types::infer_type(function, function.type(src.data()), iedge.subset());
+    }
+    for (auto& oedge : data_flow_graph.out_edges(node)) {
+        if (type || oedge.src_conn() != conn) continue;
+        auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+        type = &types::infer_type(function, function.type(dst.data()), oedge.subset());
+    }
+
+    auto* pointer = dynamic_cast<const types::Pointer*>(type);
+    if (!pointer) return false;
+    return dynamic_cast<const types::Pointer*>(&pointer->pointee_type()) != nullptr;
+}
+
+bool native_epilogue(codegen::LanguageExtension& language_extension,
+                     const symbolic::Expression& epilogue, const std::string& out,
+                     std::string& args) {
+    auto out_symbol = symbolic::symbol(out);
+
+    // Peel off the bounds
+    symbolic::Expression expr = epilogue;
+    std::string lower = "-INFINITY", upper = "INFINITY";
+    bool has_lower = false, has_upper = false;
+    while (true) {
+        bool is_max = expr->get_type_code() == SymEngine::TypeID::SYMENGINE_MAX;
+        bool is_min = expr->get_type_code() == SymEngine::TypeID::SYMENGINE_MIN;
+        if (!(is_max && !has_lower) && !(is_min && !has_upper)) break;
+
+        auto args = expr->get_args();
+        if (args.size() != 2) return false;
+        size_t bound = symbolic::uses(args[0], out_symbol) ? 1 : 0;
+        if (symbolic::uses(args[bound], out_symbol)) return false;
+        if (is_max) {
+            lower = language_extension.expression(args[bound]);
+            has_lower = true;
+        } else {
+            upper = language_extension.expression(args[bound]);
+            has_upper = true;
+        }
+        expr = args[1 - bound];
+    }
+
+    // Check that the remainder is affine in the output
+    symbolic::Expression scale = expr->diff(out_symbol);
+    if (symbolic::uses(scale, out_symbol)) return false;
+    symbolic::Expression shift = symbolic::subs(expr, out_symbol, symbolic::zero());
+
+    args = language_extension.expression(scale) + ", " + language_extension.expression(shift) +
+           ", " + lower + ", " + upper;
+    return true;
+}
+
+bool constant_size(const symbolic::Expression& size, size_t& value) {
+    if (size->get_type_code() != SymEngine::TypeID::SYMENGINE_INTEGER) return false;
+    long long result = SymEngine::rcp_static_cast<const SymEngine::Integer>(size)->as_int();
+    if (result < 0) return false;
+    value = result;
+    return true;
+}
+
+void epilogue_loop(codegen::LanguageExtension& language_extension, codegen::PrettyPrinter& stream,
+                   const symbolic::Expression& epilogue, const std::string& out,
+                   const std::string& rows, const std::string& cols, const std::string& ld,
+                   bool nested) {
+    const std::string element = nested ? out + "[_i][_j]" : out + "[_i * " + ld + " + _j]";
+    auto value = symbolic::subs(epilogue, symbolic::symbol(out), symbolic::symbol(element));
+
+    stream << "#pragma omp parallel for" << std::endl
+           << "for (size_t _i = 0; _i < " << rows << "; _i++)" << std::endl
+           << "{" << std::endl;
+    stream.setIndent(stream.indent() + 4);
+    stream << "for (size_t _j = 0; _j < " << cols << "; _j++)" << std::endl
+           << "{" << std::endl;
+    stream.setIndent(stream.indent() + 4);
+    stream << element << " = " << language_extension.expression(value) << ";" << std::endl;
+    stream.setIndent(stream.indent() - 4);
+    stream << "}" << std::endl;
+    stream.setIndent(stream.indent() - 4);
+    stream << "}" << std::endl;
+}
+
+}  // namespace blas
+}  // namespace sdfg
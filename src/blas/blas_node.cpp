@@ -9,6 +9,7 @@
 #include <sdfg/symbolic/symbolic.h>
 
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace sdfg {
@@ -27,6 +28,28 @@ BLASNode::BLASNode(size_t element_id, const DebugInfo& debug_info, const graph::
 
 BLASType BLASNode::type() const { return this->type_; }
 
+bool BLASNode::resident_input(const std::string& conn) const {
+    return this->resident_inputs_.contains(conn);
+}
+
+void BLASNode::set_resident_input(const std::string& conn, bool resident) {
+    if (resident)
+        this->resident_inputs_.insert(conn);
+    else
+        this->resident_inputs_.erase(conn);
+}
+
+bool BLASNode::resident_output(const std::string& conn) const {
+    return this->resident_outputs_.contains(conn);
+}
+
+void BLASNode::set_resident_output(const std::string& conn, bool resident) {
+    if (resident)
+        this->resident_outputs_.insert(conn);
+    else
+        this->resident_outputs_.erase(conn);
+}
+
 symbolic::SymbolSet BLASNode::symbols() const { return {}; }
 
 void BLASNode::validate() const {
@@ -21,10 +21,13 @@ namespace blas {
 BLASNodeAxpy::BLASNodeAxpy(size_t element_id, const DebugInfo& debug_info,
                            const graph::Vertex vertex, data_flow::DataFlowGraph& parent,
                            const BLASType type, symbolic::Expression n, std::string alpha,
-                           std::string x, std::string y)
+                           std::string x, std::string y, symbolic::Expression incx,
+                           symbolic::Expression incy)
     : BLASNode(element_id, debug_info, vertex, parent, LibraryNodeType_BLAS_axpy, {y},
                {alpha, x, y}, type),
-      n_(n) {}
+      n_(n),
+      incx_(incx),
+      incy_(incy) {}
 
 symbolic::Expression BLASNodeAxpy::n() const { return this->n_; }
 
@@ -34,18 +37,23 @@ std::string BLASNodeAxpy::x() const { return this->input(1); }
 
 std::string BLASNodeAxpy::y() const { return this->input(2); }
 
+symbolic::Expression BLASNodeAxpy::incx() const { return this->incx_; }
+
+symbolic::Expression BLASNodeAxpy::incy() const { return this->incy_; }
+
 std::unique_ptr<data_flow::DataFlowNode> BLASNodeAxpy::clone(
     size_t element_id, const graph::Vertex vertex, data_flow::DataFlowGraph& parent) const {
     return std::make_unique<BLASNodeAxpy>(element_id, this->debug_info(), vertex, parent,
                                           this->type(), this->n(), this->alpha(), this->x(),
-                                          this->y());
+                                          this->y(), this->incx(), this->incy());
 }
 
 std::string BLASNodeAxpy::toStr() const {
     std::stringstream stream;
 
     stream << blasType2String(this->type()) << "axpy(" << this->n()->__str__() << ", "
-           << this->alpha() << ", " << this->x() << ", 1, " << this->y() << ", 1)";
+           << this->alpha() << ", " << this->x() << ", " << this->incx()->__str__() << ", "
+           << this->y() << ", " << this->incy()->__str__() << ")";
 
     return stream.str();
 }
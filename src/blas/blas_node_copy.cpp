@@ -21,9 +21,11 @@ namespace blas {
 BLASNodeCopy::BLASNodeCopy(size_t element_id, const DebugInfo& debug_info,
                            const graph::Vertex vertex, data_flow::DataFlowGraph& parent,
                            const BLASType type, symbolic::Expression n, std::string x,
-                           std::string y)
+                           std::string y, symbolic::Expression incx, symbolic::Expression incy)
     : BLASNode(element_id, debug_info, vertex, parent, LibraryNodeType_BLAS_copy, {y}, {x}, type),
-      n_(n) {}
+      n_(n),
+      incx_(incx),
+      incy_(incy) {}
 
 symbolic::Expression BLASNodeCopy::n() const { return this->n_; }
 
@@ -31,17 +33,23 @@ std::string BLASNodeCopy::x() const { return this->input(0); }
 
 std::string BLASNodeCopy::y() const { return this->output(0); }
 
+symbolic::Expression BLASNodeCopy::incx() const { return this->incx_; }
+
+symbolic::Expression BLASNodeCopy::incy() const { return this->incy_; }
+
 std::unique_ptr<data_flow::DataFlowNode> BLASNodeCopy::clone(
     size_t element_id, const graph::Vertex vertex, data_flow::DataFlowGraph& parent) const {
     return std::make_unique<BLASNodeCopy>(element_id, this->debug_info(), vertex, parent,
-                                          this->type(), this->n(), this->x(), this->y());
+                                          this->type(), this->n(), this->x(), this->y(),
+                                          this->incx(), this->incy());
 }
 
 std::string BLASNodeCopy::toStr() const {
     std::stringstream stream;
 
     stream << blasType2String(this->type()) << "copy(" << this->n()->__str__() << ", " << this->x()
-           << ", 1, " << this->y() << ", 1)";
+           << ", " << this->incx()->__str__() << ", " << this->y() << ", "
+           << this->incy()->__str__() << ")";
 
     return stream.str();
 }
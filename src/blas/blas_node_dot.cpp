@@ -20,10 +20,13 @@ namespace blas {
 
 BLASNodeDot::BLASNodeDot(size_t element_id, const DebugInfo& debug_info, const graph::Vertex vertex,
                          data_flow::DataFlowGraph& parent, std::string result, const BLASType type,
-                         symbolic::Expression n, std::string x, std::string y)
+                         symbolic::Expression n, std::string x, std::string y,
+                         symbolic::Expression incx, symbolic::Expression incy)
     : BLASNode(element_id, debug_info, vertex, parent, LibraryNodeType_BLAS_dot, {result},
                {x, y, result}, type),
-      n_(n) {}
+      n_(n),
+      incx_(incx),
+      incy_(incy) {}
 
 std::string BLASNodeDot::result() const { return this->output(0); }
 
@@ -33,18 +36,24 @@ std::string BLASNodeDot::x() const { return this->input(0); }
 
 std::string BLASNodeDot::y() const { return this->input(1); }
 
+symbolic::Expression BLASNodeDot::incx() const { return this->incx_; }
+
+symbolic::Expression BLASNodeDot::incy() const { return this->incy_; }
+
 std::unique_ptr<data_flow::DataFlowNode> BLASNodeDot::clone(
     size_t element_id, const graph::Vertex vertex, data_flow::DataFlowGraph& parent) const {
     return std::make_unique<BLASNodeDot>(element_id, this->debug_info(), vertex, parent,
                                          this->result(), this->type(), this->n(), this->x(),
-                                         this->y());
+                                         this->y(), this->incx(), this->incy());
 }
 
 std::string BLASNodeDot::toStr() const {
     std::stringstream stream;
 
     stream << this->result() << " = " << this->result() << " + " << blasType2String(this->type())
-           << "dot(" << this->n()->__str__() << ", " << this->x() << ", 1, " << this->y() << ", 1)";
+           << "dot(" << this->n()->__str__() << ", " << this->x() << ", "
+           << this->incx()->__str__() << ", " << this->y() << ", " << this->incy()->__str__()
+           << ")";
 
     return stream.str();
 }
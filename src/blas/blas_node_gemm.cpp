@@ -22,14 +22,21 @@ BLASNodeGemm::BLASNodeGemm(size_t element_id, const DebugInfo& debug_info,
                            const graph::Vertex vertex, data_flow::DataFlowGraph& parent,
                            const BLASType type, BLASTranspose transA, BLASTranspose transB,
                            symbolic::Expression m, symbolic::Expression n, symbolic::Expression k,
-                           std::string alpha, std::string A, std::string B, std::string C)
+                           std::string alpha, std::string A, std::string B, std::string C,
+                           symbolic::Expression lda, symbolic::Expression ldb,
+                           symbolic::Expression ldc, std::string beta,
+                           symbolic::Expression epilogue)
     : BLASNode(element_id, debug_info, vertex, parent, LibraryNodeType_BLAS_gemm, {C},
-               {alpha, A, B, C}, type),
+               {alpha, A, B, C, beta.empty() ? blasOne(type) : beta}, type),
       transA_(transA),
       transB_(transB),
       m_(m),
       n_(n),
-      k_(k) {}
+      k_(k),
+      lda_(lda.is_null() ? (transA == BLASTranspose_No ? k : m) : lda),
+      ldb_(ldb.is_null() ? (transB == BLASTranspose_No ? n : k) : ldb),
+      ldc_(ldc.is_null() ? n : ldc),
+      epilogue_(epilogue) {}
 
 BLASTranspose BLASNodeGemm::transA() const { return this->transA_; }
 
@@ -49,12 +56,23 @@ std::string BLASNodeGemm::B() const { return this->input(2); }
 
 std::string BLASNodeGemm::C() const { return this->input(3); }
 
+std::string BLASNodeGemm::beta() const { return this->input(4); }
+
+symbolic::Expression BLASNodeGemm::lda() const { return this->lda_; }
+
+symbolic::Expression BLASNodeGemm::ldb() const { return this->ldb_; }
+
+symbolic::Expression BLASNodeGemm::ldc() const { return this->ldc_; }
+
+symbolic::Expression BLASNodeGemm::epilogue() const { return this->epilogue_; }
+
 std::unique_ptr<data_flow::DataFlowNode> BLASNodeGemm::clone(
     size_t element_id, const graph::Vertex vertex, data_flow::DataFlowGraph& parent) const {
     return std::make_unique<BLASNodeGemm>(element_id, this->debug_info(), vertex, parent,
                                           this->type(), this->transA(), this->transB(), this->m(),
                                           this->n(), this->k(), this->alpha(), this->A(), this->B(),
-                                          this->C());
+                                          this->C(), this->lda(), this->ldb(), this->ldc(),
+                                          this->beta(), this->epilogue());
 }
 
 std::string BLASNodeGemm::toStr() const {
@@ -63,17 +81,10 @@ std::string BLASNodeGemm::toStr() const {
     stream << blasType2String(this->type()) << "gemm(" << blasTranspose2String(this->transA())
            << ", " << blasTranspose2String(this->transB()) << ", " << this->m()->__str__() << ", "
            << this->n()->__str__() << ", " << this->k()->__str__() << ", " << this->alpha() << ", "
-           << this->A() << ", ";
-    if (this->transA() == BLASTranspose_No)
-        stream << this->k()->__str__();
-    else
-        stream << this->m()->__str__();
-    stream << ", " << this->B() << ", ";
-    if (this->transB() == BLASTranspose_No)
-        stream << this->n()->__str__();
-    else
-        stream << this->k()->__str__();
-    stream << ", 1.0, " << this->C() << ", " << this->n()->__str__() << ")";
+           << this->A() << ", " << this->lda()->__str__() << ", " << this->B() << ", "
+           << this->ldb()->__str__() << ", " << this->beta() << ", " << this->C() << ", "
+           << this->ldc()->__str__() << ")";
+    if (!this->epilogue().is_null()) stream << " then " << this->epilogue()->__str__();
 
     return stream.str();
 }
@@ -0,0 +1,113 @@
+#include "sdfg/blas/blas_node_gemm_batched.h"
+
+#include <sdfg/data_flow/data_flow_graph.h>
+#include <sdfg/data_flow/data_flow_node.h>
+#include <sdfg/data_flow/library_node.h>
+#include <sdfg/element.h>
+#include <sdfg/exceptions.h>
+#include <sdfg/graph/graph.h>
+#include <sdfg/symbolic/symbolic.h>
+
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sdfg/blas/blas_node.h"
+
+namespace sdfg {
+namespace blas {
+
+BLASNodeGemmBatched::BLASNodeGemmBatched(
+    size_t element_id, const DebugInfo& debug_info, const graph::Vertex vertex,
+    data_flow::DataFlowGraph& parent, const BLASType type, BLASTranspose transA,
+    BLASTranspose transB,
+    const std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>& batch,
+    symbolic::Expression m, symbolic::Expression n, symbolic::Expression k, std::string alpha,
+    std::string A, std::string B, std::string C, std::string beta)
+    : BLASNode(element_id, debug_info, vertex, parent, LibraryNodeType_BLAS_gemm_batched, {C},
+               {alpha, A, B, C, beta.empty() ? blasOne(type) : beta}, type),
+      transA_(transA),
+      transB_(transB),
+      batch_(batch),
+      m_(m),
+      n_(n),
+      k_(k) {
+    if (batch.empty()) {
+        throw InvalidSDFGException("Batched gemm node needs at least one batch index");
+    }
+}
+
+BLASTranspose BLASNodeGemmBatched::transA() const { return this->transA_; }
+
+BLASTranspose BLASNodeGemmBatched::transB() const { return this->transB_; }
+
+const std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>& BLASNodeGemmBatched::batch()
+    const {
+    return this->batch_;
+}
+
+const symbolic::Symbol& BLASNodeGemmBatched::batch_indvar(size_t index) const {
+    return this->batch_.at(index).first;
+}
+
+const symbolic::Expression& BLASNodeGemmBatched::batch_size(size_t index) const {
+    return this->batch_.at(index).second;
+}
+
+symbolic::Expression BLASNodeGemmBatched::m() const { return this->m_; }
+
+symbolic::Expression BLASNodeGemmBatched::n() const { return this->n_; }
+
+symbolic::Expression BLASNodeGemmBatched::k() const { return this->k_; }
+
+std::string BLASNodeGemmBatched::alpha() const { return this->input(0); }
+
+std::string BLASNodeGemmBatched::A() const { return this->input(1); }
+
+std::string BLASNodeGemmBatched::B() const { return this->input(2); }
+
+std::string BLASNodeGemmBatched::C() const { return this->input(3); }
+
+std::string BLASNodeGemmBatched::beta() const { return this->input(4); }
+
+std::unique_ptr<data_flow::DataFlowNode> BLASNodeGemmBatched::clone(
+    size_t element_id, const graph::Vertex vertex, data_flow::DataFlowGraph& parent) const {
+    return std::make_unique<BLASNodeGemmBatched>(
+        element_id, this->debug_info(), vertex, parent, this->type(), this->transA(),
+        this->transB(), this->batch(), this->m(), this->n(), this->k(), this->alpha(), this->A(),
+        this->B(), this->C(), this->beta());
+}
+
+std::string BLASNodeGemmBatched::toStr() const {
+    std::stringstream stream;
+
+    std::stringstream batch_indices;
+    for (auto& batch : this->batch()) {
+        stream << "for " << batch.first->__str__() << " = 0:" << batch.second->__str__() << ": ";
+        batch_indices << "[" << batch.first->__str__() << "]";
+    }
+
+    stream << blasType2String(this->type()) << "gemm(" << blasTranspose2String(this->transA())
+           << ", " << blasTranspose2String(this->transB()) << ", " << this->m()->__str__() << ", "
+           << this->n()->__str__() << ", " << this->k()->__str__() << ", " << this->alpha() << ", "
+           << this->A() << batch_indices.str() << ", ";
+    if (this->transA() == BLASTranspose_No)
+        stream << this->k()->__str__();
+    else
+        stream << this->m()->__str__();
+    stream << ", " << this->B() << batch_indices.str() << ", ";
+    if (this->transB() == BLASTranspose_No)
+        stream << this->n()->__str__();
+    else
+        stream << this->k()->__str__();
+    stream << ", " << this->beta() << ", " << this->C() << batch_indices.str() << ", "
+           << this->n()->__str__() << ")";
+
+    return stream.str();
+}
+
+}  // namespace blas
+}  // namespace sdfg
@@ -20,12 +20,18 @@ BLASNodeGemv::BLASNodeGemv(size_t element_id, const DebugInfo& debug_info,
                            const graph::Vertex vertex, data_flow::DataFlowGraph& parent,
                            const BLASType type, BLASTranspose trans, symbolic::Expression m,
                            symbolic::Expression n, std::string alpha, std::string A, std::string x,
-                           std::string y)
+                           std::string y, symbolic::Expression lda, symbolic::Expression incx,
+                           symbolic::Expression incy, std::string beta,
+                           symbolic::Expression epilogue)
     : BLASNode(element_id, debug_info, vertex, parent, LibraryNodeType_BLAS_gemv, {y},
-               {alpha, A, x, y}, type),
+               {alpha, A, x, y, beta.empty() ? blasOne(type) : beta}, type),
       trans_(trans),
       m_(m),
-      n_(n) {}
+      n_(n),
+      lda_(lda.is_null() ? n : lda),
+      incx_(incx),
+      incy_(incy),
+      epilogue_(epilogue) {}
 
 BLASTranspose BLASNodeGemv::trans() const { return this->trans_; }
 
@@ -41,11 +47,23 @@ std::string BLASNodeGemv::x() const { return this->input(2); }
 
 std::string BLASNodeGemv::y() const { return this->input(3); }
 
+std::string BLASNodeGemv::beta() const { return this->input(4); }
+
+symbolic::Expression BLASNodeGemv::lda() const { return this->lda_; }
+
+symbolic::Expression BLASNodeGemv::incx() const { return this->incx_; }
+
+symbolic::Expression BLASNodeGemv::incy() const { return this->incy_; }
+
+symbolic::Expression BLASNodeGemv::epilogue() const { return this->epilogue_; }
+
 std::unique_ptr<data_flow::DataFlowNode> BLASNodeGemv::clone(
     size_t element_id, const graph::Vertex vertex, data_flow::DataFlowGraph& parent) const {
     return std::make_unique<BLASNodeGemv>(element_id, this->debug_info(), vertex, parent,
                                           this->type(), this->trans(), this->m(), this->n(),
-                                          this->alpha(), this->A(), this->x(), this->y());
+                                          this->alpha(), this->A(), this->x(), this->y(),
+                                          this->lda(), this->incx(), this->incy(), this->beta(),
+                                          this->epilogue());
 }
 
 std::string BLASNodeGemv::toStr() const {
@@ -53,8 +71,10 @@ std::string BLASNodeGemv::toStr() const {
 
     stream << blasType2String(this->type()) << "gemv(" << blasTranspose2String(this->trans())
            << ", " << this->m()->__str__() << ", " << this->n()->__str__() << ", " << this->alpha()
-           << ", " << this->A() << ", " << this->n()->__str__() << ", " << this->x() << ", 1, 1.0, "
-           << this->y() << ", 1)";
+           << ", " << this->A() << ", " << this->lda()->__str__() << ", " << this->x() << ", "
+           << this->incx()->__str__() << ", " << this->beta() << ", " << this->y() << ", "
+           << this->incy()->__str__() << ")";
+    if (!this->epilogue().is_null()) stream << " then " << this->epilogue()->__str__();
 
     return stream.str();
 }
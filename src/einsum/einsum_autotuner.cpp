@@ -0,0 +1,389 @@
+#include "sdfg/einsum/einsum_autotuner.h"
+
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/codegen/code_generators/c_code_generator.h>
+#include <sdfg/codegen/dispatchers/node_dispatcher_registry.h>
+#include <sdfg/codegen/language_extensions/c_language_extension.h>
+#include <sdfg/data_flow/access_node.h>
+#include <sdfg/data_flow/library_node.h>
+#include <sdfg/data_flow/memlet.h>
+#include <sdfg/function.h>
+#include <sdfg/structured_control_flow/block.h>
+#include <sdfg/structured_sdfg.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/types/pointer.h>
+#include <sdfg/types/scalar.h>
+#include <sdfg/types/type.h>
+#include <symengine/integer.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "sdfg/blas/blas_dispatcher.h"
+#include "sdfg/blas/blas_node.h"
+#include "sdfg/einsum/einsum_dispatcher.h"
+#include "sdfg/einsum/einsum_node.h"
+#include "sdfg/einsum/einsum_tuning.h"
+#include "sdfg/transformations/einsum2blas.h"
+
+namespace sdfg {
+namespace einsum {
+
+namespace {
+
+// Restores the caller's dispatchers of einsum and BLAS nodes after a benchmark was generated
+class DispatcherRestore {
+    std::vector<std::pair<std::string, codegen::LibraryNodeDispatcherFn>> previous_;
+
+   public:
+    DispatcherRestore() {
+        auto& registry = codegen::LibraryNodeDispatcherRegistry::instance();
+        for (auto& code :
+             {LibraryNodeType_Einsum.value(), blas::LibraryNodeType_BLAS_axpy.value(),
+              blas::LibraryNodeType_BLAS_copy.value(), blas::LibraryNodeType_BLAS_dot.value(),
+              blas::LibraryNodeType_BLAS_gemv.value(), blas::LibraryNodeType_BLAS_symv.value(),
+              blas::LibraryNodeType_BLAS_ger.value(), blas::LibraryNodeType_BLAS_syr.value(),
+              blas::LibraryNodeType_BLAS_gemm.value(),
+              blas::LibraryNodeType_BLAS_gemm_batched.value(),
+              blas::LibraryNodeType_BLAS_symm.value(), blas::LibraryNodeType_BLAS_syrk.value()}) {
+            this->previous_.push_back({code, registry.get_library_node_dispatcher(code)});
+        }
+    }
+
+    ~DispatcherRestore() {
+        auto& registry = codegen::LibraryNodeDispatcherRegistry::instance();
+        for (auto& previous : this->previous_) {
+            registry.register_library_node_dispatcher(previous.first, previous.second);
+        }
+    }
+};
+
+}  // namespace
+
+std::unique_ptr<StructuredSDFG> EinsumAutotuner::benchmark_sdfg(
+    EinsumNode*& einsum_node, std::vector<std::string>& arguments) {
+    builder::StructuredSDFGBuilder builder("einsum_benchmark", FunctionType_CPU);
+    auto& dfg = this->einsum_node_.get_parent();
+    arguments.clear();
+
+    // The map variables are locals and the other symbols are arguments
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    std::unordered_set<std::string> containers;
+    for (auto& map : this->einsum_node_.maps()) {
+        builder.add_container(map.first->get_name(), sym_desc);
+        containers.insert(map.first->get_name());
+    }
+    for (auto& symbol : this->einsum_node_.symbols()) {
+        if (containers.contains(symbol->get_name())) continue;
+        builder.add_container(symbol->get_name(), sym_desc, true);
+        containers.insert(symbol->get_name());
+        arguments.push_back(symbol->get_name());
+    }
+
+    // Copy the einsum node and its operands
+    auto& block = builder.add_block(builder.subject().root());
+    auto& libnode = builder.copy_library_node(block, this->einsum_node_);
+    auto add_operand = [&](const std::string& container) -> data_flow::AccessNode& {
+        if (!containers.contains(container)) {
+            builder.add_container(container, this->sdfg_.type(container), true);
+            containers.insert(container);
+            arguments.push_back(container);
+        }
+        return builder.add_access(block, container);
+    };
+    for (auto& iedge : dfg.in_edges(this->einsum_node_)) {
+        if (!iedge.subset().empty()) return nullptr;
+        auto& src = dynamic_cast<const data_flow::AccessNode&>(iedge.src());
+        builder.add_memlet(block, add_operand(src.data()), "void", libnode, iedge.dst_conn(), {});
+    }
+    for (auto& oedge : dfg.out_edges(this->einsum_node_)) {
+        if (!oedge.subset().empty()) return nullptr;
+        auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+        builder.add_memlet(block, libnode, oedge.src_conn(), add_operand(dst.data()), "void", {});
+    }
+
+    einsum_node = dynamic_cast<EinsumNode*>(&libnode);
+    return builder.move();
+}
+
+bool EinsumAutotuner::extents(const data_flow::Subset& indices, std::vector<long long>& result) {
+    result.clear();
+    for (auto& index : indices) {
+        bool found = false;
+        for (size_t i = 0; i < this->einsum_node_.maps().size(); ++i) {
+            if (!symbolic::eq(index, this->einsum_node_.indvar(i))) continue;
+
+            // Evaluate the bound with the representative sizes
+            symbolic::Expression bound = this->einsum_node_.num_iteration(i);
+            for (auto& size : this->options_.sizes) {
+                bound = symbolic::subs(bound, symbolic::symbol(size.first),
+                                       symbolic::integer(size.second));
+            }
+            if (bound->get_type_code() != SymEngine::TypeID::SYMENGINE_INTEGER) return false;
+            result.push_back(SymEngine::rcp_static_cast<const SymEngine::Integer>(bound)->as_int());
+            found = true;
+            break;
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+EinsumAutotuner::EinsumAutotuner(StructuredSDFG& sdfg, EinsumNode& einsum_node,
+                                 const EinsumAutotunerOptions& options)
+    : sdfg_(sdfg), einsum_node_(einsum_node), options_(options) {}
+
+std::vector<EinsumVariant> EinsumAutotuner::variants() {
+    std::vector<EinsumVariant> result;
+
+    // Loop nests of the EinsumDispatcher
+    for (bool loop_interchange : {false, true}) {
+        for (size_t tiling_cache_size : {0, 32768, 262144}) {
+            for (bool vectorize : {false, true}) {
+                if (vectorize && this->einsum_node_.getOutInputIndex() < 0) continue;
+                EinsumVariant variant;
+                variant.options.loop_interchange = loop_interchange;
+                variant.options.tiling = tiling_cache_size > 0;
+                if (variant.options.tiling) variant.options.tiling_cache_size = tiling_cache_size;
+                variant.options.vectorize = vectorize;
+                result.push_back(variant);
+            }
+        }
+    }
+
+    // Fully unrolled loop nest if all bounds are constants, e.g., for 4x4 blocks
+    bool constant_bounds = true;
+    for (auto& map : this->einsum_node_.maps()) {
+        if (map.second->get_type_code() != SymEngine::TypeID::SYMENGINE_INTEGER)
+            constant_bounds = false;
+    }
+    if (constant_bounds) {
+        EinsumVariant variant;
+        variant.options.unroll_iterations = 512;
+        result.push_back(variant);
+    }
+
+    // BLAS routines
+    EinsumNode* einsum_node = nullptr;
+    std::vector<std::string> arguments;
+    auto sdfg = this->benchmark_sdfg(einsum_node, arguments);
+    if (!sdfg) return result;
+    builder::StructuredSDFGBuilder builder(sdfg);
+    analysis::AnalysisManager analysis_manager(builder.subject());
+    transformations::Einsum2BLAS transformation(*einsum_node);
+    for (auto& routine : transformation.candidates(builder, analysis_manager)) {
+        EinsumVariant variant;
+        variant.lowering = routine;
+        result.push_back(variant);
+    }
+
+    return result;
+}
+
+std::string EinsumAutotuner::benchmark_source(const EinsumVariant& variant) {
+    EinsumNode* einsum_node = nullptr;
+    std::vector<std::string> arguments;
+    auto sdfg = this->benchmark_sdfg(einsum_node, arguments);
+    if (!sdfg) return "";
+
+    // Indices of the operands
+    std::unordered_map<std::string, data_flow::Subset> operand_indices;
+    auto& dfg = this->einsum_node_.get_parent();
+    for (auto& iedge : dfg.in_edges(this->einsum_node_)) {
+        auto& src = dynamic_cast<const data_flow::AccessNode&>(iedge.src());
+        for (size_t i = 0; i < this->einsum_node_.inputs().size(); ++i) {
+            if (this->einsum_node_.input(i) == iedge.dst_conn())
+                operand_indices.insert({src.data(), this->einsum_node_.in_indices(i)});
+        }
+    }
+    for (auto& oedge : dfg.out_edges(this->einsum_node_)) {
+        auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+        for (size_t i = 0; i < this->einsum_node_.outputs().size(); ++i) {
+            if (this->einsum_node_.output(i) == oedge.src_conn())
+                operand_indices.insert({dst.data(), this->einsum_node_.out_indices(i)});
+        }
+    }
+
+    // Apply the BLAS routine of the variant
+    if (!variant.lowering.empty()) {
+        builder::StructuredSDFGBuilder builder(sdfg);
+        analysis::AnalysisManager analysis_manager(builder.subject());
+        transformations::Einsum2BLAS transformation(*einsum_node, 0, variant.lowering);
+        if (!transformation.can_be_applied(builder, analysis_manager)) return "";
+        transformation.apply(builder, analysis_manager);
+        sdfg = builder.move();
+    }
+
+    // Generate the code with the dispatchers of the variant, which are only registered until the
+    // code is generated
+    DispatcherRestore restore;
+    EinsumDispatcherOptions options = variant.options;
+    options.database = nullptr;
+    register_einsum_dispatcher(options);
+    blas::register_blas_dispatchers(this->options_.blas_implementation);
+    codegen::CCodeGenerator generator(*sdfg);
+    if (!generator.generate()) return "";
+
+    std::stringstream source;
+    source << "#include <math.h>" << std::endl
+           << "#include <stdint.h>" << std::endl
+           << "#include <stdio.h>" << std::endl
+           << "#include <stdlib.h>" << std::endl
+           << "#include <time.h>" << std::endl;
+    switch (this->options_.blas_implementation) {
+        case blas::BLASImplementation_CBLAS:
+            source << "#include <cblas.h>" << std::endl;
+            break;
+        case blas::BLASImplementation_CUBLAS:
+            source << "#include <cublas_v2.h>" << std::endl
+                   << "#include \"sdfg/blas/runtime/sdfg_cublas.h\"" << std::endl;
+            break;
+        case blas::BLASImplementation_Native:
+            source << "#include \"sdfg/blas/runtime/sdfg_blas.h\"" << std::endl;
+            break;
+    }
+    source << std::endl
+           << generator.function_definition() << std::endl
+           << "{" << std::endl
+           << generator.main().str() << "}" << std::endl
+           << std::endl;
+
+    // Allocates nested arrays for the loop nest and packed arrays for BLAS
+    source << "static void *benchmark_alloc(const long long *extents, int depth, size_t size) {"
+           << std::endl
+           << "    if (depth == 1) return calloc(extents[0], size);" << std::endl
+           << "    void **ptrs = malloc(extents[0] * sizeof(void *));" << std::endl
+           << "    for (long long i = 0; i < extents[0]; ++i)" << std::endl
+           << "        ptrs[i] = benchmark_alloc(extents + 1, depth - 1, size);" << std::endl
+           << "    return ptrs;" << std::endl
+           << "}" << std::endl
+           << std::endl
+           << "static double benchmark_now(void) {" << std::endl
+           << "    struct timespec t;" << std::endl
+           << "    clock_gettime(CLOCK_MONOTONIC, &t);" << std::endl
+           << "    return t.tv_sec + 1e-9 * t.tv_nsec;" << std::endl
+           << "}" << std::endl
+           << std::endl
+           << "int main(void) {" << std::endl;
+
+    codegen::CLanguageExtension language_extension;
+    std::stringstream call;
+    call << sdfg->name() << "(";
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        if (i > 0) call << ", ";
+        auto& argument = arguments[i];
+
+        // Symbols
+        if (!operand_indices.contains(argument)) {
+            if (!this->options_.sizes.contains(argument)) return "";
+            call << this->options_.sizes.at(argument);
+            continue;
+        }
+
+        // Scalars
+        auto& type = sdfg->type(argument);
+        if (!dynamic_cast<const types::Pointer*>(&type)) {
+            call << "1";
+            continue;
+        }
+
+        // Arrays
+        std::vector<long long> shape;
+        if (!this->extents(operand_indices.at(argument), shape)) return "";
+        if (!variant.lowering.empty() || shape.empty()) {
+            long long size = 1;
+            for (long long extent : shape) size *= extent;
+            shape = {size};
+        }
+        std::string element =
+            language_extension.declaration("", types::Scalar(type.primitive_type()));
+        while (!element.empty() && element.back() == ' ') element.pop_back();
+        source << "    const long long extents_" << argument << "[] = {";
+        for (size_t j = 0; j < shape.size(); ++j) {
+            if (j > 0) source << ", ";
+            source << shape[j];
+        }
+        source << "};" << std::endl
+               << "    void *" << argument << " = benchmark_alloc(extents_" << argument << ", "
+               << shape.size() << ", sizeof(" << element << "));" << std::endl;
+        call << argument;
+    }
+    call << ");";
+
+    source << std::endl
+           << "    double best = -1.0;" << std::endl
+           << "    for (int r = 0; r <= " << this->options_.repetitions << "; ++r) {" << std::endl
+           << "        double start = benchmark_now();" << std::endl
+           << "        " << call.str() << std::endl
+           << "        double time = benchmark_now() - start;" << std::endl
+           << "        if (r > 0 && (best < 0.0 || time < best)) best = time;" << std::endl
+           << "    }" << std::endl
+           << "    printf(\"%.9f\\n\", best);" << std::endl
+           << "    return 0;" << std::endl
+           << "}" << std::endl;
+
+    return source.str();
+}
+
+double EinsumAutotuner::measure(const EinsumVariant& variant) {
+    std::string source = this->benchmark_source(variant);
+    if (source.empty()) return -1.0;
+
+    std::filesystem::path dir = this->options_.work_dir.empty()
+                                    ? std::filesystem::temp_directory_path()
+                                    : std::filesystem::path(this->options_.work_dir);
+    // Benchmarks of different einsums in the same directory must not overwrite each other
+    std::string key =
+        EinsumTuningDatabase::key(this->sdfg_, this->einsum_node_.get_parent(), this->einsum_node_);
+    std::string stem =
+        "sdfg_einsum_benchmark_" +
+        std::to_string(std::hash<std::string>{}(
+            key + "\n" + std::to_string(this->einsum_node_.element_id()) + "\n" +
+            variant.toStr()));
+    std::filesystem::path src = dir / (stem + ".c");
+    std::filesystem::path bin = dir / stem;
+    std::filesystem::path out = dir / (stem + ".out");
+    {
+        std::ofstream file(src);
+        if (!file) return -1.0;
+        file << source;
+    }
+
+    // Compile and run the benchmark
+    std::string command = this->options_.compile_command;
+    for (auto& placeholder : {std::make_pair(std::string("{src}"), src.string()),
+                              std::make_pair(std::string("{bin}"), bin.string())}) {
+        for (size_t pos = command.find(placeholder.first); pos != std::string::npos;
+             pos = command.find(placeholder.first, pos + placeholder.second.size())) {
+            command.replace(pos, placeholder.first.size(), placeholder.second);
+        }
+    }
+    if (std::system(command.c_str()) != 0) return -1.0;
+    if (std::system((bin.string() + " > " + out.string()).c_str()) != 0) return -1.0;
+
+    std::ifstream result(out);
+    double time = -1.0;
+    if (!(result >> time)) return -1.0;
+    return time;
+}
+
+const EinsumVariant* EinsumAutotuner::tune(EinsumTuningDatabase& database) {
+    std::string key =
+        EinsumTuningDatabase::key(this->sdfg_, this->einsum_node_.get_parent(), this->einsum_node_);
+    for (auto& variant : this->variants()) database.record(key, variant, this->measure(variant));
+    return database.lookup(key);
+}
+
+}  // namespace einsum
+}  // namespace sdfg
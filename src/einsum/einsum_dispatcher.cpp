@@ -6,29 +6,40 @@
 #include <sdfg/data_flow/data_flow_graph.h>
 #include <sdfg/data_flow/library_node.h>
 #include <sdfg/data_flow/memlet.h>
+#include <sdfg/exceptions.h>
 #include <sdfg/function.h>
 #include <sdfg/symbolic/symbolic.h>
 #include <sdfg/types/type.h>
 #include <sdfg/types/utils.h>
+#include <symengine/integer.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <iostream>
 #include <list>
 #include <set>
+#include <sstream>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "sdfg/einsum/einsum_node.h"
+#include "sdfg/einsum/einsum_tuning.h"
 
 namespace sdfg {
 namespace einsum {
 
 std::vector<size_t> EinsumDispatcher::get_outer_maps(const EinsumNode& einsum_node) {
+    return this->get_outer_maps(einsum_node, einsum_node.out_indices());
+}
+
+std::vector<size_t> EinsumDispatcher::get_outer_maps(const EinsumNode& einsum_node,
+                                                     const data_flow::Subset& out_indices) {
     std::vector<size_t> result;
     std::set<size_t> used;
 
-    for (auto& out_index : einsum_node.out_indices()) {
+    for (auto& out_index : out_indices) {
         for (size_t i = 0; i < einsum_node.maps().size(); ++i) {
             if (used.contains(i) || !symbolic::uses(out_index, einsum_node.indvar(i))) continue;
 
@@ -90,11 +101,407 @@ std::vector<size_t> EinsumDispatcher::get_inner_maps(const EinsumNode& einsum_no
     return result;
 }
 
+size_t EinsumDispatcher::get_stride_cost(const EinsumNode& einsum_node, size_t map) {
+    // The cost of a map is the sum of the (row-major) stride ranks of the dimensions it indexes
+    // over all operands. A rank of zero denotes the unit stride dimension.
+    std::vector<data_flow::Subset> subsets = {einsum_node.out_indices()};
+    for (auto& indices : einsum_node.in_indices()) {
+        if (indices.size() > 0) subsets.push_back(indices);
+    }
+
+    size_t cost = 0;
+    for (auto& subset : subsets) {
+        for (size_t i = subset.size(); i > 0; --i) {
+            if (symbolic::uses(subset[i - 1], einsum_node.indvar(map))) {
+                cost += subset.size() - i;
+                break;
+            }
+        }
+    }
+    return cost;
+}
+
+void EinsumDispatcher::interchange_maps(const EinsumNode& einsum_node, std::vector<size_t>& maps) {
+    std::vector<size_t> result;
+    std::set<size_t> remaining(maps.begin(), maps.end());
+
+    // Greedily place the map with the highest stride cost outermost among all maps whose bound
+    // does not depend on a map that is not placed yet. Ties keep the original order.
+    while (!remaining.empty()) {
+        size_t best = maps.size();
+        size_t best_cost = 0;
+        for (size_t i = 0; i < maps.size(); ++i) {
+            if (!remaining.contains(maps[i])) continue;
+
+            bool ready = true;
+            for (size_t map : remaining) {
+                if (map != maps[i] && symbolic::uses(einsum_node.num_iteration(maps[i]),
+                                                     einsum_node.indvar(map))) {
+                    ready = false;
+                    break;
+                }
+            }
+            if (!ready) continue;
+
+            size_t cost = this->get_stride_cost(einsum_node, maps[i]);
+            if (best == maps.size() || cost > best_cost) {
+                best = i;
+                best_cost = cost;
+            }
+        }
+
+        // Cyclic bound dependencies cannot be resolved, keep the original order
+        if (best == maps.size()) return;
+
+        result.push_back(maps[best]);
+        remaining.erase(maps[best]);
+    }
+
+    maps = result;
+}
+
+std::unordered_map<size_t, size_t> EinsumDispatcher::get_tile_sizes(
+    const EinsumNode& einsum_node, const std::vector<size_t>& outer_maps,
+    const std::vector<size_t>& inner_maps, types::PrimitiveType primitive_type) {
+    std::unordered_map<size_t, size_t> result;
+
+    // Only rectangular iteration spaces are tiled
+    for (size_t i = 0; i < einsum_node.maps().size(); ++i) {
+        for (size_t j = 0; j < einsum_node.maps().size(); ++j) {
+            if (symbolic::uses(einsum_node.num_iteration(i), einsum_node.indvar(j))) return result;
+        }
+    }
+
+    // Inner maps can only be tiled if the output is accumulated. The output is written back once
+    // per tile of the inner maps, so they stay untiled if an epilogue must be applied only once.
+    std::vector<size_t> candidates(outer_maps.begin(), outer_maps.end());
+    if (einsum_node.getOutInputIndex() >= 0 && !einsum_node.has_epilogue())
+        candidates.insert(candidates.end(), inner_maps.begin(), inner_maps.end());
+    if (candidates.size() < 2) return result;
+
+    size_t element_size;
+    switch (primitive_type) {
+        case types::PrimitiveType::Bool:
+        case types::PrimitiveType::Int8:
+        case types::PrimitiveType::UInt8:
+            element_size = 1;
+            break;
+        case types::PrimitiveType::Int16:
+        case types::PrimitiveType::UInt16:
+            element_size = 2;
+            break;
+        case types::PrimitiveType::Int32:
+        case types::PrimitiveType::UInt32:
+        case types::PrimitiveType::Float:
+            element_size = 4;
+            break;
+        default:
+            element_size = 8;
+            break;
+    }
+
+    // Collect the maps accessed by every operand (output and non-scalar inputs)
+    std::vector<std::vector<size_t>> operands;
+    std::vector<data_flow::Subset> subsets = {einsum_node.out_indices()};
+    for (auto& indices : einsum_node.in_indices()) {
+        if (indices.size() > 0) subsets.push_back(indices);
+    }
+    for (auto& subset : subsets) {
+        std::vector<size_t> operand;
+        for (size_t i = 0; i < einsum_node.maps().size(); ++i) {
+            for (auto& index : subset) {
+                if (symbolic::uses(index, einsum_node.indvar(i))) {
+                    operand.push_back(i);
+                    break;
+                }
+            }
+        }
+        operands.push_back(operand);
+    }
+
+    // Choose the largest tile size such that the tiles of all operands fit into the cache budget.
+    // Maps with a constant number of iterations not larger than the tile size stay untiled.
+    size_t tile_size;
+    for (tile_size = 1024; tile_size > 8; tile_size /= 2) {
+        size_t working_set = 0;
+        for (auto& operand : operands) {
+            size_t footprint = element_size;
+            for (size_t map : operand) {
+                auto& bound = einsum_node.num_iteration(map);
+                if (bound->get_type_code() == SymEngine::TypeID::SYMENGINE_INTEGER) {
+                    size_t extent = SymEngine::rcp_static_cast<const SymEngine::Integer>(bound)
+                                        ->as_uint();
+                    footprint *= std::min(extent, tile_size);
+                } else {
+                    footprint *= tile_size;
+                }
+            }
+            working_set += footprint;
+        }
+        if (working_set <= this->options_.tiling_cache_size) break;
+    }
+
+    for (size_t map : candidates) {
+        auto& bound = einsum_node.num_iteration(map);
+        if (bound->get_type_code() == SymEngine::TypeID::SYMENGINE_INTEGER &&
+            SymEngine::rcp_static_cast<const SymEngine::Integer>(bound)->as_uint() <= tile_size)
+            continue;
+        result.insert({map, tile_size});
+    }
+
+    return result;
+}
+
+std::string EinsumDispatcher::reduction_identity(ReductionType reduction,
+                                                 types::PrimitiveType primitive_type) {
+    if (reduction == ReductionType_Sum) return "0";
+    if (reduction == ReductionType_Prod) return "1";
+
+    // Identities of max and min are the lowest and highest value of the type
+    bool max = reduction == ReductionType_Max;
+    switch (primitive_type) {
+        case types::PrimitiveType::Bool:
+            return max ? "0" : "1";
+        case types::PrimitiveType::Int8:
+            return max ? "INT8_MIN" : "INT8_MAX";
+        case types::PrimitiveType::Int16:
+            return max ? "INT16_MIN" : "INT16_MAX";
+        case types::PrimitiveType::Int32:
+            return max ? "INT32_MIN" : "INT32_MAX";
+        case types::PrimitiveType::Int64:
+            return max ? "INT64_MIN" : "INT64_MAX";
+        case types::PrimitiveType::UInt8:
+            return max ? "0" : "UINT8_MAX";
+        case types::PrimitiveType::UInt16:
+            return max ? "0" : "UINT16_MAX";
+        case types::PrimitiveType::UInt32:
+            return max ? "0" : "UINT32_MAX";
+        case types::PrimitiveType::UInt64:
+            return max ? "0" : "UINT64_MAX";
+        default:
+            return max ? "-INFINITY" : "INFINITY";
+    }
+}
+
+std::string EinsumDispatcher::reduction_operator(ReductionType reduction) {
+    switch (reduction) {
+        case ReductionType_Sum:
+            return "+";
+        case ReductionType_Max:
+            return "max";
+        case ReductionType_Min:
+            return "min";
+        case ReductionType_Prod:
+            return "*";
+    }
+    return "+";
+}
+
+data_flow::Subset EinsumDispatcher::substitute(const data_flow::Subset& subset,
+                                               const Iteration& iteration) {
+    data_flow::Subset result;
+    for (auto index : subset) {
+        for (auto& value : iteration) index = symbolic::subs(index, value.first, value.second);
+        result.push_back(index);
+    }
+    return result;
+}
+
+bool EinsumDispatcher::expand_iterations(const EinsumNode& einsum_node,
+                                         const std::vector<size_t>& maps, size_t max_iterations,
+                                         std::vector<Iteration>& iterations) {
+    for (size_t map : maps) {
+        std::vector<Iteration> expanded;
+        for (auto& iteration : iterations) {
+            // Bounds may depend on the indvars of enclosing maps
+            symbolic::Expression bound = einsum_node.num_iteration(map);
+            for (auto& value : iteration) bound = symbolic::subs(bound, value.first, value.second);
+            if (bound->get_type_code() != SymEngine::TypeID::SYMENGINE_INTEGER) return false;
+            long long num_iterations =
+                SymEngine::rcp_static_cast<const SymEngine::Integer>(bound)->as_int();
+            for (long long i = 0; i < num_iterations; ++i) {
+                if (expanded.size() >= max_iterations) return false;
+                expanded.push_back(iteration);
+                expanded.back().push_back({einsum_node.indvar(map), symbolic::integer(i)});
+            }
+        }
+        iterations = std::move(expanded);
+    }
+    return true;
+}
+
+std::string EinsumDispatcher::term_value(
+    const EinsumNode& einsum_node, size_t output,
+    const std::unordered_map<std::string, const types::IType&>& src_types,
+    const Iteration& iteration) {
+    std::stringstream value;
+    bool first_term = true;
+    for (size_t t = 0; t < einsum_node.terms().size(); ++t) {
+        if (einsum_node.term_output(t) != output) continue;
+        if (!first_term) value << " + ";
+        first_term = false;
+        bool first_mul = false;
+        for (size_t i : einsum_node.term(t)) {
+            if (first_mul) value << " * ";
+            first_mul = true;
+            if (einsum_node.in_indices(i).size() > 0) {
+                value << einsum_node.input(i);
+                value << this->language_extension_.subset(
+                    this->function_, src_types.at(einsum_node.input(i)),
+                    substitute(einsum_node.in_indices(i), iteration));
+            } else {
+                if (src_types.contains(einsum_node.input(i)) &&
+                    dynamic_cast<const types::Pointer*>(&src_types.at(einsum_node.input(i))))
+                    value << "*";
+                value << einsum_node.input(i);
+            }
+        }
+    }
+    return value.str();
+}
+
+std::string EinsumDispatcher::reduction_update(
+    const EinsumNode& einsum_node, size_t output, const std::string& out,
+    const std::unordered_map<std::string, const types::IType&>& src_types,
+    const Iteration& iteration) {
+    std::string value = this->term_value(einsum_node, output, src_types, iteration);
+    size_t num_terms = std::count(einsum_node.term_outputs().begin(),
+                                  einsum_node.term_outputs().end(), output);
+    switch (einsum_node.reduction()) {
+        case ReductionType_Sum:
+            return out + " + " + value;
+        case ReductionType_Prod:
+            if (num_terms > 1) return out + " * (" + value + ")";
+            return out + " * " + value;
+        case ReductionType_Max:
+            return out + " > " + value + " ? " + out + " : " + value;
+        case ReductionType_Min:
+            return out + " < " + value + " ? " + out + " : " + value;
+    }
+    return out + " + " + value;
+}
+
+EinsumDispatcherOptions EinsumDispatcher::tuned_options(
+    const Function& function, const data_flow::DataFlowGraph& data_flow_graph,
+    const data_flow::LibraryNode& node, const EinsumDispatcherOptions& options) {
+    if (!options.database) return options;
+
+    const auto& einsum_node = dynamic_cast<const EinsumNode&>(node);
+    auto* variant = options.database->lookup(
+        EinsumTuningDatabase::key(function, data_flow_graph, einsum_node));
+    if (!variant || !variant->lowering.empty()) return options;
+
+    EinsumDispatcherOptions result = variant->options;
+    result.database = options.database;
+    return result;
+}
+
 EinsumDispatcher::EinsumDispatcher(codegen::LanguageExtension& language_extension,
                                    const Function& function,
                                    const data_flow::DataFlowGraph& data_flow_graph,
-                                   const data_flow::LibraryNode& node)
-    : codegen::LibraryNodeDispatcher(language_extension, function, data_flow_graph, node) {}
+                                   const data_flow::LibraryNode& node,
+                                   const EinsumDispatcherOptions& options)
+    : codegen::LibraryNodeDispatcher(language_extension, function, data_flow_graph, node),
+      options_(tuned_options(function, data_flow_graph, node, options)) {}
+
+void EinsumDispatcher::dispatch_sequential(codegen::PrettyPrinter& stream,
+                                           const EinsumNode& einsum_node) {
+    // Connectors point to their containers, the outputs are read and written in place
+    std::unordered_map<std::string, const types::IType&> src_types;
+    auto declare = [&](const std::string& conn_name, const std::string& container,
+                       const data_flow::Subset& subset) {
+        if (src_types.contains(conn_name)) return;
+        const types::IType& type = this->function_.type(container);
+        src_types.insert({conn_name, type});
+        stream << this->language_extension_.declaration(
+                      conn_name, types::infer_type(function_, type, subset))
+               << " = " << container
+               << this->language_extension_.subset(function_, type, subset) << ";" << std::endl;
+    };
+    for (auto& iedge : this->data_flow_graph_.in_edges(this->node_)) {
+        auto& src = dynamic_cast<const data_flow::AccessNode&>(iedge.src());
+        declare(iedge.dst_conn(), src.data(), iedge.subset());
+    }
+    for (auto& oedge : this->data_flow_graph_.out_edges(this->node_)) {
+        auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+        declare(oedge.src_conn(), dst.data(), oedge.subset());
+    }
+
+    stream << std::endl;
+
+    auto element = [&](size_t output) {
+        const std::string& out = einsum_node.output(output);
+        auto& indices = einsum_node.out_indices(output);
+        if (indices.empty() && dynamic_cast<const types::Pointer*>(&src_types.at(out)))
+            return "*" + out;
+        return out + this->language_extension_.subset(this->function_, src_types.at(out), indices);
+    };
+    auto loop = [&](size_t map) {
+        const std::string indvar = einsum_node.indvar(map)->__str__();
+        stream << "for (" << indvar << " = 0; " << indvar << " < "
+               << this->language_extension_.expression(einsum_node.num_iteration(map)) << "; "
+               << indvar << "++)" << std::endl
+               << "{" << std::endl;
+        stream.setIndent(stream.indent() + 4);
+    };
+    auto close_loops = [&](size_t num_loops) {
+        for (size_t i = 0; i < num_loops; ++i) {
+            stream.setIndent(stream.indent() - 4);
+            stream << "}" << std::endl;
+        }
+    };
+
+    // Outputs which are not read start from the identity of the reduction
+    if (einsum_node.getOutInputIndex() < 0) {
+        for (size_t output = 0; output < einsum_node.outputs().size(); ++output) {
+            auto maps = this->get_outer_maps(einsum_node, einsum_node.out_indices(output));
+            for (size_t map : maps) loop(map);
+            stream << element(output) << " = "
+                   << this->reduction_identity(einsum_node.reduction(),
+                                               src_types.at(einsum_node.output(output))
+                                                   .primitive_type())
+                   << ";" << std::endl;
+            close_loops(maps.size());
+        }
+        stream << std::endl;
+    }
+
+    // One loop nest over all maps updates every output in each iteration
+    std::vector<size_t> maps = this->get_outer_maps(einsum_node);
+    std::vector<size_t> inner_maps = this->get_inner_maps(einsum_node);
+    maps.insert(maps.end(), inner_maps.begin(), inner_maps.end());
+    if (this->options_.loop_interchange) this->interchange_maps(einsum_node, maps);
+
+    // The outermost loop is parallelized if every thread owns distinct elements of all outputs
+    bool parallel = !maps.empty();
+    for (size_t i = 0; parallel && i < einsum_node.maps().size(); ++i) {
+        if (symbolic::uses(einsum_node.num_iteration(maps.front()), einsum_node.indvar(i)))
+            parallel = false;
+    }
+    for (size_t output = 0; parallel && output < einsum_node.outputs().size(); ++output) {
+        auto& indices = einsum_node.out_indices(output);
+        parallel = std::any_of(indices.begin(), indices.end(), [&](auto& index) {
+            return symbolic::eq(index, einsum_node.indvar(maps.front()));
+        });
+    }
+    if (parallel) {
+        stream << "#pragma omp parallel for private(";
+        for (size_t i = 0; i < einsum_node.maps().size(); ++i) {
+            if (i > 0) stream << ", ";
+            stream << einsum_node.indvar(i)->__str__();
+        }
+        stream << ")" << std::endl;
+    }
+
+    for (size_t map : maps) loop(map);
+    for (size_t output = 0; output < einsum_node.outputs().size(); ++output) {
+        std::string out = element(output);
+        stream << out << " = "
+               << this->reduction_update(einsum_node, output, out, src_types, {}) << ";"
+               << std::endl;
+    }
+    close_loops(maps.size());
+}
 
 void EinsumDispatcher::dispatch(codegen::PrettyPrinter& stream) {
     stream << "// Einsum Node" << std::endl;
@@ -103,25 +510,57 @@ void EinsumDispatcher::dispatch(codegen::PrettyPrinter& stream) {
 
     const EinsumNode* einsum_node = dynamic_cast<const EinsumNode*>(&this->node_);
 
+    // Outputs with different out indices are accumulated in memory
+    if (!einsum_node->shared_out_indices()) {
+        this->dispatch_sequential(stream, *einsum_node);
+        stream.setIndent(stream.indent() - 4);
+        stream << "}" << std::endl;
+        return;
+    }
+
     std::unordered_map<std::string, const types::IType&> src_types;
 
-    // Get output container
-    auto& oedge = *this->data_flow_graph_.out_edges(this->node_).begin();
-    auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
-    const types::IType& dst_type = this->function_.type(dst.data());
-    auto& conn_name = oedge.src_conn();
-    auto& conn_type = types::infer_type(function_, dst_type, einsum_node->out_indices());
-
-    std::string dummy_declaration = this->language_extension_.declaration(dst.data(), conn_type);
-    std::string dummy_primitive_type =
-        this->language_extension_.primitive_type(conn_type.primitive_type());
-    std::string output_container;
-    if (dummy_primitive_type.size() + dst.data().size() + 1 >= dummy_declaration.size())
-        output_container = dst.data();
-    else
-        output_container = dummy_declaration.substr(dummy_primitive_type.size() + 1);
+    // Get output containers, all outputs share the out indices
+    struct Output {
+        const std::string& conn_name;
+        const types::IType& dst_type;
+        const types::IType& conn_type;
+        std::string container;
+    };
+    std::vector<Output> outputs;
+    for (auto& output : einsum_node->outputs()) {
+        for (auto& oedge : this->data_flow_graph_.out_edges(this->node_)) {
+            if (oedge.src_conn() != output) continue;
+            auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+            const types::IType& dst_type = this->function_.type(dst.data());
+            auto& conn_type = types::infer_type(function_, dst_type, einsum_node->out_indices());
+
+            std::string dummy_declaration =
+                this->language_extension_.declaration(dst.data(), conn_type);
+            std::string dummy_primitive_type =
+                this->language_extension_.primitive_type(conn_type.primitive_type());
+            std::string output_container;
+            if (dummy_primitive_type.size() + dst.data().size() + 1 >= dummy_declaration.size())
+                output_container = dst.data();
+            else
+                output_container = dummy_declaration.substr(dummy_primitive_type.size() + 1);
+
+            outputs.push_back({output, dst_type, conn_type, output_container});
+            break;
+        }
+    }
+    auto& conn_type = outputs.front().conn_type;
 
     long long oii = einsum_node->getOutInputIndex();
+    std::string reduction_operator = this->reduction_operator(einsum_node->reduction());
+
+    // Reduction clause over all outputs
+    std::string reduction_clause = " reduction(" + reduction_operator + ":";
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        if (i > 0) reduction_clause += ", ";
+        reduction_clause += outputs[i].conn_name;
+    }
+    reduction_clause += ")";
 
     // Input connector declarations
     for (auto& iedge : this->data_flow_graph_.in_edges(this->node_)) {
@@ -129,7 +568,10 @@ void EinsumDispatcher::dispatch(codegen::PrettyPrinter& stream) {
         const types::IType& src_type = this->function_.type(src.data());
 
         auto& conn_name = iedge.dst_conn();
-        if (conn_name == einsum_node->output(0)) continue;
+        auto& einsum_outputs = einsum_node->outputs();
+        if (std::find(einsum_outputs.begin(), einsum_outputs.end(), conn_name) !=
+            einsum_outputs.end())
+            continue;
         auto& conn_type = types::infer_type(function_, src_type, iedge.subset());
 
         src_types.insert({conn_name, src_type});
@@ -147,8 +589,108 @@ void EinsumDispatcher::dispatch(codegen::PrettyPrinter& stream) {
     std::vector<size_t> outer_maps = this->get_outer_maps(*einsum_node);
     size_t num_outer_maps = outer_maps.size();
 
-    // Parallelize loops if possible
+    // Get inner maps
+    std::vector<size_t> inner_maps = this->get_inner_maps(*einsum_node);
+    size_t num_inner_maps = inner_maps.size();
+
+    // Reorder maps according to the access strides of the operands
+    if (this->options_.loop_interchange) {
+        this->interchange_maps(*einsum_node, outer_maps);
+        this->interchange_maps(*einsum_node, inner_maps);
+    }
+
+    // Outer maps which do not index the output reduce into the same output element
+    auto is_reduction_map = [&](size_t map) {
+        if (oii < 0) return false;
+        for (auto& index : einsum_node->out_indices()) {
+            if (symbolic::eq(index, einsum_node->indvar(map))) return false;
+        }
+        return true;
+    };
     bool reduction = false;
+    for (size_t outer_map : outer_maps) {
+        if (is_reduction_map(outer_map)) reduction = true;
+    }
+
+    // Every output element is written back once per iteration of a reduction map
+    if (reduction && einsum_node->has_epilogue()) {
+        throw InvalidSDFGException("Einsum epilogue requires every outer map to index the output");
+    }
+
+    // The output is combined with the value of every iteration if it is read or if inner maps
+    // reduce into it, starting from the identity of the reduction in the latter case
+    bool reduces = oii >= 0 || num_inner_maps > 0;
+
+    // Small loop nests with constant bounds are unrolled completely, so that the outputs stay in
+    // registers and neither loops nor a parallel region add overhead
+    std::vector<std::pair<Iteration, std::vector<Iteration>>> unrolled;
+    bool unroll = this->options_.unroll_iterations > 0;
+    std::vector<Iteration> outer_iterations(1);
+    if (unroll)
+        unroll = this->expand_iterations(*einsum_node, outer_maps,
+                                         this->options_.unroll_iterations, outer_iterations);
+    size_t num_unrolled = 0;
+    for (auto& outer_iteration : outer_iterations) {
+        if (!unroll) break;
+        std::vector<Iteration> inner_iterations = {outer_iteration};
+        unroll = this->expand_iterations(*einsum_node, inner_maps,
+                                         this->options_.unroll_iterations, inner_iterations);
+        num_unrolled += inner_iterations.size();
+        if (num_unrolled > this->options_.unroll_iterations) unroll = false;
+        unrolled.push_back({outer_iteration, std::move(inner_iterations)});
+    }
+    if (unroll) {
+        for (auto& iterations : unrolled) {
+            stream << "{" << std::endl;
+            stream.setIndent(stream.indent() + 4);
+            for (auto& output : outputs) {
+                stream << this->language_extension_.declaration(
+                    output.conn_name, types::Scalar(output.conn_type.primitive_type()));
+                if (oii >= 0)
+                    stream << " = " << output.container
+                           << this->language_extension_.subset(
+                                  this->function_, output.dst_type,
+                                  substitute(einsum_node->out_indices(), iterations.first));
+                else if (reduces)
+                    stream << " = "
+                           << this->reduction_identity(einsum_node->reduction(),
+                                                       output.conn_type.primitive_type());
+                stream << ";" << std::endl;
+            }
+            for (auto& iteration : iterations.second) {
+                for (size_t output = 0; output < outputs.size(); ++output) {
+                    const std::string& out = outputs[output].conn_name;
+                    stream << out << " = ";
+                    if (reduces)
+                        stream << this->reduction_update(*einsum_node, output, out, src_types,
+                                                         iteration);
+                    else
+                        stream << this->term_value(*einsum_node, output, src_types, iteration);
+                    stream << ";" << std::endl;
+                }
+            }
+            for (auto& output : outputs) {
+                stream << output.container
+                       << this->language_extension_.subset(
+                              this->function_, output.dst_type,
+                              substitute(einsum_node->out_indices(), iterations.first))
+                       << " = ";
+                if (einsum_node->has_epilogue())
+                    stream << this->language_extension_.expression(einsum_node->epilogue());
+                else
+                    stream << output.conn_name;
+                stream << ";" << std::endl;
+            }
+            stream.setIndent(stream.indent() - 4);
+            stream << "}" << std::endl;
+        }
+        stream.setIndent(stream.indent() - 4);
+        stream << "}" << std::endl;
+        return;
+    }
+
+    // Parallelize loops if possible. The collapsed loop nest stops at the first reduction map, so
+    // that every thread owns distinct output elements.
     size_t outer_collapse = 0;
     for (size_t i = 0; i < num_outer_maps; ++i) {
         size_t j;
@@ -157,135 +699,228 @@ void EinsumDispatcher::dispatch(codegen::PrettyPrinter& stream) {
                                einsum_node->indvar(outer_maps[j])))
                 break;
         }
-        if (j != i) break;
+        if (j != i || is_reduction_map(outer_maps[i])) break;
         ++outer_collapse;
-        if (oii >= 0 && !reduction) {
-            bool indvar_in_out_indices = false;
-            for (auto& index : einsum_node->out_indices()) {
-                if (symbolic::eq(index, einsum_node->indvar(outer_maps[i]))) {
-                    indvar_in_out_indices = true;
-                    break;
-                }
+    }
+
+    // If the outermost map is a reduction map, all threads iterate over it and the first map
+    // indexing the output is distributed among the threads instead
+    size_t workshare_map = num_outer_maps;
+    if (outer_collapse == 0) {
+        for (size_t i = 0; i < num_outer_maps; ++i) {
+            if (!is_reduction_map(outer_maps[i])) {
+                workshare_map = i;
+                break;
             }
-            if (!indvar_in_out_indices) reduction = true;
         }
     }
-    if (outer_collapse > 0) {
-        stream << "#pragma omp parallel for private(";
+
+    // Determine tile sizes
+    std::unordered_map<size_t, size_t> tile_sizes;
+    if (this->options_.tiling && !reduction)
+        tile_sizes = this->get_tile_sizes(*einsum_node, outer_maps, inner_maps,
+                                          conn_type.primitive_type());
+    size_t num_tiled_outer_maps = 0, num_tiled_inner_maps = 0;
+    for (size_t outer_map : outer_maps) {
+        if (tile_sizes.contains(outer_map)) ++num_tiled_outer_maps;
+    }
+    for (size_t inner_map : inner_maps) {
+        if (tile_sizes.contains(inner_map)) ++num_tiled_inner_maps;
+    }
+
+    // Vectorize the innermost loop if its bound does not depend on other maps
+    bool vectorize = false;
+    if (this->options_.vectorize && oii >= 0 && num_inner_maps > 0) {
+        vectorize = true;
+        for (size_t i = 0; i < einsum_node->maps().size(); ++i) {
+            if (symbolic::uses(einsum_node->num_iteration(inner_maps.back()),
+                               einsum_node->indvar(i))) {
+                vectorize = false;
+                break;
+            }
+        }
+    }
+    bool simd_emitted = false;
+
+    // Declare index variables of tile loops
+    std::string tile_indvars;
+    for (size_t i = 0; i < einsum_node->maps().size(); ++i) {
+        if (!tile_sizes.contains(i)) continue;
+        const std::string indvar = einsum_node->indvar(i)->__str__();
+        stream << this->language_extension_.declaration(indvar + "_tile",
+                                                        this->function_.type(indvar))
+               << ";" << std::endl;
+        tile_indvars += ", " + indvar + "_tile";
+    }
+    if (!tile_sizes.empty()) stream << std::endl;
+
+    auto tile_loop = [&](size_t map) {
+        const std::string indvar = einsum_node->indvar(map)->__str__();
+        stream << "for (" << indvar << "_tile = 0; " << indvar << "_tile < "
+               << this->language_extension_.expression(einsum_node->num_iteration(map)) << "; "
+               << indvar << "_tile += " << tile_sizes.at(map) << ")" << std::endl
+               << "{" << std::endl;
+        stream.setIndent(stream.indent() + 4);
+    };
+    auto point_loop = [&](size_t map) {
+        const std::string indvar = einsum_node->indvar(map)->__str__();
+        const std::string bound =
+            this->language_extension_.expression(einsum_node->num_iteration(map));
+        if (tile_sizes.contains(map)) {
+            std::string tile_bound = indvar + "_tile + " + std::to_string(tile_sizes.at(map));
+            stream << "for (" << indvar << " = " << indvar << "_tile; " << indvar << " < ("
+                   << tile_bound << " < " << bound << " ? " << tile_bound << " : " << bound
+                   << "); " << indvar << "++)" << std::endl;
+        } else {
+            stream << "for (" << indvar << " = 0; " << indvar << " < " << bound << "; " << indvar
+                   << "++)" << std::endl;
+        }
+        stream << "{" << std::endl;
+        stream.setIndent(stream.indent() + 4);
+    };
+
+    auto private_indvars = [&]() {
+        stream << "private(";
         for (size_t i = 0; i < einsum_node->maps().size(); ++i) {
             if (i > 0) stream << ", ";
             stream << einsum_node->indvar(i)->__str__();
         }
-        stream << ")";
+        stream << tile_indvars << ")";
+    };
+
+    if (outer_collapse > 0) {
+        stream << "#pragma omp parallel for ";
+        private_indvars();
         if (outer_collapse > 1) stream << " collapse(" << outer_collapse << ")";
-        if (reduction)
-            stream << " reduction(+:" << output_container
-                   << this->language_extension_.subset(this->function_, dst_type,
-                                                       einsum_node->out_indices())
-                   << ")";
+        stream << std::endl;
+    } else if (workshare_map < num_outer_maps) {
+        stream << "#pragma omp parallel ";
+        private_indvars();
         stream << std::endl;
     }
 
-    // Create outer maps as for loops
-    for (size_t outer_map : outer_maps) {
-        const std::string indvar = einsum_node->indvar(outer_map)->__str__();
-        stream << "for (" << indvar << " = 0; " << indvar << " < "
-               << this->language_extension_.expression(einsum_node->num_iteration(outer_map))
-               << "; " << indvar << "++)" << std::endl
-               << "{" << std::endl;
-        stream.setIndent(stream.indent() + 4);
+    // Create outer maps as for loops. In case of tiling, the tile loops of the outer and inner maps
+    // are created first and followed by the point loops of the outer maps.
+    for (size_t i = 0; i < num_outer_maps; ++i) {
+        if (i == workshare_map) stream << "#pragma omp for" << std::endl;
+        if (tile_sizes.contains(outer_maps[i]))
+            tile_loop(outer_maps[i]);
+        else
+            point_loop(outer_maps[i]);
+    }
+    if (num_outer_maps > 0) {
+        for (size_t inner_map : inner_maps) {
+            if (tile_sizes.contains(inner_map)) tile_loop(inner_map);
+        }
+        for (size_t outer_map : outer_maps) {
+            if (tile_sizes.contains(outer_map)) point_loop(outer_map);
+        }
     }
 
-    // Set output connector to previous value / to zero
-    if (dynamic_cast<const types::Pointer*>(&conn_type))
-        stream << this->language_extension_.declaration(conn_name,
-                                                        types::Scalar(conn_type.primitive_type()));
-    else
-        stream << this->language_extension_.declaration(conn_name, conn_type);
-    if (oii >= 0)
-        stream << " = " << output_container
-               << this->language_extension_.subset(this->function_, dst_type,
-                                                   einsum_node->out_indices());
-    stream << ";" << std::endl;
+    // Set output connectors to previous value / to zero
+    for (auto& output : outputs) {
+        if (dynamic_cast<const types::Pointer*>(&output.conn_type))
+            stream << this->language_extension_.declaration(
+                output.conn_name, types::Scalar(output.conn_type.primitive_type()));
+        else
+            stream << this->language_extension_.declaration(output.conn_name, output.conn_type);
+        if (oii >= 0)
+            stream << " = " << output.container
+                   << this->language_extension_.subset(this->function_, output.dst_type,
+                                                       einsum_node->out_indices());
+        else if (reduces)
+            stream << " = "
+                   << this->reduction_identity(einsum_node->reduction(),
+                                               output.conn_type.primitive_type());
+        stream << ";" << std::endl;
+    }
 
     stream << std::endl;
 
-    // Get inner maps
-    std::vector<size_t> inner_maps = this->get_inner_maps(*einsum_node);
-    size_t num_inner_maps = inner_maps.size();
-
     // Parallelize loops if possible
     if (num_outer_maps == 0) {
         size_t inner_collapse = 0;
-        for (size_t i = 0; i < num_inner_maps; ++i) {
-            size_t j;
-            for (j = 0; j < i; ++j) {
-                if (symbolic::uses(einsum_node->num_iteration(inner_maps[i]),
-                                   einsum_node->indvar(inner_maps[j])))
-                    break;
+        if (num_tiled_inner_maps > 0) {
+            inner_collapse = num_tiled_inner_maps;
+        } else {
+            for (size_t i = 0; i < num_inner_maps; ++i) {
+                size_t j;
+                for (j = 0; j < i; ++j) {
+                    if (symbolic::uses(einsum_node->num_iteration(inner_maps[i]),
+                                       einsum_node->indvar(inner_maps[j])))
+                        break;
+                }
+                if (j != i) break;
+                ++inner_collapse;
             }
-            if (j != i) break;
-            ++inner_collapse;
         }
         if (inner_collapse > 0) {
-            stream << "#pragma omp parallel for private(";
+            // The innermost loop is part of the parallel loop nest
+            if (vectorize && num_tiled_inner_maps == 0 && inner_collapse == num_inner_maps) {
+                stream << "#pragma omp parallel for simd private(";
+                simd_emitted = true;
+            } else {
+                stream << "#pragma omp parallel for private(";
+            }
             for (size_t i = 0; i < num_inner_maps; ++i) {
                 if (i > 0) stream << ", ";
                 stream << einsum_node->indvar(inner_maps[i])->__str__();
             }
-            stream << ")";
+            stream << tile_indvars << ")";
             if (inner_collapse > 1) stream << " collapse(" << inner_collapse << ")";
-            stream << " reduction(+:" << einsum_node->output(0) << ")" << std::endl;
+            stream << reduction_clause << std::endl;
+        }
+
+        for (size_t inner_map : inner_maps) {
+            if (tile_sizes.contains(inner_map)) tile_loop(inner_map);
         }
     }
 
     // Create inner maps as for loops
     for (size_t inner_map : inner_maps) {
-        const std::string indvar = einsum_node->indvar(inner_map)->__str__();
-        stream << "for (" << indvar << " = 0; " << indvar << " < "
-               << this->language_extension_.expression(einsum_node->num_iteration(inner_map))
-               << "; " << indvar << "++)" << std::endl
-               << "{" << std::endl;
-        stream.setIndent(stream.indent() + 4);
+        if (vectorize && !simd_emitted && inner_map == inner_maps.back())
+            stream << "#pragma omp simd" << reduction_clause << std::endl;
+        point_loop(inner_map);
     }
 
-    // Calculate one entry
-    stream << einsum_node->output(0) << " = ";
-    if (oii >= 0) stream << einsum_node->output(0) << " + ";
-    bool first_mul = false;
-    for (size_t i = 0; i < einsum_node->inputs().size(); ++i) {
-        if (einsum_node->input(i) == einsum_node->output(0)) continue;
-        if (first_mul) stream << " * ";
-        first_mul = true;
-        if (einsum_node->in_indices(i).size() > 0) {
-            stream << einsum_node->input(i);
-            stream << this->language_extension_.subset(
-                this->function_, src_types.at(einsum_node->input(i)), einsum_node->in_indices(i));
-        } else {
-            if (src_types.contains(einsum_node->input(i)) &&
-                dynamic_cast<const types::Pointer*>(&src_types.at(einsum_node->input(i))))
-                stream << "*";
-            stream << einsum_node->input(i);
-        }
+    // Calculate one entry of every output from the terms which belong to it
+    for (size_t output = 0; output < outputs.size(); ++output) {
+        const std::string& out = outputs[output].conn_name;
+        stream << out << " = ";
+        if (reduces)
+            stream << this->reduction_update(*einsum_node, output, out, src_types, {});
+        else
+            stream << this->term_value(*einsum_node, output, src_types, {});
+        stream << ";" << std::endl;
     }
-    stream << ";" << std::endl;
 
     // Closing brackets for inner maps
-    for (size_t i = 0; i < num_inner_maps; ++i) {
+    size_t num_inner_loops = num_inner_maps;
+    if (num_outer_maps == 0) num_inner_loops += num_tiled_inner_maps;
+    for (size_t i = 0; i < num_inner_loops; ++i) {
         stream.setIndent(stream.indent() - 4);
         stream << "}" << std::endl;
     }
 
     stream << std::endl;
 
-    // Write back output connector
-    stream << output_container
-           << this->language_extension_.subset(this->function_, dst_type,
-                                               einsum_node->out_indices())
-           << " = " << oedge.src_conn() << ";" << std::endl;
+    // Write back output connectors
+    for (auto& output : outputs) {
+        stream << output.container
+               << this->language_extension_.subset(this->function_, output.dst_type,
+                                                   einsum_node->out_indices())
+               << " = ";
+        if (einsum_node->has_epilogue())
+            stream << this->language_extension_.expression(einsum_node->epilogue());
+        else
+            stream << output.conn_name;
+        stream << ";" << std::endl;
+    }
 
     // Closing brackets for outer maps
-    for (size_t i = 0; i < num_outer_maps; ++i) {
+    size_t num_outer_loops = num_outer_maps;
+    if (num_outer_maps > 0) num_outer_loops += num_tiled_outer_maps + num_tiled_inner_maps;
+    for (size_t i = 0; i < num_outer_loops; ++i) {
         stream.setIndent(stream.indent() - 4);
         stream << "}" << std::endl;
     }
@@ -295,4 +930,4 @@ void EinsumDispatcher::dispatch(codegen::PrettyPrinter& stream) {
 }
 
 }  // namespace einsum
-}  // namespace sdfg
\ No newline at end of file
+}  // namespace sdfg
@@ -21,34 +21,66 @@ EinsumNode::EinsumNode(size_t element_id, const DebugInfo& debug_info, const gra
                        const std::vector<std::string>& inputs,
                        const std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>& maps,
                        const data_flow::Subset& out_indices,
-                       const std::vector<data_flow::Subset>& in_indices)
+                       const std::vector<data_flow::Subset>& in_indices,
+                       const std::vector<std::vector<size_t>>& terms, ReductionType reduction,
+                       const symbolic::Expression& epilogue,
+                       const std::vector<size_t>& term_outputs)
+    : EinsumNode(element_id, debug_info, vertex, parent, outputs, inputs, maps,
+                 std::vector<data_flow::Subset>(outputs.size(), out_indices), in_indices, terms,
+                 reduction, epilogue, term_outputs) {}
+
+EinsumNode::EinsumNode(size_t element_id, const DebugInfo& debug_info, const graph::Vertex vertex,
+                       data_flow::DataFlowGraph& parent, const std::vector<std::string>& outputs,
+                       const std::vector<std::string>& inputs,
+                       const std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>& maps,
+                       const std::vector<data_flow::Subset>& out_indices,
+                       const std::vector<data_flow::Subset>& in_indices,
+                       const std::vector<std::vector<size_t>>& terms, ReductionType reduction,
+                       const symbolic::Expression& epilogue,
+                       const std::vector<size_t>& term_outputs)
     : data_flow::LibraryNode(element_id, debug_info, vertex, parent, LibraryNodeType_Einsum,
                              outputs, inputs, false),
       maps_(maps),
       out_indices_(out_indices),
-      in_indices_(in_indices) {
+      in_indices_(in_indices),
+      terms_(terms),
+      reduction_(reduction),
+      epilogue_(epilogue),
+      term_outputs_(term_outputs) {
     // Check number of outputs
-    if (outputs.size() != 1) {
-        throw InvalidSDFGException("Einsum node can only have exactly one output");
+    if (outputs.empty()) {
+        throw InvalidSDFGException("Einsum node must have at least one output");
+    }
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            if (outputs[i] == outputs[j]) {
+                throw InvalidSDFGException("Einsum output " + outputs[i] + " occurs twice");
+            }
+        }
     }
 
     // Check list sizes
+    if (outputs.size() != out_indices.size()) {
+        throw InvalidSDFGException("Number of outputs != number of out indices");
+    }
     if (inputs.size() != in_indices.size()) {
         throw InvalidSDFGException("Number of input containers != number of input indices");
     }
 
-    // Check if map indices occur at least once as in/out indices
+    // Check if map indices are used at least once in in/out indices, e.g., as x[2 * i]
     for (auto& map : maps) {
         bool unused = true;
-        for (auto& index : out_indices) {
-            if (map.first->__str__() == index->__str__()) {
-                unused = false;
-                break;
+        for (auto& indices : out_indices) {
+            for (auto& index : indices) {
+                if (symbolic::uses(index, map.first)) {
+                    unused = false;
+                    break;
+                }
             }
         }
         for (auto& indices : in_indices) {
             for (auto& index : indices) {
-                if (map.first->__str__() == index->__str__()) {
+                if (symbolic::uses(index, map.first)) {
                     unused = false;
                     break;
                 }
@@ -60,17 +92,93 @@ EinsumNode::EinsumNode(size_t element_id, const DebugInfo& debug_info, const gra
         }
     }
 
-    size_t i;
-    for (i = 0; i < inputs.size(); ++i) {
-        if (inputs[i] == outputs[0]) break;
+    // Check that out inputs have the indices of the output and that all or no outputs are read
+    std::vector<bool> is_output(inputs.size(), false);
+    size_t num_out_inputs = 0;
+    for (size_t output = 0; output < outputs.size(); ++output) {
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (inputs[i] != outputs[output]) continue;
+            is_output[i] = true;
+            ++num_out_inputs;
+            if (in_indices[i].size() != out_indices[output].size()) {
+                throw InvalidSDFGException("Out input and output do not have the same indices");
+            }
+            for (size_t j = 0; j < out_indices[output].size(); ++j) {
+                if (!symbolic::eq(in_indices[i][j], out_indices[output][j])) {
+                    throw InvalidSDFGException(
+                        "Out input and output do not have the same indices");
+                }
+            }
+        }
+    }
+    if (num_out_inputs != 0 && num_out_inputs != outputs.size()) {
+        throw InvalidSDFGException("Einsum node must read either all or none of its outputs");
+    }
+
+    // Default to a single product of all inputs except the output
+    if (this->terms_.empty()) {
+        if (outputs.size() > 1) {
+            throw InvalidSDFGException("Einsum node with several outputs needs explicit terms");
+        }
+        std::vector<size_t> term;
+        for (size_t j = 0; j < inputs.size(); ++j) {
+            if (!is_output[j]) term.push_back(j);
+        }
+        if (!term.empty()) this->terms_.push_back(term);
     }
-    if (i < inputs.size()) {
-        if (in_indices[i].size() != out_indices.size()) {
-            throw InvalidSDFGException("Out input and output do not have the same indices");
+
+    // Check that every input except the outputs occurs in exactly one term
+    std::vector<bool> in_term(inputs.size(), false);
+    for (auto& term : this->terms_) {
+        if (term.empty()) {
+            throw InvalidSDFGException("Einsum term must have at least one input");
         }
-        for (size_t j = 0; j < out_indices.size(); ++j) {
-            if (!symbolic::eq(in_indices[i][j], out_indices[j])) {
-                throw InvalidSDFGException("Out input and output do not have the same indices");
+        for (size_t input : term) {
+            if (input >= inputs.size() || is_output[input] || in_term[input]) {
+                throw InvalidSDFGException("Einsum term input " + std::to_string(input) +
+                                           " is invalid or occurs in more than one term");
+            }
+            in_term[input] = true;
+        }
+    }
+    for (size_t j = 0; j < inputs.size(); ++j) {
+        if (!is_output[j] && !in_term[j]) {
+            throw InvalidSDFGException("Einsum input " + inputs[j] + " does not occur in a term");
+        }
+    }
+
+    // Check that every term belongs to an output and every output has a term. Without term outputs
+    // all terms belong to the first output.
+    if (this->term_outputs_.empty()) this->term_outputs_.resize(this->terms_.size(), 0);
+    if (this->term_outputs_.size() != this->terms_.size()) {
+        throw InvalidSDFGException("Number of einsum terms != number of term outputs");
+    }
+    std::vector<bool> has_term(outputs.size(), false);
+    for (size_t output : this->term_outputs_) {
+        if (output >= outputs.size()) {
+            throw InvalidSDFGException("Einsum term output " + std::to_string(output) +
+                                       " is invalid");
+        }
+        has_term[output] = true;
+    }
+    if (outputs.size() > 1) {
+        for (size_t j = 0; j < outputs.size(); ++j) {
+            if (!has_term[j]) {
+                throw InvalidSDFGException("Einsum output " + outputs[j] + " has no term");
+            }
+        }
+    }
+
+    // Check that the epilogue is element-wise, i.e., does not depend on the maps, and that there is
+    // a single output it refers to
+    if (this->has_epilogue()) {
+        if (outputs.size() != 1) {
+            throw InvalidSDFGException("Einsum epilogue requires exactly one output");
+        }
+        for (auto& map : maps) {
+            if (symbolic::uses(epilogue, map.first)) {
+                throw InvalidSDFGException("Einsum epilogue must not use indvar " +
+                                           map.first->__str__());
             }
         }
     }
@@ -94,10 +202,25 @@ const symbolic::Expression& EinsumNode::num_iteration(size_t index) const {
     return this->maps_[index].second;
 }
 
-const data_flow::Subset& EinsumNode::out_indices() const { return this->out_indices_; }
+const data_flow::Subset& EinsumNode::out_indices() const { return this->out_indices_[0]; }
+
+const data_flow::Subset& EinsumNode::out_indices(size_t output) const {
+    return this->out_indices_[output];
+}
 
 const symbolic::Expression& EinsumNode::out_index(size_t index) const {
-    return this->out_indices_[index];
+    return this->out_indices_[0][index];
+}
+
+bool EinsumNode::shared_out_indices() const {
+    for (size_t output = 1; output < this->out_indices_.size(); ++output) {
+        if (this->out_indices_[output].size() != this->out_indices_[0].size()) return false;
+        for (size_t i = 0; i < this->out_indices_[0].size(); ++i) {
+            if (!symbolic::eq(this->out_indices_[output][i], this->out_indices_[0][i]))
+                return false;
+        }
+    }
+    return true;
 }
 
 const std::vector<data_flow::Subset>& EinsumNode::in_indices() const { return this->in_indices_; }
@@ -110,12 +233,28 @@ const symbolic::Expression& EinsumNode::in_index(size_t index1, size_t index2) c
     return this->in_indices_[index1][index2];
 }
 
+const std::vector<std::vector<size_t>>& EinsumNode::terms() const { return this->terms_; }
+
+const std::vector<size_t>& EinsumNode::term(size_t index) const { return this->terms_[index]; }
+
+const std::vector<size_t>& EinsumNode::term_outputs() const { return this->term_outputs_; }
+
+size_t EinsumNode::term_output(size_t index) const { return this->term_outputs_[index]; }
+
+ReductionType EinsumNode::reduction() const { return this->reduction_; }
+
+const symbolic::Expression& EinsumNode::epilogue() const { return this->epilogue_; }
+
+bool EinsumNode::has_epilogue() const { return !this->epilogue_.is_null(); }
+
 std::unique_ptr<data_flow::DataFlowNode> EinsumNode::clone(size_t element_id,
                                                            const graph::Vertex vertex,
                                                            data_flow::DataFlowGraph& parent) const {
     return std::make_unique<EinsumNode>(element_id, this->debug_info(), vertex, parent,
                                         this->outputs(), this->inputs(), this->maps(),
-                                        this->out_indices(), this->in_indices());
+                                        this->out_indices_, this->in_indices(), this->terms(),
+                                        this->reduction(), this->epilogue(),
+                                        this->term_outputs());
 }
 
 symbolic::SymbolSet EinsumNode::symbols() const {
@@ -129,9 +268,11 @@ symbolic::SymbolSet EinsumNode::symbols() const {
     }
 
     // Indices
-    for (auto& expr : this->out_indices()) {
-        symbolic::SymbolSet atoms = symbolic::atoms(expr);
-        result.insert(atoms.begin(), atoms.end());
+    for (auto& indices : this->out_indices_) {
+        for (auto& expr : indices) {
+            symbolic::SymbolSet atoms = symbolic::atoms(expr);
+            result.insert(atoms.begin(), atoms.end());
+        }
     }
     for (auto& indices : this->in_indices()) {
         for (auto& expr : indices) {
@@ -140,6 +281,13 @@ symbolic::SymbolSet EinsumNode::symbols() const {
         }
     }
 
+    // Epilogue without the output connector
+    if (this->has_epilogue()) {
+        for (auto& atom : symbolic::atoms(this->epilogue())) {
+            if (atom->get_name() != this->outputs_[0]) result.insert(atom);
+        }
+    }
+
     return result;
 }
 
@@ -155,45 +303,60 @@ void EinsumNode::replace(const symbolic::Expression& old_expression,
 std::string EinsumNode::toStr() const {
     std::stringstream stream;
 
-    stream << this->outputs_[0];
-    if (this->out_indices_.size() > 0) {
-        stream << "[";
-        for (size_t i = 0; i < this->out_indices_.size(); ++i) {
-            if (i > 0) stream << ",";
-            stream << this->out_indices_[i]->__str__();
-        }
-        stream << "]";
-    }
-    stream << " = ";
-    long long oii = this->getOutInputIndex();
-    if (oii >= 0) {
-        stream << this->inputs_[oii];
-        if (this->in_indices_[oii].size() > 0) {
+    // One equation per output, each summing the terms which belong to it
+    for (size_t output = 0; output < this->outputs_.size(); ++output) {
+        if (output > 0) stream << "; ";
+        stream << this->outputs_[output];
+        if (this->out_indices_[output].size() > 0) {
             stream << "[";
-            for (size_t i = 0; i < this->in_indices_[oii].size(); ++i) {
+            for (size_t i = 0; i < this->out_indices_[output].size(); ++i) {
                 if (i > 0) stream << ",";
-                stream << this->in_indices_[oii][i]->__str__();
+                stream << this->out_indices_[output][i]->__str__();
             }
             stream << "]";
         }
-        stream << " + ";
-    }
-    bool first_mul = false;
-    for (size_t i = 0; i < this->inputs_.size(); ++i) {
-        if (this->inputs_[i] == this->outputs_[0]) continue;
-        if (first_mul) stream << " * ";
-        first_mul = true;
-        stream << this->inputs_[i];
-        if (this->in_indices_[i].size() > 0) {
-            stream << "[";
-            for (size_t j = 0; j < this->in_indices_[i].size(); j++) {
-                if (j > 0) stream << ",";
-                stream << this->in_indices_[i][j]->__str__();
+        stream << " = ";
+        if (this->reduction_ != ReductionType_Sum)
+            stream << reductionType2String(this->reduction_) << "(";
+        long long oii = this->getOutInputIndex(output);
+        if (oii >= 0) {
+            stream << this->inputs_[oii];
+            if (this->in_indices_[oii].size() > 0) {
+                stream << "[";
+                for (size_t i = 0; i < this->in_indices_[oii].size(); ++i) {
+                    if (i > 0) stream << ",";
+                    stream << this->in_indices_[oii][i]->__str__();
+                }
+                stream << "]";
             }
-            stream << "]";
+            stream << (this->reduction_ == ReductionType_Sum ? " + " : ", ");
         }
+        bool first_term = true;
+        for (size_t t = 0; t < this->terms_.size(); ++t) {
+            if (this->term_outputs_[t] != output) continue;
+            if (!first_term) stream << " + ";
+            first_term = false;
+            bool first_mul = false;
+            for (size_t i : this->terms_[t]) {
+                if (first_mul) stream << " * ";
+                first_mul = true;
+                stream << this->inputs_[i];
+                if (this->in_indices_[i].size() > 0) {
+                    stream << "[";
+                    for (size_t j = 0; j < this->in_indices_[i].size(); j++) {
+                        if (j > 0) stream << ",";
+                        stream << this->in_indices_[i][j]->__str__();
+                    }
+                    stream << "]";
+                }
+            }
+        }
+
+        if (this->reduction_ != ReductionType_Sum) stream << ")";
     }
 
+    if (this->has_epilogue()) stream << " then " << this->epilogue_->__str__();
+
     for (auto& map : this->maps_) {
         stream << " for " << map.first->__str__() << " = 0:" << map.second->__str__();
     }
@@ -201,9 +364,9 @@ std::string EinsumNode::toStr() const {
     return stream.str();
 }
 
-long long EinsumNode::getOutInputIndex() const {
+long long EinsumNode::getOutInputIndex(size_t output) const {
     for (size_t i = 0; i < this->inputs_.size(); ++i) {
-        if (this->inputs_[i] == this->outputs_[0]) return i;
+        if (this->inputs_[i] == this->outputs_[output]) return i;
     }
     return -1;
 }
@@ -53,6 +53,18 @@ nlohmann::json EinsumSerializer::serialize(const sdfg::data_flow::LibraryNode& l
         j["out_indices"].push_back(this->expression(index));
     }
 
+    // Outputs with their own out indices list all of them, the first ones are also given above
+    if (!einsum_node.shared_out_indices()) {
+        j["outputs_out_indices"] = nlohmann::json::array();
+        for (size_t output = 0; output < einsum_node.outputs().size(); ++output) {
+            nlohmann::json indicesj = nlohmann::json::array();
+            for (const auto& index : einsum_node.out_indices(output)) {
+                indicesj.push_back(this->expression(index));
+            }
+            j["outputs_out_indices"].push_back(indicesj);
+        }
+    }
+
     j["in_indices"] = nlohmann::json::array();
     for (const auto& indices : einsum_node.in_indices()) {
         nlohmann::json indicesj = nlohmann::json::array();
@@ -62,6 +74,27 @@ nlohmann::json EinsumSerializer::serialize(const sdfg::data_flow::LibraryNode& l
         j["in_indices"].push_back(indicesj);
     }
 
+    // Single products are implied by the inputs
+    if (einsum_node.terms().size() > 1) {
+        j["terms"] = nlohmann::json::array();
+        for (const auto& term : einsum_node.terms()) {
+            j["terms"].push_back(term);
+        }
+    }
+
+    // A single output owns all terms
+    if (einsum_node.outputs().size() > 1) {
+        j["term_outputs"] = einsum_node.term_outputs();
+    }
+
+    if (einsum_node.reduction() != ReductionType_Sum) {
+        j["reduction"] = std::string(reductionType2String(einsum_node.reduction()));
+    }
+
+    if (einsum_node.has_epilogue()) {
+        j["epilogue"] = this->expression(einsum_node.epilogue());
+    }
+
     return j;
 }
 
@@ -95,6 +128,20 @@ data_flow::LibraryNode& EinsumSerializer::deserialize(
         out_indices.push_back(SymEngine::Expression(index_str));
     }
 
+    std::vector<data_flow::Subset> outputs_out_indices(outputs.size(), out_indices);
+    if (j.contains("outputs_out_indices")) {
+        outputs_out_indices.clear();
+        auto outputs_out_indices_str =
+            j["outputs_out_indices"].get<std::vector<std::vector<std::string>>>();
+        for (auto& indices_str : outputs_out_indices_str) {
+            data_flow::Subset subset;
+            for (auto& index_str : indices_str) {
+                subset.push_back(SymEngine::Expression(index_str));
+            }
+            outputs_out_indices.push_back(subset);
+        }
+    }
+
     std::vector<data_flow::Subset> in_indices;
     auto in_indices_str = j["in_indices"].get<std::vector<std::vector<std::string>>>();
     for (auto& indices_str : in_indices_str) {
@@ -105,12 +152,43 @@ data_flow::LibraryNode& EinsumSerializer::deserialize(
         in_indices.push_back(subset);
     }
 
+    std::vector<std::vector<size_t>> terms;
+    if (j.contains("terms")) {
+        terms = j["terms"].get<std::vector<std::vector<size_t>>>();
+    }
+
+    ReductionType reduction = ReductionType_Sum;
+    if (j.contains("reduction")) {
+        auto reduction_str = j["reduction"].get<std::string>();
+        if (reduction_str == reductionType2String(ReductionType_Max))
+            reduction = ReductionType_Max;
+        else if (reduction_str == reductionType2String(ReductionType_Min))
+            reduction = ReductionType_Min;
+        else if (reduction_str == reductionType2String(ReductionType_Prod))
+            reduction = ReductionType_Prod;
+        else if (reduction_str != reductionType2String(ReductionType_Sum))
+            throw std::runtime_error("Invalid reduction type: " + reduction_str);
+    }
+
+    symbolic::Expression epilogue;
+    if (j.contains("epilogue")) {
+        epilogue = SymEngine::Expression(j["epilogue"].get<std::string>());
+    }
+
+    std::vector<size_t> term_outputs;
+    if (j.contains("term_outputs")) {
+        term_outputs = j["term_outputs"].get<std::vector<size_t>>();
+    }
+
     auto& einsum_node =
         builder.add_library_node<EinsumNode, const std::vector<std::string>&,
                                  const std::vector<std::string>&,
                                  std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
-                                 data_flow::Subset, std::vector<data_flow::Subset>>(
-            parent, DebugInfo(), outputs, inputs, maps, out_indices, in_indices);
+                                 std::vector<data_flow::Subset>, std::vector<data_flow::Subset>,
+                                 const std::vector<std::vector<size_t>>&, ReductionType,
+                                 const symbolic::Expression&, const std::vector<size_t>&>(
+            parent, DebugInfo(), outputs, inputs, maps, outputs_out_indices, in_indices, terms,
+            reduction, epilogue, term_outputs);
 
     return einsum_node;
 }
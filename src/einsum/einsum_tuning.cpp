@@ -0,0 +1,125 @@
+#include "sdfg/einsum/einsum_tuning.h"
+
+#include <sdfg/codegen/language_extensions/c_language_extension.h>
+#include <sdfg/data_flow/access_node.h>
+#include <sdfg/data_flow/data_flow_graph.h>
+#include <sdfg/function.h>
+#include <sdfg/types/scalar.h>
+#include <sdfg/types/type.h>
+#include <sdfg/types/utils.h>
+
+#include <cstddef>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "sdfg/einsum/einsum_dispatcher.h"
+#include "sdfg/einsum/einsum_node.h"
+
+namespace sdfg {
+namespace einsum {
+
+std::string EinsumVariant::toStr() const {
+    if (!this->lowering.empty()) return this->lowering;
+
+    std::stringstream stream;
+    stream << "EinsumDispatcher";
+    if (this->options.loop_interchange) stream << " interchange";
+    if (this->options.tiling) stream << " tiling(" << this->options.tiling_cache_size << ")";
+    if (this->options.vectorize) stream << " vectorize";
+    if (this->options.unroll_iterations > 0)
+        stream << " unroll(" << this->options.unroll_iterations << ")";
+    return stream.str();
+}
+
+void to_json(nlohmann::json& j, const EinsumVariant& variant) {
+    j["lowering"] = variant.lowering;
+    j["tiling"] = variant.options.tiling;
+    j["tiling_cache_size"] = variant.options.tiling_cache_size;
+    j["loop_interchange"] = variant.options.loop_interchange;
+    j["vectorize"] = variant.options.vectorize;
+    j["unroll_iterations"] = variant.options.unroll_iterations;
+}
+
+void from_json(const nlohmann::json& j, EinsumVariant& variant) {
+    variant.lowering = j.at("lowering").get<std::string>();
+    variant.options.tiling = j.at("tiling").get<bool>();
+    variant.options.tiling_cache_size = j.at("tiling_cache_size").get<size_t>();
+    variant.options.loop_interchange = j.at("loop_interchange").get<bool>();
+    variant.options.vectorize = j.at("vectorize").get<bool>();
+    if (j.contains("unroll_iterations"))
+        variant.options.unroll_iterations = j.at("unroll_iterations").get<size_t>();
+}
+
+std::string EinsumTuningDatabase::key(const Function& function,
+                                      const data_flow::DataFlowGraph& data_flow_graph,
+                                      const EinsumNode& einsum_node) {
+    // Determine the element type of the output
+    auto& oedge = *data_flow_graph.out_edges(einsum_node).begin();
+    auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+    auto primitive_type =
+        types::infer_type(function, function.type(dst.data()), oedge.subset()).primitive_type();
+
+    codegen::CLanguageExtension language_extension;
+    std::string type = language_extension.declaration("", types::Scalar(primitive_type));
+    while (!type.empty() && type.back() == ' ') type.pop_back();
+
+    return type + " " + einsum_node.toStr();
+}
+
+const EinsumVariant* EinsumTuningDatabase::lookup(const std::string& key) const {
+    auto entry = this->entries_.find(key);
+    if (entry == this->entries_.end()) return nullptr;
+    return &entry->second.first;
+}
+
+double EinsumTuningDatabase::time(const std::string& key) const {
+    auto entry = this->entries_.find(key);
+    if (entry == this->entries_.end()) return -1.0;
+    return entry->second.second;
+}
+
+bool EinsumTuningDatabase::record(const std::string& key, const EinsumVariant& variant,
+                                  double time) {
+    if (time < 0.0) return false;
+
+    auto entry = this->entries_.find(key);
+    if (entry != this->entries_.end() && entry->second.second <= time) return false;
+    this->entries_.insert_or_assign(key, std::make_pair(variant, time));
+    return true;
+}
+
+size_t EinsumTuningDatabase::size() const { return this->entries_.size(); }
+
+void EinsumTuningDatabase::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("Cannot open tuning database " + path);
+
+    nlohmann::json j = nlohmann::json::parse(file);
+    for (auto& entry : j.at("entries")) {
+        this->record(entry.at("key").get<std::string>(), entry.at("variant").get<EinsumVariant>(),
+                     entry.at("time").get<double>());
+    }
+}
+
+void EinsumTuningDatabase::save(const std::string& path) const {
+    nlohmann::json j;
+    j["entries"] = nlohmann::json::array();
+    for (auto& entry : this->entries_) {
+        nlohmann::json entryj;
+        entryj["key"] = entry.first;
+        entryj["variant"] = entry.second.first;
+        entryj["time"] = entry.second.second;
+        j["entries"].push_back(entryj);
+    }
+
+    std::ofstream file(path);
+    if (!file) throw std::runtime_error("Cannot write tuning database " + path);
+    file << j.dump(4) << std::endl;
+}
+
+}  // namespace einsum
+}  // namespace sdfg
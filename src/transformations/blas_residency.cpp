@@ -0,0 +1,217 @@
+#include "sdfg/transformations/blas_residency.h"
+
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/data_flow/access_node.h>
+#include <sdfg/data_flow/library_node.h>
+#include <sdfg/structured_control_flow/block.h>
+#include <sdfg/structured_control_flow/sequence.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/transformations/transformation.h>
+
+#include <cstddef>
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "sdfg/blas/blas_dispatcher_utils.h"
+#include "sdfg/blas/blas_node.h"
+#include "sdfg/blas/blas_node_axpy.h"
+#include "sdfg/blas/blas_node_copy.h"
+#include "sdfg/blas/blas_node_gemm.h"
+#include "sdfg/blas/blas_node_gemv.h"
+#include "sdfg/blas/blas_node_syrk.h"
+
+namespace sdfg {
+namespace transformations {
+
+blas::BLASNode* BLASResidency::blas_node(structured_control_flow::ControlFlowNode& node) {
+    auto block = dynamic_cast<structured_control_flow::Block*>(&node);
+    if (!block) return nullptr;
+
+    // Check that the block only contains access nodes and a single supported BLAS node
+    blas::BLASNode* result = nullptr;
+    for (auto& dfg_node : block->dataflow().nodes()) {
+        if (dynamic_cast<data_flow::AccessNode*>(&dfg_node)) continue;
+        if (result) return nullptr;
+        if (!dynamic_cast<blas::BLASNodeAxpy*>(&dfg_node) &&
+            !dynamic_cast<blas::BLASNodeCopy*>(&dfg_node) &&
+            !dynamic_cast<blas::BLASNodeGemv*>(&dfg_node) &&
+            !dynamic_cast<blas::BLASNodeGemm*>(&dfg_node) &&
+            !dynamic_cast<blas::BLASNodeSyrk*>(&dfg_node))
+            return nullptr;
+        result = dynamic_cast<blas::BLASNode*>(&dfg_node);
+    }
+    return result;
+}
+
+std::vector<BLASResidency::Operand> BLASResidency::operands(blas::BLASNode& blas_node) {
+    auto one = symbolic::one();
+    if (auto axpy = dynamic_cast<blas::BLASNodeAxpy*>(&blas_node)) {
+        return {{axpy->x(), axpy->n(), symbolic::eq(axpy->incx(), one), true, false},
+                {axpy->y(), axpy->n(), symbolic::eq(axpy->incy(), one), true, true}};
+    } else if (auto copy = dynamic_cast<blas::BLASNodeCopy*>(&blas_node)) {
+        return {{copy->x(), copy->n(), symbolic::eq(copy->incx(), one), true, false},
+                {copy->y(), copy->n(), symbolic::eq(copy->incy(), one), false, true}};
+    } else if (auto gemv = dynamic_cast<blas::BLASNodeGemv*>(&blas_node)) {
+        bool no_trans = gemv->trans() == blas::BLASTranspose_No;
+        return {{gemv->A(), symbolic::mul(gemv->m(), gemv->n()),
+                 symbolic::eq(gemv->lda(), gemv->n()), true, false},
+                {gemv->x(), no_trans ? gemv->n() : gemv->m(), symbolic::eq(gemv->incx(), one),
+                 true, false},
+                {gemv->y(), no_trans ? gemv->m() : gemv->n(), symbolic::eq(gemv->incy(), one),
+                 true, true}};
+    } else if (auto gemm = dynamic_cast<blas::BLASNodeGemm*>(&blas_node)) {
+        auto ldA = gemm->transA() == blas::BLASTranspose_No ? gemm->k() : gemm->m();
+        auto ldB = gemm->transB() == blas::BLASTranspose_No ? gemm->n() : gemm->k();
+        bool read_C = gemm->beta() != blas::blasZero(gemm->type());
+        return {{gemm->A(), symbolic::mul(gemm->m(), gemm->k()), symbolic::eq(gemm->lda(), ldA),
+                 true, false},
+                {gemm->B(), symbolic::mul(gemm->k(), gemm->n()), symbolic::eq(gemm->ldb(), ldB),
+                 true, false},
+                {gemm->C(), symbolic::mul(gemm->m(), gemm->n()),
+                 symbolic::eq(gemm->ldc(), gemm->n()), read_C, true}};
+    } else if (auto syrk = dynamic_cast<blas::BLASNodeSyrk*>(&blas_node)) {
+        return {{syrk->A(), symbolic::mul(syrk->n(), syrk->k()), true, true, false},
+                {syrk->C(), symbolic::mul(syrk->n(), syrk->n()), true, true, true}};
+    }
+    return {};
+}
+
+bool BLASResidency::eligible(blas::BLASNode& blas_node, const Operand& operand,
+                             std::string& container) {
+    auto& dfg = blas_node.get_parent();
+    bool whole = true;
+    for (auto& iedge : dfg.in_edges(blas_node)) {
+        if (iedge.dst_conn() != operand.conn) continue;
+        container = dynamic_cast<data_flow::AccessNode&>(iedge.src()).data();
+        whole = whole && iedge.subset().empty();
+    }
+    for (auto& oedge : dfg.out_edges(blas_node)) {
+        if (oedge.src_conn() != operand.conn) continue;
+        container = dynamic_cast<data_flow::AccessNode&>(oedge.dst()).data();
+        whole = whole && oedge.subset().empty();
+    }
+
+    // Epilogues are applied to the output on the host
+    if (operand.written) {
+        auto gemm = dynamic_cast<blas::BLASNodeGemm*>(&blas_node);
+        auto gemv = dynamic_cast<blas::BLASNodeGemv*>(&blas_node);
+        if (gemm && !gemm->epilogue().is_null()) return false;
+        if (gemv && !gemv->epilogue().is_null()) return false;
+    }
+
+    // The device buffer must be a copy of the whole container that no other connector shares
+    return whole && operand.packed &&
+           blas::cublas_buffer_key(dfg, blas_node, operand.conn) == container;
+}
+
+std::vector<std::vector<blas::BLASNode*>> BLASResidency::runs() {
+    std::vector<std::vector<blas::BLASNode*>> result;
+    std::vector<blas::BLASNode*> run;
+    for (size_t i = 0; i < this->sequence_.size(); ++i) {
+        auto child = this->sequence_.at(i);
+        auto blas_node = this->blas_node(child.first);
+        if (blas_node) run.push_back(blas_node);
+
+        // Assignments may change the sizes of the operands
+        if (!blas_node || !child.second.assignments().empty()) {
+            if (run.size() > 1) result.push_back(run);
+            run.clear();
+        }
+    }
+    if (run.size() > 1) result.push_back(run);
+    return result;
+}
+
+BLASResidency::BLASResidency(structured_control_flow::Sequence& sequence) : sequence_(sequence) {}
+
+std::string BLASResidency::name() const { return "BLASResidency"; }
+
+bool BLASResidency::can_be_applied(builder::StructuredSDFGBuilder& builder,
+                                   analysis::AnalysisManager& analysis_manager) {
+    return !this->runs().empty();
+}
+
+void BLASResidency::apply(builder::StructuredSDFGBuilder& builder,
+                          analysis::AnalysisManager& analysis_manager) {
+    for (auto& run : this->runs()) {
+        // Collect the containers touched by each node and the operands that may stay on the device
+        std::vector<std::unordered_set<std::string>> touched(run.size());
+        std::vector<std::unordered_map<std::string, Operand>> resident(run.size());
+        for (size_t i = 0; i < run.size(); ++i) {
+            for (auto& operand : this->operands(*run[i])) {
+                run[i]->set_resident_input(operand.conn, false);
+                run[i]->set_resident_output(operand.conn, false);
+
+                std::string container;
+                if (this->eligible(*run[i], operand, container)) {
+                    resident[i].insert({container, operand});
+                }
+                touched[i].insert(container);
+            }
+        }
+
+        // Skip uploads of containers that the previous nodes left on the device
+        std::unordered_map<std::string, symbolic::Expression> on_device;
+        for (size_t i = 0; i < run.size(); ++i) {
+            for (auto& entry : resident[i]) {
+                if (!entry.second.read) continue;
+                auto device = on_device.find(entry.first);
+                if (device != on_device.end() && symbolic::eq(device->second, entry.second.size)) {
+                    run[i]->set_resident_input(entry.second.conn, true);
+                }
+            }
+            for (auto& container : touched[i]) {
+                auto operand = resident[i].find(container);
+                if (operand == resident[i].end()) {
+                    on_device.erase(container);
+                } else {
+                    on_device.insert_or_assign(container, operand->second.size);
+                }
+            }
+        }
+
+        // Skip downloads of outputs that a later node of the run writes again. All nodes up to
+        // that one must keep the container on the device.
+        for (size_t i = 0; i < run.size(); ++i) {
+            for (auto& entry : resident[i]) {
+                if (!entry.second.written) continue;
+                for (size_t j = i + 1; j < run.size(); ++j) {
+                    if (!touched[j].contains(entry.first)) continue;
+                    auto later = resident[j].find(entry.first);
+                    if (later == resident[j].end() ||
+                        !symbolic::eq(later->second.size, entry.second.size))
+                        break;
+                    if (later->second.written) {
+                        run[i]->set_resident_output(entry.second.conn, true);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void BLASResidency::to_json(nlohmann::json& j) const {
+    j["transformation_type"] = this->name();
+    j["sequence_element_id"] = this->sequence_.element_id();
+}
+
+BLASResidency BLASResidency::from_json(builder::StructuredSDFGBuilder& builder,
+                                       const nlohmann::json& j) {
+    size_t sequence_id = j["sequence_element_id"].get<size_t>();
+    auto sequence_element = builder.find_element_by_id(sequence_id);
+    if (!sequence_element) {
+        throw InvalidTransformationDescriptionException(
+            "Element with ID " + std::to_string(sequence_id) + " not found.");
+    }
+    auto sequence = dynamic_cast<structured_control_flow::Sequence*>(sequence_element);
+
+    return BLASResidency(*sequence);
+}
+
+}  // namespace transformations
+}  // namespace sdfg
@@ -2,19 +2,32 @@
 
 #include <sdfg/analysis/analysis.h>
 #include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/deepcopy/structured_sdfg_deep_copy.h>
 #include <sdfg/element.h>
+#include <sdfg/structured_control_flow/block.h>
+#include <sdfg/structured_control_flow/if_else.h>
+#include <sdfg/structured_control_flow/sequence.h>
+#include <sdfg/symbolic/symbolic.h>
 #include <sdfg/transformations/transformation.h>
 
+#include <cassert>
+#include <cstddef>
 #include <nlohmann/json_fwd.hpp>
 #include <string>
+#include <vector>
 
 #include "sdfg/einsum/einsum_node.h"
+#include "sdfg/einsum/einsum_tuning.h"
 
 namespace sdfg {
 namespace transformations {
 
-Einsum2BLAS::Einsum2BLAS(einsum::EinsumNode& einsum_node)
+Einsum2BLAS::Einsum2BLAS(einsum::EinsumNode& einsum_node, size_t threshold,
+                         const std::string& routine)
     : einsum_node_(einsum_node),
+      threshold_(threshold),
+      routine_(routine),
+      database_(nullptr),
       axpy_(einsum_node),
       copy_(einsum_node),
       dot_(einsum_node),
@@ -23,73 +36,157 @@ Einsum2BLAS::Einsum2BLAS(einsum::EinsumNode& einsum_node)
       ger_(einsum_node),
       syr_(einsum_node),
       gemm_(einsum_node),
+      gemm_batched_(einsum_node),
       symm_(einsum_node),
-      syrk_(einsum_node) {}
+      syrk_(einsum_node),
+      ttgt_(einsum_node) {}
 
 std::string Einsum2BLAS::name() const { return "Einsum2BLAS"; }
 
-bool Einsum2BLAS::can_be_applied(builder::StructuredSDFGBuilder& builder,
-                                 analysis::AnalysisManager& analysis_manager) {
-    if (this->axpy_.can_be_applied(builder, analysis_manager)) return true;
-    if (this->copy_.can_be_applied(builder, analysis_manager)) return true;
-    if (this->dot_.can_be_applied(builder, analysis_manager)) return true;
-    if (this->gemv_.can_be_applied(builder, analysis_manager)) return true;
-    if (this->symv_.can_be_applied(builder, analysis_manager)) return true;
-    if (this->ger_.can_be_applied(builder, analysis_manager)) return true;
-    if (this->syr_.can_be_applied(builder, analysis_manager)) return true;
-    if (this->gemm_.can_be_applied(builder, analysis_manager)) return true;
-    if (this->symm_.can_be_applied(builder, analysis_manager)) return true;
-    if (this->syrk_.can_be_applied(builder, analysis_manager)) return true;
-    return false;
+std::vector<Transformation*> Einsum2BLAS::routines() {
+    return {&this->axpy_, &this->copy_, &this->dot_,  &this->gemv_,         &this->symv_,
+            &this->ger_,  &this->syr_,  &this->gemm_, &this->gemm_batched_, &this->symm_,
+            &this->syrk_, &this->ttgt_};
 }
 
-void Einsum2BLAS::apply(builder::StructuredSDFGBuilder& builder,
-                        analysis::AnalysisManager& analysis_manager) {
-    if (this->axpy_.can_be_applied(builder, analysis_manager)) {
-        this->axpy_.apply(builder, analysis_manager);
-        return;
-    }
-    if (this->copy_.can_be_applied(builder, analysis_manager)) {
-        this->copy_.apply(builder, analysis_manager);
-        return;
-    }
-    if (this->dot_.can_be_applied(builder, analysis_manager)) {
-        this->dot_.apply(builder, analysis_manager);
-        return;
+std::string Einsum2BLAS::routine(builder::StructuredSDFGBuilder& builder) {
+    if (!this->routine_.empty() || !this->database_) return this->routine_;
+
+    auto* variant = this->database_->lookup(einsum::EinsumTuningDatabase::key(
+        builder.subject(), this->einsum_node_.get_parent(), this->einsum_node_));
+    if (!variant) return "";
+
+    // The loop nest was fastest, so no routine must match
+    if (variant->lowering.empty()) return "EinsumDispatcher";
+    return variant->lowering;
+}
+
+std::vector<std::string> Einsum2BLAS::candidates(builder::StructuredSDFGBuilder& builder,
+                                                 analysis::AnalysisManager& analysis_manager) {
+    std::vector<std::string> result;
+    for (auto* routine : this->routines()) {
+        if (routine->can_be_applied(builder, analysis_manager)) result.push_back(routine->name());
     }
-    if (this->gemv_.can_be_applied(builder, analysis_manager)) {
-        this->gemv_.apply(builder, analysis_manager);
-        return;
+    return result;
+}
+
+bool Einsum2BLAS::can_be_applied(builder::StructuredSDFGBuilder& builder,
+                                 analysis::AnalysisManager& analysis_manager) {
+    // The hybrid lowering finds the einsum node in the copy of its block, so it must be the only
+    // one there
+    if (this->threshold_ > 0) {
+        auto* block = dynamic_cast<structured_control_flow::Block*>(
+            this->einsum_node_.get_parent().get_parent());
+        if (!block) return false;
+        size_t einsum_nodes = 0;
+        for (auto& node : block->dataflow().nodes()) {
+            if (dynamic_cast<einsum::EinsumNode*>(&node)) ++einsum_nodes;
+        }
+        if (einsum_nodes != 1) return false;
     }
-    if (this->symv_.can_be_applied(builder, analysis_manager)) {
-        this->symv_.apply(builder, analysis_manager);
-        return;
+
+    std::string selected = this->routine(builder);
+    for (auto* routine : this->routines()) {
+        if (!selected.empty() && routine->name() != selected) continue;
+        if (routine->can_be_applied(builder, analysis_manager)) return true;
     }
-    if (this->ger_.can_be_applied(builder, analysis_manager)) {
-        this->ger_.apply(builder, analysis_manager);
-        return;
+    return false;
+}
+
+void Einsum2BLAS::apply_hybrid(builder::StructuredSDFGBuilder& builder,
+                               analysis::AnalysisManager& analysis_manager) {
+    // Select the routine while the einsum node still exists, the block is removed below
+    std::string selected = this->routine(builder);
+
+    // Get the block in which the einsum node lives and its parent
+    auto* block =
+        dynamic_cast<structured_control_flow::Block*>(this->einsum_node_.get_parent().get_parent());
+    auto& parent = builder.parent(*block);
+
+    // The loop nest is used if all maps have fewer iterations than the threshold. Bounds which
+    // depend on other indvars (e.g., 1 + j of triangular routines) are not defined outside of the
+    // loop nest and are bounded by the maps they depend on.
+    symbolic::Condition small = symbolic::__true__();
+    for (size_t i = 0; i < this->einsum_node_.maps().size(); ++i) {
+        bool dependent = false;
+        for (size_t j = 0; j < this->einsum_node_.maps().size(); ++j) {
+            if (symbolic::uses(this->einsum_node_.num_iteration(i), this->einsum_node_.indvar(j)))
+                dependent = true;
+        }
+        if (dependent) continue;
+        small = symbolic::And(small, symbolic::Lt(this->einsum_node_.num_iteration(i),
+                                                  symbolic::integer(this->threshold_)));
     }
-    if (this->syr_.can_be_applied(builder, analysis_manager)) {
-        this->syr_.apply(builder, analysis_manager);
-        return;
+
+    // Add an if-else after the block and copy the block into both cases
+    auto if_else_and_transition = builder.add_if_else_after(parent, *block);
+    auto& if_else = if_else_and_transition.first;
+    auto& case_loops = builder.add_case(if_else, small);
+    auto& case_blas = builder.add_case(if_else, symbolic::Not(small));
+    deepcopy::StructuredSDFGDeepCopy deep_copy_loops(builder, case_loops, *block);
+    deep_copy_loops.copy();
+    deepcopy::StructuredSDFGDeepCopy deep_copy_blas(builder, case_blas, *block);
+    deep_copy_blas.copy();
+
+    // Find position of the block
+    size_t block_index;
+    for (block_index = 0; block_index < parent.size(); ++block_index) {
+        if (parent.at(block_index).first.element_id() == block->element_id()) break;
     }
-    if (this->gemm_.can_be_applied(builder, analysis_manager)) {
-        this->gemm_.apply(builder, analysis_manager);
-        return;
+    assert(block_index < parent.size());
+
+    // Copy assignments
+    if_else_and_transition.second.assignments().insert(
+        parent.at(block_index).second.assignments().begin(),
+        parent.at(block_index).second.assignments().end());
+
+    // Remove the original block
+    builder.remove_child(parent, *block);
+
+    // Replace the einsum node in the BLAS case, which is the only one in the block
+    auto* block_blas = dynamic_cast<structured_control_flow::Block*>(&case_blas.at(0).first);
+    einsum::EinsumNode* einsum_node_blas = nullptr;
+    for (auto& node : block_blas->dataflow().nodes()) {
+        if ((einsum_node_blas = dynamic_cast<einsum::EinsumNode*>(&node))) break;
     }
-    if (this->symm_.can_be_applied(builder, analysis_manager)) {
-        this->symm_.apply(builder, analysis_manager);
+    Einsum2BLAS transformation(*einsum_node_blas, 0, selected);
+    if (transformation.can_be_applied(builder, analysis_manager))
+        transformation.apply(builder, analysis_manager);
+
+    analysis_manager.invalidate_all();
+}
+
+void Einsum2BLAS::apply(builder::StructuredSDFGBuilder& builder,
+                        analysis::AnalysisManager& analysis_manager) {
+    if (this->threshold_ > 0) {
+        this->apply_hybrid(builder, analysis_manager);
         return;
     }
-    if (this->syrk_.can_be_applied(builder, analysis_manager)) {
-        this->syrk_.apply(builder, analysis_manager);
-        return;
+    std::string selected = this->routine(builder);
+    for (auto* routine : this->routines()) {
+        if (!selected.empty() && routine->name() != selected) continue;
+        if (routine->can_be_applied(builder, analysis_manager)) {
+            routine->apply(builder, analysis_manager);
+            return;
+        }
     }
 }
 
+Einsum2BLAS::Einsum2BLAS(einsum::EinsumNode& einsum_node,
+                         const einsum::EinsumTuningDatabase& database, size_t threshold)
+    : Einsum2BLAS(einsum_node, threshold) {
+    this->database_ = &database;
+}
+
+size_t Einsum2BLAS::threshold() const { return this->threshold_; }
+
+const std::string& Einsum2BLAS::routine() const { return this->routine_; }
+
 void Einsum2BLAS::to_json(nlohmann::json& j) const {
     j["transformation_type"] = this->name();
     j["einsum_node_id"] = this->einsum_node_.element_id();
+    j["threshold"] = this->threshold_;
+    j["routine"] = this->routine_;
 }
 
 Einsum2BLAS Einsum2BLAS::from_json(builder::StructuredSDFGBuilder& builder,
@@ -101,8 +198,10 @@ Einsum2BLAS Einsum2BLAS::from_json(builder::StructuredSDFGBuilder& builder,
             "Element with ID " + std::to_string(einsum_node_id) + " not found.");
     }
     auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(einsum_node_element);
+    size_t threshold = j.contains("threshold") ? j["threshold"].get<size_t>() : 0;
+    std::string routine = j.contains("routine") ? j["routine"].get<std::string>() : "";
 
-    return Einsum2BLAS(*einsum_node);
+    return Einsum2BLAS(*einsum_node, threshold, routine);
 }
 
 }  // namespace transformations
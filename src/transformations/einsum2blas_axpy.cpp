@@ -19,6 +19,7 @@
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_axpy.h"
 #include "sdfg/einsum/einsum_node.h"
+#include "sdfg/transformations/einsum2blas_utils.h"
 
 namespace sdfg {
 namespace transformations {
@@ -29,39 +30,45 @@ std::string Einsum2BLASAxpy::name() const { return "Einsum2BLASAxpy"; }
 
 bool Einsum2BLASAxpy::can_be_applied(builder::StructuredSDFGBuilder& builder,
                                      analysis::AnalysisManager& analysis_manager) {
+    // Check that the einsum has a single output and is a single product with a sum reduction and
+    // without an epilogue
+    if (this->einsum_node_.outputs().size() != 1) return false;
+    if (this->einsum_node_.terms().size() != 1) return false;
+    if (this->einsum_node_.reduction() != einsum::ReductionType_Sum) return false;
+    if (this->einsum_node_.has_epilogue()) return false;
+
     // Check maps
     if (this->einsum_node_.maps().size() != 1) return false;
     symbolic::Symbol indvar = this->einsum_node_.indvar(0);
 
     // Check out indices
-    if (this->einsum_node_.out_indices().size() != 1) return false;
-    if (!symbolic::eq(this->einsum_node_.out_index(0), indvar)) return false;
+    symbolic::Expression incx, incy;
+    if (!vector_access(this->einsum_node_.out_indices(), indvar, incy)) return false;
 
     // Check inputs
     if (this->einsum_node_.inputs().size() == 2) {
         if (this->einsum_node_.input(1) != this->einsum_node_.output(0)) return false;
 
         // Check in indices
-        if (this->einsum_node_.in_indices(1).size() != 1) return false;
-        if (!symbolic::eq(this->einsum_node_.in_index(1, 0), indvar)) return false;
+        if (!same_indices(this->einsum_node_.in_indices(1), this->einsum_node_.out_indices()))
+            return false;
 
-        if (this->einsum_node_.in_indices(0).size() != 1) return false;
-        if (!symbolic::eq(this->einsum_node_.in_index(0, 0), indvar)) return false;
+        if (!vector_access(this->einsum_node_.in_indices(0), indvar, incx)) return false;
     } else if (this->einsum_node_.inputs().size() == 3) {
         if (this->einsum_node_.input(2) != this->einsum_node_.output(0)) return false;
 
         // Check in indices
-        if (this->einsum_node_.in_indices(2).size() != 1) return false;
-        if (!symbolic::eq(this->einsum_node_.in_index(2, 0), indvar)) return false;
+        if (!same_indices(this->einsum_node_.in_indices(2), this->einsum_node_.out_indices()))
+            return false;
 
         if (this->einsum_node_.in_indices(0).size() + this->einsum_node_.in_indices(1).size() != 1)
             return false;
         if (this->einsum_node_.in_indices(0).size() == 1) {
             // _in0 = x, _in1 = alpha
-            if (!symbolic::eq(this->einsum_node_.in_index(0, 0), indvar)) return false;
+            if (!vector_access(this->einsum_node_.in_indices(0), indvar, incx)) return false;
         } else {
             // _in0 = alpha, _in1 = x
-            if (!symbolic::eq(this->einsum_node_.in_index(1, 0), indvar)) return false;
+            if (!vector_access(this->einsum_node_.in_indices(1), indvar, incx)) return false;
         }
     } else {
         return false;
@@ -102,6 +109,13 @@ void Einsum2BLASAxpy::apply(builder::StructuredSDFGBuilder& builder,
     // Get the number of iterations (n)
     symbolic::Expression num_iteration = this->einsum_node_.num_iteration(0);
 
+    // Get the increments of x and y
+    symbolic::Symbol indvar = this->einsum_node_.indvar(0);
+    size_t x_input = (this->einsum_node_.in_indices(0).size() == 1) ? 0 : 1;
+    symbolic::Expression incx, incy;
+    vector_access(this->einsum_node_.in_indices(x_input), indvar, incx);
+    vector_access(this->einsum_node_.out_indices(), indvar, incy);
+
     // Determine the BLAS type
     blas::BLASType type;
     {
@@ -123,25 +137,28 @@ void Einsum2BLASAxpy::apply(builder::StructuredSDFGBuilder& builder,
         std::string alpha = (type == blas::BLASType_real) ? "1.0f" : "1.0";
         libnode =
             &builder.add_library_node<blas::BLASNodeAxpy, const blas::BLASType,
-                                      symbolic::Expression, std::string, std::string, std::string>(
+                                      symbolic::Expression, std::string, std::string, std::string,
+                                      symbolic::Expression, symbolic::Expression>(
                 *block, this->einsum_node_.debug_info(), type, num_iteration, alpha,
-                this->einsum_node_.input(0), this->einsum_node_.input(1));
+                this->einsum_node_.input(0), this->einsum_node_.input(1), incx, incy);
     } else if (this->einsum_node_.in_indices(0).size() == 1) {
         // Inputs: x, alpha, y
         libnode =
             &builder.add_library_node<blas::BLASNodeAxpy, const blas::BLASType,
-                                      symbolic::Expression, std::string, std::string, std::string>(
+                                      symbolic::Expression, std::string, std::string, std::string,
+                                      symbolic::Expression, symbolic::Expression>(
                 *block, this->einsum_node_.debug_info(), type, num_iteration,
                 this->einsum_node_.input(1), this->einsum_node_.input(0),
-                this->einsum_node_.input(2));
+                this->einsum_node_.input(2), incx, incy);
     } else {
         // Inputs: alpha, x, y
         libnode =
             &builder.add_library_node<blas::BLASNodeAxpy, const blas::BLASType,
-                                      symbolic::Expression, std::string, std::string, std::string>(
+                                      symbolic::Expression, std::string, std::string, std::string,
+                                      symbolic::Expression, symbolic::Expression>(
                 *block, this->einsum_node_.debug_info(), type, num_iteration,
                 this->einsum_node_.input(0), this->einsum_node_.input(1),
-                this->einsum_node_.input(2));
+                this->einsum_node_.input(2), incx, incy);
     }
 
     // Copy the memlets
@@ -12,6 +12,7 @@
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_copy.h"
 #include "sdfg/einsum/einsum_node.h"
+#include "sdfg/transformations/einsum2blas_utils.h"
 
 namespace sdfg {
 namespace transformations {
@@ -22,20 +23,26 @@ std::string Einsum2BLASCopy::name() const { return "Einsum2BLASCopy"; }
 
 bool Einsum2BLASCopy::can_be_applied(builder::StructuredSDFGBuilder& builder,
                                      analysis::AnalysisManager& analysis_manager) {
+    // Check that the einsum has a single output and is a single product with a sum reduction and
+    // without an epilogue
+    if (this->einsum_node_.outputs().size() != 1) return false;
+    if (this->einsum_node_.terms().size() != 1) return false;
+    if (this->einsum_node_.reduction() != einsum::ReductionType_Sum) return false;
+    if (this->einsum_node_.has_epilogue()) return false;
+
     // Check maps
     if (this->einsum_node_.maps().size() != 1) return false;
     symbolic::Symbol indvar = this->einsum_node_.indvar(0);
 
     // Check out indices
-    if (this->einsum_node_.out_indices().size() != 1) return false;
-    if (!symbolic::eq(this->einsum_node_.out_index(0), indvar)) return false;
+    symbolic::Expression incx, incy;
+    if (!vector_access(this->einsum_node_.out_indices(), indvar, incy)) return false;
 
     // Check input
     if (this->einsum_node_.inputs().size() != 1) return false;
 
     // Check in indices
-    if (this->einsum_node_.in_indices(0).size() != 1) return false;
-    if (!symbolic::eq(this->einsum_node_.in_index(0, 0), indvar)) return false;
+    if (!vector_access(this->einsum_node_.in_indices(0), indvar, incx)) return false;
 
     // Get the data flow graph
     auto& dfg = this->einsum_node_.get_parent();
@@ -71,6 +78,12 @@ void Einsum2BLASCopy::apply(builder::StructuredSDFGBuilder& builder,
     // Get the number of iterations (n)
     symbolic::Expression num_iteration = this->einsum_node_.num_iteration(0);
 
+    // Get the increments of x and y
+    symbolic::Symbol indvar = this->einsum_node_.indvar(0);
+    symbolic::Expression incx, incy;
+    vector_access(this->einsum_node_.in_indices(0), indvar, incx);
+    vector_access(this->einsum_node_.out_indices(), indvar, incy);
+
     // Determine the BLAS type
     blas::BLASType type;
     {
@@ -86,10 +99,12 @@ void Einsum2BLASCopy::apply(builder::StructuredSDFGBuilder& builder,
     }
 
     // Add the BLAS node for copy
-    auto& libnode = builder.add_library_node<blas::BLASNodeCopy, const blas::BLASType,
-                                             symbolic::Expression, std::string, std::string>(
-        *block, this->einsum_node_.debug_info(), type, num_iteration, this->einsum_node_.input(0),
-        this->einsum_node_.output(0));
+    auto& libnode =
+        builder.add_library_node<blas::BLASNodeCopy, const blas::BLASType, symbolic::Expression,
+                                 std::string, std::string, symbolic::Expression,
+                                 symbolic::Expression>(
+            *block, this->einsum_node_.debug_info(), type, num_iteration,
+            this->einsum_node_.input(0), this->einsum_node_.output(0), incx, incy);
 
     // Copy the memlets
     for (auto& iedge : dfg.in_edges(this->einsum_node_)) {
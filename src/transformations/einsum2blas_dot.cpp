@@ -12,6 +12,7 @@
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_dot.h"
 #include "sdfg/einsum/einsum_node.h"
+#include "sdfg/transformations/einsum2blas_utils.h"
 
 namespace sdfg {
 namespace transformations {
@@ -22,6 +23,13 @@ std::string Einsum2BLASDot::name() const { return "Einsum2BLASDot"; }
 
 bool Einsum2BLASDot::can_be_applied(builder::StructuredSDFGBuilder& builder,
                                     analysis::AnalysisManager& analysis_manager) {
+    // Check that the einsum has a single output and is a single product with a sum reduction and
+    // without an epilogue
+    if (this->einsum_node_.outputs().size() != 1) return false;
+    if (this->einsum_node_.terms().size() != 1) return false;
+    if (this->einsum_node_.reduction() != einsum::ReductionType_Sum) return false;
+    if (this->einsum_node_.has_epilogue()) return false;
+
     // Check maps
     if (this->einsum_node_.maps().size() != 1) return false;
     symbolic::Symbol indvar = this->einsum_node_.indvar(0);
@@ -34,11 +42,9 @@ bool Einsum2BLASDot::can_be_applied(builder::StructuredSDFGBuilder& builder,
     if (this->einsum_node_.input(2) != this->einsum_node_.output(0)) return false;
 
     // Check in indices
-    if (this->einsum_node_.in_indices(0).size() != 1) return false;
-    if (!symbolic::eq(this->einsum_node_.in_index(0, 0), indvar)) return false;
-
-    if (this->einsum_node_.in_indices(1).size() != 1) return false;
-    if (!symbolic::eq(this->einsum_node_.in_index(1, 0), indvar)) return false;
+    symbolic::Expression incx, incy;
+    if (!vector_access(this->einsum_node_.in_indices(0), indvar, incx)) return false;
+    if (!vector_access(this->einsum_node_.in_indices(1), indvar, incy)) return false;
 
     // Get the data flow graph
     auto& dfg = this->einsum_node_.get_parent();
@@ -75,6 +81,12 @@ void Einsum2BLASDot::apply(builder::StructuredSDFGBuilder& builder,
     // Get the number of iterations (n)
     symbolic::Expression num_iteration = this->einsum_node_.num_iteration(0);
 
+    // Get the increments of x and y
+    symbolic::Symbol indvar = this->einsum_node_.indvar(0);
+    symbolic::Expression incx, incy;
+    vector_access(this->einsum_node_.in_indices(0), indvar, incx);
+    vector_access(this->einsum_node_.in_indices(1), indvar, incy);
+
     // Determine the BLAS type
     blas::BLASType type;
     {
@@ -90,10 +102,12 @@ void Einsum2BLASDot::apply(builder::StructuredSDFGBuilder& builder,
     }
 
     // Add the BLAS node for copy
-    auto& libnode = builder.add_library_node<blas::BLASNodeDot, std::string, const blas::BLASType,
-                                             symbolic::Expression, std::string, std::string>(
-        *block, this->einsum_node_.debug_info(), this->einsum_node_.output(0), type, num_iteration,
-        this->einsum_node_.input(0), this->einsum_node_.input(1));
+    auto& libnode =
+        builder.add_library_node<blas::BLASNodeDot, std::string, const blas::BLASType,
+                                 symbolic::Expression, std::string, std::string,
+                                 symbolic::Expression, symbolic::Expression>(
+            *block, this->einsum_node_.debug_info(), this->einsum_node_.output(0), type,
+            num_iteration, this->einsum_node_.input(0), this->einsum_node_.input(1), incx, incy);
 
     // Copy the memlets
     for (auto& iedge : dfg.in_edges(this->einsum_node_)) {
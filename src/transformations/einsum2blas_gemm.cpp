@@ -17,25 +17,37 @@
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_gemm.h"
 #include "sdfg/einsum/einsum_node.h"
+#include "sdfg/transformations/einsum2blas_utils.h"
 
 namespace sdfg {
 namespace transformations {
 
 bool Einsum2BLASGemm::check_indvars(size_t indvar1, size_t indvar2) {
-    return symbolic::eq(this->einsum_node_.out_index(0), this->einsum_node_.indvar(indvar1)) &&
-           symbolic::eq(this->einsum_node_.out_index(1), this->einsum_node_.indvar(indvar2));
+    symbolic::Expression ldc;
+    return matrix_access(this->einsum_node_.out_indices(), this->einsum_node_.indvar(indvar1),
+                         this->einsum_node_.indvar(indvar2), ldc);
 }
 
-bool Einsum2BLASGemm::check_matrix_indices(const symbolic::Expression& mat_index1,
-                                           const symbolic::Expression& mat_index2,
-                                           const symbolic::Symbol& loop_index1,
-                                           const symbolic::Symbol& loop_index2) {
-    if (symbolic::eq(mat_index1, mat_index2)) return false;
-    if (!symbolic::eq(mat_index1, loop_index1) && !symbolic::eq(mat_index1, loop_index2))
-        return false;
-    if (!symbolic::eq(mat_index2, loop_index1) && !symbolic::eq(mat_index2, loop_index2))
-        return false;
-    return true;
+bool Einsum2BLASGemm::uses_indvar(size_t input, const symbolic::Symbol& indvar) {
+    for (auto& index : this->einsum_node_.in_indices(input)) {
+        if (symbolic::uses(index, indvar)) return true;
+    }
+    return false;
+}
+
+void Einsum2BLASGemm::get_input_positions(const symbolic::Symbol& indvar_outer_1,
+                                          const symbolic::Symbol& indvar_outer_2, long long& alpha,
+                                          long long& A, long long& B) {
+    for (size_t i = 0; i < this->einsum_node_.in_indices().size(); ++i) {
+        if (static_cast<long long>(i) == this->einsum_node_.getOutInputIndex())
+            continue;
+        else if (this->einsum_node_.in_indices(i).size() == 0)
+            alpha = i;
+        else if (this->uses_indvar(i, indvar_outer_1))
+            A = i;
+        else if (this->uses_indvar(i, indvar_outer_2))
+            B = i;
+    }
 }
 
 Einsum2BLASGemm::Einsum2BLASGemm(einsum::EinsumNode& einsum_node) : einsum_node_(einsum_node) {}
@@ -44,11 +56,15 @@ std::string Einsum2BLASGemm::name() const { return "Einsum2BLASGemm"; }
 
 bool Einsum2BLASGemm::can_be_applied(builder::StructuredSDFGBuilder& builder,
                                      analysis::AnalysisManager& analysis_manager) {
+    // Check that the einsum has a single output and is a single product with a sum reduction
+    if (this->einsum_node_.outputs().size() != 1) return false;
+    if (this->einsum_node_.terms().size() != 1) return false;
+    if (this->einsum_node_.reduction() != einsum::ReductionType_Sum) return false;
+
     // Check maps
     if (this->einsum_node_.maps().size() != 3) return false;
 
     // Check out indices
-    if (this->einsum_node_.out_indices().size() != 2) return false;
     symbolic::Symbol indvar_outer_1, indvar_outer_2, indvar_inner;
     if (this->check_indvars(0, 1)) {
         indvar_outer_1 = this->einsum_node_.indvar(0);
@@ -89,61 +105,26 @@ bool Einsum2BLASGemm::can_be_applied(builder::StructuredSDFGBuilder& builder,
     if (symbolic::uses(this->einsum_node_.num_iteration(2), indvar_outer_2)) return false;
     if (symbolic::uses(this->einsum_node_.num_iteration(2), indvar_inner)) return false;
 
-    // Check inputs
-    long long A = -1, B = -1, C = -1;
-    if (this->einsum_node_.inputs().size() == 3) {
-        C = 2;
-        for (size_t i = 0; i < this->einsum_node_.in_indices().size() - 1; ++i) {
-            if (this->einsum_node_.in_indices(i).size() != 2)
-                break;
-            else if (symbolic::eq(this->einsum_node_.in_index(i, 0), indvar_outer_1) ||
-                     symbolic::eq(this->einsum_node_.in_index(i, 1), indvar_outer_1))
-                A = i;
-            else if (symbolic::eq(this->einsum_node_.in_index(i, 0), indvar_outer_2) ||
-                     symbolic::eq(this->einsum_node_.in_index(i, 1), indvar_outer_2))
-                B = i;
-        }
-    } else if (this->einsum_node_.inputs().size() == 4) {
-        C = 3;
-        long long alpha = -1;
-        for (size_t i = 0; i < this->einsum_node_.in_indices().size() - 1; ++i) {
-            if (this->einsum_node_.in_indices(i).size() == 0)
-                alpha = i;
-            else if (this->einsum_node_.in_indices(i).size() != 2)
-                break;
-            else if (symbolic::eq(this->einsum_node_.in_index(i, 0), indvar_outer_1) ||
-                     symbolic::eq(this->einsum_node_.in_index(i, 1), indvar_outer_1))
-                A = i;
-            else if (symbolic::eq(this->einsum_node_.in_index(i, 0), indvar_outer_2) ||
-                     symbolic::eq(this->einsum_node_.in_index(i, 1), indvar_outer_2))
-                B = i;
-        }
-
-        // Check alpha
-        if (alpha == -1) return false;
-        if (this->einsum_node_.in_indices(alpha).size() != 0) return false;
-    } else {
-        return false;
-    }
-    if (A == -1 || B == -1 || A == B) return false;
-    if (this->einsum_node_.input(C) != this->einsum_node_.output(0)) return false;
+    // Check inputs. C is either accumulated onto (beta = 1) or overwritten (beta = 0).
+    long long alpha = -1, A = -1, B = -1;
+    long long C = this->einsum_node_.getOutInputIndex();
+    size_t num_operands = this->einsum_node_.inputs().size() - ((C >= 0) ? 1 : 0);
+    if (num_operands != 2 && num_operands != 3) return false;
+    this->get_input_positions(indvar_outer_1, indvar_outer_2, alpha, A, B);
+    if (A == -1 || B == -1) return false;
+    if (num_operands == 3 && alpha == -1) return false;
 
     // Check in indices
-    if (this->einsum_node_.in_indices(A).size() != 2) return false;
-    if (!this->check_matrix_indices(this->einsum_node_.in_index(A, 0),
-                                    this->einsum_node_.in_index(A, 1), indvar_outer_1,
-                                    indvar_inner))
+    symbolic::Expression lda, ldb;
+    if (!matrix_access(this->einsum_node_.in_indices(A), indvar_outer_1, indvar_inner, lda) &&
+        !matrix_access(this->einsum_node_.in_indices(A), indvar_inner, indvar_outer_1, lda))
         return false;
-
-    if (this->einsum_node_.in_indices(B).size() != 2) return false;
-    if (!this->check_matrix_indices(this->einsum_node_.in_index(B, 0),
-                                    this->einsum_node_.in_index(B, 1), indvar_inner,
-                                    indvar_outer_2))
+    if (!matrix_access(this->einsum_node_.in_indices(B), indvar_inner, indvar_outer_2, ldb) &&
+        !matrix_access(this->einsum_node_.in_indices(B), indvar_outer_2, indvar_inner, ldb))
+        return false;
+    if (C >= 0 &&
+        !same_indices(this->einsum_node_.in_indices(C), this->einsum_node_.out_indices()))
         return false;
-
-    if (this->einsum_node_.in_indices(C).size() != 2) return false;
-    if (!symbolic::eq(this->einsum_node_.in_index(C, 0), indvar_outer_1)) return false;
-    if (!symbolic::eq(this->einsum_node_.in_index(C, 1), indvar_outer_2)) return false;
 
     // Get the data flow graph
     auto& dfg = this->einsum_node_.get_parent();
@@ -239,60 +220,43 @@ void Einsum2BLASGemm::apply(builder::StructuredSDFGBuilder& builder,
     }
 
     // Determine inputs
-    long long alpha = -1, A = -1, B = -1, C = -1;
-    bool has_alpha = false;
-    if (this->einsum_node_.inputs().size() == 3) {
-        C = 2;
-        for (size_t i = 0; i < this->einsum_node_.in_indices().size() - 1; ++i) {
-            if (this->einsum_node_.in_indices(i).size() != 2)
-                break;
-            else if (symbolic::eq(this->einsum_node_.in_index(i, 0), indvar_outer_1) ||
-                     symbolic::eq(this->einsum_node_.in_index(i, 1), indvar_outer_1))
-                A = i;
-            else if (symbolic::eq(this->einsum_node_.in_index(i, 0), indvar_outer_2) ||
-                     symbolic::eq(this->einsum_node_.in_index(i, 1), indvar_outer_2))
-                B = i;
-        }
-    } else if (this->einsum_node_.inputs().size() == 4) {
-        C = 3;
-        has_alpha = true;
-        for (size_t i = 0; i < this->einsum_node_.in_indices().size() - 1; ++i) {
-            if (this->einsum_node_.in_indices(i).size() == 0)
-                alpha = i;
-            else if (this->einsum_node_.in_indices(i).size() != 2)
-                break;
-            else if (symbolic::eq(this->einsum_node_.in_index(i, 0), indvar_outer_1) ||
-                     symbolic::eq(this->einsum_node_.in_index(i, 1), indvar_outer_1))
-                A = i;
-            else if (symbolic::eq(this->einsum_node_.in_index(i, 0), indvar_outer_2) ||
-                     symbolic::eq(this->einsum_node_.in_index(i, 1), indvar_outer_2))
-                B = i;
-        }
-    }
+    long long alpha = -1, A = -1, B = -1;
+    long long C = this->einsum_node_.getOutInputIndex();
+    bool has_alpha = (this->einsum_node_.inputs().size() - ((C >= 0) ? 1 : 0) == 3);
+    this->get_input_positions(indvar_outer_1, indvar_outer_2, alpha, A, B);
 
-    // Determine transA and transB
+    // Determine transA and transB and the leading dimensions
     blas::BLASTranspose transA, transB;
-    if (symbolic::eq(this->einsum_node_.in_index(A, 0), indvar_outer_1))
+    symbolic::Expression lda, ldb, ldc;
+    if (matrix_access(this->einsum_node_.in_indices(A), indvar_outer_1, indvar_inner, lda)) {
         transA = blas::BLASTranspose_No;
-    else
+    } else {
+        matrix_access(this->einsum_node_.in_indices(A), indvar_inner, indvar_outer_1, lda);
         transA = blas::BLASTranspose_Transpose;
-    if (symbolic::eq(this->einsum_node_.in_index(B, 1), indvar_outer_2))
+    }
+    if (matrix_access(this->einsum_node_.in_indices(B), indvar_inner, indvar_outer_2, ldb)) {
         transB = blas::BLASTranspose_No;
-    else
+    } else {
+        matrix_access(this->einsum_node_.in_indices(B), indvar_outer_2, indvar_inner, ldb);
         transB = blas::BLASTranspose_Transpose;
+    }
+    matrix_access(this->einsum_node_.out_indices(), indvar_outer_1, indvar_outer_2, ldc);
 
-    // Determine alpha
+    // Determine alpha and beta
     std::string alpha_input = has_alpha ? this->einsum_node_.input(alpha)
                                         : ((type == blas::BLASType_real) ? "1.0f" : "1.0");
+    std::string beta_input = (C >= 0) ? blas::blasOne(type) : blas::blasZero(type);
 
     // Add the BLAS node for gemm
     data_flow::LibraryNode& libnode =
         builder.add_library_node<blas::BLASNodeGemm, const blas::BLASType, blas::BLASTranspose,
                                  blas::BLASTranspose, symbolic::Expression, symbolic::Expression,
                                  symbolic::Expression, std::string, std::string, std::string,
-                                 std::string>(
+                                 std::string, symbolic::Expression, symbolic::Expression,
+                                 symbolic::Expression, std::string, symbolic::Expression>(
             *block, this->einsum_node_.debug_info(), type, transA, transB, m, n, k, alpha_input,
-            this->einsum_node_.input(A), this->einsum_node_.input(B), this->einsum_node_.input(C));
+            this->einsum_node_.input(A), this->einsum_node_.input(B), this->einsum_node_.output(0),
+            lda, ldb, ldc, beta_input, this->einsum_node_.epilogue());
 
     // Copy the memlets
     for (auto& iedge : dfg.in_edges(this->einsum_node_)) {
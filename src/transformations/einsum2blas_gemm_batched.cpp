@@ -0,0 +1,287 @@
+#include "sdfg/transformations/einsum2blas_gemm_batched.h"
+
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/data_flow/access_node.h>
+#include <sdfg/data_flow/library_node.h>
+#include <sdfg/data_flow/memlet.h>
+#include <sdfg/structured_control_flow/block.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/transformations/transformation.h>
+#include <sdfg/types/type.h>
+#include <sdfg/types/utils.h>
+
+#include <cstddef>
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sdfg/blas/blas_node.h"
+#include "sdfg/blas/blas_node_gemm_batched.h"
+#include "sdfg/einsum/einsum_node.h"
+#include "sdfg/transformations/einsum2blas_utils.h"
+
+namespace sdfg {
+namespace transformations {
+
+bool Einsum2BLASGemmBatched::get_indvars(std::vector<size_t>& batch, size_t& outer_1,
+                                         size_t& outer_2, size_t& inner) {
+    auto& out_indices = this->einsum_node_.out_indices();
+    size_t num_maps = this->einsum_node_.maps().size();
+    if (num_maps < 4 || out_indices.size() != num_maps - 1) return false;
+
+    // Every out index must be a distinct indvar
+    std::vector<bool> used(num_maps, false);
+    std::vector<size_t> positions;
+    for (auto& index : out_indices) {
+        bool found = false;
+        for (size_t i = 0; i < num_maps; ++i) {
+            if (!used[i] && symbolic::eq(index, this->einsum_node_.indvar(i))) {
+                used[i] = true;
+                positions.push_back(i);
+                found = true;
+                break;
+            }
+        }
+        if (!found) return false;
+    }
+
+    // The leading out indices are the batch, the trailing two are the rows and columns of C
+    batch.assign(positions.begin(), positions.end() - 2);
+    outer_1 = positions.at(positions.size() - 2);
+    outer_2 = positions.at(positions.size() - 1);
+    for (size_t i = 0; i < num_maps; ++i) {
+        if (!used[i]) inner = i;
+    }
+
+    return true;
+}
+
+bool Einsum2BLASGemmBatched::batch_prefix(size_t input, const std::vector<size_t>& batch) {
+    auto& indices = this->einsum_node_.in_indices(input);
+    if (indices.size() != batch.size() + 2) return false;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (!symbolic::eq(indices.at(i), this->einsum_node_.indvar(batch.at(i)))) return false;
+    }
+    return true;
+}
+
+data_flow::Subset Einsum2BLASGemmBatched::matrix_indices(size_t input, size_t num_batch) {
+    auto& indices = this->einsum_node_.in_indices(input);
+    return data_flow::Subset(indices.begin() + num_batch, indices.end());
+}
+
+void Einsum2BLASGemmBatched::get_input_positions(const std::vector<size_t>& batch,
+                                                 const symbolic::Symbol& indvar_outer_1,
+                                                 const symbolic::Symbol& indvar_outer_2,
+                                                 long long& alpha, long long& A, long long& B) {
+    for (size_t i = 0; i < this->einsum_node_.in_indices().size(); ++i) {
+        if (static_cast<long long>(i) == this->einsum_node_.getOutInputIndex()) continue;
+        if (this->einsum_node_.in_indices(i).size() == 0) {
+            alpha = i;
+            continue;
+        }
+        if (!this->batch_prefix(i, batch)) continue;
+        for (auto& index : this->matrix_indices(i, batch.size())) {
+            if (symbolic::uses(index, indvar_outer_1)) {
+                A = i;
+                break;
+            } else if (symbolic::uses(index, indvar_outer_2)) {
+                B = i;
+                break;
+            }
+        }
+    }
+}
+
+Einsum2BLASGemmBatched::Einsum2BLASGemmBatched(einsum::EinsumNode& einsum_node)
+    : einsum_node_(einsum_node) {}
+
+std::string Einsum2BLASGemmBatched::name() const { return "Einsum2BLASGemmBatched"; }
+
+bool Einsum2BLASGemmBatched::can_be_applied(builder::StructuredSDFGBuilder& builder,
+                                            analysis::AnalysisManager& analysis_manager) {
+    // Check that the einsum has a single output and is a single product with a sum reduction and
+    // without an epilogue
+    if (this->einsum_node_.outputs().size() != 1) return false;
+    if (this->einsum_node_.terms().size() != 1) return false;
+    if (this->einsum_node_.reduction() != einsum::ReductionType_Sum) return false;
+    if (this->einsum_node_.has_epilogue()) return false;
+
+    // Check maps and out indices
+    std::vector<size_t> batch;
+    size_t outer_1, outer_2, inner;
+    if (!this->get_indvars(batch, outer_1, outer_2, inner)) return false;
+    auto& indvar_outer_1 = this->einsum_node_.indvar(outer_1);
+    auto& indvar_outer_2 = this->einsum_node_.indvar(outer_2);
+    auto& indvar_inner = this->einsum_node_.indvar(inner);
+
+    // Check bounds
+    for (size_t i = 0; i < this->einsum_node_.maps().size(); ++i) {
+        for (size_t j = 0; j < this->einsum_node_.maps().size(); ++j) {
+            if (symbolic::uses(this->einsum_node_.num_iteration(i), this->einsum_node_.indvar(j)))
+                return false;
+        }
+    }
+
+    // Check inputs. C is either accumulated onto (beta = 1) or overwritten (beta = 0).
+    long long alpha = -1, A = -1, B = -1;
+    long long C = this->einsum_node_.getOutInputIndex();
+    size_t num_operands = this->einsum_node_.inputs().size() - ((C >= 0) ? 1 : 0);
+    if (num_operands != 2 && num_operands != 3) return false;
+    this->get_input_positions(batch, indvar_outer_1, indvar_outer_2, alpha, A, B);
+    if (A == -1 || B == -1) return false;
+    if (num_operands == 3 && alpha == -1) return false;
+
+    // Check in indices. Only packed matrices are supported per batch element.
+    symbolic::Expression lda, ldb;
+    auto A_indices = this->matrix_indices(A, batch.size());
+    auto B_indices = this->matrix_indices(B, batch.size());
+    if (!matrix_access(A_indices, indvar_outer_1, indvar_inner, lda) &&
+        !matrix_access(A_indices, indvar_inner, indvar_outer_1, lda))
+        return false;
+    if (!matrix_access(B_indices, indvar_inner, indvar_outer_2, ldb) &&
+        !matrix_access(B_indices, indvar_outer_2, indvar_inner, ldb))
+        return false;
+    if (C >= 0 &&
+        !same_indices(this->einsum_node_.in_indices(C), this->einsum_node_.out_indices()))
+        return false;
+
+    // Get the data flow graph
+    auto& dfg = this->einsum_node_.get_parent();
+
+    // Determine and check the base type of output
+    auto& oedge = *dfg.out_edges(this->einsum_node_).begin();
+    auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+    const types::IType& dst_type = builder.subject().type(dst.data());
+    auto base_type =
+        types::infer_type(builder.subject(), dst_type, oedge.subset()).primitive_type();
+    if (base_type != types::PrimitiveType::Float && base_type != types::PrimitiveType::Double)
+        return false;
+
+    // Check if all inputs have the same base type
+    for (auto& iedge : dfg.in_edges(this->einsum_node_)) {
+        auto& src = dynamic_cast<const data_flow::AccessNode&>(iedge.src());
+        const types::IType& src_type = builder.subject().type(src.data());
+        if (types::infer_type(builder.subject(), src_type, iedge.subset()).primitive_type() !=
+            base_type)
+            return false;
+    }
+
+    return true;
+}
+
+void Einsum2BLASGemmBatched::apply(builder::StructuredSDFGBuilder& builder,
+                                   analysis::AnalysisManager& analysis_manager) {
+    // Get the data flow graph
+    auto& dfg = this->einsum_node_.get_parent();
+
+    // Get the block in which the einsum node lives
+    auto* block = dynamic_cast<structured_control_flow::Block*>(dfg.get_parent());
+
+    // Determine the BLAS type
+    blas::BLASType type;
+    {
+        auto& oedge = *dfg.out_edges(this->einsum_node_).begin();
+        auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+        const types::IType& dst_type = builder.subject().type(dst.data());
+        if (types::infer_type(builder.subject(), dst_type, oedge.subset()).primitive_type() ==
+            types::PrimitiveType::Float) {
+            type = blas::BLASType_real;
+        } else {
+            type = blas::BLASType_double;
+        }
+    }
+
+    // Determine indvars
+    std::vector<size_t> batch;
+    size_t outer_1, outer_2, inner;
+    this->get_indvars(batch, outer_1, outer_2, inner);
+    auto& indvar_outer_1 = this->einsum_node_.indvar(outer_1);
+    auto& indvar_outer_2 = this->einsum_node_.indvar(outer_2);
+    auto& indvar_inner = this->einsum_node_.indvar(inner);
+    std::vector<std::pair<symbolic::Symbol, symbolic::Expression>> batch_maps;
+    for (size_t i : batch) {
+        batch_maps.push_back({this->einsum_node_.indvar(i), this->einsum_node_.num_iteration(i)});
+    }
+    symbolic::Expression m = this->einsum_node_.num_iteration(outer_1);
+    symbolic::Expression n = this->einsum_node_.num_iteration(outer_2);
+    symbolic::Expression k = this->einsum_node_.num_iteration(inner);
+
+    // Determine inputs
+    long long alpha = -1, A = -1, B = -1;
+    long long C = this->einsum_node_.getOutInputIndex();
+    bool has_alpha = (this->einsum_node_.inputs().size() - ((C >= 0) ? 1 : 0) == 3);
+    this->get_input_positions(batch, indvar_outer_1, indvar_outer_2, alpha, A, B);
+
+    // Determine transA and transB
+    blas::BLASTranspose transA, transB;
+    symbolic::Expression lda, ldb;
+    if (matrix_access(this->matrix_indices(A, batch.size()), indvar_outer_1, indvar_inner, lda))
+        transA = blas::BLASTranspose_No;
+    else
+        transA = blas::BLASTranspose_Transpose;
+    if (matrix_access(this->matrix_indices(B, batch.size()), indvar_inner, indvar_outer_2, ldb))
+        transB = blas::BLASTranspose_No;
+    else
+        transB = blas::BLASTranspose_Transpose;
+
+    // Determine alpha and beta
+    std::string alpha_input = has_alpha ? this->einsum_node_.input(alpha) : blas::blasOne(type);
+    std::string beta_input = (C >= 0) ? blas::blasOne(type) : blas::blasZero(type);
+
+    // Add the BLAS node for batched gemm
+    data_flow::LibraryNode& libnode = builder.add_library_node<
+        blas::BLASNodeGemmBatched, const blas::BLASType, blas::BLASTranspose, blas::BLASTranspose,
+        const std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>&,
+        symbolic::Expression, symbolic::Expression, symbolic::Expression, std::string, std::string,
+        std::string, std::string, std::string>(
+        *block, this->einsum_node_.debug_info(), type, transA, transB, batch_maps, m, n, k,
+        alpha_input, this->einsum_node_.input(A), this->einsum_node_.input(B),
+        this->einsum_node_.output(0), beta_input);
+
+    // Copy the memlets
+    for (auto& iedge : dfg.in_edges(this->einsum_node_)) {
+        builder.add_memlet(*block, iedge.src(), iedge.src_conn(), libnode, iedge.dst_conn(),
+                           iedge.subset(), iedge.debug_info());
+    }
+    for (auto& oedge : dfg.out_edges(this->einsum_node_)) {
+        builder.add_memlet(*block, libnode, oedge.src_conn(), oedge.dst(), oedge.dst_conn(),
+                           oedge.subset(), oedge.debug_info());
+    }
+
+    // Remove the old memlets
+    while (dfg.in_edges(this->einsum_node_).begin() != dfg.in_edges(this->einsum_node_).end()) {
+        builder.remove_memlet(*block, *dfg.in_edges(this->einsum_node_).begin());
+    }
+    while (dfg.out_edges(this->einsum_node_).begin() != dfg.out_edges(this->einsum_node_).end()) {
+        builder.remove_memlet(*block, *dfg.out_edges(this->einsum_node_).begin());
+    }
+
+    // Remove the einsum node
+    builder.remove_node(*block, this->einsum_node_);
+
+    analysis_manager.invalidate_all();
+}
+
+void Einsum2BLASGemmBatched::to_json(nlohmann::json& j) const {
+    j["transformation_type"] = this->name();
+    j["einsum_node_id"] = this->einsum_node_.element_id();
+}
+
+Einsum2BLASGemmBatched Einsum2BLASGemmBatched::from_json(builder::StructuredSDFGBuilder& builder,
+                                                         const nlohmann::json& j) {
+    size_t einsum_node_id = j["einsum_node_id"].get<size_t>();
+    auto einsum_node_element = builder.find_element_by_id(einsum_node_id);
+    if (!einsum_node_element) {
+        throw InvalidTransformationDescriptionException(
+            "Element with ID " + std::to_string(einsum_node_id) + " not found.");
+    }
+    auto einsum_node = dynamic_cast<einsum::EinsumNode*>(einsum_node_element);
+
+    return Einsum2BLASGemmBatched(*einsum_node);
+}
+
+}  // namespace transformations
+}  // namespace sdfg
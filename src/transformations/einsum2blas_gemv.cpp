@@ -19,43 +19,69 @@
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_gemv.h"
 #include "sdfg/einsum/einsum_node.h"
+#include "sdfg/transformations/einsum2blas_utils.h"
 
 namespace sdfg {
 namespace transformations {
 
-bool Einsum2BLASGemv::check_matrix_indices(const symbolic::Expression& mat_index1,
-                                           const symbolic::Expression& mat_index2,
-                                           const symbolic::Symbol& loop_index1,
-                                           const symbolic::Symbol& loop_index2) {
-    if (symbolic::eq(mat_index1, mat_index2)) return false;
-    if (!symbolic::eq(mat_index1, loop_index1) && !symbolic::eq(mat_index1, loop_index2))
-        return false;
-    if (!symbolic::eq(mat_index2, loop_index1) && !symbolic::eq(mat_index2, loop_index2))
+bool Einsum2BLASGemv::get_indvars(size_t& outer, size_t& inner) {
+    if (this->einsum_node_.out_indices().size() != 1) return false;
+    auto& out_index = this->einsum_node_.out_index(0);
+    if (symbolic::uses(out_index, this->einsum_node_.indvar(0)) &&
+        !symbolic::uses(out_index, this->einsum_node_.indvar(1))) {
+        outer = 0;
+        inner = 1;
+    } else if (symbolic::uses(out_index, this->einsum_node_.indvar(1)) &&
+               !symbolic::uses(out_index, this->einsum_node_.indvar(0))) {
+        outer = 1;
+        inner = 0;
+    } else {
         return false;
+    }
     return true;
 }
 
+void Einsum2BLASGemv::get_input_positions(const symbolic::Symbol& indvar_outer, long long& alpha,
+                                          long long& A, long long& x) {
+    // A flattened matrix has a single index like x, but x does not use the outer indvar
+    for (size_t i = 0; i < this->einsum_node_.in_indices().size(); ++i) {
+        if (static_cast<long long>(i) == this->einsum_node_.getOutInputIndex()) continue;
+        switch (this->einsum_node_.in_indices(i).size()) {
+            case 0:
+                alpha = i;
+                break;
+            case 1:
+                if (symbolic::uses(this->einsum_node_.in_index(i, 0), indvar_outer))
+                    A = i;
+                else
+                    x = i;
+                break;
+            case 2:
+                A = i;
+                break;
+        }
+    }
+}
+
 Einsum2BLASGemv::Einsum2BLASGemv(einsum::EinsumNode& einsum_node) : einsum_node_(einsum_node) {}
 
 std::string Einsum2BLASGemv::name() const { return "Einsum2BLASGemv"; }
 
 bool Einsum2BLASGemv::can_be_applied(builder::StructuredSDFGBuilder& builder,
                                      analysis::AnalysisManager& analysis_manager) {
+    // Check that the einsum has a single output and is a single product with a sum reduction
+    if (this->einsum_node_.outputs().size() != 1) return false;
+    if (this->einsum_node_.terms().size() != 1) return false;
+    if (this->einsum_node_.reduction() != einsum::ReductionType_Sum) return false;
+
     // Check maps
     if (this->einsum_node_.maps().size() != 2) return false;
 
     // Check out indices
-    symbolic::Symbol indvar_outer, indvar_inner;
-    if (this->einsum_node_.out_indices().size() != 1) return false;
-    if (symbolic::eq(this->einsum_node_.out_index(0), this->einsum_node_.indvar(0))) {
-        indvar_outer = this->einsum_node_.indvar(0);
-        indvar_inner = this->einsum_node_.indvar(1);
-    } else if (symbolic::eq(this->einsum_node_.out_index(0), this->einsum_node_.indvar(1))) {
-        indvar_outer = this->einsum_node_.indvar(1);
-        indvar_inner = this->einsum_node_.indvar(0);
-    } else {
-        return false;
-    }
+    size_t outer, inner;
+    if (!this->get_indvars(outer, inner)) return false;
+    symbolic::Symbol indvar_outer = this->einsum_node_.indvar(outer);
+    symbolic::Symbol indvar_inner = this->einsum_node_.indvar(inner);
 
     // Check bounds
     if (symbolic::uses(this->einsum_node_.num_iteration(0), indvar_outer)) return false;
@@ -63,58 +89,25 @@ bool Einsum2BLASGemv::can_be_applied(builder::StructuredSDFGBuilder& builder,
     if (symbolic::uses(this->einsum_node_.num_iteration(1), indvar_outer)) return false;
     if (symbolic::uses(this->einsum_node_.num_iteration(1), indvar_inner)) return false;
 
-    // Check inputs
-    long long A = -1, x = -1, y = -1;
-    if (this->einsum_node_.inputs().size() == 3) {
-        y = 2;
-        for (size_t i = 0; i < this->einsum_node_.in_indices().size() - 1; ++i) {
-            switch (this->einsum_node_.in_indices(i).size()) {
-                case 1:
-                    x = i;
-                    break;
-                case 2:
-                    A = i;
-                    break;
-            }
-        }
-    } else if (this->einsum_node_.inputs().size() == 4) {
-        y = 3;
-        long long alpha = -1;
-        for (size_t i = 0; i < this->einsum_node_.in_indices().size() - 1; ++i) {
-            switch (this->einsum_node_.in_indices(i).size()) {
-                case 0:
-                    alpha = i;
-                    break;
-                case 1:
-                    x = i;
-                    break;
-                case 2:
-                    A = i;
-                    break;
-            }
-        }
-
-        // Check alpha
-        if (alpha == -1) return false;
-        if (this->einsum_node_.in_indices(alpha).size() != 0) return false;
-    } else {
-        return false;
-    }
-    if (A == -1 || x == -1 || x == y) return false;
-    if (this->einsum_node_.input(y) != this->einsum_node_.output(0)) return false;
+    // Check inputs. y is either accumulated onto (beta = 1) or overwritten (beta = 0).
+    long long alpha = -1, A = -1, x = -1;
+    long long y = this->einsum_node_.getOutInputIndex();
+    size_t num_operands = this->einsum_node_.inputs().size() - ((y >= 0) ? 1 : 0);
+    if (num_operands != 2 && num_operands != 3) return false;
+    this->get_input_positions(indvar_outer, alpha, A, x);
+    if (A == -1 || x == -1) return false;
+    if (num_operands == 3 && alpha == -1) return false;
 
     // Check in indices
-    if (this->einsum_node_.in_indices(A).size() != 2) return false;
-    if (!this->check_matrix_indices(this->einsum_node_.in_index(A, 0),
-                                    this->einsum_node_.in_index(A, 1), indvar_outer, indvar_inner))
+    symbolic::Expression lda, incx, incy;
+    if (!matrix_access(this->einsum_node_.in_indices(A), indvar_outer, indvar_inner, lda) &&
+        !matrix_access(this->einsum_node_.in_indices(A), indvar_inner, indvar_outer, lda))
+        return false;
+    if (!vector_access(this->einsum_node_.in_indices(x), indvar_inner, incx)) return false;
+    if (!vector_access(this->einsum_node_.out_indices(), indvar_outer, incy)) return false;
+    if (y >= 0 &&
+        !same_indices(this->einsum_node_.in_indices(y), this->einsum_node_.out_indices()))
         return false;
-    // bool trans = symbolic::eq(this->einsum_node_.in_index(A, 0), indvar_inner);
-
-    if (this->einsum_node_.in_indices(x).size() != 1) return false;
-    if (!symbolic::eq(this->einsum_node_.in_index(x, 0), indvar_inner)) return false;
-
-    if (this->einsum_node_.in_indices(y).size() != 1) return false;
-    if (!symbolic::eq(this->einsum_node_.in_index(y, 0), indvar_outer)) return false;
 
     // Get the data flow graph
     auto& dfg = this->einsum_node_.get_parent();
@@ -163,70 +156,48 @@ void Einsum2BLASGemv::apply(builder::StructuredSDFGBuilder& builder,
     }
 
     // Determine the input positions
-    long long alpha = -1, A = -1, x = -1, y = -1;
-    bool has_alpha = false;
-    if (this->einsum_node_.inputs().size() == 3) {
-        y = 2;
-        for (size_t i = 0; i < this->einsum_node_.in_indices().size() - 1; ++i) {
-            switch (this->einsum_node_.in_indices(i).size()) {
-                case 1:
-                    x = i;
-                    break;
-                case 2:
-                    A = i;
-                    break;
-            }
-        }
-    } else {
-        y = 3;
-        has_alpha = true;
-        for (size_t i = 0; i < this->einsum_node_.in_indices().size() - 1; ++i) {
-            switch (this->einsum_node_.in_indices(i).size()) {
-                case 0:
-                    alpha = i;
-                    break;
-                case 1:
-                    x = i;
-                    break;
-                case 2:
-                    A = i;
-                    break;
-            }
-        }
-    }
+    size_t outer, inner;
+    this->get_indvars(outer, inner);
+    symbolic::Symbol indvar_outer = this->einsum_node_.indvar(outer);
+    symbolic::Symbol indvar_inner = this->einsum_node_.indvar(inner);
+    long long alpha = -1, A = -1, x = -1;
+    long long y = this->einsum_node_.getOutInputIndex();
+    bool has_alpha = (this->einsum_node_.inputs().size() - ((y >= 0) ? 1 : 0) == 3);
+    this->get_input_positions(indvar_outer, alpha, A, x);
 
     // Determine m and n and if matrix is accessed in a transposed manner
-    size_t outer, inner;
-    if (symbolic::eq(this->einsum_node_.out_index(0), this->einsum_node_.indvar(0))) {
-        outer = 0;
-        inner = 1;
-    } else {
-        outer = 1;
-        inner = 0;
-    }
-    symbolic::Expression m, n;
+    symbolic::Expression m, n, lda, incx, incy;
     blas::BLASTranspose trans;
-    if (symbolic::eq(this->einsum_node_.in_index(A, 0), this->einsum_node_.out_index(0))) {
+    if (matrix_access(this->einsum_node_.in_indices(A), indvar_outer, indvar_inner, lda)) {
         m = this->einsum_node_.num_iteration(outer);
         n = this->einsum_node_.num_iteration(inner);
         trans = blas::BLASTranspose_No;
     } else {
+        matrix_access(this->einsum_node_.in_indices(A), indvar_inner, indvar_outer, lda);
         m = this->einsum_node_.num_iteration(inner);
         n = this->einsum_node_.num_iteration(outer);
         trans = blas::BLASTranspose_Transpose;
     }
 
-    // Determine alpha
+    // Determine the increments of x and y
+    vector_access(this->einsum_node_.in_indices(x), indvar_inner, incx);
+    vector_access(this->einsum_node_.out_indices(), indvar_outer, incy);
+
+    // Determine alpha and beta
     std::string alpha_input = has_alpha ? this->einsum_node_.input(alpha)
                                         : ((type == blas::BLASType_real) ? "1.0f" : "1.0");
+    std::string beta_input = (y >= 0) ? blas::blasOne(type) : blas::blasZero(type);
 
     // Add the BLAS node for gemv
     data_flow::LibraryNode& libnode =
         builder.add_library_node<blas::BLASNodeGemv, const blas::BLASType, blas::BLASTranspose,
                                  symbolic::Expression, symbolic::Expression, std::string,
-                                 std::string, std::string, std::string>(
+                                 std::string, std::string, std::string, symbolic::Expression,
+                                 symbolic::Expression, symbolic::Expression, std::string,
+                                 symbolic::Expression>(
             *block, this->einsum_node_.debug_info(), type, trans, m, n, alpha_input,
-            this->einsum_node_.input(A), this->einsum_node_.input(x), this->einsum_node_.input(y));
+            this->einsum_node_.input(A), this->einsum_node_.input(x), this->einsum_node_.output(0),
+            lda, incx, incy, beta_input, this->einsum_node_.epilogue());
 
     // Copy the memlets
     for (auto& iedge : dfg.in_edges(this->einsum_node_)) {
@@ -29,6 +29,13 @@ std::string Einsum2BLASGer::name() const { return "Einsum2BLASGer"; }
 
 bool Einsum2BLASGer::can_be_applied(builder::StructuredSDFGBuilder& builder,
                                     analysis::AnalysisManager& analysis_manager) {
+    // Check that the einsum has a single output and is a single product with a sum reduction and
+    // without an epilogue
+    if (this->einsum_node_.outputs().size() != 1) return false;
+    if (this->einsum_node_.terms().size() != 1) return false;
+    if (this->einsum_node_.reduction() != einsum::ReductionType_Sum) return false;
+    if (this->einsum_node_.has_epilogue()) return false;
+
     // Check maps
     if (this->einsum_node_.maps().size() != 2) return false;
 
@@ -0,0 +1,286 @@
+#include "sdfg/transformations/einsum2blas_ttgt.h"
+
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/data_flow/access_node.h>
+#include <sdfg/data_flow/library_node.h>
+#include <sdfg/data_flow/memlet.h>
+#include <sdfg/structured_control_flow/block.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/transformations/transformation.h>
+#include <sdfg/types/type.h>
+#include <sdfg/types/utils.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+#include <vector>
+
+#include "sdfg/blas/blas_node.h"
+#include "sdfg/blas/blas_node_gemm.h"
+#include "sdfg/einsum/einsum_node.h"
+
+namespace sdfg {
+namespace transformations {
+
+bool Einsum2BLASTTGT::as_maps(const data_flow::Subset& indices, std::vector<size_t>& maps) {
+    maps.clear();
+    for (auto& index : indices) {
+        bool found = false;
+        for (size_t i = 0; i < this->einsum_node_.maps().size(); ++i) {
+            if (symbolic::eq(index, this->einsum_node_.indvar(i))) {
+                if (std::find(maps.begin(), maps.end(), i) != maps.end()) return false;
+                maps.push_back(i);
+                found = true;
+                break;
+            }
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+bool Einsum2BLASTTGT::get_groups(long long& alpha, long long& A, long long& B,
+                                 std::vector<size_t>& free_A, std::vector<size_t>& free_B,
+                                 std::vector<size_t>& contracted, blas::BLASTranspose& transA,
+                                 blas::BLASTranspose& transB) {
+    // All indices must be distinct indvars
+    std::vector<size_t> out;
+    if (!this->as_maps(this->einsum_node_.out_indices(), out) || out.empty()) return false;
+
+    // Determine operands. A provides the first out index.
+    std::vector<size_t> maps_A, maps_B;
+    long long C = this->einsum_node_.getOutInputIndex();
+    for (size_t i = 0; i < this->einsum_node_.in_indices().size(); ++i) {
+        if (static_cast<long long>(i) == C) continue;
+        if (this->einsum_node_.in_indices(i).size() == 0) {
+            if (alpha != -1) return false;
+            alpha = i;
+            continue;
+        }
+        std::vector<size_t> maps;
+        if (!this->as_maps(this->einsum_node_.in_indices(i), maps)) return false;
+        if (A == -1 && std::find(maps.begin(), maps.end(), out.front()) != maps.end()) {
+            A = i;
+            maps_A = maps;
+        } else if (B == -1) {
+            B = i;
+            maps_B = maps;
+        } else {
+            return false;
+        }
+    }
+    if (A == -1 || B == -1) return false;
+
+    // Split the operand indices into free and contracted groups
+    std::vector<size_t> contracted_A, contracted_B;
+    free_A.clear();
+    free_B.clear();
+    for (size_t map : maps_A) {
+        if (std::find(out.begin(), out.end(), map) != out.end())
+            free_A.push_back(map);
+        else
+            contracted_A.push_back(map);
+    }
+    for (size_t map : maps_B) {
+        if (std::find(out.begin(), out.end(), map) != out.end())
+            free_B.push_back(map);
+        else
+            contracted_B.push_back(map);
+    }
+    if (free_A.empty() || free_B.empty() || contracted_A.empty()) return false;
+    if (contracted_A != contracted_B) return false;
+    contracted = contracted_A;
+
+    // Every indvar belongs to exactly one group
+    if (free_A.size() + free_B.size() + contracted.size() != this->einsum_node_.maps().size())
+        return false;
+
+    // The out indices are the free indices of A followed by the free indices of B
+    std::vector<size_t> expected_out(free_A);
+    expected_out.insert(expected_out.end(), free_B.begin(), free_B.end());
+    if (out != expected_out) return false;
+
+    // The groups must be contiguous in A and B
+    std::vector<size_t> grouped(free_A);
+    grouped.insert(grouped.end(), contracted.begin(), contracted.end());
+    if (maps_A == grouped) {
+        transA = blas::BLASTranspose_No;
+    } else {
+        grouped.assign(contracted.begin(), contracted.end());
+        grouped.insert(grouped.end(), free_A.begin(), free_A.end());
+        if (maps_A != grouped) return false;
+        transA = blas::BLASTranspose_Transpose;
+    }
+    grouped.assign(contracted.begin(), contracted.end());
+    grouped.insert(grouped.end(), free_B.begin(), free_B.end());
+    if (maps_B == grouped) {
+        transB = blas::BLASTranspose_No;
+    } else {
+        grouped.assign(free_B.begin(), free_B.end());
+        grouped.insert(grouped.end(), contracted.begin(), contracted.end());
+        if (maps_B != grouped) return false;
+        transB = blas::BLASTranspose_Transpose;
+    }
+
+    return true;
+}
+
+symbolic::Expression Einsum2BLASTTGT::flattened_size(const std::vector<size_t>& group) {
+    symbolic::Expression size = symbolic::one();
+    for (size_t map : group) size = symbolic::mul(size, this->einsum_node_.num_iteration(map));
+    return size;
+}
+
+Einsum2BLASTTGT::Einsum2BLASTTGT(einsum::EinsumNode& einsum_node) : einsum_node_(einsum_node) {}
+
+std::string Einsum2BLASTTGT::name() const { return "Einsum2BLASTTGT"; }
+
+bool Einsum2BLASTTGT::can_be_applied(builder::StructuredSDFGBuilder& builder,
+                                     analysis::AnalysisManager& analysis_manager) {
+    // Check that the einsum has a single output and is a single product with a sum reduction and
+    // without an epilogue
+    if (this->einsum_node_.outputs().size() != 1) return false;
+    if (this->einsum_node_.terms().size() != 1) return false;
+    if (this->einsum_node_.reduction() != einsum::ReductionType_Sum) return false;
+    if (this->einsum_node_.has_epilogue()) return false;
+
+    // Check index groups
+    long long alpha = -1, A = -1, B = -1;
+    std::vector<size_t> free_A, free_B, contracted;
+    blas::BLASTranspose transA, transB;
+    if (!this->get_groups(alpha, A, B, free_A, free_B, contracted, transA, transB)) return false;
+
+    // Check bounds
+    for (size_t i = 0; i < this->einsum_node_.maps().size(); ++i) {
+        for (size_t j = 0; j < this->einsum_node_.maps().size(); ++j) {
+            if (symbolic::uses(this->einsum_node_.num_iteration(i), this->einsum_node_.indvar(j)))
+                return false;
+        }
+    }
+
+    // Check the accumulated output
+    long long C = this->einsum_node_.getOutInputIndex();
+    if (C >= 0) {
+        std::vector<size_t> maps_C, out;
+        if (!this->as_maps(this->einsum_node_.in_indices(C), maps_C)) return false;
+        this->as_maps(this->einsum_node_.out_indices(), out);
+        if (maps_C != out) return false;
+    }
+
+    // Get the data flow graph
+    auto& dfg = this->einsum_node_.get_parent();
+
+    // Determine and check the base type of output
+    auto& oedge = *dfg.out_edges(this->einsum_node_).begin();
+    auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+    const types::IType& dst_type = builder.subject().type(dst.data());
+    auto base_type =
+        types::infer_type(builder.subject(), dst_type, oedge.subset()).primitive_type();
+    if (base_type != types::PrimitiveType::Float && base_type != types::PrimitiveType::Double)
+        return false;
+
+    // Check if all inputs have the same base type
+    for (auto& iedge : dfg.in_edges(this->einsum_node_)) {
+        auto& src = dynamic_cast<const data_flow::AccessNode&>(iedge.src());
+        const types::IType& src_type = builder.subject().type(src.data());
+        if (types::infer_type(builder.subject(), src_type, iedge.subset()).primitive_type() !=
+            base_type)
+            return false;
+    }
+
+    return true;
+}
+
+void Einsum2BLASTTGT::apply(builder::StructuredSDFGBuilder& builder,
+                            analysis::AnalysisManager& analysis_manager) {
+    // Get the data flow graph
+    auto& dfg = this->einsum_node_.get_parent();
+
+    // Get the block in which the einsum node lives
+    auto* block = dynamic_cast<structured_control_flow::Block*>(dfg.get_parent());
+
+    // Determine the BLAS type
+    blas::BLASType type;
+    {
+        auto& oedge = *dfg.out_edges(this->einsum_node_).begin();
+        auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+        const types::IType& dst_type = builder.subject().type(dst.data());
+        if (types::infer_type(builder.subject(), dst_type, oedge.subset()).primitive_type() ==
+            types::PrimitiveType::Float) {
+            type = blas::BLASType_real;
+        } else {
+            type = blas::BLASType_double;
+        }
+    }
+
+    // Determine the index groups and flatten them
+    long long alpha = -1, A = -1, B = -1;
+    std::vector<size_t> free_A, free_B, contracted;
+    blas::BLASTranspose transA, transB;
+    this->get_groups(alpha, A, B, free_A, free_B, contracted, transA, transB);
+    symbolic::Expression m = this->flattened_size(free_A);
+    symbolic::Expression n = this->flattened_size(free_B);
+    symbolic::Expression k = this->flattened_size(contracted);
+
+    // Determine alpha and beta
+    long long C = this->einsum_node_.getOutInputIndex();
+    std::string alpha_input = (alpha >= 0) ? this->einsum_node_.input(alpha) : blas::blasOne(type);
+    std::string beta_input = (C >= 0) ? blas::blasOne(type) : blas::blasZero(type);
+
+    // Add the BLAS node for gemm
+    data_flow::LibraryNode& libnode =
+        builder.add_library_node<blas::BLASNodeGemm, const blas::BLASType, blas::BLASTranspose,
+                                 blas::BLASTranspose, symbolic::Expression, symbolic::Expression,
+                                 symbolic::Expression, std::string, std::string, std::string,
+                                 std::string, symbolic::Expression, symbolic::Expression,
+                                 symbolic::Expression, std::string>(
+            *block, this->einsum_node_.debug_info(), type, transA, transB, m, n, k, alpha_input,
+            this->einsum_node_.input(A), this->einsum_node_.input(B), this->einsum_node_.output(0),
+            symbolic::Expression(), symbolic::Expression(), symbolic::Expression(), beta_input);
+
+    // Copy the memlets
+    for (auto& iedge : dfg.in_edges(this->einsum_node_)) {
+        builder.add_memlet(*block, iedge.src(), iedge.src_conn(), libnode, iedge.dst_conn(),
+                           iedge.subset(), iedge.debug_info());
+    }
+    for (auto& oedge : dfg.out_edges(this->einsum_node_)) {
+        builder.add_memlet(*block, libnode, oedge.src_conn(), oedge.dst(), oedge.dst_conn(),
+                           oedge.subset(), oedge.debug_info());
+    }
+
+    // Remove the old memlets
+    while (dfg.in_edges(this->einsum_node_).begin() != dfg.in_edges(this->einsum_node_).end()) {
+        builder.remove_memlet(*block, *dfg.in_edges(this->einsum_node_).begin());
+    }
+    while (dfg.out_edges(this->einsum_node_).begin() != dfg.out_edges(this->einsum_node_).end()) {
+        builder.remove_memlet(*block, *dfg.out_edges(this->einsum_node_).begin());
+    }
+
+    // Remove the einsum node
+    builder.remove_node(*block, this->einsum_node_);
+
+    analysis_manager.invalidate_all();
+}
+
+void Einsum2BLASTTGT::to_json(nlohmann::json& j) const {
+    j["transformation_type"] = this->name();
+    j["einsum_node_id"] = this->einsum_node_.element_id();
+}
+
+Einsum2BLASTTGT Einsum2BLASTTGT::from_json(builder::StructuredSDFGBuilder& builder,
+                                           const nlohmann::json& j) {
+    size_t einsum_node_id = j["einsum_node_id"].get<size_t>();
+    auto einsum_node_element = builder.find_element_by_id(einsum_node_id);
+    if (!einsum_node_element) {
+        throw InvalidTransformationDescriptionException(
+            "Element with ID " + std::to_string(einsum_node_id) + " not found.");
+    }
+    auto einsum_node = dynamic_cast<einsum::EinsumNode*>(einsum_node_element);
+
+    return Einsum2BLASTTGT(*einsum_node);
+}
+
+}  // namespace transformations
+}  // namespace sdfg
@@ -0,0 +1,60 @@
+#include "sdfg/transformations/einsum2blas_utils.h"
+
+#include <sdfg/data_flow/memlet.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <symengine/basic.h>
+
+#include <cstddef>
+
+namespace sdfg {
+namespace transformations {
+
+bool affine_index(const symbolic::Expression& index, const symbolic::Symbol& indvar,
+                  symbolic::Expression& stride, symbolic::Expression& offset) {
+    symbolic::Expression expanded = SymEngine::expand(index);
+    offset = SymEngine::expand(symbolic::subs(expanded, indvar, symbolic::zero()));
+    stride = SymEngine::expand(
+        symbolic::sub(symbolic::subs(expanded, indvar, symbolic::one()), offset));
+    if (symbolic::uses(stride, indvar)) return false;
+
+    // Reject non-linear terms in indvar
+    symbolic::Expression rest = SymEngine::expand(
+        symbolic::sub(expanded, symbolic::add(symbolic::mul(stride, indvar), offset)));
+    return symbolic::eq(rest, symbolic::zero());
+}
+
+bool same_indices(const data_flow::Subset& indices1, const data_flow::Subset& indices2) {
+    if (indices1.size() != indices2.size()) return false;
+    for (size_t i = 0; i < indices1.size(); ++i) {
+        if (!symbolic::eq(indices1.at(i), indices2.at(i))) return false;
+    }
+    return true;
+}
+
+bool vector_access(const data_flow::Subset& indices, const symbolic::Symbol& indvar,
+                   symbolic::Expression& inc) {
+    if (indices.size() != 1) return false;
+
+    symbolic::Expression offset;
+    if (!affine_index(indices.at(0), indvar, inc, offset)) return false;
+    if (!symbolic::eq(offset, symbolic::zero())) return false;
+    return !symbolic::eq(inc, symbolic::zero());
+}
+
+bool matrix_access(const data_flow::Subset& indices, const symbolic::Symbol& row,
+                   const symbolic::Symbol& col, symbolic::Expression& ld) {
+    if (indices.size() == 2) {
+        ld = symbolic::Expression();
+        return symbolic::eq(indices.at(0), row) && symbolic::eq(indices.at(1), col);
+    }
+    if (indices.size() != 1) return false;
+
+    symbolic::Expression offset;
+    if (!affine_index(indices.at(0), row, ld, offset)) return false;
+    if (!symbolic::eq(offset, col)) return false;
+    if (symbolic::uses(ld, col)) return false;
+    return !symbolic::eq(ld, symbolic::zero());
+}
+
+}  // namespace transformations
+}  // namespace sdfg
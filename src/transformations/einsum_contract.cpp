@@ -0,0 +1,553 @@
+#include "sdfg/transformations/einsum_contract.h"
+
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/data_flow/access_node.h>
+#include <sdfg/data_flow/library_node.h>
+#include <sdfg/data_flow/memlet.h>
+#include <sdfg/structured_control_flow/block.h>
+#include <sdfg/structured_control_flow/sequence.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/transformations/transformation.h>
+#include <sdfg/types/array.h>
+#include <sdfg/types/scalar.h>
+#include <sdfg/types/type.h>
+#include <sdfg/types/utils.h>
+#include <symengine/integer.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sdfg/einsum/einsum_node.h"
+
+namespace sdfg {
+namespace transformations {
+
+// Assumed number of iterations of maps with a symbolic bound
+constexpr double SYMBOLIC_NUM_ITERATIONS = 1024;
+
+// Maximum number of tensor inputs for which the contraction path is searched exhaustively
+constexpr size_t OPTIMAL_SEARCH_MAX_TENSORS = 6;
+
+// Maximum number of elements of a temporary, which is allocated on the stack
+constexpr long MAX_TEMPORARY_ELEMENTS = 64 * 1024;
+
+std::vector<size_t> EinsumContract::tensor_inputs() const {
+    std::vector<size_t> result;
+    for (size_t i = 0; i < this->einsum_node_.inputs().size(); ++i) {
+        if (this->einsum_node_.input(i) == this->einsum_node_.output(0)) continue;
+        if (this->einsum_node_.in_indices(i).size() == 0) continue;
+        result.push_back(i);
+    }
+    return result;
+}
+
+std::set<size_t> EinsumContract::used_maps(const data_flow::Subset& subset) const {
+    std::set<size_t> result;
+    for (size_t i = 0; i < this->einsum_node_.maps().size(); ++i) {
+        for (auto& index : subset) {
+            if (symbolic::eq(index, this->einsum_node_.indvar(i))) {
+                result.insert(i);
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+double EinsumContract::size(const std::set<size_t>& maps) const {
+    double result = 1;
+    for (size_t map : maps) {
+        auto& bound = this->einsum_node_.num_iteration(map);
+        if (bound->get_type_code() == SymEngine::TypeID::SYMENGINE_INTEGER)
+            result *= SymEngine::rcp_static_cast<const SymEngine::Integer>(bound)->as_int();
+        else
+            result *= SYMBOLIC_NUM_ITERATIONS;
+    }
+    return result;
+}
+
+std::set<size_t> EinsumContract::contract(const std::vector<std::set<size_t>>& operands,
+                                          size_t operand1, size_t operand2) const {
+    // Keep the maps which are used by the output or by one of the remaining operands
+    std::set<size_t> keep = this->used_maps(this->einsum_node_.out_indices());
+    for (size_t i = 0; i < operands.size(); ++i) {
+        if (i == operand1 || i == operand2) continue;
+        keep.insert(operands[i].begin(), operands[i].end());
+    }
+
+    std::set<size_t> result;
+    for (size_t map : operands[operand1]) {
+        if (keep.contains(map)) result.insert(map);
+    }
+    for (size_t map : operands[operand2]) {
+        if (keep.contains(map)) result.insert(map);
+    }
+    return result;
+}
+
+double EinsumContract::cost(const std::vector<std::set<size_t>>& operands, size_t operand1,
+                            size_t operand2) const {
+    // Number of iterations of the pairwise einsum
+    std::set<size_t> maps(operands[operand1].begin(), operands[operand1].end());
+    maps.insert(operands[operand2].begin(), operands[operand2].end());
+    double result = this->size(maps);
+
+    // Size of the temporary
+    if (operands.size() > 2) result += this->size(this->contract(operands, operand1, operand2));
+
+    return result;
+}
+
+void EinsumContract::search(std::vector<std::set<size_t>>& operands, double current_cost,
+                            std::vector<std::pair<size_t, size_t>>& current_path,
+                            double& best_cost,
+                            std::vector<std::pair<size_t, size_t>>& best_path) const {
+    if (operands.size() < 2) {
+        if (current_cost < best_cost) {
+            best_cost = current_cost;
+            best_path = current_path;
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < operands.size(); ++i) {
+        for (size_t j = i + 1; j < operands.size(); ++j) {
+            double new_cost = current_cost + this->cost(operands, i, j);
+            if (new_cost >= best_cost) continue;
+
+            std::vector<std::set<size_t>> new_operands;
+            for (size_t k = 0; k < operands.size(); ++k) {
+                if (k != i && k != j) new_operands.push_back(operands[k]);
+            }
+            new_operands.push_back(this->contract(operands, i, j));
+
+            current_path.push_back({i, j});
+            this->search(new_operands, new_cost, current_path, best_cost, best_path);
+            current_path.pop_back();
+        }
+    }
+}
+
+EinsumContract::EinsumContract(einsum::EinsumNode& einsum_node, bool greedy)
+    : einsum_node_(einsum_node), greedy_(greedy) {}
+
+std::string EinsumContract::name() const { return "EinsumContract"; }
+
+std::vector<std::pair<size_t, size_t>> EinsumContract::path() const {
+    std::vector<std::set<size_t>> operands;
+    for (size_t i : this->tensor_inputs())
+        operands.push_back(this->used_maps(this->einsum_node_.in_indices(i)));
+
+    std::vector<std::pair<size_t, size_t>> result;
+    if (operands.size() < 2) return result;
+
+    // Optimal path
+    if (!this->greedy_ && operands.size() <= OPTIMAL_SEARCH_MAX_TENSORS) {
+        std::vector<std::pair<size_t, size_t>> current_path;
+        double best_cost = std::numeric_limits<double>::infinity();
+        this->search(operands, 0, current_path, best_cost, result);
+        return result;
+    }
+
+    // Greedy path: Contract the pair which removes the most memory first and prefer the pair with
+    // fewer iterations on ties
+    while (operands.size() > 1) {
+        size_t best_i = 0, best_j = 1;
+        double best_removed = std::numeric_limits<double>::infinity();
+        double best_cost = std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < operands.size(); ++i) {
+            for (size_t j = i + 1; j < operands.size(); ++j) {
+                double removed = this->size(this->contract(operands, i, j)) -
+                                 this->size(operands[i]) - this->size(operands[j]);
+                double cost = this->cost(operands, i, j);
+                if (removed < best_removed || (removed == best_removed && cost < best_cost)) {
+                    best_i = i;
+                    best_j = j;
+                    best_removed = removed;
+                    best_cost = cost;
+                }
+            }
+        }
+
+        std::vector<std::set<size_t>> new_operands;
+        for (size_t k = 0; k < operands.size(); ++k) {
+            if (k != best_i && k != best_j) new_operands.push_back(operands[k]);
+        }
+        new_operands.push_back(this->contract(operands, best_i, best_j));
+        operands = new_operands;
+
+        result.push_back({best_i, best_j});
+    }
+
+    return result;
+}
+
+double EinsumContract::path_cost() const {
+    std::vector<std::set<size_t>> operands;
+    for (size_t i : this->tensor_inputs())
+        operands.push_back(this->used_maps(this->einsum_node_.in_indices(i)));
+
+    double result = 0;
+    for (auto& step : this->path()) {
+        result += this->cost(operands, step.first, step.second);
+
+        std::vector<std::set<size_t>> new_operands;
+        for (size_t k = 0; k < operands.size(); ++k) {
+            if (k != step.first && k != step.second) new_operands.push_back(operands[k]);
+        }
+        new_operands.push_back(this->contract(operands, step.first, step.second));
+        operands = new_operands;
+    }
+    return result;
+}
+
+bool EinsumContract::can_be_applied(builder::StructuredSDFGBuilder& builder,
+                                    analysis::AnalysisManager& analysis_manager) {
+    // Check that the einsum is a single product with a sum reduction
+    if (this->einsum_node_.terms().size() != 1) return false;
+    if (this->einsum_node_.reduction() != einsum::ReductionType_Sum) return false;
+
+    // Check that the output is accumulated
+    if (this->einsum_node_.getOutInputIndex() < 0) return false;
+
+    // Check maps
+    for (size_t i = 0; i < this->einsum_node_.maps().size(); ++i) {
+        for (size_t j = 0; j < this->einsum_node_.maps().size(); ++j) {
+            if (symbolic::uses(this->einsum_node_.num_iteration(i), this->einsum_node_.indvar(j)))
+                return false;
+        }
+    }
+
+    // Check that all indices are index variables of maps which occur at most once per operand
+    auto check_indices = [this](const data_flow::Subset& subset) {
+        return this->used_maps(subset).size() == subset.size();
+    };
+    if (!check_indices(this->einsum_node_.out_indices())) return false;
+    auto tensors = this->tensor_inputs();
+    if (tensors.size() < 3) return false;
+    std::set<size_t> tensor_maps;
+    for (size_t tensor : tensors) {
+        if (!check_indices(this->einsum_node_.in_indices(tensor))) return false;
+        auto maps = this->used_maps(this->einsum_node_.in_indices(tensor));
+        tensor_maps.insert(maps.begin(), maps.end());
+    }
+
+    // Check that every map indexes a tensor. The pairwise einsums only keep maps of tensors, so
+    // another map would leave an output index undefined or drop its repetition of the product.
+    if (tensor_maps.size() != this->einsum_node_.maps().size()) return false;
+
+    // Get the data flow graph
+    auto& dfg = this->einsum_node_.get_parent();
+    if (!dynamic_cast<structured_control_flow::Block*>(dfg.get_parent())) return false;
+
+    // Determine the base type of output
+    auto& oedge = *dfg.out_edges(this->einsum_node_).begin();
+    auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+    const types::IType& dst_type = builder.subject().type(dst.data());
+    auto base_type =
+        types::infer_type(builder.subject(), dst_type, oedge.subset()).primitive_type();
+
+    // Check that the inputs are not computed in the same block, differ from the output, and have
+    // the same base type as the output
+    std::set<std::string> connected_inputs;
+    for (auto& iedge : dfg.in_edges(this->einsum_node_)) {
+        connected_inputs.insert(iedge.dst_conn());
+        if (iedge.dst_conn() == this->einsum_node_.output(0)) continue;
+        auto& src = dynamic_cast<const data_flow::AccessNode&>(iedge.src());
+        if (dfg.in_degree(src) > 0) return false;
+        if (src.data() == dst.data()) return false;
+        const types::IType& src_type = builder.subject().type(src.data());
+        if (types::infer_type(builder.subject(), src_type, iedge.subset()).primitive_type() !=
+            base_type)
+            return false;
+    }
+    for (size_t tensor : tensors) {
+        if (!connected_inputs.contains(this->einsum_node_.input(tensor))) return false;
+    }
+
+    // Check that every temporary has a constant size which fits on the stack
+    std::vector<std::set<size_t>> operands;
+    for (size_t tensor : tensors)
+        operands.push_back(this->used_maps(this->einsum_node_.in_indices(tensor)));
+    auto path = this->path();
+    for (size_t step = 0; step + 1 < path.size(); ++step) {
+        auto result_maps = this->contract(operands, path[step].first, path[step].second);
+        long elements = 1;
+        for (size_t map : result_maps) {
+            auto& bound = this->einsum_node_.num_iteration(map);
+            if (bound->get_type_code() != SymEngine::TypeID::SYMENGINE_INTEGER) return false;
+            auto integer = SymEngine::rcp_static_cast<const SymEngine::Integer>(bound);
+            if (integer->is_negative() || integer->as_int() > MAX_TEMPORARY_ELEMENTS) return false;
+            elements *= integer->as_int();
+            if (elements > MAX_TEMPORARY_ELEMENTS) return false;
+        }
+
+        std::vector<std::set<size_t>> new_operands;
+        for (size_t k = 0; k < operands.size(); ++k) {
+            if (k != path[step].first && k != path[step].second)
+                new_operands.push_back(operands[k]);
+        }
+        new_operands.push_back(result_maps);
+        operands = new_operands;
+    }
+
+    // Check that the pairwise einsums are cheaper than the original one
+    std::set<size_t> all_maps;
+    for (size_t i = 0; i < this->einsum_node_.maps().size(); ++i) all_maps.insert(i);
+    if (this->path_cost() >= this->size(all_maps)) return false;
+
+    return true;
+}
+
+void EinsumContract::apply(builder::StructuredSDFGBuilder& builder,
+                           analysis::AnalysisManager& analysis_manager) {
+    // Get the data flow graph
+    auto& dfg = this->einsum_node_.get_parent();
+
+    // Get the block in which the einsum node lives and its parent
+    auto* block = dynamic_cast<structured_control_flow::Block*>(dfg.get_parent());
+    auto& parent = builder.parent(*block);
+
+    auto& debug_info = this->einsum_node_.debug_info();
+
+    // Determine the element type of the temporaries
+    auto& oedge = *dfg.out_edges(this->einsum_node_).begin();
+    auto* dst = dynamic_cast<data_flow::AccessNode*>(&oedge.dst());
+    std::string dst_conn = oedge.dst_conn();
+    data_flow::Subset dst_subset = oedge.subset();
+    const types::IType& dst_type = builder.subject().type(dst->data());
+    types::Scalar element_type(
+        types::infer_type(builder.subject(), dst_type, this->einsum_node_.out_indices())
+            .primitive_type());
+    std::string zero;
+    if (element_type.primitive_type() == types::PrimitiveType::Float)
+        zero = "0.0f";
+    else if (element_type.primitive_type() == types::PrimitiveType::Double)
+        zero = "0.0";
+    else
+        zero = "0";
+
+    // Collect the access nodes and subsets of the input connectors
+    std::unordered_map<std::string, std::pair<data_flow::AccessNode*, data_flow::Subset>> in_access;
+    for (auto& iedge : dfg.in_edges(this->einsum_node_)) {
+        in_access.insert({iedge.dst_conn(),
+                          {dynamic_cast<data_flow::AccessNode*>(&iedge.src()), iedge.subset()}});
+    }
+
+    struct Operand {
+        data_flow::AccessNode* access;
+        std::string container;
+        data_flow::Subset subset;
+        data_flow::Subset indices;
+    };
+
+    auto maps_of = [this](const std::set<size_t>& maps) {
+        std::vector<std::pair<symbolic::Symbol, symbolic::Expression>> result;
+        for (size_t map : maps) result.push_back(this->einsum_node_.map(map));
+        return result;
+    };
+    auto indices_of = [this](const std::set<size_t>& maps) {
+        data_flow::Subset result;
+        for (size_t map : maps) result.push_back(this->einsum_node_.indvar(map));
+        return result;
+    };
+
+    // Collect the tensor inputs
+    std::vector<Operand> operands;
+    std::vector<std::set<size_t>> operand_maps;
+    std::set<data_flow::AccessNode*> tensor_access;
+    for (size_t i : this->tensor_inputs()) {
+        auto& access = in_access.at(this->einsum_node_.input(i));
+        operands.push_back({access.first, access.first->data(), access.second,
+                            this->einsum_node_.in_indices(i)});
+        operand_maps.push_back(this->used_maps(this->einsum_node_.in_indices(i)));
+        tensor_access.insert(access.first);
+    }
+
+    // Create the pairwise einsums with temporaries as outputs in new blocks before the original one
+    auto path = this->path();
+    for (size_t step = 0; step + 1 < path.size(); ++step) {
+        size_t op1 = path[step].first, op2 = path[step].second;
+
+        std::set<size_t> result_maps = this->contract(operand_maps, op1, op2);
+        std::set<size_t> loop_maps(operand_maps[op1].begin(), operand_maps[op1].end());
+        loop_maps.insert(operand_maps[op2].begin(), operand_maps[op2].end());
+        bool reduction = loop_maps.size() != result_maps.size();
+
+        // Add the temporary container
+        std::string container;
+        size_t counter = 0;
+        do {
+            container = "_einsum_tmp" + std::to_string(counter++);
+        } while (builder.subject().exists(container));
+        std::unique_ptr<types::IType> type = element_type.clone();
+        for (auto it = result_maps.rbegin(); it != result_maps.rend(); ++it)
+            type = std::make_unique<types::Array>(*type, this->einsum_node_.num_iteration(*it));
+        builder.add_container(container, *type);
+
+        // Initialize the temporary with zero if the pairwise einsum reduces
+        if (reduction) {
+            auto& init_block = builder.add_block_before(parent, *block).first;
+            auto& tmp = builder.add_access(init_block, container);
+            auto& init_node = builder.add_library_node<
+                einsum::EinsumNode, const std::vector<std::string>&,
+                const std::vector<std::string>&,
+                std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>, data_flow::Subset,
+                std::vector<data_flow::Subset>>(init_block, debug_info, {"_out"}, {zero},
+                                                maps_of(result_maps), indices_of(result_maps),
+                                                {data_flow::Subset()});
+            builder.add_memlet(init_block, init_node, "_out", tmp, "void", {});
+        }
+
+        // Add the pairwise einsum
+        std::vector<std::string> inputs = {"_in1", "_in2"};
+        std::vector<data_flow::Subset> in_indices = {operands[op1].indices, operands[op2].indices};
+        if (reduction) {
+            inputs.push_back("_out");
+            in_indices.push_back(indices_of(result_maps));
+        }
+        auto& contract_block = builder.add_block_before(parent, *block).first;
+        auto& in1 = builder.add_access(contract_block, operands[op1].container);
+        auto& in2 = builder.add_access(contract_block, operands[op2].container);
+        auto& tmp_out = builder.add_access(contract_block, container);
+        auto& libnode =
+            builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                     const std::vector<std::string>&,
+                                     std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                     data_flow::Subset, std::vector<data_flow::Subset>>(
+                contract_block, debug_info, {"_out"}, inputs, maps_of(loop_maps),
+                indices_of(result_maps), in_indices);
+        builder.add_memlet(contract_block, in1, "void", libnode, "_in1", operands[op1].subset);
+        builder.add_memlet(contract_block, in2, "void", libnode, "_in2", operands[op2].subset);
+        if (reduction) {
+            auto& tmp_in = builder.add_access(contract_block, container);
+            builder.add_memlet(contract_block, tmp_in, "void", libnode, "_out", {});
+        }
+        builder.add_memlet(contract_block, libnode, "_out", tmp_out, "void", {});
+
+        // Replace both operands by the temporary
+        std::vector<Operand> new_operands;
+        std::vector<std::set<size_t>> new_operand_maps;
+        for (size_t k = 0; k < operands.size(); ++k) {
+            if (k == op1 || k == op2) continue;
+            new_operands.push_back(operands[k]);
+            new_operand_maps.push_back(operand_maps[k]);
+        }
+        new_operands.push_back({nullptr, container, {}, indices_of(result_maps)});
+        new_operand_maps.push_back(result_maps);
+        operands = new_operands;
+        operand_maps = new_operand_maps;
+    }
+
+    // The last pairwise einsum replaces the original einsum node. It keeps the scalar inputs,
+    // accumulates into the original output, and applies the epilogue.
+    size_t op1 = path.back().first, op2 = path.back().second;
+    std::vector<std::string> inputs;
+    std::vector<data_flow::Subset> in_indices;
+    std::vector<std::tuple<data_flow::AccessNode*, std::string, data_flow::Subset>> in_memlets;
+    size_t counter = 0;
+    for (size_t op : {op1, op2}) {
+        std::string conn = "_in" + std::to_string(++counter);
+        inputs.push_back(conn);
+        in_indices.push_back(operands[op].indices);
+        data_flow::AccessNode* access = operands[op].access;
+        if (!access) access = &builder.add_access(*block, operands[op].container);
+        in_memlets.push_back({access, conn, operands[op].subset});
+    }
+    std::set<size_t> loop_maps(operand_maps[op1].begin(), operand_maps[op1].end());
+    loop_maps.insert(operand_maps[op2].begin(), operand_maps[op2].end());
+
+    auto tensors = this->tensor_inputs();
+    long long oii = this->einsum_node_.getOutInputIndex();
+    for (size_t i = 0; i < this->einsum_node_.inputs().size(); ++i) {
+        if (i == static_cast<size_t>(oii)) continue;
+        if (std::find(tensors.begin(), tensors.end(), i) != tensors.end()) continue;
+        if (in_access.contains(this->einsum_node_.input(i))) {
+            std::string conn = "_in" + std::to_string(++counter);
+            inputs.push_back(conn);
+            in_memlets.push_back({in_access.at(this->einsum_node_.input(i)).first, conn,
+                                  in_access.at(this->einsum_node_.input(i)).second});
+        } else {
+            inputs.push_back(this->einsum_node_.input(i));
+        }
+        in_indices.push_back({});
+    }
+    inputs.push_back(this->einsum_node_.output(0));
+    in_indices.push_back(this->einsum_node_.in_indices(oii));
+    if (in_access.contains(this->einsum_node_.output(0)))
+        in_memlets.push_back({in_access.at(this->einsum_node_.output(0)).first,
+                              this->einsum_node_.output(0),
+                              in_access.at(this->einsum_node_.output(0)).second});
+
+    auto& libnode =
+        builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                 const std::vector<std::string>&,
+                                 std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                 data_flow::Subset, std::vector<data_flow::Subset>,
+                                 const std::vector<std::vector<size_t>>&, einsum::ReductionType,
+                                 const symbolic::Expression&>(
+            *block, debug_info, this->einsum_node_.outputs(), inputs, maps_of(loop_maps),
+            this->einsum_node_.out_indices(), in_indices, {}, einsum::ReductionType_Sum,
+            this->einsum_node_.epilogue());
+
+    // Create the memlets
+    for (auto& in_memlet : in_memlets) {
+        builder.add_memlet(*block, *std::get<0>(in_memlet), "void", libnode,
+                           std::get<1>(in_memlet), std::get<2>(in_memlet), debug_info);
+    }
+    builder.add_memlet(*block, libnode, this->einsum_node_.output(0), *dst, dst_conn, dst_subset,
+                       debug_info);
+
+    // Remove the old memlets
+    while (dfg.in_edges(this->einsum_node_).begin() != dfg.in_edges(this->einsum_node_).end()) {
+        builder.remove_memlet(*block, *dfg.in_edges(this->einsum_node_).begin());
+    }
+    while (dfg.out_edges(this->einsum_node_).begin() != dfg.out_edges(this->einsum_node_).end()) {
+        builder.remove_memlet(*block, *dfg.out_edges(this->einsum_node_).begin());
+    }
+
+    // Remove the einsum node
+    builder.remove_node(*block, this->einsum_node_);
+
+    // Remove the access nodes of inputs which moved to the pairwise einsums
+    for (auto* access : tensor_access) {
+        if (dfg.in_degree(*access) == 0 && dfg.out_degree(*access) == 0)
+            builder.remove_node(*block, *access);
+    }
+
+    analysis_manager.invalidate_all();
+}
+
+void EinsumContract::to_json(nlohmann::json& j) const {
+    j["transformation_type"] = this->name();
+    j["einsum_node_element_id"] = this->einsum_node_.element_id();
+    j["greedy"] = this->greedy_;
+}
+
+EinsumContract EinsumContract::from_json(builder::StructuredSDFGBuilder& builder,
+                                         const nlohmann::json& j) {
+    size_t einsum_node_id = j["einsum_node_element_id"].get<size_t>();
+    auto einsum_node_element = builder.find_element_by_id(einsum_node_id);
+    if (!einsum_node_element) {
+        throw InvalidTransformationDescriptionException(
+            "Element with ID " + std::to_string(einsum_node_id) + " not found.");
+    }
+    auto einsum_node = dynamic_cast<einsum::EinsumNode*>(einsum_node_element);
+
+    bool greedy = j.contains("greedy") ? j["greedy"].get<bool>() : false;
+
+    return EinsumContract(*einsum_node, greedy);
+}
+
+}  // namespace transformations
+}  // namespace sdfg
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "sdfg/einsum/einsum_node.h"
+#include "sdfg/transformations/transformation_profile.h"
 
 namespace sdfg {
 namespace transformations {
@@ -50,6 +51,40 @@ void EinsumExpand::visitElements(std::set<size_t>& elements,
     }
 }
 
+void EinsumExpand::visitUses(Uses& uses, const structured_control_flow::ControlFlowNode& node) {
+    if (auto block = dynamic_cast<const structured_control_flow::Block*>(&node)) {
+        auto& dfg = block->dataflow();
+        for (auto& node : dfg.nodes()) {
+            auto access_node = dynamic_cast<const data_flow::AccessNode*>(&node);
+            if (!access_node) continue;
+            if (dfg.in_degree(*access_node) > 0)
+                uses[access_node->data()].push_back({node.element_id(), analysis::Use::WRITE});
+            if (dfg.out_degree(*access_node) > 0)
+                uses[access_node->data()].push_back({node.element_id(), analysis::Use::READ});
+        }
+    } else if (auto sequence = dynamic_cast<const structured_control_flow::Sequence*>(&node)) {
+        for (size_t i = 0; i < sequence->size(); ++i) {
+            this->visitUses(uses, sequence->at(i).first);
+            auto& transition = sequence->at(i).second;
+            for (auto& assignment : transition.assignments()) {
+                uses[assignment.first->get_name()].push_back(
+                    {transition.element_id(), analysis::Use::WRITE});
+            }
+        }
+    } else if (auto if_else = dynamic_cast<const structured_control_flow::IfElse*>(&node)) {
+        for (size_t i = 0; i < if_else->size(); ++i) this->visitUses(uses, if_else->at(i).first);
+    } else if (auto while_loop = dynamic_cast<const structured_control_flow::While*>(&node)) {
+        this->visitUses(uses, while_loop->root());
+    } else if (auto loop = dynamic_cast<const structured_control_flow::For*>(&node)) {
+        uses[loop->indvar()->get_name()].push_back({loop->element_id(), analysis::Use::WRITE});
+        this->visitUses(uses, loop->root());
+    } else if (auto map_node = dynamic_cast<const structured_control_flow::Map*>(&node)) {
+        uses[map_node->indvar()->get_name()].push_back(
+            {map_node->element_id(), analysis::Use::WRITE});
+        this->visitUses(uses, map_node->root());
+    }
+}
+
 bool EinsumExpand::subsetContainsSymbol(const data_flow::Subset& subset,
                                         const symbolic::Symbol& symbol) {
     for (auto& expr : subset) {
@@ -66,6 +101,11 @@ std::string EinsumExpand::name() const { return "EinsumExpand"; }
 
 bool EinsumExpand::can_be_applied(builder::StructuredSDFGBuilder& builder,
                                   analysis::AnalysisManager& analysis_manager) {
+    TransformationProfileScope total("EinsumExpand.can_be_applied");
+
+    // Check that the einsum node has a single output
+    if (this->einsum_node_.outputs().size() != 1) return false;
+
     // Check that the einsum node is in a block in the loop
     structured_control_flow::Block* block_einsum = nullptr;
     size_t loop_root_index;
@@ -113,6 +153,15 @@ bool EinsumExpand::can_be_applied(builder::StructuredSDFGBuilder& builder,
         if (symbolic::eq(map.first, this->loop_.indvar())) return false;
     }
 
+    // Check that the loop iterates over output elements if an epilogue is applied per write-back
+    if (this->einsum_node_.has_epilogue()) {
+        bool indexes_output = false;
+        for (auto& index : this->einsum_node_.out_indices()) {
+            if (symbolic::eq(index, this->loop_.indvar())) indexes_output = true;
+        }
+        if (!indexes_output) return false;
+    }
+
     // Check that the index variable of the loop occurs without a calculation in the einsum in
     // indices
     for (auto& indices : this->einsum_node_.in_indices()) {
@@ -194,17 +243,19 @@ bool EinsumExpand::can_be_applied(builder::StructuredSDFGBuilder& builder,
             return false;
     }
 
-    // Perform a user analysis
-    auto& users = analysis_manager.get<analysis::Users>();
-    users.run(analysis_manager);
+    // Collect the uses inside the loop instead of running the user analysis on the whole SDFG
+    Uses uses;
+    {
+        TransformationProfileScope scope("EinsumExpand.uses");
+        this->visitUses(uses, this->loop_.root());
+    }
 
     // Check for every input container of the einsum node: If it is write accessed inside the loop
     // before the einsum node, the loop index variable has to be in the input indices
     for (size_t i = 0; i < this->einsum_node_.inputs().size(); ++i) {
         if (!in_containers.contains(this->einsum_node_.input(i))) continue;
-        for (auto* user : users.uses(in_containers.at(this->einsum_node_.input(i)))) {
-            if (user && user->use() == analysis::Use::WRITE && user->element() &&
-                elements_before_einsum.contains(user->element()->element_id()) &&
+        for (auto& use : uses[in_containers.at(this->einsum_node_.input(i))]) {
+            if (use.second == analysis::Use::WRITE && elements_before_einsum.contains(use.first) &&
                 !this->subsetContainsSymbol(this->einsum_node_.in_indices(i), this->loop_.indvar()))
                 return false;
         }
@@ -213,9 +264,8 @@ bool EinsumExpand::can_be_applied(builder::StructuredSDFGBuilder& builder,
     // Check for the output container of the einsum node: If it is read accessed inside the loop
     // after the einsum node, the loop index variable has to be in the output indices
     if (out_containers.contains(this->einsum_node_.output(0))) {
-        for (auto* user : users.uses(out_containers.at(this->einsum_node_.output(0)))) {
-            if (user && user->use() == analysis::Use::READ && user->element() &&
-                elements_after_einsum.contains(user->element()->element_id()) &&
+        for (auto& use : uses[out_containers.at(this->einsum_node_.output(0))]) {
+            if (use.second == analysis::Use::READ && elements_after_einsum.contains(use.first) &&
                 !this->subsetContainsSymbol(this->einsum_node_.out_indices(), this->loop_.indvar()))
                 return false;
         }
@@ -225,13 +275,11 @@ bool EinsumExpand::can_be_applied(builder::StructuredSDFGBuilder& builder,
     symbolic::SymbolSet map_indvars;
     for (auto& maps : this->einsum_node_.maps()) map_indvars.insert(maps.first);
     for (auto& sym : this->einsum_node_.symbols()) {
-        for (auto* user : users.uses(sym->__str__())) {
-            if (user && user->use() == analysis::Use::WRITE && user->element() &&
-                elements_before_einsum.contains(user->element()->element_id()) &&
+        for (auto& use : uses[sym->__str__()]) {
+            if (use.second == analysis::Use::WRITE && elements_before_einsum.contains(use.first) &&
                 !map_indvars.contains(sym))
                 return false;
-            if (user && user->use() == analysis::Use::WRITE && user->element() &&
-                elements_after_einsum.contains(user->element()->element_id()) &&
+            if (use.second == analysis::Use::WRITE && elements_after_einsum.contains(use.first) &&
                 !map_indvars.contains(sym))
                 return false;
         }
@@ -242,6 +290,8 @@ bool EinsumExpand::can_be_applied(builder::StructuredSDFGBuilder& builder,
 
 void EinsumExpand::apply(builder::StructuredSDFGBuilder& builder,
                          analysis::AnalysisManager& analysis_manager) {
+    TransformationProfileScope total("EinsumExpand.apply");
+
     // Get the block in which the einsum node lives
     structured_control_flow::Block* block_einsum = nullptr;
     size_t loop_root_index;
@@ -315,10 +365,13 @@ void EinsumExpand::apply(builder::StructuredSDFGBuilder& builder,
         builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
                                  const std::vector<std::string>&,
                                  std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
-                                 data_flow::Subset, std::vector<data_flow::Subset>>(
+                                 data_flow::Subset, std::vector<data_flow::Subset>,
+                                 const std::vector<std::vector<size_t>>&, einsum::ReductionType,
+                                 const symbolic::Expression&>(
             new_block_einsum, this->einsum_node_.debug_info(), this->einsum_node_.outputs(),
             this->einsum_node_.inputs(), new_maps, this->einsum_node_.out_indices(),
-            this->einsum_node_.in_indices());
+            this->einsum_node_.in_indices(), this->einsum_node_.terms(),
+            this->einsum_node_.reduction(), this->einsum_node_.epilogue());
 
     // Create the memlets in the new einsum block
     for (size_t i = 0; i < this->einsum_node_.outputs().size(); ++i) {
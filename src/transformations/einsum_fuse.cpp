@@ -0,0 +1,310 @@
+#include "sdfg/transformations/einsum_fuse.h"
+
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/data_flow/access_node.h>
+#include <sdfg/data_flow/memlet.h>
+#include <sdfg/element.h>
+#include <sdfg/exceptions.h>
+#include <sdfg/structured_control_flow/block.h>
+#include <sdfg/structured_control_flow/sequence.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/transformations/transformation.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <nlohmann/json.hpp>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sdfg/einsum/einsum_node.h"
+
+namespace sdfg {
+namespace transformations {
+
+EinsumFuse::EinsumFuse(einsum::EinsumNode& first, einsum::EinsumNode& second,
+                       bool allow_different_out_indices)
+    : first_(first), second_(second), allow_different_out_indices_(allow_different_out_indices) {}
+
+std::string EinsumFuse::name() const { return "EinsumFuse"; }
+
+structured_control_flow::Block* EinsumFuse::block(einsum::EinsumNode& einsum_node) const {
+    return dynamic_cast<structured_control_flow::Block*>(einsum_node.get_parent().get_parent());
+}
+
+size_t EinsumFuse::position(structured_control_flow::Sequence& parent,
+                            structured_control_flow::Block& block) const {
+    size_t index;
+    for (index = 0; index < parent.size(); ++index) {
+        if (parent.at(index).first.element_id() == block.element_id()) break;
+    }
+    return index;
+}
+
+bool EinsumFuse::can_be_applied(builder::StructuredSDFGBuilder& builder,
+                                analysis::AnalysisManager& analysis_manager) {
+    // Check that both einsum nodes live in consecutive blocks of the same sequence without
+    // assignments in between
+    auto* block1 = this->block(this->first_);
+    auto* block2 = this->block(this->second_);
+    if (!block1 || !block2 || block1 == block2) return false;
+    auto& parent = builder.parent(*block1);
+    if (&builder.parent(*block2) != &parent) return false;
+    size_t index = this->position(parent, *block1);
+    if (index + 1 >= parent.size() || &parent.at(index + 1).first != block2) return false;
+    if (!parent.at(index).second.assignments().empty()) return false;
+
+    // Check that every block only contains its einsum node and the access nodes connected to it
+    for (auto* einsum_node : {&this->first_, &this->second_}) {
+        auto& dfg = einsum_node->get_parent();
+        for (auto& node : dfg.nodes()) {
+            if (&node == einsum_node) continue;
+            if (!dynamic_cast<const data_flow::AccessNode*>(&node)) return false;
+            for (auto& iedge : dfg.in_edges(node)) {
+                if (&iedge.src() != einsum_node) return false;
+            }
+            for (auto& oedge : dfg.out_edges(node)) {
+                if (&oedge.dst() != einsum_node) return false;
+            }
+        }
+        if (dfg.out_degree(*einsum_node) != einsum_node->outputs().size()) return false;
+    }
+
+    // Check that both einsum nodes combine their outputs in the same way
+    if (this->first_.reduction() != this->second_.reduction()) return false;
+    if (this->first_.has_epilogue() || this->second_.has_epilogue()) return false;
+    if ((this->first_.getOutInputIndex() >= 0) != (this->second_.getOutInputIndex() >= 0))
+        return false;
+
+    // Check that the maps match positionally after renaming the indvars of the second einsum node.
+    // The indvars are renamed one after another, so an indvar of the second einsum node must not
+    // be renamed to another one of its indvars.
+    auto& maps1 = this->first_.maps();
+    auto& maps2 = this->second_.maps();
+    if (maps1.size() != maps2.size()) return false;
+    for (size_t i = 0; i < maps1.size(); ++i) {
+        for (size_t j = 0; j < maps2.size(); ++j) {
+            if (i != j && symbolic::eq(maps1[i].first, maps2[j].first)) return false;
+        }
+    }
+    auto rename = [&](symbolic::Expression expr) {
+        for (size_t i = 0; i < maps1.size(); ++i)
+            expr = symbolic::subs(expr, maps2[i].first, maps1[i].first);
+        return expr;
+    };
+    for (size_t i = 0; i < maps1.size(); ++i) {
+        if (!symbolic::eq(rename(maps2[i].second), maps1[i].second)) return false;
+    }
+
+    // Check that the second einsum node does not use an indvar of the first one otherwise
+    std::set<std::string> indvars2;
+    for (auto& map : maps2) indvars2.insert(map.first->get_name());
+    std::set<std::string> names2(this->second_.inputs().begin(), this->second_.inputs().end());
+    for (auto& symbol : this->second_.symbols()) {
+        if (!indvars2.contains(symbol->get_name())) names2.insert(symbol->get_name());
+    }
+    for (auto& map : maps1) {
+        if (names2.contains(map.first->get_name())) return false;
+    }
+
+    // Check that both einsum nodes write the same elements unless the outputs may have different
+    // out indices
+    if (!this->allow_different_out_indices_) {
+        if (!this->first_.shared_out_indices() || !this->second_.shared_out_indices())
+            return false;
+        auto& out_indices1 = this->first_.out_indices();
+        auto& out_indices2 = this->second_.out_indices();
+        if (out_indices1.size() != out_indices2.size()) return false;
+        for (size_t i = 0; i < out_indices1.size(); ++i) {
+            if (!symbolic::eq(rename(out_indices2[i]), out_indices1[i])) return false;
+        }
+    }
+
+    // Check that the second einsum node neither reads nor writes the outputs of the first one and
+    // does not write its inputs
+    auto& dfg1 = this->first_.get_parent();
+    auto& dfg2 = this->second_.get_parent();
+    std::set<std::string> reads1, writes1;
+    for (auto& iedge : dfg1.in_edges(this->first_))
+        reads1.insert(dynamic_cast<const data_flow::AccessNode&>(iedge.src()).data());
+    for (auto& oedge : dfg1.out_edges(this->first_))
+        writes1.insert(dynamic_cast<const data_flow::AccessNode&>(oedge.dst()).data());
+    for (auto& iedge : dfg2.in_edges(this->second_)) {
+        auto& src = dynamic_cast<const data_flow::AccessNode&>(iedge.src());
+        if (writes1.contains(src.data())) return false;
+    }
+    for (auto& oedge : dfg2.out_edges(this->second_)) {
+        auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+        if (writes1.contains(dst.data()) || reads1.contains(dst.data())) return false;
+    }
+
+    return true;
+}
+
+void EinsumFuse::apply(builder::StructuredSDFGBuilder& builder,
+                       analysis::AnalysisManager& analysis_manager) {
+    auto* block1 = this->block(this->first_);
+    auto* block2 = this->block(this->second_);
+    auto& parent = builder.parent(*block1);
+    auto& dfg1 = this->first_.get_parent();
+    auto& dfg2 = this->second_.get_parent();
+    DebugInfo debug_info = this->first_.debug_info();
+
+    auto& maps1 = this->first_.maps();
+    auto& maps2 = this->second_.maps();
+    auto rename = [&](symbolic::Expression expr) {
+        for (size_t i = 0; i < maps1.size(); ++i)
+            expr = symbolic::subs(expr, maps2[i].first, maps1[i].first);
+        return expr;
+    };
+
+    // Connectors of the second einsum node get names not used by the first one. Inputs without a
+    // memlet are constants or scalars and keep their name.
+    std::set<std::string> names(this->first_.inputs().begin(), this->first_.inputs().end());
+    names.insert(this->first_.outputs().begin(), this->first_.outputs().end());
+    std::set<std::string> conns2(this->second_.outputs().begin(), this->second_.outputs().end());
+    for (auto& iedge : dfg2.in_edges(this->second_)) conns2.insert(iedge.dst_conn());
+    std::unordered_map<std::string, std::string> renamed;
+    for (auto& conn : conns2) {
+        std::string name = conn;
+        for (size_t suffix = 1; names.contains(name) || (name != conn && conns2.contains(name));
+             ++suffix)
+            name = conn + "_" + std::to_string(suffix);
+        names.insert(name);
+        renamed.insert({conn, name});
+    }
+    auto rename_conn = [&](const std::string& conn) {
+        return renamed.contains(conn) ? renamed.at(conn) : conn;
+    };
+
+    // Outputs, inputs and terms of the second einsum node follow the ones of the first
+    std::vector<std::string> outputs = this->first_.outputs();
+    std::vector<data_flow::Subset> out_indices;
+    for (size_t output = 0; output < outputs.size(); ++output)
+        out_indices.push_back(this->first_.out_indices(output));
+    std::vector<std::string> inputs = this->first_.inputs();
+    std::vector<data_flow::Subset> in_indices = this->first_.in_indices();
+    std::vector<std::vector<size_t>> terms = this->first_.terms();
+    std::vector<size_t> term_outputs = this->first_.term_outputs();
+    size_t num_outputs1 = outputs.size(), num_inputs1 = inputs.size();
+    for (size_t output = 0; output < this->second_.outputs().size(); ++output) {
+        outputs.push_back(rename_conn(this->second_.output(output)));
+        data_flow::Subset indices;
+        for (auto& index : this->second_.out_indices(output)) indices.push_back(rename(index));
+        out_indices.push_back(indices);
+    }
+    for (size_t i = 0; i < this->second_.inputs().size(); ++i) {
+        inputs.push_back(rename_conn(this->second_.input(i)));
+        data_flow::Subset indices;
+        for (auto& index : this->second_.in_indices(i)) indices.push_back(rename(index));
+        in_indices.push_back(indices);
+    }
+    for (size_t t = 0; t < this->second_.terms().size(); ++t) {
+        std::vector<size_t> term;
+        for (size_t input : this->second_.term(t)) term.push_back(num_inputs1 + input);
+        terms.push_back(term);
+        term_outputs.push_back(num_outputs1 + this->second_.term_output(t));
+    }
+
+    auto& libnode = builder.add_library_node<
+        einsum::EinsumNode, const std::vector<std::string>&, const std::vector<std::string>&,
+        std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+        std::vector<data_flow::Subset>, std::vector<data_flow::Subset>,
+        const std::vector<std::vector<size_t>>&, einsum::ReductionType,
+        const symbolic::Expression&, const std::vector<size_t>&>(
+        *block1, debug_info, outputs, inputs, maps1, out_indices, in_indices, terms,
+        this->first_.reduction(), symbolic::Expression(), term_outputs);
+
+    // Connect the fused einsum node to the access nodes of the first einsum node. Read-only access
+    // nodes are shared with the second einsum node if it reads the same container.
+    std::vector<std::tuple<data_flow::AccessNode*, std::string, data_flow::Subset>> in_memlets;
+    std::vector<std::tuple<std::string, data_flow::AccessNode*, std::string, data_flow::Subset>>
+        out_memlets;
+    std::unordered_map<std::string, data_flow::AccessNode*> read_access;
+    for (auto& iedge : dfg1.in_edges(this->first_)) {
+        auto* src = dynamic_cast<data_flow::AccessNode*>(&iedge.src());
+        in_memlets.push_back({src, iedge.dst_conn(), iedge.subset()});
+        if (dfg1.in_degree(*src) == 0) read_access.insert({src->data(), src});
+    }
+    for (auto& oedge : dfg1.out_edges(this->first_)) {
+        auto* dst = dynamic_cast<data_flow::AccessNode*>(&oedge.dst());
+        out_memlets.push_back({oedge.src_conn(), dst, oedge.dst_conn(), oedge.subset()});
+    }
+    while (dfg1.in_edges(this->first_).begin() != dfg1.in_edges(this->first_).end()) {
+        builder.remove_memlet(*block1, *dfg1.in_edges(this->first_).begin());
+    }
+    while (dfg1.out_edges(this->first_).begin() != dfg1.out_edges(this->first_).end()) {
+        builder.remove_memlet(*block1, *dfg1.out_edges(this->first_).begin());
+    }
+    builder.remove_node(*block1, this->first_);
+    for (auto& memlet : in_memlets) {
+        builder.add_memlet(*block1, *std::get<0>(memlet), "void", libnode, std::get<1>(memlet),
+                           std::get<2>(memlet), debug_info);
+    }
+    for (auto& memlet : out_memlets) {
+        builder.add_memlet(*block1, libnode, std::get<0>(memlet), *std::get<1>(memlet),
+                           std::get<2>(memlet), std::get<3>(memlet), debug_info);
+    }
+
+    // Connect the fused einsum node to the containers of the second einsum node
+    for (auto& iedge : dfg2.in_edges(this->second_)) {
+        auto& src = dynamic_cast<const data_flow::AccessNode&>(iedge.src());
+        data_flow::AccessNode* access;
+        if (read_access.contains(src.data())) {
+            access = read_access.at(src.data());
+        } else {
+            access = &builder.add_access(*block1, src.data());
+            read_access.insert({src.data(), access});
+        }
+        builder.add_memlet(*block1, *access, "void", libnode, rename_conn(iedge.dst_conn()),
+                           iedge.subset(), debug_info);
+    }
+    for (auto& oedge : dfg2.out_edges(this->second_)) {
+        auto& dst = dynamic_cast<const data_flow::AccessNode&>(oedge.dst());
+        auto& access = builder.add_access(*block1, dst.data());
+        builder.add_memlet(*block1, libnode, rename_conn(oedge.src_conn()), access,
+                           oedge.dst_conn(), oedge.subset(), debug_info);
+    }
+
+    // Move the assignments after the second block to the first one and remove the second block
+    size_t index = this->position(parent, *block1);
+    parent.at(index).second.assignments().insert(
+        parent.at(index + 1).second.assignments().begin(),
+        parent.at(index + 1).second.assignments().end());
+    builder.remove_child(parent, *block2);
+
+    analysis_manager.invalidate_all();
+}
+
+void EinsumFuse::to_json(nlohmann::json& j) const {
+    j["transformation_type"] = this->name();
+    j["first_einsum_node_element_id"] = this->first_.element_id();
+    j["second_einsum_node_element_id"] = this->second_.element_id();
+    j["allow_different_out_indices"] = this->allow_different_out_indices_;
+}
+
+EinsumFuse EinsumFuse::from_json(builder::StructuredSDFGBuilder& builder,
+                                 const nlohmann::json& j) {
+    std::vector<einsum::EinsumNode*> einsum_nodes;
+    for (auto key : {"first_einsum_node_element_id", "second_einsum_node_element_id"}) {
+        size_t einsum_node_id = j[key].get<size_t>();
+        auto einsum_node_element = builder.find_element_by_id(einsum_node_id);
+        if (!einsum_node_element) {
+            throw InvalidTransformationDescriptionException(
+                "Element with ID " + std::to_string(einsum_node_id) + " not found.");
+        }
+        einsum_nodes.push_back(dynamic_cast<einsum::EinsumNode*>(einsum_node_element));
+    }
+
+    bool allow_different_out_indices = j.contains("allow_different_out_indices") &&
+                                       j["allow_different_out_indices"].get<bool>();
+
+    return EinsumFuse(*einsum_nodes[0], *einsum_nodes[1], allow_different_out_indices);
+}
+
+}  // namespace transformations
+}  // namespace sdfg
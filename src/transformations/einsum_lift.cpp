@@ -15,17 +15,24 @@
 #include <sdfg/symbolic/symbolic.h>
 #include <sdfg/transformations/transformation.h>
 #include <symengine/basic.h>
+#include <symengine/derivative.h>
+#include <symengine/integer.h>
+#include <symengine/mul.h>
 
 #include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <nlohmann/json_fwd.hpp>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "sdfg/einsum/einsum_node.h"
+#include "sdfg/transformations/transformation_profile.h"
 
 namespace sdfg {
 
@@ -105,184 +112,407 @@ bool EinsumLift::containsNegation(const symbolic::Expression& expr) {
     return false;
 }
 
-EinsumLift::EinsumLift(
-    std::vector<std::reference_wrapper<structured_control_flow::StructuredLoop>> loops,
-    structured_control_flow::Block& comp_block)
-    : loops_(loops), comp_block_(comp_block) {}
+symbolic::Expression EinsumLift::reductionOperand(const symbolic::Expression& expr,
+                                                  const symbolic::Symbol& comp_out) {
+    auto& args = expr->get_args();
+    if (expr->get_type_code() == SymEngine::TypeID::SYMENGINE_MUL) {
+        // All factors except the output form the operand
+        symbolic::Expression result = symbolic::one();
+        bool found = false;
+        for (auto& arg : args) {
+            if (!found && symbolic::eq(arg, comp_out))
+                found = true;
+            else
+                result = symbolic::mul(result, arg);
+        }
+        if (found) return result;
+    } else if (args.size() == 2) {
+        if (symbolic::eq(args.at(0), comp_out)) return args.at(1);
+        if (symbolic::eq(args.at(1), comp_out)) return args.at(0);
+    }
+    return symbolic::__nullptr__();
+}
 
-std::string EinsumLift::name() const { return "EinsumLift"; }
+bool EinsumLift::collectTerms(const Capture& capture, const symbolic::Expression& expr,
+                              std::vector<std::vector<Factor>>& terms) {
+    // Captured inputs by their access expression
+    std::unordered_map<std::string, Factor> factors;
+    for (size_t i = 0; i < capture.inputs.size(); ++i) {
+        factors.insert({this->createAccessExpr(capture.inputs[i], capture.in_indices[i]),
+                        {capture.inputs[i], capture.in_indices[i]}});
+    }
 
-bool EinsumLift::can_be_applied(builder::StructuredSDFGBuilder& builder,
-                                analysis::AnalysisManager& analysis_manager) {
-    // Check if loops are nested in each other with computation block inside
-    if (this->loops_.size() > 0) {
-        size_t i;
-        for (i = 0; i < this->loops_.size() - 1; ++i) {
-            if (this->loops_[i].get().root().size() != 1 ||
-                this->loops_[i].get().root().at(0).first.element_id() !=
-                    this->loops_[i + 1].get().element_id())
-                return false;
-        }
-        if (this->loops_[i].get().root().size() != 1 ||
-            this->loops_[i].get().root().at(0).first.element_id() != this->comp_block_.element_id())
+    std::function<bool(const symbolic::Expression&, std::vector<Factor>&)> collect =
+        [&](const symbolic::Expression& factor, std::vector<Factor>& term) {
+            if (factor->get_type_code() == SymEngine::TypeID::SYMENGINE_SYMBOL) {
+                auto it = factors.find(factor->__str__());
+                if (it == factors.end()) return false;
+                term.push_back(it->second);
+                return true;
+            } else if (factor->get_type_code() == SymEngine::TypeID::SYMENGINE_INTEGER) {
+                // Coefficients created by simplifying, e.g., -1 for a subtraction
+                term.push_back({factor->__str__(), {}});
+                return true;
+            } else if (factor->get_type_code() == SymEngine::TypeID::SYMENGINE_MUL) {
+                for (auto& arg : factor->get_args()) {
+                    if (!collect(arg, term)) return false;
+                }
+                return true;
+            } else if (factor->get_type_code() == SymEngine::TypeID::SYMENGINE_POW &&
+                       factor->get_args().size() == 2 &&
+                       factor->get_args().at(1)->get_type_code() ==
+                           SymEngine::TypeID::SYMENGINE_INTEGER) {
+                long exponent =
+                    SymEngine::rcp_static_cast<const SymEngine::Integer>(factor->get_args().at(1))
+                        ->as_int();
+                for (long i = 0; i < exponent; ++i) {
+                    if (!collect(factor->get_args().at(0), term)) return false;
+                }
+                return exponent > 0;
+            }
             return false;
+        };
+
+    // Every summand except the output becomes a product term
+    terms.clear();
+    for (auto& arg : expr->get_args()) {
+        if (symbolic::eq(arg, capture.comp_out)) continue;
+        if (symbolic::uses(arg, capture.comp_out)) return false;
+        terms.emplace_back();
+        if (!collect(arg, terms.back())) return false;
     }
+    return true;
+}
 
-    // Check that each loop is of sufficient form
-    for (auto loop : this->loops_) {
-        if (loop.get().init()->get_type_code() != SymEngine::TypeID::SYMENGINE_INTEGER)
-            return false;
-        if (!symbolic::eq(loop.get().init(), symbolic::zero())) return false;
-        if (loop.get().condition()->get_type_code() != SymEngine::TypeID::SYMENGINE_STRICTLESSTHAN)
-            return false;
-        if (loop.get().condition()->get_args().size() != 2) return false;
-        if (loop.get().condition()->get_args().at(0)->__str__() != loop.get().indvar()->__str__())
-            return false;
-        if (loop.get().update()->get_type_code() != SymEngine::TypeID::SYMENGINE_ADD) return false;
-        if (loop.get().update()->get_args().size() != 2) return false;
-        if (loop.get().update()->get_args().at(0)->__str__() != loop.get().indvar()->__str__() &&
-            loop.get().update()->get_args().at(1)->__str__() != loop.get().indvar()->__str__())
-            return false;
-        if (loop.get().update()->get_args().at(0)->__str__() != "1" &&
-            loop.get().update()->get_args().at(1)->__str__() != "1")
-            return false;
-        for (auto other_loop : this->loops_) {
-            if (other_loop.get().element_id() == loop.get().element_id()) continue;
-            if (other_loop.get().indvar()->__str__() == loop.get().indvar()->__str__())
-                return false;
-        }
+std::string EinsumLift::signature() {
+    // Subsets are part of the signature because they may be rewritten in place, e.g., by a loop
+    // transformation that substitutes an index variable
+    std::stringstream result;
+    auto add_memlet = [&result](const data_flow::Memlet& memlet) {
+        result << " " << memlet.element_id() << "[";
+        for (auto& index : memlet.subset()) result << index->__str__() << ",";
+        result << "]";
+    };
+    auto& comp_dfg = this->comp_block_.dataflow();
+    for (auto tasklet : comp_dfg.tasklets()) {
+        result << tasklet->element_id() << ":";
+        for (auto& iedge : comp_dfg.in_edges(*tasklet)) add_memlet(iedge);
+        for (auto& oedge : comp_dfg.out_edges(*tasklet)) add_memlet(oedge);
+        result << ";";
     }
+    return result.str();
+}
+
+EinsumLift::Capture& EinsumLift::capture() {
+    // Reuse the capture if the comp block did not change since
+    auto current = this->signature();
+    if (this->capture_ && this->capture_->signature == current) {
+        TransformationProfile::count("EinsumLift.capture_cache_hit");
+        return *this->capture_;
+    }
+    this->capture_.emplace();
+    auto& capture = *this->capture_;
+    capture.signature = current;
 
     // Capture all supported calculations from all tasklets in comp block
-    std::vector<std::string> outputs, inputs;
-    std::vector<data_flow::Subset> out_indicess, in_indices;
     auto& comp_dfg = this->comp_block_.dataflow();
     std::vector<std::pair<symbolic::Symbol, symbolic::Expression>> comps, comps_static_assign;
-    for (auto tasklet : comp_dfg.tasklets()) {
-        switch (tasklet->code()) {
-            case data_flow::TaskletCode::assign:
-            case data_flow::TaskletCode::neg:
-            case data_flow::TaskletCode::add:
-            case data_flow::TaskletCode::sub:
-            case data_flow::TaskletCode::mul:
-            case data_flow::TaskletCode::fma:
-            case data_flow::TaskletCode::max:
-            case data_flow::TaskletCode::min:
-            case data_flow::TaskletCode::pow:
-            case data_flow::TaskletCode::powf:
-            case data_flow::TaskletCode::powl:
-                break;
-            default:
-                return false;
-        }
-        auto& oedge = *comp_dfg.out_edges(*tasklet).begin();
-        std::string out_cont = dynamic_cast<const data_flow::AccessNode&>(oedge.dst()).data();
-        symbolic::Symbol new_comp_out =
-            symbolic::symbol(this->createAccessExpr(out_cont, oedge.subset()));
-        outputs.push_back(out_cont);
-        out_indicess.push_back(oedge.subset());
-        std::unordered_map<std::string, symbolic::Expression> input_map;
-        for (auto& iedge : comp_dfg.in_edges(*tasklet)) {
-            std::string in_cont = dynamic_cast<const data_flow::AccessNode&>(iedge.src()).data();
-            input_map.insert({iedge.dst_conn(),
-                              symbolic::symbol(this->createAccessExpr(in_cont, iedge.subset()))});
-            inputs.push_back(in_cont);
-            in_indices.push_back(iedge.subset());
-        }
-        std::vector<symbolic::Expression> comp_ins;
-        for (auto tasklet_input : tasklet->inputs()) {
-            if (input_map.contains(tasklet_input.first)) {
-                comp_ins.push_back(input_map.at(tasklet_input.first));
-            } else if (tasklet_input.first == "0" || tasklet_input.first == "0.0") {
-                comp_ins.push_back(symbolic::zero());
-            } else if (tasklet_input.first == "1" || tasklet_input.first == "1.0") {
-                comp_ins.push_back(symbolic::one());
-            } else {
-                comp_ins.push_back(symbolic::symbol(tasklet_input.first));
-                inputs.push_back(tasklet_input.first);
-                in_indices.push_back({});
+    {
+        TransformationProfileScope scope("EinsumLift.capture");
+        for (auto tasklet : comp_dfg.tasklets()) {
+            switch (tasklet->code()) {
+                case data_flow::TaskletCode::assign:
+                case data_flow::TaskletCode::neg:
+                case data_flow::TaskletCode::add:
+                case data_flow::TaskletCode::sub:
+                case data_flow::TaskletCode::mul:
+                case data_flow::TaskletCode::fma:
+                case data_flow::TaskletCode::max:
+                case data_flow::TaskletCode::min:
+                case data_flow::TaskletCode::pow:
+                case data_flow::TaskletCode::powf:
+                case data_flow::TaskletCode::powl:
+                    break;
+                default:
+                    return capture;
             }
-        }
-        symbolic::Expression new_comp = this->taskletCode2Expr(tasklet->code(), comp_ins);
-        if (symbolic::eq(new_comp, symbolic::__nullptr__())) return false;
-        if (tasklet->code() == data_flow::TaskletCode::assign && input_map.size() == 0)
-            comps_static_assign.push_back({new_comp_out, new_comp});
-        else
-            comps.push_back({new_comp_out, new_comp});
-    }
-
-    // Prevent one of the inputs to be a index variable
-    for (auto& input : inputs) {
-        for (auto loop : this->loops_) {
-            if (input == loop.get().indvar()->__str__()) return false;
+            auto& oedge = *comp_dfg.out_edges(*tasklet).begin();
+            std::string out_cont = dynamic_cast<const data_flow::AccessNode&>(oedge.dst()).data();
+            symbolic::Symbol new_comp_out =
+                symbolic::symbol(this->createAccessExpr(out_cont, oedge.subset()));
+            capture.outputs.push_back(out_cont);
+            capture.out_indicess.push_back(oedge.subset());
+            std::unordered_map<std::string, symbolic::Expression> input_map;
+            for (auto& iedge : comp_dfg.in_edges(*tasklet)) {
+                std::string in_cont =
+                    dynamic_cast<const data_flow::AccessNode&>(iedge.src()).data();
+                input_map.insert(
+                    {iedge.dst_conn(),
+                     symbolic::symbol(this->createAccessExpr(in_cont, iedge.subset()))});
+                capture.inputs.push_back(in_cont);
+                capture.input_conns.insert(in_cont);
+                capture.in_indices.push_back(iedge.subset());
+            }
+            std::vector<symbolic::Expression> comp_ins;
+            for (auto tasklet_input : tasklet->inputs()) {
+                if (input_map.contains(tasklet_input.first)) {
+                    comp_ins.push_back(input_map.at(tasklet_input.first));
+                } else if (tasklet_input.first == "0" || tasklet_input.first == "0.0") {
+                    comp_ins.push_back(symbolic::zero());
+                } else if (tasklet_input.first == "1" || tasklet_input.first == "1.0") {
+                    comp_ins.push_back(symbolic::one());
+                } else {
+                    comp_ins.push_back(symbolic::symbol(tasklet_input.first));
+                    capture.inputs.push_back(tasklet_input.first);
+                    capture.in_indices.push_back({});
+                }
+            }
+            symbolic::Expression new_comp = this->taskletCode2Expr(tasklet->code(), comp_ins);
+            if (symbolic::eq(new_comp, symbolic::__nullptr__())) return capture;
+            if (tasklet->code() == data_flow::TaskletCode::assign && input_map.size() == 0)
+                comps_static_assign.push_back({new_comp_out, new_comp});
+            else
+                comps.push_back({new_comp_out, new_comp});
         }
     }
+    if (comps.size() == 0) return capture;
+    capture.valid = true;
 
     // Perform a fixed point iteration to join all captured calculations to one "dummy" calculation
-    if (comps.size() == 0) return false;
+    TransformationProfileScope scope("EinsumLift.fixed_point");
     std::vector<bool> comps_used(comps.size(), false),
         comps_static_assign_used(comps_static_assign.size(), false);
-    symbolic::Symbol comp_out = comps[0].first;
-    symbolic::Expression comp = comps[0].second;
+    capture.comp_out = comps[0].first;
+    capture.comp = comps[0].second;
     comps_used[0] = true;
     bool applied = false;
     do {
         applied = false;
         for (size_t i = 0; i < comps_static_assign.size(); ++i) {
-            if (symbolic::uses(comp, comps_static_assign[i].first)) {
-                comp = symbolic::subs(comp, comps_static_assign[i].first,
-                                      comps_static_assign[i].second);
+            if (symbolic::uses(capture.comp, comps_static_assign[i].first)) {
+                capture.comp = symbolic::subs(capture.comp, comps_static_assign[i].first,
+                                              comps_static_assign[i].second);
                 applied = true;
                 comps_static_assign_used[i] = true;
             }
         }
         for (size_t i = 0; i < comps.size(); ++i) {
-            if (symbolic::eq(comp_out, comps[i].first)) continue;
-            if (symbolic::uses(comp, comps[i].first)) {
-                comp = symbolic::subs(comp, comps[i].first, comps[i].second);
+            if (symbolic::eq(capture.comp_out, comps[i].first)) continue;
+            if (symbolic::uses(capture.comp, comps[i].first)) {
+                capture.comp = symbolic::subs(capture.comp, comps[i].first, comps[i].second);
                 applied = true;
                 comps_used[i] = true;
             }
-            if (symbolic::uses(comps[i].second, comp_out)) {
-                comp = symbolic::subs(comps[i].second, comp_out, comp);
-                comp_out = comps[i].first;
+            if (symbolic::uses(comps[i].second, capture.comp_out)) {
+                capture.comp = symbolic::subs(comps[i].second, capture.comp_out, capture.comp);
+                capture.comp_out = comps[i].first;
                 applied = true;
                 comps_used[i] = true;
             }
         }
     } while (applied);
+    capture.all_used = std::all_of(comps_used.begin(), comps_used.end(),
+                                   [](bool used) { return used; }) &&
+                       std::all_of(comps_static_assign_used.begin(),
+                                   comps_static_assign_used.end(), [](bool used) { return used; });
 
-    // Check if all captured calculations were used
-    for (bool used : comps_used) {
-        if (!used) return false;
+    // Determine the output container with its subset
+    for (size_t i = 0; i < capture.outputs.size(); ++i) {
+        if (capture.comp_out->get_name() ==
+            this->createAccessExpr(capture.outputs[i], capture.out_indicess[i])) {
+            capture.output = capture.outputs[i];
+            capture.out_indices = capture.out_indicess[i];
+            break;
+        }
     }
-    for (bool used : comps_static_assign_used) {
-        if (!used) return false;
+
+    return capture;
+}
+
+const symbolic::Expression& EinsumLift::simplified(Capture& capture) {
+    if (!capture.simplified) {
+        TransformationProfileScope scope("EinsumLift.simplify");
+        capture.scomp = symbolic::simplify(capture.comp);
+        capture.simplified = true;
     }
+    return capture.scomp;
+}
 
-    // Check that we captured the output container with its subset
-    std::string output;
-    data_flow::Subset out_indices;
-    for (size_t i = 0; i < outputs.size(); ++i) {
-        if (comp_out->get_name() == this->createAccessExpr(outputs[i], out_indicess[i])) {
-            output = outputs[i];
-            out_indices = out_indicess[i];
-            break;
+bool EinsumLift::normalizeLoop(const structured_control_flow::StructuredLoop& loop,
+                               symbolic::Expression& init, long long& stride,
+                               symbolic::Expression& num_iteration) {
+    // Condition: indvar < bound
+    auto condition = loop.condition();
+    if (condition->get_type_code() != SymEngine::TypeID::SYMENGINE_STRICTLESSTHAN) return false;
+    if (condition->get_args().size() != 2) return false;
+    if (!symbolic::eq(condition->get_args().at(0), loop.indvar())) return false;
+    symbolic::Expression bound = condition->get_args().at(1);
+    if (symbolic::uses(bound, loop.indvar())) return false;
+
+    // Update: indvar + stride with a positive integer stride
+    auto update = loop.update();
+    if (update->get_type_code() != SymEngine::TypeID::SYMENGINE_ADD) return false;
+    if (update->get_args().size() != 2) return false;
+    symbolic::Expression step;
+    if (symbolic::eq(update->get_args().at(0), loop.indvar()))
+        step = update->get_args().at(1);
+    else if (symbolic::eq(update->get_args().at(1), loop.indvar()))
+        step = update->get_args().at(0);
+    else
+        return false;
+    if (step->get_type_code() != SymEngine::TypeID::SYMENGINE_INTEGER) return false;
+    stride = SymEngine::rcp_static_cast<const SymEngine::Integer>(step)->as_int();
+    if (stride < 1) return false;
+
+    // Init: any expression that does not depend on the loop itself
+    init = loop.init();
+    if (symbolic::uses(init, loop.indvar())) return false;
+
+    // Number of iterations: ceil((bound - init) / stride), or zero if init >= bound
+    symbolic::Expression span = symbolic::sub(bound, init);
+    if (span->get_type_code() == SymEngine::TypeID::SYMENGINE_INTEGER) {
+        long long iterations = SymEngine::rcp_static_cast<const SymEngine::Integer>(span)->as_int();
+        num_iteration = symbolic::integer(iterations > 0 ? (iterations + stride - 1) / stride : 0);
+        return true;
+    }
+
+    // A span that subtracts, e.g., N - j, wraps around for init > bound and is clamped at zero
+    if (!this->checkSpan(span)) span = symbolic::sub(symbolic::max(bound, init), init);
+
+    if (stride == 1) {
+        num_iteration = span;
+    } else {
+        // Keep exact quotients, e.g., N for a span of 2 * N and a stride of 2, and round up
+        // otherwise with an integer division
+        num_iteration = SymEngine::div(span, symbolic::integer(stride));
+        if (this->containsRational(num_iteration)) {
+            num_iteration = symbolic::div(symbolic::add(span, symbolic::integer(stride - 1)),
+                                          symbolic::integer(stride));
         }
     }
-    if (output.empty()) return false;
+    return true;
+}
+
+bool EinsumLift::checkSpan(const symbolic::Expression& span) {
+    // Sums and products of symbols and non-negative integers do not subtract
+    switch (span->get_type_code()) {
+        case SymEngine::TypeID::SYMENGINE_INTEGER:
+            return !SymEngine::rcp_static_cast<const SymEngine::Integer>(span)->is_negative();
+        case SymEngine::TypeID::SYMENGINE_SYMBOL:
+            return true;
+        case SymEngine::TypeID::SYMENGINE_ADD:
+        case SymEngine::TypeID::SYMENGINE_MUL:
+            for (auto& arg : span->get_args()) {
+                if (!this->checkSpan(arg)) return false;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool EinsumLift::containsRational(const symbolic::Expression& expr) {
+    if (expr->get_type_code() == SymEngine::TypeID::SYMENGINE_RATIONAL) return true;
+    for (auto& sub_expr : expr->get_args()) {
+        if (this->containsRational(sub_expr)) return true;
+    }
+    return false;
+}
 
-    // Check that the output container does not use an index variable of the loops
-    for (auto& index : out_indices) {
-        for (auto& loop : this->loops_) {
-            if (symbolic::uses(index, loop.get().indvar())) return false;
+bool EinsumLift::checkAffine(const symbolic::Expression& expr) {
+    // The derivative by each index variable must not depend on any index variable
+    for (auto& loop : this->loops_) {
+        if (!symbolic::uses(expr, loop.get().indvar())) continue;
+        symbolic::Expression derivative = SymEngine::diff(expr, loop.get().indvar());
+        for (auto& other_loop : this->loops_) {
+            if (symbolic::uses(derivative, other_loop.get().indvar())) return false;
+        }
+    }
+    return true;
+}
+
+bool EinsumLift::checkLoops() {
+    // Check if loops are nested in each other with computation block inside
+    if (this->loops_.size() > 0) {
+        size_t i;
+        for (i = 0; i < this->loops_.size() - 1; ++i) {
+            if (this->loops_[i].get().root().size() != 1 ||
+                this->loops_[i].get().root().at(0).first.element_id() !=
+                    this->loops_[i + 1].get().element_id())
+                return false;
+        }
+        if (this->loops_[i].get().root().size() != 1 ||
+            this->loops_[i].get().root().at(0).first.element_id() != this->comp_block_.element_id())
+            return false;
+    }
+
+    // Check that each loop is of sufficient form
+    for (auto loop : this->loops_) {
+        symbolic::Expression init, num_iteration;
+        long long stride;
+        if (!this->normalizeLoop(loop.get(), init, stride, num_iteration)) return false;
+        for (auto other_loop : this->loops_) {
+            if (symbolic::uses(init, other_loop.get().indvar())) return false;
+            if (other_loop.get().element_id() == loop.get().element_id()) continue;
+            if (other_loop.get().indvar()->__str__() == loop.get().indvar()->__str__())
+                return false;
+        }
+    }
+
+    return true;
+}
+
+EinsumLift::EinsumLift(
+    std::vector<std::reference_wrapper<structured_control_flow::StructuredLoop>> loops,
+    structured_control_flow::Block& comp_block)
+    : loops_(loops), comp_block_(comp_block) {}
+
+std::string EinsumLift::name() const { return "EinsumLift"; }
+
+bool EinsumLift::can_be_applied(builder::StructuredSDFGBuilder& builder,
+                                analysis::AnalysisManager& analysis_manager) {
+    TransformationProfileScope total("EinsumLift.can_be_applied");
+
+    {
+        TransformationProfileScope scope("EinsumLift.checks");
+        if (!this->checkLoops()) return false;
+    }
+
+    auto& capture = this->capture();
+    if (!capture.valid) return false;
+
+    {
+        TransformationProfileScope scope("EinsumLift.checks");
+
+        // Prevent one of the inputs to be a index variable
+        for (auto& input : capture.inputs) {
+            for (auto loop : this->loops_) {
+                if (input == loop.get().indvar()->__str__()) return false;
+            }
+        }
+
+        // Check if all captured calculations were used
+        if (!capture.all_used) return false;
+
+        // Check that we captured the output container with its subset
+        if (capture.output.empty()) return false;
+
+        // Check that the output container does not use an index variable of the loops
+        for (auto& index : capture.out_indices) {
+            for (auto& loop : this->loops_) {
+                if (symbolic::uses(index, loop.get().indvar())) return false;
+            }
         }
     }
 
     // Simplify "dummy" calculation and check if it can be represented in Einstein notation
-    symbolic::Expression scomp = symbolic::simplify(comp);
+    symbolic::Expression scomp = this->simplified(capture);
+    TransformationProfileScope scope("EinsumLift.checks");
+    auto& comp_out = capture.comp_out;
     if (scomp->get_type_code() == SymEngine::TypeID::SYMENGINE_ADD &&
-        scomp->get_args().size() == 2) {
+        scomp->get_args().size() == 2 &&
+        (symbolic::eq(scomp->get_args().at(0), comp_out) ||
+         symbolic::eq(scomp->get_args().at(1), comp_out))) {
         symbolic::Expression scomp_mul;
         if (scomp->get_args().at(0)->get_type_code() == SymEngine::TypeID::SYMENGINE_SYMBOL &&
             symbolic::eq(scomp->get_args().at(0), comp_out))
@@ -301,30 +531,37 @@ bool EinsumLift::can_be_applied(builder::StructuredSDFGBuilder& builder,
             !this->checkMulExpr(scomp->get_args().at(1)))
             return false;
     } else if (scomp->get_type_code() == SymEngine::TypeID::SYMENGINE_MUL) {
-        if (symbolic::uses(scomp, comp_out) || !this->checkMulExpr(scomp)) return false;
+        // A product with the output is a product reduction
+        symbolic::Expression scomp_mul = this->reductionOperand(scomp, comp_out);
+        if (symbolic::eq(scomp_mul, symbolic::__nullptr__())) scomp_mul = scomp;
+        if (symbolic::uses(scomp_mul, comp_out) || !this->checkMulExpr(scomp_mul)) return false;
+    } else if (scomp->get_type_code() == SymEngine::TypeID::SYMENGINE_MAX ||
+               scomp->get_type_code() == SymEngine::TypeID::SYMENGINE_MIN) {
+        symbolic::Expression scomp_mul = this->reductionOperand(scomp, comp_out);
+        if (symbolic::eq(scomp_mul, symbolic::__nullptr__())) return false;
+        if (symbolic::uses(scomp_mul, comp_out) || !this->checkMulExpr(scomp_mul)) return false;
     } else if (scomp->get_type_code() == SymEngine::TypeID::SYMENGINE_SYMBOL) {
         if (symbolic::uses(scomp, comp_out)) return false;
+    } else if (scomp->get_type_code() == SymEngine::TypeID::SYMENGINE_ADD) {
+        // Sum of products, optionally plus the output
+        std::vector<std::vector<Factor>> terms;
+        if (!this->collectTerms(capture, scomp, terms) || terms.size() < 2) return false;
     } else {
         return false;
     }
 
     // Reduce inputs and in_indices to the ones occurring in the simplified "dummy" calculation
-    for (size_t i = 0; i < inputs.size(); ++i) {
-        if (!symbolic::uses(scomp, this->createAccessExpr(inputs[i], in_indices[i]))) {
-            inputs.erase(inputs.begin() + i);
-            in_indices.erase(in_indices.begin() + i);
-            --i;
-        }
+    std::vector<data_flow::Subset> in_indices;
+    for (size_t i = 0; i < capture.inputs.size(); ++i) {
+        if (symbolic::uses(scomp,
+                           this->createAccessExpr(capture.inputs[i], capture.in_indices[i])))
+            in_indices.push_back(capture.in_indices[i]);
     }
 
-    // Check that the index variables of the loops occur without a calculation in the in indices
+    // Check that the in indices are affine in the index variables of the loops
     for (auto& indices : in_indices) {
         for (auto& index : indices) {
-            for (auto& loop : this->loops_) {
-                if (symbolic::uses(index, loop.get().indvar()) &&
-                    !symbolic::eq(index, loop.get().indvar()))
-                    return false;
-            }
+            if (!this->checkAffine(index)) return false;
         }
     }
 
@@ -333,105 +570,56 @@ bool EinsumLift::can_be_applied(builder::StructuredSDFGBuilder& builder,
 
 void EinsumLift::apply(builder::StructuredSDFGBuilder& builder,
                        analysis::AnalysisManager& analysis_manager) {
-    // Construct maps
+    TransformationProfileScope total("EinsumLift.apply");
+
+    // Construct maps. Each map counts the iterations of its loop from zero, so the index variable
+    // is replaced by init + stride * indvar in the indices and in the bounds of inner maps.
     std::vector<std::pair<symbolic::Symbol, symbolic::Expression>> maps;
+    std::vector<std::pair<symbolic::Symbol, symbolic::Expression>> replacements;
     for (auto& loop : this->loops_) {
-        if (loop.get().condition()->get_args().at(0)->__str__() == loop.get().indvar()->__str__())
-            maps.push_back({loop.get().indvar(), loop.get().condition()->get_args().at(1)});
-        else
-            maps.push_back({loop.get().indvar(), loop.get().condition()->get_args().at(0)});
-    }
-
-    // Capture all supported calculations from all tasklets in comp block
-    std::vector<std::string> outputs, inputs;
-    std::unordered_set<std::string> input_conns;
-    std::vector<data_flow::Subset> out_indicess, in_indices;
-    auto& comp_dfg = this->comp_block_.dataflow();
-    std::vector<std::pair<symbolic::Symbol, symbolic::Expression>> comps, comps_static_assign;
-    for (auto tasklet : comp_dfg.tasklets()) {
-        auto& oedge = *comp_dfg.out_edges(*tasklet).begin();
-        std::string out_cont = dynamic_cast<const data_flow::AccessNode&>(oedge.dst()).data();
-        symbolic::Symbol new_comp_out =
-            symbolic::symbol(this->createAccessExpr(out_cont, oedge.subset()));
-        outputs.push_back(out_cont);
-        out_indicess.push_back(oedge.subset());
-        std::unordered_map<std::string, symbolic::Expression> input_map;
-        for (auto& iedge : comp_dfg.in_edges(*tasklet)) {
-            const std::string in_cont =
-                dynamic_cast<const data_flow::AccessNode&>(iedge.src()).data();
-            input_map.insert({iedge.dst_conn(),
-                              symbolic::symbol(this->createAccessExpr(in_cont, iedge.subset()))});
-            inputs.push_back(in_cont);
-            input_conns.insert(in_cont);
-            in_indices.push_back(iedge.subset());
-        }
-        std::vector<symbolic::Expression> comp_ins;
-        for (auto tasklet_input : tasklet->inputs()) {
-            if (input_map.contains(tasklet_input.first)) {
-                comp_ins.push_back(input_map.at(tasklet_input.first));
-            } else if (tasklet_input.first == "0" || tasklet_input.first == "0.0") {
-                comp_ins.push_back(symbolic::zero());
-            } else if (tasklet_input.first == "1" || tasklet_input.first == "1.0") {
-                comp_ins.push_back(symbolic::one());
-            } else {
-                comp_ins.push_back(symbolic::symbol(tasklet_input.first));
-                inputs.push_back(tasklet_input.first);
-                in_indices.push_back({});
-            }
+        symbolic::Expression init, num_iteration;
+        long long stride;
+        this->normalizeLoop(loop.get(), init, stride, num_iteration);
+        maps.push_back({loop.get().indvar(), num_iteration});
+        if (!symbolic::eq(init, symbolic::zero()) || stride != 1) {
+            auto offset = symbolic::mul(symbolic::integer(stride), loop.get().indvar());
+            replacements.push_back({loop.get().indvar(), symbolic::add(init, offset)});
         }
-        symbolic::Expression new_comp = this->taskletCode2Expr(tasklet->code(), comp_ins);
-        if (tasklet->code() == data_flow::TaskletCode::assign && input_map.size() == 0)
-            comps_static_assign.push_back({new_comp_out, new_comp});
-        else
-            comps.push_back({new_comp_out, new_comp});
     }
 
-    // Perform a fixed point iteration to join all captured calculations to one "dummy" calculation
-    symbolic::Symbol comp_out = comps[0].first;
-    symbolic::Expression comp = comps[0].second;
-    bool applied = false;
-    do {
-        applied = false;
-        for (size_t i = 0; i < comps_static_assign.size(); ++i) {
-            if (symbolic::uses(comp, comps_static_assign[i].first)) {
-                comp = symbolic::subs(comp, comps_static_assign[i].first,
-                                      comps_static_assign[i].second);
-                applied = true;
-            }
-        }
-        for (size_t i = 0; i < comps.size(); ++i) {
-            if (symbolic::eq(comp_out, comps[i].first)) continue;
-            if (symbolic::uses(comp, comps[i].first)) {
-                comp = symbolic::subs(comp, comps[i].first, comps[i].second);
-                applied = true;
-                break;
-            }
-            if (symbolic::uses(comps[i].second, comp_out)) {
-                comp = symbolic::subs(comps[i].second, comp_out, comp);
-                comp_out = comps[i].first;
-                applied = true;
-                break;
-            }
-        }
-    } while (applied);
-
-    // Determine the output container with its subset
-    std::string output;
-    data_flow::Subset out_indices;
-    for (size_t i = 0; i < outputs.size(); ++i) {
-        if (comp_out->get_name() == this->createAccessExpr(outputs[i], out_indicess[i])) {
-            output = outputs[i];
-            out_indices = out_indicess[i];
-            break;
-        }
-    }
+    // Inner inits may use outer index variables, so the inner replacements are applied first
+    auto normalize = [&replacements](const symbolic::Expression& expr) {
+        symbolic::Expression result = expr;
+        for (auto it = replacements.rbegin(); it != replacements.rend(); ++it)
+            result = symbolic::subs(result, it->first, it->second);
+        return result;
+    };
+    for (auto& map : maps) map.second = normalize(map.second);
+
+    // Reuse the captured calculation of can_be_applied
+    auto& capture = this->capture();
+    std::vector<std::string> inputs = capture.inputs;
+    std::vector<data_flow::Subset> in_indices = capture.in_indices;
+    std::unordered_set<std::string> input_conns = capture.input_conns;
+    symbolic::Symbol comp_out = capture.comp_out;
+    std::string output = capture.output;
+    data_flow::Subset out_indices = capture.out_indices;
 
     // Simplify "dummy" calculation
-    symbolic::Expression scomp = symbolic::simplify(comp);
+    symbolic::Expression scomp = this->simplified(capture);
 
     // Determine if simplified "dummy" calculation contains output container with subsets
     bool out_in_scomp = symbolic::uses(scomp, this->createAccessExpr(output, out_indices));
 
+    // Determine how the output is combined with the product
+    einsum::ReductionType reduction = einsum::ReductionType_Sum;
+    if (scomp->get_type_code() == SymEngine::TypeID::SYMENGINE_MAX)
+        reduction = einsum::ReductionType_Max;
+    else if (scomp->get_type_code() == SymEngine::TypeID::SYMENGINE_MIN)
+        reduction = einsum::ReductionType_Min;
+    else if (scomp->get_type_code() == SymEngine::TypeID::SYMENGINE_MUL && out_in_scomp)
+        reduction = einsum::ReductionType_Prod;
+
     // Reduce inputs and in_indices to the ones occurring in the simplified "dummy" calculation
     for (size_t i = 0; i < inputs.size(); ++i) {
         if (!symbolic::uses(scomp, this->createAccessExpr(inputs[i], in_indices[i]))) {
@@ -454,6 +642,23 @@ void EinsumLift::apply(builder::StructuredSDFGBuilder& builder,
         in_indices.push_back({});
     }
 
+    // Split a sum of products into terms, each term multiplies its own inputs
+    std::vector<std::vector<size_t>> terms;
+    std::vector<std::vector<Factor>> term_factors;
+    if (scomp->get_type_code() == SymEngine::TypeID::SYMENGINE_ADD &&
+        this->collectTerms(capture, scomp, term_factors) && term_factors.size() > 1) {
+        inputs.clear();
+        in_indices.clear();
+        for (auto& factors : term_factors) {
+            terms.emplace_back();
+            for (auto& factor : factors) {
+                terms.back().push_back(inputs.size());
+                inputs.push_back(factor.first);
+                in_indices.push_back(factor.second);
+            }
+        }
+    }
+
     // Get the most outer node and its parent node
     structured_control_flow::ControlFlowNode* most_outer_node;
     if (this->loops_.size() == 0)
@@ -511,19 +716,28 @@ void EinsumLift::apply(builder::StructuredSDFGBuilder& builder,
         in_conns_with_scalars[in_conns_with_scalars.size() - 1] = "_out";
     }
 
+    // Normalize the indices of the loops
+    for (auto& index : out_indices) index = normalize(index);
+    for (auto& indices : in_indices) {
+        for (auto& index : indices) index = normalize(index);
+    }
+
     // Add einsum node as library node
     auto& libnode =
         builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
                                  const std::vector<std::string>&,
                                  std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
-                                 data_flow::Subset, std::vector<data_flow::Subset>>(
-            block, DebugInfo(), {"_out"}, in_conns_with_scalars, maps, out_indices, in_indices);
+                                 data_flow::Subset, std::vector<data_flow::Subset>,
+                                 const std::vector<std::vector<size_t>>&, einsum::ReductionType>(
+            block, DebugInfo(), {"_out"}, in_conns_with_scalars, maps, out_indices, in_indices,
+            terms, reduction);
 
     // Add memlets
     builder.add_memlet(block, libnode, "_out", out_access, "void", {});
     for (size_t i = 0; i < in_access.size(); ++i)
         builder.add_memlet(block, in_access[i], "void", libnode, in_conns[i], {});
 
+    this->capture_.reset();
     analysis_manager.invalidate_all();
 }
 
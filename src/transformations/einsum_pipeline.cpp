@@ -0,0 +1,276 @@
+#include "sdfg/transformations/einsum_pipeline.h"
+
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/data_flow/library_node.h>
+#include <sdfg/data_flow/tasklet.h>
+#include <sdfg/structured_control_flow/block.h>
+#include <sdfg/structured_control_flow/control_flow_node.h>
+#include <sdfg/structured_control_flow/if_else.h>
+#include <sdfg/structured_control_flow/sequence.h>
+#include <sdfg/structured_control_flow/structured_loop.h>
+#include <sdfg/structured_control_flow/while.h>
+#include <sdfg/structured_sdfg.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "sdfg/einsum/einsum_node.h"
+#include "sdfg/einsum/einsum_tuning.h"
+#include "sdfg/transformations/einsum2blas.h"
+#include "sdfg/transformations/einsum_expand.h"
+#include "sdfg/transformations/einsum_fuse.h"
+#include "sdfg/transformations/einsum_lift.h"
+#include "sdfg/transformations/transformation_profile.h"
+
+namespace sdfg {
+namespace transformations {
+
+EinsumPipelineReport& EinsumPipelineReport::operator+=(const EinsumPipelineReport& other) {
+    this->lifted += other.lifted;
+    this->expanded += other.expanded;
+    this->lowered += other.lowered;
+    this->fused += other.fused;
+    for (auto& routine : other.routines) this->routines[routine.first] += routine.second;
+    return *this;
+}
+
+std::string EinsumPipelineReport::toStr() const {
+    std::stringstream stream;
+    stream << "lifted: " << this->lifted << ", expanded: " << this->expanded
+           << ", lowered: " << this->lowered << ", fused: " << this->fused;
+    for (auto& routine : this->routines) stream << ", " << routine.first << ": " << routine.second;
+    return stream.str();
+}
+
+EinsumPipeline::EinsumPipeline(const EinsumPipelineOptions& options) : options_(options) {}
+
+void EinsumPipeline::discover(structured_control_flow::ControlFlowNode& node,
+                              std::vector<structured_control_flow::StructuredLoop*>& loops,
+                              std::vector<LiftCandidate>* lift_candidates,
+                              std::vector<EinsumCandidate>* einsum_candidates) {
+    // Loops are only expanded or lifted if they directly contain the block, so if-else and while
+    // nodes interrupt the chain of loops with a null entry
+    auto* enclosing_loop = loops.empty() ? nullptr : loops.back();
+
+    if (auto block = dynamic_cast<structured_control_flow::Block*>(&node)) {
+        bool tasklets = false, library_nodes = false;
+        for (auto& dnode : block->dataflow().nodes()) {
+            if (auto einsum_node = dynamic_cast<einsum::EinsumNode*>(&dnode)) {
+                if (einsum_candidates) einsum_candidates->push_back({enclosing_loop, einsum_node});
+                library_nodes = true;
+            } else if (dynamic_cast<data_flow::LibraryNode*>(&dnode)) {
+                library_nodes = true;
+            } else if (dynamic_cast<data_flow::Tasklet*>(&dnode)) {
+                tasklets = true;
+            }
+        }
+
+        // Collect the perfectly nested loops around a block of tasklets inside a loop
+        if (lift_candidates && tasklets && !library_nodes && enclosing_loop) {
+            LiftCandidate candidate = {{}, block};
+            structured_control_flow::ControlFlowNode* child = block;
+            for (auto loop = loops.rbegin(); loop != loops.rend() && *loop; ++loop) {
+                if ((*loop)->root().size() != 1 || &(*loop)->root().at(0).first != child) break;
+                candidate.loops.insert(candidate.loops.begin(), *loop);
+                child = *loop;
+            }
+            lift_candidates->push_back(candidate);
+        }
+    } else if (auto sequence = dynamic_cast<structured_control_flow::Sequence*>(&node)) {
+        for (size_t i = 0; i < sequence->size(); ++i)
+            this->discover(sequence->at(i).first, loops, lift_candidates, einsum_candidates);
+    } else if (auto if_else = dynamic_cast<structured_control_flow::IfElse*>(&node)) {
+        loops.push_back(nullptr);
+        for (size_t i = 0; i < if_else->size(); ++i)
+            this->discover(if_else->at(i).first, loops, lift_candidates, einsum_candidates);
+        loops.pop_back();
+    } else if (auto while_loop = dynamic_cast<structured_control_flow::While*>(&node)) {
+        loops.push_back(nullptr);
+        this->discover(while_loop->root(), loops, lift_candidates, einsum_candidates);
+        loops.pop_back();
+    } else if (auto loop = dynamic_cast<structured_control_flow::StructuredLoop*>(&node)) {
+        loops.push_back(loop);
+        this->discover(loop->root(), loops, lift_candidates, einsum_candidates);
+        loops.pop_back();
+    }
+}
+
+bool EinsumPipeline::lift(builder::StructuredSDFGBuilder& builder,
+                          analysis::AnalysisManager& analysis_manager,
+                          EinsumPipelineReport& report) {
+    TransformationProfileScope scope("EinsumPipeline.lift");
+
+    std::vector<LiftCandidate> candidates;
+    std::vector<structured_control_flow::StructuredLoop*> loops;
+    this->discover(builder.subject().root(), loops, &candidates, nullptr);
+
+    // The candidates do not share loops, so lifting one leaves the others intact
+    bool applied = false;
+    for (auto& candidate : candidates) {
+        for (size_t first = 0; first <= candidate.loops.size(); ++first) {
+            std::vector<std::reference_wrapper<structured_control_flow::StructuredLoop>> chain;
+            for (size_t i = first; i < candidate.loops.size(); ++i)
+                chain.push_back(*candidate.loops[i]);
+            EinsumLift transformation(chain, *candidate.block);
+            if (!transformation.can_be_applied(builder, analysis_manager)) continue;
+            transformation.apply(builder, analysis_manager);
+            ++report.lifted;
+            applied = true;
+            break;
+        }
+    }
+    return applied;
+}
+
+bool EinsumPipeline::expand(builder::StructuredSDFGBuilder& builder,
+                            analysis::AnalysisManager& analysis_manager,
+                            std::set<std::pair<size_t, size_t>>& failed,
+                            EinsumPipelineReport& report) {
+    TransformationProfileScope scope("EinsumPipeline.expand");
+
+    std::vector<EinsumCandidate> candidates;
+    std::vector<structured_control_flow::StructuredLoop*> loops;
+    this->discover(builder.subject().root(), loops, nullptr, &candidates);
+
+    // Expanding restructures the loop, so the candidates are collected again afterwards
+    for (auto& candidate : candidates) {
+        if (!candidate.loop) continue;
+        auto key =
+            std::make_pair(candidate.loop->element_id(), candidate.einsum_node->element_id());
+        if (failed.contains(key)) continue;
+        EinsumExpand transformation(*candidate.loop, *candidate.einsum_node);
+        if (!transformation.can_be_applied(builder, analysis_manager)) {
+            failed.insert(key);
+            continue;
+        }
+        transformation.apply(builder, analysis_manager);
+        ++report.expanded;
+        return true;
+    }
+    return false;
+}
+
+void EinsumPipeline::lower(builder::StructuredSDFGBuilder& builder,
+                           analysis::AnalysisManager& analysis_manager,
+                           EinsumPipelineReport& report) {
+    TransformationProfileScope scope("EinsumPipeline.lower");
+
+    std::vector<EinsumCandidate> candidates;
+    std::vector<structured_control_flow::StructuredLoop*> loops;
+    this->discover(builder.subject().root(), loops, nullptr, &candidates);
+
+    // The blocks are recorded before lowering because a hybrid lowering (threshold > 0) removes
+    // the block of its einsum node. The candidates of removed blocks are skipped, all others stay
+    // valid since lowering only replaces their einsum node.
+    std::vector<structured_control_flow::Block*> blocks;
+    for (auto& candidate : candidates) {
+        blocks.push_back(dynamic_cast<structured_control_flow::Block*>(
+            candidate.einsum_node->get_parent().get_parent()));
+    }
+    std::set<structured_control_flow::Block*> removed;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (removed.contains(blocks[i])) continue;
+        auto& einsum_node = *candidates[i].einsum_node;
+        std::string routine;
+        if (this->options_.database) {
+            auto* variant = this->options_.database->lookup(einsum::EinsumTuningDatabase::key(
+                builder.subject(), einsum_node.get_parent(), einsum_node));
+            if (variant) routine = variant->lowering;
+        }
+
+        auto transformation = this->options_.database
+                                  ? Einsum2BLAS(einsum_node, *this->options_.database,
+                                                this->options_.threshold)
+                                  : Einsum2BLAS(einsum_node, this->options_.threshold);
+        if (!transformation.can_be_applied(builder, analysis_manager)) continue;
+        if (routine.empty()) routine = transformation.candidates(builder, analysis_manager).front();
+        transformation.apply(builder, analysis_manager);
+        if (this->options_.threshold > 0) removed.insert(blocks[i]);
+        ++report.lowered;
+        ++report.routines[routine];
+    }
+}
+
+bool EinsumPipeline::fuse(builder::StructuredSDFGBuilder& builder,
+                          analysis::AnalysisManager& analysis_manager,
+                          EinsumPipelineReport& report) {
+    TransformationProfileScope scope("EinsumPipeline.fuse");
+
+    std::vector<EinsumCandidate> candidates;
+    std::vector<structured_control_flow::StructuredLoop*> loops;
+    this->discover(builder.subject().root(), loops, nullptr, &candidates);
+
+    // Consecutive blocks are discovered one after another. Fusing replaces the first einsum node
+    // and removes the block of the second one, so the candidates are collected again afterwards.
+    for (size_t i = 0; i + 1 < candidates.size(); ++i) {
+        EinsumFuse transformation(*candidates[i].einsum_node, *candidates[i + 1].einsum_node);
+        if (!transformation.can_be_applied(builder, analysis_manager)) continue;
+        transformation.apply(builder, analysis_manager);
+        ++report.fused;
+        return true;
+    }
+    return false;
+}
+
+EinsumPipelineReport EinsumPipeline::run(builder::StructuredSDFGBuilder& builder,
+                                         analysis::AnalysisManager& analysis_manager) {
+    EinsumPipelineReport report;
+
+    // Lift and expand until a fixed point is reached
+    bool changed;
+    do {
+        changed = this->lift(builder, analysis_manager, report);
+        if (this->options_.expand) {
+            std::set<std::pair<size_t, size_t>> failed;
+            while (this->expand(builder, analysis_manager, failed, report)) changed = true;
+        }
+    } while (changed);
+
+    if (this->options_.blas) this->lower(builder, analysis_manager, report);
+    if (this->options_.fuse) {
+        while (this->fuse(builder, analysis_manager, report));
+    }
+    return report;
+}
+
+EinsumPipelineReport EinsumPipeline::run(std::vector<std::unique_ptr<StructuredSDFG>>& sdfgs,
+                                         size_t threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, sdfgs.size());
+
+    // Every worker takes the next function until all are processed
+    std::vector<EinsumPipelineReport> reports(sdfgs.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < sdfgs.size(); i = next++) {
+            builder::StructuredSDFGBuilder builder(sdfgs[i]);
+            analysis::AnalysisManager analysis_manager(builder.subject());
+            reports[i] = this->run(builder, analysis_manager);
+            sdfgs[i] = builder.move();
+        }
+    };
+    if (threads <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < threads; ++i) workers.emplace_back(worker);
+        for (auto& thread : workers) thread.join();
+    }
+
+    EinsumPipelineReport report;
+    for (auto& function_report : reports) report += function_report;
+    return report;
+}
+
+}  // namespace transformations
+}  // namespace sdfg
@@ -0,0 +1,215 @@
+#include "sdfg/transformations/einsum_split.h"
+
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/data_flow/access_node.h>
+#include <sdfg/data_flow/memlet.h>
+#include <sdfg/exceptions.h>
+#include <sdfg/structured_control_flow/block.h>
+#include <sdfg/structured_control_flow/sequence.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/transformations/transformation.h>
+
+#include <cstddef>
+#include <nlohmann/json.hpp>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sdfg/einsum/einsum_node.h"
+
+namespace sdfg {
+namespace transformations {
+
+EinsumSplit::EinsumSplit(einsum::EinsumNode& einsum_node) : einsum_node_(einsum_node) {}
+
+std::string EinsumSplit::name() const { return "EinsumSplit"; }
+
+bool EinsumSplit::can_be_applied(builder::StructuredSDFGBuilder& builder,
+                                 analysis::AnalysisManager& analysis_manager) {
+    // Check that there are at least two terms which are summed into a single output
+    if (this->einsum_node_.terms().size() < 2) return false;
+    if (this->einsum_node_.outputs().size() != 1) return false;
+    if (this->einsum_node_.reduction() != einsum::ReductionType_Sum) return false;
+
+    // Get the data flow graph
+    auto& dfg = this->einsum_node_.get_parent();
+    if (!dynamic_cast<structured_control_flow::Block*>(dfg.get_parent())) return false;
+
+    // Check that the output is written to exactly one access node
+    if (dfg.out_degree(this->einsum_node_) != 1) return false;
+    auto& oedge = *dfg.out_edges(this->einsum_node_).begin();
+    auto* dst = dynamic_cast<const data_flow::AccessNode*>(&oedge.dst());
+    if (!dst) return false;
+
+    // Check that every map occurs in the indices of the output or of each term
+    for (auto& term : this->einsum_node_.terms()) {
+        for (auto& map : this->einsum_node_.maps()) {
+            bool used = false;
+            for (auto& index : this->einsum_node_.out_indices()) {
+                if (symbolic::uses(index, map.first)) used = true;
+            }
+            for (size_t input : term) {
+                for (auto& index : this->einsum_node_.in_indices(input)) {
+                    if (symbolic::uses(index, map.first)) used = true;
+                }
+            }
+            if (!used) return false;
+        }
+    }
+
+    // Check that the inputs are not computed in the same block and do not read the output, which
+    // changes between the terms
+    for (auto& iedge : dfg.in_edges(this->einsum_node_)) {
+        if (iedge.dst_conn() == this->einsum_node_.output(0)) continue;
+        auto* src = dynamic_cast<const data_flow::AccessNode*>(&iedge.src());
+        if (!src) return false;
+        if (dfg.in_degree(*src) > 0) return false;
+        if (src->data() == dst->data()) return false;
+    }
+
+    return true;
+}
+
+void EinsumSplit::apply(builder::StructuredSDFGBuilder& builder,
+                        analysis::AnalysisManager& analysis_manager) {
+    // Get the data flow graph
+    auto& dfg = this->einsum_node_.get_parent();
+
+    // Get the block in which the einsum node lives and its parent
+    auto* block = dynamic_cast<structured_control_flow::Block*>(dfg.get_parent());
+    auto& parent = builder.parent(*block);
+
+    auto& debug_info = this->einsum_node_.debug_info();
+    const std::string& out_conn = this->einsum_node_.output(0);
+    long long oii = this->einsum_node_.getOutInputIndex();
+
+    // Get the output access node
+    auto& oedge = *dfg.out_edges(this->einsum_node_).begin();
+    auto* dst = dynamic_cast<data_flow::AccessNode*>(&oedge.dst());
+    std::string dst_conn = oedge.dst_conn();
+    data_flow::Subset dst_subset = oedge.subset();
+
+    // Collect the access nodes and subsets of the input connectors
+    std::unordered_map<std::string, std::pair<data_flow::AccessNode*, data_flow::Subset>> in_access;
+    std::set<data_flow::AccessNode*> moved_access;
+    for (auto& iedge : dfg.in_edges(this->einsum_node_)) {
+        auto* access = dynamic_cast<data_flow::AccessNode*>(&iedge.src());
+        in_access.insert({iedge.dst_conn(), {access, iedge.subset()}});
+        if (iedge.dst_conn() != out_conn) moved_access.insert(access);
+    }
+
+    // Accumulating terms read the output where the original einsum read it, or where it is written
+    std::string out_container = dst->data();
+    data_flow::Subset out_subset = dst_subset;
+    if (in_access.contains(out_conn)) {
+        out_container = in_access.at(out_conn).first->data();
+        out_subset = in_access.at(out_conn).second;
+    }
+
+    // Adds the einsum node of a term to a block
+    auto add_term = [&](structured_control_flow::Block& term_block, size_t term, bool accumulate,
+                        const symbolic::Expression& epilogue) -> einsum::EinsumNode& {
+        std::vector<std::string> inputs;
+        std::vector<data_flow::Subset> in_indices;
+        for (size_t input : this->einsum_node_.term(term)) {
+            inputs.push_back(this->einsum_node_.input(input));
+            in_indices.push_back(this->einsum_node_.in_indices(input));
+        }
+        if (accumulate) {
+            inputs.push_back(out_conn);
+            in_indices.push_back(this->einsum_node_.out_indices());
+        }
+        auto& libnode = builder.add_library_node<
+            einsum::EinsumNode, const std::vector<std::string>&, const std::vector<std::string>&,
+            std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>, data_flow::Subset,
+            std::vector<data_flow::Subset>, const std::vector<std::vector<size_t>>&,
+            einsum::ReductionType, const symbolic::Expression&>(
+            term_block, debug_info, this->einsum_node_.outputs(), inputs,
+            this->einsum_node_.maps(), this->einsum_node_.out_indices(), in_indices, {},
+            einsum::ReductionType_Sum, epilogue);
+        return static_cast<einsum::EinsumNode&>(libnode);
+    };
+
+    // Create all terms except the last one in new blocks before the original one
+    size_t num_terms = this->einsum_node_.terms().size();
+    for (size_t term = 0; term + 1 < num_terms; ++term) {
+        bool accumulate = term > 0 || oii >= 0;
+        auto& term_block = builder.add_block_before(parent, *block).first;
+        auto& libnode = add_term(term_block, term, accumulate, symbolic::Expression());
+        for (size_t input : this->einsum_node_.term(term)) {
+            auto& conn = this->einsum_node_.input(input);
+            if (!in_access.contains(conn)) continue;
+            auto& access = builder.add_access(term_block, in_access.at(conn).first->data());
+            builder.add_memlet(term_block, access, "void", libnode, conn,
+                               in_access.at(conn).second, debug_info);
+        }
+        if (accumulate) {
+            auto& access = builder.add_access(term_block, out_container);
+            builder.add_memlet(term_block, access, "void", libnode, out_conn, out_subset,
+                               debug_info);
+        }
+        auto& access = builder.add_access(term_block, dst->data());
+        builder.add_memlet(term_block, libnode, out_conn, access, dst_conn, dst_subset,
+                           debug_info);
+    }
+
+    // The last term replaces the original einsum node, always accumulates, and applies the epilogue
+    auto& libnode = add_term(*block, num_terms - 1, true, this->einsum_node_.epilogue());
+    for (size_t input : this->einsum_node_.term(num_terms - 1)) {
+        auto& conn = this->einsum_node_.input(input);
+        if (!in_access.contains(conn)) continue;
+        builder.add_memlet(*block, *in_access.at(conn).first, "void", libnode, conn,
+                           in_access.at(conn).second, debug_info);
+    }
+    if (in_access.contains(out_conn)) {
+        builder.add_memlet(*block, *in_access.at(out_conn).first, "void", libnode, out_conn,
+                           out_subset, debug_info);
+    } else {
+        auto& access = builder.add_access(*block, out_container);
+        builder.add_memlet(*block, access, "void", libnode, out_conn, out_subset, debug_info);
+    }
+    builder.add_memlet(*block, libnode, out_conn, *dst, dst_conn, dst_subset, debug_info);
+
+    // Remove the old memlets
+    while (dfg.in_edges(this->einsum_node_).begin() != dfg.in_edges(this->einsum_node_).end()) {
+        builder.remove_memlet(*block, *dfg.in_edges(this->einsum_node_).begin());
+    }
+    while (dfg.out_edges(this->einsum_node_).begin() != dfg.out_edges(this->einsum_node_).end()) {
+        builder.remove_memlet(*block, *dfg.out_edges(this->einsum_node_).begin());
+    }
+
+    // Remove the einsum node
+    builder.remove_node(*block, this->einsum_node_);
+
+    // Remove the access nodes of inputs which moved to the other terms
+    for (auto* access : moved_access) {
+        if (dfg.in_degree(*access) == 0 && dfg.out_degree(*access) == 0)
+            builder.remove_node(*block, *access);
+    }
+
+    analysis_manager.invalidate_all();
+}
+
+void EinsumSplit::to_json(nlohmann::json& j) const {
+    j["transformation_type"] = this->name();
+    j["einsum_node_element_id"] = this->einsum_node_.element_id();
+}
+
+EinsumSplit EinsumSplit::from_json(builder::StructuredSDFGBuilder& builder,
+                                   const nlohmann::json& j) {
+    size_t einsum_node_id = j["einsum_node_element_id"].get<size_t>();
+    auto einsum_node_element = builder.find_element_by_id(einsum_node_id);
+    if (!einsum_node_element) {
+        throw InvalidTransformationDescriptionException(
+            "Element with ID " + std::to_string(einsum_node_id) + " not found.");
+    }
+    auto einsum_node = dynamic_cast<einsum::EinsumNode*>(einsum_node_element);
+
+    return EinsumSplit(*einsum_node);
+}
+
+}  // namespace transformations
+}  // namespace sdfg
@@ -0,0 +1,82 @@
+#include "sdfg/transformations/transformation_profile.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+namespace sdfg {
+namespace transformations {
+
+namespace {
+
+std::atomic<bool> profile_enabled{false};
+std::mutex profile_mutex;
+std::map<std::string, TransformationProfilePhase> profile_phases;
+
+}  // namespace
+
+void TransformationProfile::enable(bool enabled) { profile_enabled = enabled; }
+
+bool TransformationProfile::enabled() { return profile_enabled; }
+
+void TransformationProfile::record(const std::string& phase, double seconds) {
+    if (!profile_enabled) return;
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    auto& entry = profile_phases[phase];
+    ++entry.calls;
+    entry.seconds += seconds;
+}
+
+void TransformationProfile::count(const std::string& phase) {
+    if (!profile_enabled) return;
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    ++profile_phases[phase].calls;
+}
+
+TransformationProfilePhase TransformationProfile::phase(const std::string& phase) {
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    auto entry = profile_phases.find(phase);
+    if (entry == profile_phases.end()) return TransformationProfilePhase();
+    return entry->second;
+}
+
+std::map<std::string, TransformationProfilePhase> TransformationProfile::phases() {
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    return profile_phases;
+}
+
+void TransformationProfile::reset() {
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    profile_phases.clear();
+}
+
+std::string TransformationProfile::toStr() {
+    std::stringstream stream;
+    stream << std::fixed << std::setprecision(6);
+    for (auto& entry : TransformationProfile::phases()) {
+        stream << entry.first << ": " << entry.second.calls << " calls, " << entry.second.seconds
+               << " s";
+        if (entry.second.calls > 0 && entry.second.seconds > 0.0)
+            stream << " (" << entry.second.seconds / entry.second.calls << " s/call)";
+        stream << std::endl;
+    }
+    return stream.str();
+}
+
+TransformationProfileScope::TransformationProfileScope(const char* phase)
+    : phase_(phase), active_(TransformationProfile::enabled()) {
+    if (this->active_) this->start_ = std::chrono::steady_clock::now();
+}
+
+TransformationProfileScope::~TransformationProfileScope() {
+    if (!this->active_) return;
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - this->start_;
+    TransformationProfile::record(this->phase_, duration.count());
+}
+
+}  // namespace transformations
+}  // namespace sdfg
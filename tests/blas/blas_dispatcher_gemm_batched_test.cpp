@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/codegen/code_generators/c_code_generator.h>
+#include <sdfg/function.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/types/pointer.h>
+#include <sdfg/types/scalar.h>
+#include <sdfg/types/type.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sdfg/blas/blas_node.h"
+#include "sdfg/blas/blas_node_gemm_batched.h"
+
+using namespace sdfg;
+
+TEST(BLASDispatcherGemmBatched, sgemmNN) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("b", sym_desc);
+    builder.add_container("batch", sym_desc, true);
+    builder.add_container("m", sym_desc, true);
+    builder.add_container("n", sym_desc, true);
+    builder.add_container("k", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    types::Pointer desc3(*desc2.clone());
+    builder.add_container("A", desc3, true);
+    builder.add_container("B", desc3, true);
+    builder.add_container("C", desc3, true);
+
+    auto& root = builder.subject().root();
+
+    auto& block = builder.add_block(root);
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& C1 = builder.add_access(block, "C");
+    auto& C2 = builder.add_access(block, "C");
+    auto& libnode = builder.add_library_node<
+        blas::BLASNodeGemmBatched, const blas::BLASType, blas::BLASTranspose, blas::BLASTranspose,
+        const std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>&,
+        symbolic::Expression, symbolic::Expression, symbolic::Expression, std::string, std::string,
+        std::string, std::string>(block, DebugInfo(), blas::BLASType_real, blas::BLASTranspose_No,
+                                  blas::BLASTranspose_No,
+                                  {{symbolic::symbol("b"), symbolic::symbol("batch")}},
+                                  symbolic::symbol("m"), symbolic::symbol("n"),
+                                  symbolic::symbol("k"), "1.0f", "_A", "_B", "_C");
+    builder.add_memlet(block, A, "void", libnode, "_A", {});
+    builder.add_memlet(block, B, "void", libnode, "_B", {});
+    builder.add_memlet(block, C1, "void", libnode, "_C", {});
+    builder.add_memlet(block, libnode, "_C", C2, "void", {});
+
+    auto sdfg = builder.move();
+
+    codegen::CCodeGenerator generator(*sdfg);
+    ASSERT_TRUE(generator.generate());
+
+    EXPECT_EQ(generator.function_definition(),
+              "extern void sdfg_1(unsigned long long batch, unsigned long long m, unsigned long "
+              "long n, unsigned long long k, float ***A, float ***B, float ***C)");
+    EXPECT_EQ(generator.main().str(), R"(unsigned long long b;
+    {
+        float ***_A = A;
+        float ***_B = B;
+        float ***_C = C;
+
+        #pragma omp parallel for private(b)
+        for (b = 0; b < batch; b++)
+        {
+            cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, m, n, k, 1.0f, _A[b], k, _B[b], n, 1.0f, _C[b], n);
+        }
+    }
+)");
+}
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <sdfg/builder/structured_sdfg_builder.h>
 #include <sdfg/codegen/code_generators/c_code_generator.h>
+#include <sdfg/codegen/language_extensions/c_language_extension.h>
+#include <sdfg/codegen/utils.h>
 #include <sdfg/function.h>
 #include <sdfg/symbolic/symbolic.h>
 #include <sdfg/types/pointer.h>
@@ -9,6 +11,7 @@
 
 #include <string>
 
+#include "sdfg/blas/blas_dispatcher_gemm.h"
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_gemm.h"
 
@@ -188,4 +191,391 @@ TEST(BLASDispatcherGemm, dgemmTT) {
         cblas_dgemm(CblasRowMajor, CblasTrans, CblasTrans, m, n, k, _alpha, _A, m, _B, k, 1.0, _C, n);
     }
 )");
-}
\ No newline at end of file
+}
+TEST(BLASDispatcherGemm, sgemmNN_overwrite) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("m", sym_desc, true);
+    builder.add_container("n", sym_desc, true);
+    builder.add_container("k", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("alpha", base_desc, true);
+    builder.add_container("A", desc2, true);
+    builder.add_container("B", desc2, true);
+    builder.add_container("C", desc2, true);
+
+    auto& root = builder.subject().root();
+
+    // C is not read, so it is only connected as output and scaled by beta = 0
+    auto& block = builder.add_block(root);
+    auto& alpha = builder.add_access(block, "alpha");
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& C = builder.add_access(block, "C");
+    auto& libnode =
+        builder.add_library_node<blas::BLASNodeGemm, const blas::BLASType, blas::BLASTranspose,
+                                 blas::BLASTranspose, symbolic::Expression, symbolic::Expression,
+                                 symbolic::Expression, std::string, std::string, std::string,
+                                 std::string, symbolic::Expression, symbolic::Expression,
+                                 symbolic::Expression, std::string>(
+            block, DebugInfo(), blas::BLASType_real, blas::BLASTranspose_No,
+            blas::BLASTranspose_No, symbolic::symbol("m"), symbolic::symbol("n"),
+            symbolic::symbol("k"), "_alpha", "_A", "_B", "_C", symbolic::Expression(),
+            symbolic::Expression(), symbolic::Expression(), "0.0f");
+    builder.add_memlet(block, alpha, "void", libnode, "_alpha", {});
+    builder.add_memlet(block, A, "void", libnode, "_A", {});
+    builder.add_memlet(block, B, "void", libnode, "_B", {});
+    builder.add_memlet(block, libnode, "_C", C, "void", {});
+
+    auto sdfg = builder.move();
+
+    codegen::CCodeGenerator generator(*sdfg);
+    ASSERT_TRUE(generator.generate());
+
+    EXPECT_EQ(generator.function_definition(),
+              "extern void sdfg_1(unsigned long long m, unsigned long long n, unsigned long long "
+              "k, float alpha, float **A, float **B, float **C)");
+    EXPECT_EQ(generator.main().str(), R"(    {
+        float _alpha = alpha;
+        float **_A = A;
+        float **_B = B;
+        float **_C = C;
+
+        cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, m, n, k, _alpha, _A, k, _B, n, 0.0f, _C, n);
+    }
+)");
+}
+
+TEST(BLASDispatcherGemm, sgemmTN_native) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("m", sym_desc, true);
+    builder.add_container("n", sym_desc, true);
+    builder.add_container("k", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("alpha", base_desc, true);
+    builder.add_container("A", desc2, true);
+    builder.add_container("B", desc2, true);
+    builder.add_container("C", desc2, true);
+
+    auto& root = builder.subject().root();
+
+    auto& block = builder.add_block(root);
+    auto& alpha = builder.add_access(block, "alpha");
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& C1 = builder.add_access(block, "C");
+    auto& C2 = builder.add_access(block, "C");
+    auto& libnode =
+        builder.add_library_node<blas::BLASNodeGemm, const blas::BLASType, blas::BLASTranspose,
+                                 blas::BLASTranspose, symbolic::Expression, symbolic::Expression,
+                                 symbolic::Expression, std::string, std::string, std::string,
+                                 std::string>(block, DebugInfo(), blas::BLASType_real,
+                                              blas::BLASTranspose_Transpose, blas::BLASTranspose_No,
+                                              symbolic::symbol("m"), symbolic::symbol("n"),
+                                              symbolic::symbol("k"), "_alpha", "_A", "_B", "_C");
+    builder.add_memlet(block, alpha, "void", libnode, "_alpha", {});
+    builder.add_memlet(block, A, "void", libnode, "_A", {});
+    builder.add_memlet(block, B, "void", libnode, "_B", {});
+    builder.add_memlet(block, C1, "void", libnode, "_C", {});
+    builder.add_memlet(block, libnode, "_C", C2, "void", {});
+
+    auto sdfg = builder.move();
+
+    codegen::CLanguageExtension language_extension;
+    blas::BLASDispatcherGemm dispatcher(language_extension, *sdfg, libnode.get_parent(), libnode,
+                                        blas::BLASImplementation_Native);
+    codegen::PrettyPrinter stream;
+    dispatcher.dispatch(stream);
+
+    EXPECT_EQ(stream.str(), R"({
+    float _alpha = alpha;
+    float **_A = A;
+    float **_B = B;
+    float **_C = C;
+
+    sdfg_blas_sgemm('T', 'N', m, n, k, _alpha, _A, m, _B, n, 1.0f, _C, n);
+}
+)");
+}
+
+TEST(BLASDispatcherGemm, sgemmNN_native_epilogue) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("m", sym_desc, true);
+    builder.add_container("n", sym_desc, true);
+    builder.add_container("k", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("alpha", base_desc, true);
+    builder.add_container("A", desc2, true);
+    builder.add_container("B", desc2, true);
+    builder.add_container("C", desc2, true);
+
+    auto& root = builder.subject().root();
+
+    // C = max(2 * (C + alpha * A * B), 0)
+    auto epilogue = symbolic::max(symbolic::mul(symbolic::integer(2), symbolic::symbol("_C")),
+                                  symbolic::zero());
+
+    auto& block = builder.add_block(root);
+    auto& alpha = builder.add_access(block, "alpha");
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& C1 = builder.add_access(block, "C");
+    auto& C2 = builder.add_access(block, "C");
+    auto& libnode =
+        builder.add_library_node<blas::BLASNodeGemm, const blas::BLASType, blas::BLASTranspose,
+                                 blas::BLASTranspose, symbolic::Expression, symbolic::Expression,
+                                 symbolic::Expression, std::string, std::string, std::string,
+                                 std::string, symbolic::Expression, symbolic::Expression,
+                                 symbolic::Expression, std::string, symbolic::Expression>(
+            block, DebugInfo(), blas::BLASType_real, blas::BLASTranspose_No,
+            blas::BLASTranspose_No, symbolic::symbol("m"), symbolic::symbol("n"),
+            symbolic::symbol("k"), "_alpha", "_A", "_B", "_C", symbolic::Expression(),
+            symbolic::Expression(), symbolic::Expression(), "", epilogue);
+    builder.add_memlet(block, alpha, "void", libnode, "_alpha", {});
+    builder.add_memlet(block, A, "void", libnode, "_A", {});
+    builder.add_memlet(block, B, "void", libnode, "_B", {});
+    builder.add_memlet(block, C1, "void", libnode, "_C", {});
+    builder.add_memlet(block, libnode, "_C", C2, "void", {});
+
+    auto sdfg = builder.move();
+
+    codegen::CLanguageExtension language_extension;
+    blas::BLASDispatcherGemm dispatcher(language_extension, *sdfg, libnode.get_parent(), libnode,
+                                        blas::BLASImplementation_Native);
+    codegen::PrettyPrinter stream;
+    dispatcher.dispatch(stream);
+
+    // The epilogue is fused into the gemm instead of a second pass over C
+    EXPECT_EQ(stream.str(), R"({
+    float _alpha = alpha;
+    float **_A = A;
+    float **_B = B;
+    float **_C = C;
+
+    sdfg_blas_sgemm_epilogue('N', 'N', m, n, k, _alpha, _A, k, _B, n, 1.0f, _C, n, 2, 0, 0, INFINITY);
+}
+)");
+}
+
+TEST(BLASDispatcherGemm, sgemmNN_epilogue) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("m", sym_desc, true);
+    builder.add_container("n", sym_desc, true);
+    builder.add_container("k", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("alpha", base_desc, true);
+    builder.add_container("A", desc2, true);
+    builder.add_container("B", desc2, true);
+    builder.add_container("C", desc2, true);
+
+    auto& root = builder.subject().root();
+
+    // C = max(C + alpha * A * B, 0)
+    auto epilogue = symbolic::max(symbolic::symbol("_C"), symbolic::zero());
+
+    auto& block = builder.add_block(root);
+    auto& alpha = builder.add_access(block, "alpha");
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& C1 = builder.add_access(block, "C");
+    auto& C2 = builder.add_access(block, "C");
+    auto& libnode =
+        builder.add_library_node<blas::BLASNodeGemm, const blas::BLASType, blas::BLASTranspose,
+                                 blas::BLASTranspose, symbolic::Expression, symbolic::Expression,
+                                 symbolic::Expression, std::string, std::string, std::string,
+                                 std::string, symbolic::Expression, symbolic::Expression,
+                                 symbolic::Expression, std::string, symbolic::Expression>(
+            block, DebugInfo(), blas::BLASType_real, blas::BLASTranspose_No,
+            blas::BLASTranspose_No, symbolic::symbol("m"), symbolic::symbol("n"),
+            symbolic::symbol("k"), "_alpha", "_A", "_B", "_C", symbolic::Expression(),
+            symbolic::Expression(), symbolic::Expression(), "", epilogue);
+    builder.add_memlet(block, alpha, "void", libnode, "_alpha", {});
+    builder.add_memlet(block, A, "void", libnode, "_A", {});
+    builder.add_memlet(block, B, "void", libnode, "_B", {});
+    builder.add_memlet(block, C1, "void", libnode, "_C", {});
+    builder.add_memlet(block, libnode, "_C", C2, "void", {});
+
+    auto sdfg = builder.move();
+
+    codegen::CLanguageExtension language_extension;
+    blas::BLASDispatcherGemm dispatcher(language_extension, *sdfg, libnode.get_parent(), libnode,
+                                        blas::BLASImplementation_CBLAS);
+    codegen::PrettyPrinter stream;
+    dispatcher.dispatch(stream);
+
+    // The epilogue is applied after the call, indexing the nested matrix by row and column
+    auto value = symbolic::max(symbolic::symbol("_C[_i][_j]"), symbolic::zero());
+    std::string code = stream.str();
+    EXPECT_NE(code.find("cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, m, n, k, _alpha, "
+                        "_A, k, _B, n, 1.0f, _C, n);"),
+              std::string::npos);
+    EXPECT_NE(code.find("for (size_t _i = 0; _i < m; _i++)"), std::string::npos);
+    EXPECT_NE(code.find("for (size_t _j = 0; _j < n; _j++)"), std::string::npos);
+    EXPECT_NE(code.find("_C[_i][_j] = " + language_extension.expression(value) + ";"),
+              std::string::npos);
+    EXPECT_EQ(code.find("_C[_i * n + _j]"), std::string::npos);
+}
+
+TEST(BLASDispatcherGemm, sgemmTN_unrolled) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("alpha", base_desc, true);
+    builder.add_container("A", desc2, true);
+    builder.add_container("B", desc2, true);
+    builder.add_container("C", desc2, true);
+
+    auto& root = builder.subject().root();
+
+    // 2x2 blocks of constant size
+    auto& block = builder.add_block(root);
+    auto& alpha = builder.add_access(block, "alpha");
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& C1 = builder.add_access(block, "C");
+    auto& C2 = builder.add_access(block, "C");
+    auto& libnode =
+        builder.add_library_node<blas::BLASNodeGemm, const blas::BLASType, blas::BLASTranspose,
+                                 blas::BLASTranspose, symbolic::Expression, symbolic::Expression,
+                                 symbolic::Expression, std::string, std::string, std::string,
+                                 std::string>(block, DebugInfo(), blas::BLASType_real,
+                                              blas::BLASTranspose_Transpose, blas::BLASTranspose_No,
+                                              symbolic::integer(2), symbolic::integer(2),
+                                              symbolic::integer(2), "_alpha", "_A", "_B", "_C");
+    builder.add_memlet(block, alpha, "void", libnode, "_alpha", {});
+    builder.add_memlet(block, A, "void", libnode, "_A", {});
+    builder.add_memlet(block, B, "void", libnode, "_B", {});
+    builder.add_memlet(block, C1, "void", libnode, "_C", {});
+    builder.add_memlet(block, libnode, "_C", C2, "void", {});
+
+    auto sdfg = builder.move();
+
+    // Unrolling is off by default
+    {
+        codegen::CLanguageExtension language_extension;
+        blas::BLASDispatcherGemm dispatcher(language_extension, *sdfg, libnode.get_parent(),
+                                            libnode, blas::BLASImplementation_CBLAS);
+        codegen::PrettyPrinter stream;
+        dispatcher.dispatch(stream);
+        EXPECT_NE(stream.str().find("cblas_sgemm("), std::string::npos);
+    }
+
+    // Both the CBLAS and the native backend emit straight-line code instead of a call. The
+    // nested matrices are indexed by row and column.
+    for (auto impl : {blas::BLASImplementation_CBLAS, blas::BLASImplementation_Native}) {
+        codegen::CLanguageExtension language_extension;
+        blas::BLASDispatcherGemm dispatcher(language_extension, *sdfg, libnode.get_parent(),
+                                            libnode, impl, 512);
+        codegen::PrettyPrinter stream;
+        dispatcher.dispatch(stream);
+
+        EXPECT_EQ(stream.str(), R"({
+    float _alpha = alpha;
+    float **_A = A;
+    float **_B = B;
+    float **_C = C;
+
+    _C[0][0] = _alpha * (_A[0][0] * _B[0][0] + _A[1][0] * _B[1][0]) + _C[0][0];
+    _C[0][1] = _alpha * (_A[0][0] * _B[0][1] + _A[1][0] * _B[1][1]) + _C[0][1];
+    _C[1][0] = _alpha * (_A[0][1] * _B[0][0] + _A[1][1] * _B[1][0]) + _C[1][0];
+    _C[1][1] = _alpha * (_A[0][1] * _B[0][1] + _A[1][1] * _B[1][1]) + _C[1][1];
+}
+)");
+    }
+}
+
+TEST(BLASDispatcherGemm, sgemmNN_cublas) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("m", sym_desc, true);
+    builder.add_container("n", sym_desc, true);
+    builder.add_container("k", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("C", desc2, true);
+
+    auto& root = builder.subject().root();
+
+    // A is used for both operands, so it gets a device buffer per connector
+    auto& block = builder.add_block(root);
+    auto& A = builder.add_access(block, "A");
+    auto& C1 = builder.add_access(block, "C");
+    auto& C2 = builder.add_access(block, "C");
+    auto& libnode =
+        builder.add_library_node<blas::BLASNodeGemm, const blas::BLASType, blas::BLASTranspose,
+                                 blas::BLASTranspose, symbolic::Expression, symbolic::Expression,
+                                 symbolic::Expression, std::string, std::string, std::string,
+                                 std::string>(block, DebugInfo(), blas::BLASType_real,
+                                              blas::BLASTranspose_No, blas::BLASTranspose_No,
+                                              symbolic::symbol("m"), symbolic::symbol("n"),
+                                              symbolic::symbol("k"), "1.0f", "_A", "_B", "_C");
+    builder.add_memlet(block, A, "void", libnode, "_A", {});
+    builder.add_memlet(block, A, "void", libnode, "_B", {});
+    builder.add_memlet(block, C1, "void", libnode, "_C", {});
+    builder.add_memlet(block, libnode, "_C", C2, "void", {});
+
+    auto sdfg = builder.move();
+
+    codegen::CLanguageExtension language_extension;
+    blas::BLASDispatcherGemm dispatcher(language_extension, *sdfg, libnode.get_parent(), libnode,
+                                        blas::BLASImplementation_CUBLAS);
+    codegen::PrettyPrinter stream;
+    dispatcher.dispatch(stream);
+
+    EXPECT_EQ(stream.str(), R"({
+    float **_A = A;
+    float **_B = A;
+    float **_C = C;
+
+    #ifndef CUDA_CHECK
+    #define CUDA_CHECK(X) X
+    #endif
+    #ifndef CUBLAS_CHECK
+    #define CUBLAS_CHECK(X) X
+    #endif
+
+    cublasHandle_t handle = sdfg_cublas_handle();
+
+    float  *d_A = (float  *)sdfg_cublas_buffer("A._A", m * k * sizeof(float ));
+    float  *d_B = (float  *)sdfg_cublas_buffer("A._B", k * n * sizeof(float ));
+    float  *d_C = (float  *)sdfg_cublas_buffer("C", m * n * sizeof(float ));
+
+    float  alpha = 1.0f;
+    float  beta = 1.0f;
+    CUBLAS_CHECK(cublasSetMatrix(m, k, sizeof(float ), _A, m, d_A, m));
+    CUBLAS_CHECK(cublasSetMatrix(k, n, sizeof(float ), _B, k, d_B, k));
+    CUBLAS_CHECK(cublasSetMatrix(m, n, sizeof(float ), _C, m, d_C, m));
+
+    CUBLAS_CHECK(cublasSgemm(handle, CUBLAS_OP_N, CUBLAS_OP_N, n, m, k, &alpha, d_B, n, d_A, k, &beta, d_C, n));
+
+    CUDA_CHECK(cudaDeviceSynchronize());
+
+    CUBLAS_CHECK(cublasGetMatrix(m, n, sizeof(float ), d_C, m, _C, m));
+}
+)");
+}
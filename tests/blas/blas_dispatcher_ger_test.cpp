@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <sdfg/builder/structured_sdfg_builder.h>
 #include <sdfg/codegen/code_generators/c_code_generator.h>
+#include <sdfg/codegen/language_extensions/c_language_extension.h>
 #include <sdfg/element.h>
 #include <sdfg/function.h>
 #include <sdfg/symbolic/symbolic.h>
@@ -10,6 +11,7 @@
 
 #include <string>
 
+#include "sdfg/blas/blas_dispatcher_ger.h"
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_ger.h"
 
@@ -87,4 +89,58 @@ TEST(BLASDispatcherGer, dger) {
         cblas_dger(CblasRowMajor, m, n, _alpha, _x, 1, _y, 1, _A, n);
     }
 )");
-}
\ No newline at end of file
+}
+
+TEST(BLASDispatcherGer, dger_native) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("m", sym_desc, true);
+    builder.add_container("n", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Double);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("alpha", base_desc, true);
+    builder.add_container("x", desc, true);
+    builder.add_container("y", desc, true);
+    builder.add_container("A", desc2, true);
+
+    auto& root = builder.subject().root();
+
+    auto& block = builder.add_block(root);
+    auto& alpha = builder.add_access(block, "alpha");
+    auto& x = builder.add_access(block, "x");
+    auto& y = builder.add_access(block, "y");
+    auto& A1 = builder.add_access(block, "A");
+    auto& A2 = builder.add_access(block, "A");
+    auto& libnode =
+        builder.add_library_node<blas::BLASNodeGer, const blas::BLASType, symbolic::Expression,
+                                 symbolic::Expression, std::string, std::string, std::string,
+                                 std::string>(block, DebugInfo(), blas::BLASType_double,
+                                              symbolic::symbol("m"), symbolic::symbol("n"),
+                                              "_alpha", "_x", "_y", "_A");
+    builder.add_memlet(block, alpha, "void", libnode, "_alpha", {});
+    builder.add_memlet(block, x, "void", libnode, "_x", {});
+    builder.add_memlet(block, y, "void", libnode, "_y", {});
+    builder.add_memlet(block, A1, "void", libnode, "_A", {});
+    builder.add_memlet(block, libnode, "_A", A2, "void", {});
+
+    auto sdfg = builder.move();
+
+    codegen::CLanguageExtension language_extension;
+    blas::BLASDispatcherGer dispatcher(language_extension, *sdfg, libnode.get_parent(), libnode,
+                                       blas::BLASImplementation_Native);
+    codegen::PrettyPrinter stream;
+    dispatcher.dispatch(stream);
+
+    EXPECT_EQ(stream.str(), R"({
+    double _alpha = alpha;
+    double *_x = x;
+    double *_y = y;
+    double **_A = A;
+
+    sdfg_blas_dger(m, n, _alpha, _x, 1, _y, 1, _A, n);
+}
+)");
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <sdfg/builder/structured_sdfg_builder.h>
 #include <sdfg/codegen/code_generators/c_code_generator.h>
+#include <sdfg/codegen/language_extensions/c_language_extension.h>
 #include <sdfg/element.h>
 #include <sdfg/function.h>
 #include <sdfg/symbolic/symbolic.h>
@@ -10,6 +11,7 @@
 
 #include <string>
 
+#include "sdfg/blas/blas_dispatcher_symm.h"
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_symm.h"
 
@@ -187,4 +189,59 @@ TEST(BLASDispatcherSymm, dsymmRU) {
         cblas_dsymm(CblasRowMajor, CblasRight, CblasUpper, m, n, _alpha, _A, n, _B, m, 1.0, _C, m);
     }
 )");
-}
\ No newline at end of file
+}
+
+TEST(BLASDispatcherSymm, ssymmRL_native) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("m", sym_desc, true);
+    builder.add_container("n", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("alpha", base_desc, true);
+    builder.add_container("A", desc2, true);
+    builder.add_container("B", desc2, true);
+    builder.add_container("C", desc2, true);
+
+    auto& root = builder.subject().root();
+
+    auto& block = builder.add_block(root);
+    auto& alpha = builder.add_access(block, "alpha");
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& C1 = builder.add_access(block, "C");
+    auto& C2 = builder.add_access(block, "C");
+    auto& libnode =
+        builder.add_library_node<blas::BLASNodeSymm, const blas::BLASType, blas::BLASSide,
+                                 blas::BLASTriangular, symbolic::Expression, symbolic::Expression,
+                                 std::string, std::string, std::string, std::string>(
+            block, DebugInfo(), blas::BLASType_real, blas::BLASSide_Right,
+            blas::BLASTriangular_Lower, symbolic::symbol("m"), symbolic::symbol("n"), "_alpha",
+            "_A", "_B", "_C");
+    builder.add_memlet(block, alpha, "void", libnode, "_alpha", {});
+    builder.add_memlet(block, A, "void", libnode, "_A", {});
+    builder.add_memlet(block, B, "void", libnode, "_B", {});
+    builder.add_memlet(block, C1, "void", libnode, "_C", {});
+    builder.add_memlet(block, libnode, "_C", C2, "void", {});
+
+    auto sdfg = builder.move();
+
+    codegen::CLanguageExtension language_extension;
+    blas::BLASDispatcherSymm dispatcher(language_extension, *sdfg, libnode.get_parent(), libnode,
+                                        blas::BLASImplementation_Native);
+    codegen::PrettyPrinter stream;
+    dispatcher.dispatch(stream);
+
+    EXPECT_EQ(stream.str(), R"({
+    float _alpha = alpha;
+    float **_A = A;
+    float **_B = B;
+    float **_C = C;
+
+    sdfg_blas_ssymm('R', 'L', m, n, _alpha, _A, n, _B, n, 1.0f, _C, n);
+}
+)");
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <sdfg/builder/structured_sdfg_builder.h>
 #include <sdfg/codegen/code_generators/c_code_generator.h>
+#include <sdfg/codegen/language_extensions/c_language_extension.h>
 #include <sdfg/element.h>
 #include <sdfg/function.h>
 #include <sdfg/symbolic/symbolic.h>
@@ -10,6 +11,7 @@
 
 #include <string>
 
+#include "sdfg/blas/blas_dispatcher_symv.h"
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_symv.h"
 
@@ -116,4 +118,56 @@ TEST(BLASDispatcherSymv, dsymvU) {
         cblas_dsymv(CblasRowMajor, CblasUpper, n, _alpha, _A, n, _x, 1, 1.0, _y, 1);
     }
 )");
-}
\ No newline at end of file
+}
+
+TEST(BLASDispatcherSymv, ssymvL_native) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("n", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("alpha", base_desc, true);
+    builder.add_container("A", desc2, true);
+    builder.add_container("x", desc, true);
+    builder.add_container("y", desc, true);
+
+    auto& root = builder.subject().root();
+
+    auto& block = builder.add_block(root);
+    auto& alpha = builder.add_access(block, "alpha");
+    auto& A = builder.add_access(block, "A");
+    auto& x = builder.add_access(block, "x");
+    auto& y1 = builder.add_access(block, "y");
+    auto& y2 = builder.add_access(block, "y");
+    auto& libnode = builder.add_library_node<blas::BLASNodeSymv, const blas::BLASType,
+                                             blas::BLASTriangular, symbolic::Expression,
+                                             std::string, std::string, std::string, std::string>(
+        block, DebugInfo(), blas::BLASType_real, blas::BLASTriangular_Lower, symbolic::symbol("n"),
+        "_alpha", "_A", "_x", "_y");
+    builder.add_memlet(block, alpha, "void", libnode, "_alpha", {});
+    builder.add_memlet(block, A, "void", libnode, "_A", {});
+    builder.add_memlet(block, x, "void", libnode, "_x", {});
+    builder.add_memlet(block, y1, "void", libnode, "_y", {});
+    builder.add_memlet(block, libnode, "_y", y2, "void", {});
+
+    auto sdfg = builder.move();
+
+    codegen::CLanguageExtension language_extension;
+    blas::BLASDispatcherSymv dispatcher(language_extension, *sdfg, libnode.get_parent(), libnode,
+                                        blas::BLASImplementation_Native);
+    codegen::PrettyPrinter stream;
+    dispatcher.dispatch(stream);
+
+    EXPECT_EQ(stream.str(), R"({
+    float _alpha = alpha;
+    float **_A = A;
+    float *_x = x;
+    float *_y = y;
+
+    sdfg_blas_ssymv('L', n, _alpha, _A, n, _x, 1, 1.0f, _y, 1);
+}
+)");
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <sdfg/builder/structured_sdfg_builder.h>
 #include <sdfg/codegen/code_generators/c_code_generator.h>
+#include <sdfg/codegen/language_extensions/c_language_extension.h>
 #include <sdfg/element.h>
 #include <sdfg/function.h>
 #include <sdfg/symbolic/symbolic.h>
@@ -10,6 +11,7 @@
 
 #include <string>
 
+#include "sdfg/blas/blas_dispatcher_syr.h"
 #include "sdfg/blas/blas_node.h"
 #include "sdfg/blas/blas_node_syr.h"
 
@@ -105,4 +107,52 @@ TEST(BLASDispatcherSyr, dsyrU) {
         cblas_dsyr(CblasRowMajor, CblasUpper, n, _alpha, _x, 1, _A, n);
     }
 )");
-}
\ No newline at end of file
+}
+
+TEST(BLASDispatcherSyr, dsyrU_native) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("n", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Double);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("alpha", base_desc, true);
+    builder.add_container("x", desc, true);
+    builder.add_container("A", desc2, true);
+
+    auto& root = builder.subject().root();
+
+    auto& block = builder.add_block(root);
+    auto& alpha = builder.add_access(block, "alpha");
+    auto& x = builder.add_access(block, "x");
+    auto& A1 = builder.add_access(block, "A");
+    auto& A2 = builder.add_access(block, "A");
+    auto& libnode =
+        builder.add_library_node<blas::BLASNodeSyr, const blas::BLASType, blas::BLASTriangular,
+                                 symbolic::Expression, std::string, std::string, std::string>(
+            block, DebugInfo(), blas::BLASType_double, blas::BLASTriangular_Upper,
+            symbolic::symbol("n"), "_alpha", "_x", "_A");
+    builder.add_memlet(block, alpha, "void", libnode, "_alpha", {});
+    builder.add_memlet(block, x, "void", libnode, "_x", {});
+    builder.add_memlet(block, A1, "void", libnode, "_A", {});
+    builder.add_memlet(block, libnode, "_A", A2, "void", {});
+
+    auto sdfg = builder.move();
+
+    codegen::CLanguageExtension language_extension;
+    blas::BLASDispatcherSyr dispatcher(language_extension, *sdfg, libnode.get_parent(), libnode,
+                                       blas::BLASImplementation_Native);
+    codegen::PrettyPrinter stream;
+    dispatcher.dispatch(stream);
+
+    EXPECT_EQ(stream.str(), R"({
+    double _alpha = alpha;
+    double *_x = x;
+    double **_A = A;
+
+    sdfg_blas_dsyr('U', n, _alpha, _x, 1, _A, n);
+}
+)");
+}
@@ -79,4 +79,39 @@ TEST(BLASNodeDot, ddot) {
     ASSERT_TRUE(blas_node);
 
     EXPECT_EQ(blas_node->toStr(), "_result = _result + ddot(n, _x, 1, _y, 1)");
-}
\ No newline at end of file
+}
+TEST(BLASNodeDot, sdot_strided) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("n", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    builder.add_container("result", desc, true);
+    builder.add_container("x", desc, true);
+    builder.add_container("y", desc, true);
+
+    auto& root = builder.subject().root();
+
+    auto& block = builder.add_block(root);
+    auto& result1 = builder.add_access(block, "result");
+    auto& result2 = builder.add_access(block, "result");
+    auto& x = builder.add_access(block, "x");
+    auto& y = builder.add_access(block, "y");
+    auto& libnode =
+        builder.add_library_node<blas::BLASNodeDot, std::string, const blas::BLASType,
+                                 symbolic::Expression, std::string, std::string,
+                                 symbolic::Expression, symbolic::Expression>(
+            block, DebugInfo(), "_result", blas::BLASType_real, symbolic::symbol("n"), "_x", "_y",
+            symbolic::integer(2), symbolic::symbol("n"));
+    builder.add_memlet(block, x, "void", libnode, "_x", {});
+    builder.add_memlet(block, y, "void", libnode, "_y", {});
+    builder.add_memlet(block, result1, "void", libnode, "_result", {symbolic::zero()});
+    builder.add_memlet(block, libnode, "_result", result2, "void", {symbolic::zero()});
+
+    auto* blas_node = dynamic_cast<blas::BLASNodeDot*>(&libnode);
+    ASSERT_TRUE(blas_node);
+
+    EXPECT_EQ(blas_node->toStr(), "_result = _result + sdot(n, _x, 2, _y, n)");
+}
@@ -0,0 +1,80 @@
+#include "sdfg/blas/blas_node_gemm_batched.h"
+
+#include <gtest/gtest.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/function.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/types/pointer.h>
+#include <sdfg/types/scalar.h>
+#include <sdfg/types/type.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sdfg/blas/blas_node.h"
+
+using namespace sdfg;
+
+inline void gemm_batched_test(const types::PrimitiveType type1, const blas::BLASType type2,
+                              const blas::BLASTranspose transA, const blas::BLASTranspose transB,
+                              const std::string expected) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("b", sym_desc);
+    builder.add_container("batch", sym_desc, true);
+    builder.add_container("m", sym_desc, true);
+    builder.add_container("n", sym_desc, true);
+    builder.add_container("k", sym_desc, true);
+
+    types::Scalar base_desc(type1);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    types::Pointer desc3(*desc2.clone());
+    builder.add_container("alpha", base_desc, true);
+    builder.add_container("A", desc3, true);
+    builder.add_container("B", desc3, true);
+    builder.add_container("C", desc3, true);
+
+    auto& root = builder.subject().root();
+
+    auto& block = builder.add_block(root);
+    auto& alpha = builder.add_access(block, "alpha");
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& C1 = builder.add_access(block, "C");
+    auto& C2 = builder.add_access(block, "C");
+    auto& libnode = builder.add_library_node<
+        blas::BLASNodeGemmBatched, const blas::BLASType, blas::BLASTranspose, blas::BLASTranspose,
+        const std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>&,
+        symbolic::Expression, symbolic::Expression, symbolic::Expression, std::string, std::string,
+        std::string, std::string>(block, DebugInfo(), type2, transA, transB,
+                                  {{symbolic::symbol("b"), symbolic::symbol("batch")}},
+                                  symbolic::symbol("m"), symbolic::symbol("n"),
+                                  symbolic::symbol("k"), "_alpha", "_A", "_B", "_C");
+    builder.add_memlet(block, alpha, "void", libnode, "_alpha", {});
+    builder.add_memlet(block, A, "void", libnode, "_A", {});
+    builder.add_memlet(block, B, "void", libnode, "_B", {});
+    builder.add_memlet(block, C1, "void", libnode, "_C", {});
+    builder.add_memlet(block, libnode, "_C", C2, "void", {});
+
+    auto* blas_node = dynamic_cast<blas::BLASNodeGemmBatched*>(&libnode);
+    ASSERT_TRUE(blas_node);
+
+    EXPECT_EQ(blas_node->toStr(), expected);
+}
+
+TEST(BLASNodeGemmBatched, sgemmNN) {
+    gemm_batched_test(types::PrimitiveType::Float, blas::BLASType_real, blas::BLASTranspose_No,
+                      blas::BLASTranspose_No,
+                      "for b = 0:batch: sgemm('N', 'N', m, n, k, _alpha, _A[b], k, _B[b], n, "
+                      "1.0f, _C[b], n)");
+}
+
+TEST(BLASNodeGemmBatched, dgemmTT) {
+    gemm_batched_test(types::PrimitiveType::Double, blas::BLASType_double,
+                      blas::BLASTranspose_Transpose, blas::BLASTranspose_Transpose,
+                      "for b = 0:batch: dgemm('T', 'T', m, n, k, _alpha, _A[b], m, _B[b], k, "
+                      "1.0, _C[b], n)");
+}
@@ -61,24 +61,26 @@ inline void gemm_test(const types::PrimitiveType type1, const blas::BLASType typ
 
 TEST(BLASNodeGemm, sgemmNN) {
     gemm_test(types::PrimitiveType::Float, blas::BLASType_real, blas::BLASTranspose_No,
-              blas::BLASTranspose_No, "sgemm('N', 'N', m, n, k, _alpha, _A, k, _B, n, 1.0, _C, n)");
+              blas::BLASTranspose_No,
+              "sgemm('N', 'N', m, n, k, _alpha, _A, k, _B, n, 1.0f, _C, n)");
 }
 
 TEST(BLASNodeGemm, sgemmTN) {
     gemm_test(types::PrimitiveType::Float, blas::BLASType_real, blas::BLASTranspose_Transpose,
-              blas::BLASTranspose_No, "sgemm('T', 'N', m, n, k, _alpha, _A, m, _B, n, 1.0, _C, n)");
+              blas::BLASTranspose_No,
+              "sgemm('T', 'N', m, n, k, _alpha, _A, m, _B, n, 1.0f, _C, n)");
 }
 
 TEST(BLASNodeGemm, sgemmNT) {
     gemm_test(types::PrimitiveType::Float, blas::BLASType_real, blas::BLASTranspose_No,
               blas::BLASTranspose_Transpose,
-              "sgemm('N', 'T', m, n, k, _alpha, _A, k, _B, k, 1.0, _C, n)");
+              "sgemm('N', 'T', m, n, k, _alpha, _A, k, _B, k, 1.0f, _C, n)");
 }
 
 TEST(BLASNodeGemm, sgemmTT) {
     gemm_test(types::PrimitiveType::Float, blas::BLASType_real, blas::BLASTranspose_Transpose,
               blas::BLASTranspose_Transpose,
-              "sgemm('T', 'T', m, n, k, _alpha, _A, m, _B, k, 1.0, _C, n)");
+              "sgemm('T', 'T', m, n, k, _alpha, _A, m, _B, k, 1.0f, _C, n)");
 }
 
 TEST(BLASNodeGemm, dgemmNN) {
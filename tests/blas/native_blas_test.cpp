@@ -0,0 +1,259 @@
+#include "sdfg/blas/runtime/sdfg_blas.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+template <typename T>
+inline std::vector<T> native_blas_matrix(size_t rows, size_t cols, size_t seed) {
+    std::vector<T> matrix(rows * cols);
+    for (size_t i = 0; i < matrix.size(); i++) matrix[i] = static_cast<T>((i * 7 + seed) % 11) - 5;
+    return matrix;
+}
+
+template <typename T>
+inline void native_blas_gemm_reference(char transA, char transB, size_t m, size_t n, size_t k,
+                                       T alpha, const T* A, size_t lda, const T* B, size_t ldb,
+                                       T beta, T* C, size_t ldc) {
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            T sum = 0;
+            for (size_t p = 0; p < k; p++) {
+                T a = (transA == 'N') ? A[i * lda + p] : A[p * lda + i];
+                T b = (transB == 'N') ? B[p * ldb + j] : B[j * ldb + p];
+                sum += a * b;
+            }
+            C[i * ldc + j] = beta * C[i * ldc + j] + alpha * sum;
+        }
+    }
+}
+
+// Sizes are chosen to leave partial micro-tiles and to span two KC blocks
+TEST(NativeBLAS, sgemmNN) {
+    size_t m = 13, n = 37, k = 300;
+    auto A = native_blas_matrix<float>(m, k, 1);
+    auto B = native_blas_matrix<float>(k, n, 2);
+    auto C = native_blas_matrix<float>(m, n, 3);
+    auto C_ref = C;
+
+    sdfg_blas_sgemm('N', 'N', m, n, k, 2.0f, A.data(), k, B.data(), n, 1.0f, C.data(), n);
+    native_blas_gemm_reference<float>('N', 'N', m, n, k, 2.0f, A.data(), k, B.data(), n, 1.0f,
+                                      C_ref.data(), n);
+
+    for (size_t i = 0; i < C.size(); i++) EXPECT_FLOAT_EQ(C[i], C_ref[i]);
+}
+
+TEST(NativeBLAS, dgemmTT) {
+    size_t m = 7, n = 19, k = 5;
+    auto A = native_blas_matrix<double>(k, m, 4);
+    auto B = native_blas_matrix<double>(n, k, 5);
+    auto C = native_blas_matrix<double>(m, n, 6);
+    auto C_ref = C;
+
+    sdfg_blas_dgemm('T', 'T', m, n, k, 1.0, A.data(), m, B.data(), k, 0.0, C.data(), n);
+    native_blas_gemm_reference<double>('T', 'T', m, n, k, 1.0, A.data(), m, B.data(), k, 0.0,
+                                       C_ref.data(), n);
+
+    for (size_t i = 0; i < C.size(); i++) EXPECT_DOUBLE_EQ(C[i], C_ref[i]);
+}
+
+// The epilogue must only be applied once although C is updated by two KC blocks
+TEST(NativeBLAS, sgemmNN_epilogue) {
+    size_t m = 13, n = 37, k = 300;
+    auto A = native_blas_matrix<float>(m, k, 1);
+    auto B = native_blas_matrix<float>(k, n, 2);
+    auto C = native_blas_matrix<float>(m, n, 3);
+    auto C_ref = C;
+
+    sdfg_blas_sgemm_epilogue('N', 'N', m, n, k, 1.0f, A.data(), k, B.data(), n, 1.0f, C.data(), n,
+                             0.5f, 1.0f, 0.0f, INFINITY);
+    native_blas_gemm_reference<float>('N', 'N', m, n, k, 1.0f, A.data(), k, B.data(), n, 1.0f,
+                                      C_ref.data(), n);
+    for (auto& c : C_ref) c = std::max(0.5f * c + 1.0f, 0.0f);
+
+    for (size_t i = 0; i < C.size(); i++) EXPECT_FLOAT_EQ(C[i], C_ref[i]);
+}
+
+TEST(NativeBLAS, dgemvN_epilogue) {
+    size_t m = 9, n = 6;
+    auto A = native_blas_matrix<double>(m, n, 7);
+    auto x = native_blas_matrix<double>(n, 1, 8);
+    auto y = native_blas_matrix<double>(m, 1, 9);
+    auto y_ref = y;
+
+    sdfg_blas_dgemv_epilogue('N', m, n, 1.0, A.data(), n, x.data(), 1, 1.0, y.data(), 1, 1.0, 0.0,
+                             -10.0, 10.0);
+    native_blas_gemm_reference<double>('N', 'N', m, 1, n, 1.0, A.data(), n, x.data(), 1, 1.0,
+                                       y_ref.data(), 1);
+    for (auto& v : y_ref) v = std::min(std::max(v, -10.0), 10.0);
+
+    for (size_t i = 0; i < y.size(); i++) EXPECT_DOUBLE_EQ(y[i], y_ref[i]);
+}
+
+TEST(NativeBLAS, dgemvT) {
+    size_t m = 9, n = 6;
+    auto A = native_blas_matrix<double>(m, n, 7);
+    auto x = native_blas_matrix<double>(m, 1, 8);
+    auto y = native_blas_matrix<double>(n, 1, 9);
+    auto y_ref = y;
+
+    sdfg_blas_dgemv('T', m, n, 3.0, A.data(), n, x.data(), 1, 2.0, y.data(), 1);
+    native_blas_gemm_reference<double>('T', 'N', n, 1, m, 3.0, A.data(), n, x.data(), 1, 2.0,
+                                       y_ref.data(), 1);
+
+    for (size_t i = 0; i < y.size(); i++) EXPECT_DOUBLE_EQ(y[i], y_ref[i]);
+}
+
+TEST(NativeBLAS, saxpy_strided) {
+    size_t n = 10;
+    auto x = native_blas_matrix<float>(2 * n, 1, 10);
+    auto y = native_blas_matrix<float>(n, 1, 11);
+    auto y_ref = y;
+
+    sdfg_blas_saxpy(n, 0.5f, x.data(), 2, y.data(), 1);
+    for (size_t i = 0; i < n; i++) y_ref[i] += 0.5f * x[2 * i];
+
+    for (size_t i = 0; i < n; i++) EXPECT_FLOAT_EQ(y[i], y_ref[i]);
+}
+
+TEST(NativeBLAS, dsyrkUN) {
+    size_t n = 5, k = 4;
+    auto A = native_blas_matrix<double>(n, k, 12);
+    std::vector<double> C(n * n, -1.0);
+
+    sdfg_blas_dsyrk('U', 'N', n, k, 1.0, A.data(), k, 0.0, C.data(), n);
+
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            double expected = -1.0;
+            if (j >= i) {
+                expected = 0.0;
+                for (size_t p = 0; p < k; p++) expected += A[i * k + p] * A[j * k + p];
+            }
+            EXPECT_DOUBLE_EQ(C[i * n + j], expected);
+        }
+    }
+}
+
+TEST(NativeBLAS, ddot_strided) {
+    size_t n = 10;
+    auto x = native_blas_matrix<double>(n, 1, 13);
+    auto y = native_blas_matrix<double>(3 * n, 1, 14);
+
+    double expected = 0.0;
+    for (size_t i = 0; i < n; i++) expected += x[i] * y[3 * i];
+
+    EXPECT_DOUBLE_EQ(sdfg_blas_ddot(n, x.data(), 1, y.data(), 3), expected);
+}
+
+// Only the triangle selected by uplo may be read, so the other one is filled with garbage
+template <typename T>
+inline std::vector<T> native_blas_symmetric(char uplo, size_t n, size_t seed,
+                                            std::vector<T>& full) {
+    auto A = native_blas_matrix<T>(n, n, seed);
+    full.assign(n * n, 0);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            bool stored = (uplo == 'U') ? (i <= j) : (j <= i);
+            if (stored) {
+                full[i * n + j] = A[i * n + j];
+                full[j * n + i] = A[i * n + j];
+            } else {
+                A[i * n + j] = 1000;
+            }
+        }
+    }
+    return A;
+}
+
+TEST(NativeBLAS, ssymvL) {
+    size_t n = 11;
+    std::vector<float> full;
+    auto A = native_blas_symmetric<float>('L', n, 15, full);
+    auto x = native_blas_matrix<float>(n, 1, 16);
+    auto y = native_blas_matrix<float>(n, 1, 17);
+    auto y_ref = y;
+
+    sdfg_blas_ssymv('L', n, 2.0f, A.data(), n, x.data(), 1, 1.0f, y.data(), 1);
+    native_blas_gemm_reference<float>('N', 'N', n, 1, n, 2.0f, full.data(), n, x.data(), 1, 1.0f,
+                                      y_ref.data(), 1);
+
+    for (size_t i = 0; i < n; i++) EXPECT_FLOAT_EQ(y[i], y_ref[i]);
+}
+
+TEST(NativeBLAS, dsymvU) {
+    size_t n = 11;
+    std::vector<double> full;
+    auto A = native_blas_symmetric<double>('U', n, 18, full);
+    auto x = native_blas_matrix<double>(n, 1, 19);
+    auto y = native_blas_matrix<double>(n, 1, 20);
+    auto y_ref = y;
+
+    sdfg_blas_dsymv('U', n, 1.0, A.data(), n, x.data(), 1, 0.5, y.data(), 1);
+    native_blas_gemm_reference<double>('N', 'N', n, 1, n, 1.0, full.data(), n, x.data(), 1, 0.5,
+                                       y_ref.data(), 1);
+
+    for (size_t i = 0; i < n; i++) EXPECT_DOUBLE_EQ(y[i], y_ref[i]);
+}
+
+TEST(NativeBLAS, sger) {
+    size_t m = 7, n = 9;
+    auto x = native_blas_matrix<float>(m, 1, 21);
+    auto y = native_blas_matrix<float>(n, 1, 22);
+    auto A = native_blas_matrix<float>(m, n, 23);
+    auto A_ref = A;
+
+    sdfg_blas_sger(m, n, 2.0f, x.data(), 1, y.data(), 1, A.data(), n);
+    native_blas_gemm_reference<float>('N', 'N', m, n, 1, 2.0f, x.data(), 1, y.data(), n, 1.0f,
+                                      A_ref.data(), n);
+
+    for (size_t i = 0; i < A.size(); i++) EXPECT_FLOAT_EQ(A[i], A_ref[i]);
+}
+
+TEST(NativeBLAS, dsyrL) {
+    size_t n = 8;
+    auto x = native_blas_matrix<double>(n, 1, 24);
+    std::vector<double> A(n * n, -1.0);
+
+    sdfg_blas_dsyr('L', n, 3.0, x.data(), 1, A.data(), n);
+
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            double expected = (j <= i) ? -1.0 + 3.0 * x[i] * x[j] : -1.0;
+            EXPECT_DOUBLE_EQ(A[i * n + j], expected);
+        }
+    }
+}
+
+TEST(NativeBLAS, ssymmLU) {
+    size_t m = 6, n = 10;
+    std::vector<float> full;
+    auto A = native_blas_symmetric<float>('U', m, 25, full);
+    auto B = native_blas_matrix<float>(m, n, 26);
+    auto C = native_blas_matrix<float>(m, n, 27);
+    auto C_ref = C;
+
+    sdfg_blas_ssymm('L', 'U', m, n, 2.0f, A.data(), m, B.data(), n, 1.0f, C.data(), n);
+    native_blas_gemm_reference<float>('N', 'N', m, n, m, 2.0f, full.data(), m, B.data(), n, 1.0f,
+                                      C_ref.data(), n);
+
+    for (size_t i = 0; i < C.size(); i++) EXPECT_FLOAT_EQ(C[i], C_ref[i]);
+}
+
+TEST(NativeBLAS, dsymmRL) {
+    size_t m = 6, n = 10;
+    std::vector<double> full;
+    auto A = native_blas_symmetric<double>('L', n, 28, full);
+    auto B = native_blas_matrix<double>(m, n, 29);
+    auto C = native_blas_matrix<double>(m, n, 30);
+    auto C_ref = C;
+
+    sdfg_blas_dsymm('R', 'L', m, n, 1.0, A.data(), n, B.data(), n, 0.0, C.data(), n);
+    native_blas_gemm_reference<double>('N', 'N', m, n, n, 1.0, B.data(), n, full.data(), n, 0.0,
+                                       C_ref.data(), n);
+
+    for (size_t i = 0; i < C.size(); i++) EXPECT_DOUBLE_EQ(C[i], C_ref[i]);
+}
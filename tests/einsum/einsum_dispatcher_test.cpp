@@ -1,9 +1,25 @@
+#include "sdfg/einsum/einsum_dispatcher.h"
+
 #include <gtest/gtest.h>
 #include <sdfg/codegen/code_generators/c_code_generator.h>
+#include <sdfg/codegen/language_extensions/c_language_extension.h>
+#include <sdfg/codegen/utils.h>
 #include <sdfg/element.h>
 
+#include <string>
+
 #include "fixtures/einsum.h"
 
+inline std::string dispatch_einsum(const StructuredSDFG& sdfg, einsum::EinsumNode& node,
+                                   const einsum::EinsumDispatcherOptions& options) {
+    codegen::CLanguageExtension language_extension;
+    einsum::EinsumDispatcher dispatcher(language_extension, sdfg, node.get_parent(), node,
+                                        options);
+    codegen::PrettyPrinter stream;
+    dispatcher.dispatch(stream);
+    return stream.str();
+}
+
 TEST(EinsumDispatcher, MatrixMatrixMultiplication) {
     auto sdfg_and_node = matrix_matrix_mult();
     auto sdfg = std::move(sdfg_and_node.first);
@@ -299,6 +315,47 @@ unsigned long long i;
 )");
 }
 
+TEST(EinsumDispatcher, MatrixVectorMultiplication_unrolled) {
+    auto sdfg_and_node = matrix_vector_mult(symbolic::integer(2), symbolic::integer(2));
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* node = sdfg_and_node.second;
+
+    EXPECT_TRUE(node);
+
+    // Unrolling is off by default
+    einsum::EinsumDispatcherOptions options;
+    std::string code = dispatch_einsum(*sdfg, *node, options);
+    EXPECT_NE(code.find("for (i = 0; i < 2; i++)"), std::string::npos);
+
+    // Constant bounds unroll the loop nest, one block per output element
+    options.unroll_iterations = 512;
+    EXPECT_EQ(dispatch_einsum(*sdfg, *node, options), R"(// Einsum Node
+{
+    float **_in1 = A;
+    float *_in2 = b;
+
+    {
+        float _out = c[0];
+        _out = _out + _in1[0][0] * _in2[0];
+        _out = _out + _in1[0][1] * _in2[1];
+        c[0] = _out;
+    }
+    {
+        float _out = c[1];
+        _out = _out + _in1[1][0] * _in2[0];
+        _out = _out + _in1[1][1] * _in2[1];
+        c[1] = _out;
+    }
+}
+)");
+
+    // Loop nests with more iterations than the limit are not unrolled
+    options.unroll_iterations = 3;
+    code = dispatch_einsum(*sdfg, *node, options);
+    EXPECT_NE(code.find("for (i = 0; i < 2; i++)"), std::string::npos);
+    EXPECT_NE(code.find("for (j = 0; j < 2; j++)"), std::string::npos);
+}
+
 TEST(EinsumDispatcher, DiagonalExtraction) {
     auto sdfg_and_node = diagonal_extraction();
     auto sdfg = std::move(sdfg_and_node.first);
@@ -657,9 +714,10 @@ unsigned long long i;
         float **_in1 = A;
         float *_in2 = x;
 
-        #pragma omp parallel for private(i, j) reduction(+:y[i])
+        #pragma omp parallel private(i, j)
         for (j = 0; j < J; j++)
         {
+            #pragma omp for
             for (i = 0; i < 1 + j; i++)
             {
                 float _out = y[i];
@@ -672,3 +730,461 @@ unsigned long long i;
     }
 )");
 }
+
+TEST(EinsumDispatcher, MatrixMatrixMultiplication_tiling) {
+    auto sdfg_and_node = matrix_matrix_mult();
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* node = sdfg_and_node.second;
+
+    ASSERT_TRUE(node);
+
+    einsum::EinsumDispatcherOptions options;
+    options.tiling = true;
+
+    EXPECT_EQ(dispatch_einsum(*sdfg, *node, options), R"(// Einsum Node
+{
+    float **_in1 = A;
+    float **_in2 = B;
+
+    unsigned long long i_tile;
+    unsigned long long j_tile;
+    unsigned long long k_tile;
+
+    #pragma omp parallel for private(i, j, k, i_tile, j_tile, k_tile) collapse(2)
+    for (i_tile = 0; i_tile < I; i_tile += 32)
+    {
+        for (k_tile = 0; k_tile < K; k_tile += 32)
+        {
+            for (j_tile = 0; j_tile < J; j_tile += 32)
+            {
+                for (i = i_tile; i < (i_tile + 32 < I ? i_tile + 32 : I); i++)
+                {
+                    for (k = k_tile; k < (k_tile + 32 < K ? k_tile + 32 : K); k++)
+                    {
+                        float _out = C[i][k];
+
+                        for (j = j_tile; j < (j_tile + 32 < J ? j_tile + 32 : J); j++)
+                        {
+                            _out = _out + _in1[i][j] * _in2[j][k];
+                        }
+
+                        C[i][k] = _out;
+                    }
+                }
+            }
+        }
+    }
+}
+)");
+}
+
+TEST(EinsumDispatcher, MatrixMatrixMultiplication_tilingCacheSize) {
+    auto sdfg_and_node = matrix_matrix_mult();
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* node = sdfg_and_node.second;
+
+    ASSERT_TRUE(node);
+
+    einsum::EinsumDispatcherOptions options;
+    options.tiling = true;
+    options.tiling_cache_size = 1048576;
+
+    std::string code = dispatch_einsum(*sdfg, *node, options);
+    EXPECT_NE(code.find("i_tile += 256"), std::string::npos);
+    EXPECT_NE(code.find("for (j = j_tile; j < (j_tile + 256 < J ? j_tile + 256 : J); j++)"),
+              std::string::npos);
+}
+
+TEST(EinsumDispatcher, MatrixCopy_tiling) {
+    auto sdfg_and_node = matrix_copy();
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* node = sdfg_and_node.second;
+
+    ASSERT_TRUE(node);
+
+    einsum::EinsumDispatcherOptions options;
+    options.tiling = true;
+
+    EXPECT_EQ(dispatch_einsum(*sdfg, *node, options), R"(// Einsum Node
+{
+    float **_in = A;
+
+    unsigned long long i_tile;
+    unsigned long long j_tile;
+
+    #pragma omp parallel for private(i, j, i_tile, j_tile) collapse(2)
+    for (i_tile = 0; i_tile < I; i_tile += 64)
+    {
+        for (j_tile = 0; j_tile < J; j_tile += 64)
+        {
+            for (i = i_tile; i < (i_tile + 64 < I ? i_tile + 64 : I); i++)
+            {
+                for (j = j_tile; j < (j_tile + 64 < J ? j_tile + 64 : J); j++)
+                {
+                    float _out;
+
+                    _out = _in[i][j];
+
+                    B[i][j] = _out;
+                }
+            }
+        }
+    }
+}
+)");
+}
+
+TEST(EinsumDispatcher, ssymvL_tiling) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+    builder.add_container("j", sym_desc);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("x", desc, true);
+    builder.add_container("y", desc, true);
+
+    auto indvar_i = symbolic::symbol("i");
+    auto bound_i = symbolic::symbol("I");
+    auto indvar_j = symbolic::symbol("j");
+    auto bound_j = symbolic::add(indvar_i, symbolic::one());
+
+    auto& root = builder.subject().root();
+    auto& block = builder.add_block(root);
+    auto& A = builder.add_access(block, "A");
+    auto& x = builder.add_access(block, "x");
+    auto& y1 = builder.add_access(block, "y");
+    auto& y2 = builder.add_access(block, "y");
+    auto& libnode =
+        builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                 const std::vector<std::string>&,
+                                 std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                 data_flow::Subset, std::vector<data_flow::Subset>>(
+            block, DebugInfo(), {"_out"}, {"_in1", "_in2", "_out"},
+            {{indvar_i, bound_i}, {indvar_j, bound_j}}, {indvar_i},
+            {{indvar_i, indvar_j}, {indvar_j}, {indvar_i}});
+    builder.add_memlet(block, A, "void", libnode, "_in1", {});
+    builder.add_memlet(block, x, "void", libnode, "_in2", {});
+    builder.add_memlet(block, y1, "void", libnode, "_out", {});
+    builder.add_memlet(block, libnode, "_out", y2, "void", {});
+
+    auto sdfg = builder.move();
+
+    einsum::EinsumDispatcherOptions options;
+    options.tiling = true;
+
+    // Triangular iteration spaces are not tiled
+    EXPECT_EQ(dispatch_einsum(*sdfg, dynamic_cast<einsum::EinsumNode&>(libnode), options),
+              R"(// Einsum Node
+{
+    float **_in1 = A;
+    float *_in2 = x;
+
+    #pragma omp parallel for private(i, j)
+    for (i = 0; i < I; i++)
+    {
+        float _out = y[i];
+
+        for (j = 0; j < 1 + i; j++)
+        {
+            _out = _out + _in1[i][j] * _in2[j];
+        }
+
+        y[i] = _out;
+    }
+}
+)");
+}
+
+TEST(EinsumDispatcher, TensorContraction3D_loopInterchange) {
+    auto sdfg_and_node = tensor_contraction_3d();
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* node = sdfg_and_node.second;
+
+    ASSERT_TRUE(node);
+
+    einsum::EinsumDispatcherOptions options;
+    options.loop_interchange = true;
+
+    EXPECT_EQ(dispatch_einsum(*sdfg, *node, options), R"(// Einsum Node
+{
+    float ***_in1 = A;
+    float ***_in2 = B;
+    float ***_in3 = C;
+
+    #pragma omp parallel for private(i, j, k, l, m, n) collapse(3)
+    for (i = 0; i < I; i++)
+    {
+        for (j = 0; j < J; j++)
+        {
+            for (k = 0; k < K; k++)
+            {
+                float _out = D[i][j][k];
+
+                for (l = 0; l < L; l++)
+                {
+                    for (n = 0; n < N; n++)
+                    {
+                        for (m = 0; m < M; m++)
+                        {
+                            _out = _out + _in1[l][j][m] * _in2[i][l][n] * _in3[n][m][k];
+                        }
+                    }
+                }
+
+                D[i][j][k] = _out;
+            }
+        }
+    }
+}
+)");
+}
+
+TEST(EinsumDispatcher, MatrixMatrixMultiplication_vectorize) {
+    auto sdfg_and_node = matrix_matrix_mult();
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* node = sdfg_and_node.second;
+
+    ASSERT_TRUE(node);
+
+    einsum::EinsumDispatcherOptions options;
+    options.vectorize = true;
+
+    EXPECT_EQ(dispatch_einsum(*sdfg, *node, options), R"(// Einsum Node
+{
+    float **_in1 = A;
+    float **_in2 = B;
+
+    #pragma omp parallel for private(i, j, k) collapse(2)
+    for (i = 0; i < I; i++)
+    {
+        for (k = 0; k < K; k++)
+        {
+            float _out = C[i][k];
+
+            #pragma omp simd reduction(+:_out)
+            for (j = 0; j < J; j++)
+            {
+                _out = _out + _in1[i][j] * _in2[j][k];
+            }
+
+            C[i][k] = _out;
+        }
+    }
+}
+)");
+}
+
+TEST(EinsumDispatcher, DotProduct_vectorize) {
+    auto sdfg_and_node = dot_product();
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* node = sdfg_and_node.second;
+
+    ASSERT_TRUE(node);
+
+    einsum::EinsumDispatcherOptions options;
+    options.vectorize = true;
+
+    EXPECT_EQ(dispatch_einsum(*sdfg, *node, options), R"(// Einsum Node
+{
+    float *_in1 = a;
+    float *_in2 = b;
+
+    float _out = *c;
+
+    #pragma omp parallel for simd private(i) reduction(+:_out)
+    for (i = 0; i < I; i++)
+    {
+        _out = _out + _in1[i] * _in2[i];
+    }
+
+    *c = _out;
+}
+)");
+}
+
+TEST(EinsumDispatcher, MatrixCopy_vectorize) {
+    auto sdfg_and_node = matrix_copy();
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* node = sdfg_and_node.second;
+
+    ASSERT_TRUE(node);
+
+    einsum::EinsumDispatcherOptions options;
+    options.vectorize = true;
+
+    // Nothing is accumulated
+    std::string code = dispatch_einsum(*sdfg, *node, options);
+    EXPECT_EQ(code.find("simd"), std::string::npos);
+}
+
+TEST(EinsumDispatcher, OuterReductionMap) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+    builder.add_container("j", sym_desc);
+    builder.add_container("J", sym_desc, true);
+    builder.add_container("k", sym_desc);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("B", desc2, true);
+    builder.add_container("C", desc2, true);
+
+    auto indvar_i = symbolic::symbol("i");
+    auto indvar_j = symbolic::symbol("j");
+    auto indvar_k = symbolic::symbol("k");
+
+    auto& root = builder.subject().root();
+    auto& block = builder.add_block(root);
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& C1 = builder.add_access(block, "C");
+    auto& C2 = builder.add_access(block, "C");
+    auto& libnode =
+        builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                 const std::vector<std::string>&,
+                                 std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                 data_flow::Subset, std::vector<data_flow::Subset>>(
+            block, DebugInfo(), {"_out"}, {"_in1", "_in2", "_out"},
+            {{indvar_i, symbolic::symbol("I")},
+             {indvar_j, symbolic::symbol("J")},
+             {indvar_k, symbolic::add(indvar_j, symbolic::one())}},
+            {indvar_i, indvar_k},
+            {{indvar_i, indvar_j}, {indvar_j, indvar_k}, {indvar_i, indvar_k}});
+    builder.add_memlet(block, A, "void", libnode, "_in1", {});
+    builder.add_memlet(block, B, "void", libnode, "_in2", {});
+    builder.add_memlet(block, C1, "void", libnode, "_out", {});
+    builder.add_memlet(block, libnode, "_out", C2, "void", {});
+
+    auto sdfg = builder.move();
+
+    // The parallel loop nest must not include the reduction over j
+    EXPECT_EQ(dispatch_einsum(*sdfg, dynamic_cast<einsum::EinsumNode&>(libnode),
+                              einsum::EinsumDispatcherOptions()),
+              R"(// Einsum Node
+{
+    float **_in1 = A;
+    float **_in2 = B;
+
+    #pragma omp parallel for private(i, j, k)
+    for (i = 0; i < I; i++)
+    {
+        for (j = 0; j < J; j++)
+        {
+            for (k = 0; k < 1 + j; k++)
+            {
+                float _out = C[i][k];
+
+                _out = _out + _in1[i][j] * _in2[j][k];
+
+                C[i][k] = _out;
+            }
+        }
+    }
+}
+)");
+}
+
+TEST(EinsumDispatcher, MatrixMatrixMultiplicationSum) {
+    auto sdfg_and_node = matrix_matrix_mult_sum();
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* node = sdfg_and_node.second;
+
+    EXPECT_TRUE(node);
+
+    // Both terms are evaluated in one loop nest
+    std::string code = dispatch_einsum(*sdfg, *node, einsum::EinsumDispatcherOptions());
+    EXPECT_NE(code.find("_out = _out + _in1[i][j] * _in2[j][k] + _in3[i][j] * _in4[j][k];"),
+              std::string::npos);
+    EXPECT_EQ(code.find("for (j"), code.rfind("for (j"));
+}
+
+TEST(EinsumDispatcher, RowMax_vectorize) {
+    auto sdfg_and_node = row_reduction(einsum::ReductionType_Max, true);
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* node = sdfg_and_node.second;
+
+    EXPECT_TRUE(node);
+
+    einsum::EinsumDispatcherOptions options;
+    options.vectorize = true;
+    std::string code = dispatch_einsum(*sdfg, *node, options);
+    EXPECT_NE(code.find("float _out = m[i];"), std::string::npos);
+    EXPECT_NE(code.find("#pragma omp simd reduction(max:_out)"), std::string::npos);
+    EXPECT_NE(code.find("_out = _out > _in[i][j] ? _out : _in[i][j];"), std::string::npos);
+}
+
+TEST(EinsumDispatcher, RowMin_identity) {
+    auto sdfg_and_node = row_reduction(einsum::ReductionType_Min, false);
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* node = sdfg_and_node.second;
+
+    EXPECT_TRUE(node);
+
+    // The output is not read, so the reduction starts from the identity of min
+    std::string code = dispatch_einsum(*sdfg, *node, einsum::EinsumDispatcherOptions());
+    EXPECT_NE(code.find("float _out = INFINITY;"), std::string::npos);
+    EXPECT_NE(code.find("_out = _out < _in[i][j] ? _out : _in[i][j];"), std::string::npos);
+}
+
+TEST(EinsumDispatcher, RowSum_epilogue) {
+    auto relu = symbolic::max(symbolic::symbol("_out"), symbolic::zero());
+    auto sdfg_and_node = row_reduction(einsum::ReductionType_Sum, true, relu);
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* node = sdfg_and_node.second;
+
+    EXPECT_TRUE(node);
+
+    // The epilogue is applied once per row when the output is written back
+    codegen::CLanguageExtension language_extension;
+    std::string code = dispatch_einsum(*sdfg, *node, einsum::EinsumDispatcherOptions());
+    EXPECT_NE(code.find("m[i] = " + language_extension.expression(relu) + ";"),
+              std::string::npos);
+    EXPECT_EQ(code.find("m[i] = _out;"), std::string::npos);
+}
+
+TEST(EinsumDispatcher, MatrixVectorMultiplicationPair) {
+    auto sdfg_and_node = matrix_vector_mult_pair(true);
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* node = sdfg_and_node.second;
+
+    EXPECT_TRUE(node);
+
+    // Both outputs are computed in one parallel loop nest
+    std::string code = dispatch_einsum(*sdfg, *node, einsum::EinsumDispatcherOptions());
+    EXPECT_EQ(code.find("#pragma omp parallel"), code.rfind("#pragma omp parallel"));
+    EXPECT_EQ(code.find("for (j"), code.rfind("for (j"));
+    EXPECT_NE(code.find("float _out = y[i];"), std::string::npos);
+    EXPECT_NE(code.find("float _out_1 = z[i];"), std::string::npos);
+    EXPECT_NE(code.find("_out = _out + _in1[i][j] * _in2[j];"), std::string::npos);
+    EXPECT_NE(code.find("_out_1 = _out_1 + _in3[i][j] * _in4[j];"), std::string::npos);
+    EXPECT_NE(code.find("y[i] = _out;"), std::string::npos);
+    EXPECT_NE(code.find("z[i] = _out_1;"), std::string::npos);
+}
+
+TEST(EinsumDispatcher, MatrixVectorMultiplicationTransposedPair) {
+    auto sdfg_and_node = matrix_vector_mult_transposed_pair(true);
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* node = sdfg_and_node.second;
+
+    EXPECT_TRUE(node);
+
+    // A is read once for both outputs, which are updated in memory by a sequential loop nest
+    std::string code = dispatch_einsum(*sdfg, *node, einsum::EinsumDispatcherOptions());
+    EXPECT_EQ(code.find("#pragma omp"), std::string::npos);
+    EXPECT_EQ(code.find("for (j"), code.rfind("for (j"));
+    EXPECT_NE(code.find("float *_out = y;"), std::string::npos);
+    EXPECT_NE(code.find("float *_out_1 = z;"), std::string::npos);
+    EXPECT_NE(code.find("_out[i] = _out[i] + _in1[i][j] * _in2[j];"), std::string::npos);
+    EXPECT_NE(code.find("_out_1[j] = _out_1[j] + _in3[i][j] * _in4[i];"), std::string::npos);
+}
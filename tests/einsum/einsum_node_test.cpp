@@ -1,6 +1,8 @@
 #include "sdfg/einsum/einsum_node.h"
 
 #include <gtest/gtest.h>
+#include <sdfg/exceptions.h>
+#include <sdfg/symbolic/symbolic.h>
 
 #include "fixtures/einsum.h"
 
@@ -109,3 +111,85 @@ TEST(EinsumNode, VectorScaling) {
 
     EXPECT_EQ(node->toStr(), "_out[i] = _in1[i] * _in2 * _in3 * _in4 for i = 0:I");
 }
+
+TEST(EinsumNode, MatrixMatrixMultiplicationSum) {
+    auto sdfg_and_node = matrix_matrix_mult_sum();
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* node = sdfg_and_node.second;
+
+    EXPECT_TRUE(node);
+
+    EXPECT_EQ(node->terms().size(), 2);
+    EXPECT_EQ(node->toStr(),
+              "_out[i,k] = _out[i,k] + _in1[i,j] * _in2[j,k] + _in3[i,j] * _in4[j,k] for i = 0:I "
+              "for j = 0:J for k = 0:K");
+}
+
+TEST(EinsumNode, DefaultTerm) {
+    auto sdfg_and_node = matrix_matrix_mult();
+    auto* node = sdfg_and_node.second;
+
+    // All inputs except the output form a single product
+    ASSERT_EQ(node->terms().size(), 1);
+    EXPECT_EQ(node->term(0), std::vector<size_t>({1, 2}));
+}
+
+TEST(EinsumNode, RowMax) {
+    auto sdfg_and_node = row_reduction(einsum::ReductionType_Max, true);
+    auto* node = sdfg_and_node.second;
+
+    EXPECT_TRUE(node);
+
+    EXPECT_EQ(node->reduction(), einsum::ReductionType_Max);
+    EXPECT_EQ(node->toStr(), "_out[i] = max(_out[i], _in[i,j]) for i = 0:I for j = 0:J");
+}
+
+TEST(EinsumNode, RowSumEpilogue) {
+    auto relu = symbolic::max(symbolic::symbol("_out"), symbolic::zero());
+    auto sdfg_and_node = row_reduction(einsum::ReductionType_Sum, true, relu);
+    auto* node = sdfg_and_node.second;
+
+    EXPECT_TRUE(node);
+
+    EXPECT_TRUE(node->has_epilogue());
+    EXPECT_EQ(node->toStr(), "_out[i] = _out[i] + _in[i,j] then " + relu->__str__() +
+                                 " for i = 0:I for j = 0:J");
+}
+
+TEST(EinsumNode, EpilogueUsesIndvar) {
+    auto epilogue = symbolic::add(symbolic::symbol("_out"), symbolic::symbol("j"));
+    EXPECT_THROW(row_reduction(einsum::ReductionType_Sum, true, epilogue), InvalidSDFGException);
+}
+
+TEST(EinsumNode, MultipleOutputs) {
+    auto sdfg_and_node = matrix_vector_mult_pair(true);
+    auto* node = sdfg_and_node.second;
+
+    EXPECT_TRUE(node);
+
+    EXPECT_EQ(node->outputs().size(), 2);
+    EXPECT_EQ(node->term_output(1), 1);
+    EXPECT_EQ(node->getOutInputIndex(0), 2);
+    EXPECT_EQ(node->getOutInputIndex(1), 5);
+    EXPECT_EQ(node->toStr(),
+              "_out[i] = _out[i] + _in1[i,j] * _in2[j]; _out_1[i] = _out_1[i] + _in3[i,j] * "
+              "_in4[j] for i = 0:I for j = 0:J");
+}
+
+TEST(EinsumNode, DifferentOutIndices) {
+    auto sdfg_and_node = matrix_vector_mult_transposed_pair(true);
+    auto* node = sdfg_and_node.second;
+
+    EXPECT_TRUE(node);
+
+    EXPECT_FALSE(node->shared_out_indices());
+    ASSERT_EQ(node->out_indices(1).size(), 1);
+    EXPECT_TRUE(symbolic::eq(node->out_indices(1).at(0), symbolic::symbol("j")));
+    EXPECT_EQ(node->toStr(),
+              "_out[i] = _out[i] + _in1[i,j] * _in2[j]; _out_1[j] = _out_1[j] + _in3[i,j] * "
+              "_in4[i] for i = 0:I for j = 0:J");
+
+    // Outputs which share the out indices
+    auto shared = matrix_vector_mult_pair(true);
+    EXPECT_TRUE(shared.second->shared_out_indices());
+}
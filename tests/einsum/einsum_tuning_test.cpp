@@ -0,0 +1,185 @@
+#include "sdfg/einsum/einsum_tuning.h"
+
+#include <gtest/gtest.h>
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/codegen/code_generators/c_code_generator.h>
+#include <sdfg/data_flow/memlet.h>
+#include <sdfg/element.h>
+#include <sdfg/function.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/types/pointer.h>
+#include <sdfg/types/scalar.h>
+#include <sdfg/types/type.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sdfg/einsum/einsum_autotuner.h"
+#include "sdfg/einsum/einsum_node.h"
+#include "sdfg/transformations/einsum2blas.h"
+
+using namespace sdfg;
+
+inline std::pair<std::unique_ptr<StructuredSDFG>, einsum::EinsumNode*> tuning_sdfg() {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+    builder.add_container("j", sym_desc);
+    builder.add_container("J", sym_desc, true);
+    builder.add_container("k", sym_desc);
+    builder.add_container("K", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("B", desc2, true);
+    builder.add_container("C", desc2, true);
+
+    auto indvar_i = symbolic::symbol("i");
+    auto indvar_j = symbolic::symbol("j");
+    auto indvar_k = symbolic::symbol("k");
+
+    auto& root = builder.subject().root();
+    auto& block = builder.add_block(root);
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& C1 = builder.add_access(block, "C");
+    auto& C2 = builder.add_access(block, "C");
+    auto& libnode =
+        builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                 const std::vector<std::string>&,
+                                 std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                 data_flow::Subset, std::vector<data_flow::Subset>>(
+            block, DebugInfo(), {"_out"}, {"_in0", "_in1", "_out"},
+            {{indvar_i, symbolic::symbol("I")},
+             {indvar_j, symbolic::symbol("J")},
+             {indvar_k, symbolic::symbol("K")}},
+            {indvar_i, indvar_j},
+            {{indvar_i, indvar_k}, {indvar_k, indvar_j}, {indvar_i, indvar_j}});
+    builder.add_memlet(block, A, "void", libnode, "_in0", {});
+    builder.add_memlet(block, B, "void", libnode, "_in1", {});
+    builder.add_memlet(block, C1, "void", libnode, "_out", {});
+    builder.add_memlet(block, libnode, "_out", C2, "void", {});
+
+    auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(&libnode);
+
+    return {builder.move(), einsum_node};
+}
+
+TEST(EinsumTuningDatabase, record_save_load) {
+    auto sdfg_and_node = tuning_sdfg();
+    auto& einsum_node = *sdfg_and_node.second;
+    std::string key = einsum::EinsumTuningDatabase::key(*sdfg_and_node.first,
+                                                        einsum_node.get_parent(), einsum_node);
+    EXPECT_EQ(key, "float " + einsum_node.toStr());
+
+    einsum::EinsumVariant loops;
+    loops.options.loop_interchange = true;
+    loops.options.tiling = true;
+    loops.options.tiling_cache_size = 262144;
+    einsum::EinsumVariant gemm;
+    gemm.lowering = "Einsum2BLASGemm";
+
+    einsum::EinsumTuningDatabase database;
+    EXPECT_FALSE(database.lookup(key));
+    EXPECT_TRUE(database.record(key, gemm, 2.0));
+    EXPECT_TRUE(database.record(key, loops, 1.0));
+    EXPECT_FALSE(database.record(key, gemm, 1.5));
+    EXPECT_FALSE(database.record("other", gemm, -1.0));
+    EXPECT_EQ(database.size(), 1);
+    EXPECT_EQ(database.time(key), 1.0);
+
+    auto path = (std::filesystem::temp_directory_path() / "sdfg_tuning_test.json").string();
+    database.save(path);
+    einsum::EinsumTuningDatabase loaded;
+    loaded.load(path);
+    std::filesystem::remove(path);
+
+    auto* variant = loaded.lookup(key);
+    ASSERT_TRUE(variant);
+    EXPECT_EQ(variant->lowering, "");
+    EXPECT_TRUE(variant->options.loop_interchange);
+    EXPECT_TRUE(variant->options.tiling);
+    EXPECT_EQ(variant->options.tiling_cache_size, 262144);
+    EXPECT_FALSE(variant->options.vectorize);
+    EXPECT_EQ(variant->options.unroll_iterations, 0);
+    EXPECT_EQ(variant->toStr(), "EinsumDispatcher interchange tiling(262144)");
+}
+
+TEST(EinsumTuningDatabase, einsum2blas) {
+    auto sdfg_and_node = tuning_sdfg();
+    auto& einsum_node = *sdfg_and_node.second;
+    std::string key = einsum::EinsumTuningDatabase::key(*sdfg_and_node.first,
+                                                        einsum_node.get_parent(), einsum_node);
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg_and_node.first);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::Einsum2BLAS any(einsum_node);
+    auto candidates = any.candidates(builder_opt, analysis_manager);
+    EXPECT_NE(std::find(candidates.begin(), candidates.end(), "Einsum2BLASGemm"),
+              candidates.end());
+
+    // The loop nest was fastest
+    einsum::EinsumTuningDatabase database;
+    database.record(key, einsum::EinsumVariant(), 1.0);
+    transformations::Einsum2BLAS tuned(einsum_node, database);
+    EXPECT_FALSE(tuned.can_be_applied(builder_opt, analysis_manager));
+
+    // The gemm was fastest
+    einsum::EinsumVariant gemm;
+    gemm.lowering = "Einsum2BLASGemm";
+    database.record(key, gemm, 0.5);
+    EXPECT_TRUE(tuned.can_be_applied(builder_opt, analysis_manager));
+}
+
+TEST(EinsumAutotuner, variants) {
+    auto sdfg_and_node = tuning_sdfg();
+
+    einsum::EinsumAutotunerOptions options;
+    options.sizes = {{"I", 8}, {"J", 16}, {"K", 4}};
+    einsum::EinsumAutotuner autotuner(*sdfg_and_node.first, *sdfg_and_node.second, options);
+
+    auto variants = autotuner.variants();
+    EXPECT_EQ(std::count_if(variants.begin(), variants.end(),
+                            [](auto& variant) { return variant.lowering.empty(); }),
+              12);
+    EXPECT_EQ(std::count_if(variants.begin(), variants.end(),
+                            [](auto& variant) { return variant.lowering == "Einsum2BLASGemm"; }),
+              1);
+
+    // The loop nest gets nested arrays
+    std::string loops = autotuner.benchmark_source(einsum::EinsumVariant());
+    EXPECT_NE(loops.find("benchmark_alloc(extents_A, 2, sizeof(float))"), std::string::npos);
+    EXPECT_NE(loops.find("const long long extents_A[] = {8, 4};"), std::string::npos);
+    EXPECT_NE(loops.find("clock_gettime"), std::string::npos);
+
+    // BLAS gets packed arrays
+    einsum::EinsumVariant gemm;
+    gemm.lowering = "Einsum2BLASGemm";
+    std::string blas = autotuner.benchmark_source(gemm);
+    EXPECT_NE(blas.find("#include <cblas.h>"), std::string::npos);
+    EXPECT_NE(blas.find("cblas_sgemm"), std::string::npos);
+    EXPECT_NE(blas.find("const long long extents_C[] = {128};"), std::string::npos);
+
+    // The dispatchers registered before are restored after a benchmark was generated
+    einsum::EinsumVariant tiled;
+    tiled.options.tiling = true;
+    EXPECT_NE(autotuner.benchmark_source(tiled).find("_tile"), std::string::npos);
+    codegen::CCodeGenerator generator(*sdfg_and_node.first);
+    EXPECT_TRUE(generator.generate());
+    EXPECT_EQ(generator.main().str().find("_tile"), std::string::npos);
+
+    // Symbols without a size cannot be benchmarked
+    options.sizes.erase("K");
+    einsum::EinsumAutotuner incomplete(*sdfg_and_node.first, *sdfg_and_node.second, options);
+    EXPECT_EQ(incomplete.benchmark_source(einsum::EinsumVariant()), "");
+}
@@ -13,6 +13,7 @@
 
 #include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -126,7 +127,9 @@ inline std::pair<std::unique_ptr<StructuredSDFG>, einsum::EinsumNode*> tensor_co
     return std::make_pair(builder.move(), dynamic_cast<einsum::EinsumNode*>(&libnode));
 }
 
-inline std::pair<std::unique_ptr<StructuredSDFG>, einsum::EinsumNode*> matrix_vector_mult() {
+inline std::pair<std::unique_ptr<StructuredSDFG>, einsum::EinsumNode*> matrix_vector_mult(
+    const symbolic::Expression& bound_i = symbolic::symbol("I"),
+    const symbolic::Expression& bound_j = symbolic::symbol("J")) {
     builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
 
     types::Scalar sym_desc(types::PrimitiveType::UInt64);
@@ -157,7 +160,7 @@ inline std::pair<std::unique_ptr<StructuredSDFG>, einsum::EinsumNode*> matrix_ve
                                  std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
                                  data_flow::Subset, std::vector<data_flow::Subset>>(
             block, DebugInfo(), {"_out"}, {"_out", "_in1", "_in2"},
-            {{i, symbolic::symbol("I")}, {j, symbolic::symbol("J")}}, {i}, {{i}, {i, j}, {j}});
+            {{i, bound_i}, {j, bound_j}}, {i}, {{i}, {i, j}, {j}});
     builder.add_memlet(block, c1, "void", libnode, "_out", {});
     builder.add_memlet(block, A, "void", libnode, "_in1", {});
     builder.add_memlet(block, b, "void", libnode, "_in2", {});
@@ -419,4 +422,281 @@ inline std::pair<std::unique_ptr<StructuredSDFG>, einsum::EinsumNode*> vector_sc
     return std::make_pair(builder.move(), dynamic_cast<einsum::EinsumNode*>(&libnode));
 }
 
+inline std::pair<std::unique_ptr<StructuredSDFG>, einsum::EinsumNode*> matrix_matrix_mult_sum() {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+    builder.add_container("j", sym_desc);
+    builder.add_container("J", sym_desc, true);
+    builder.add_container("k", sym_desc);
+    builder.add_container("K", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("B", desc2, true);
+    builder.add_container("C", desc2, true);
+    builder.add_container("D", desc2, true);
+    builder.add_container("E", desc2, true);
+
+    auto i = symbolic::symbol("i");
+    auto j = symbolic::symbol("j");
+    auto k = symbolic::symbol("k");
+
+    auto& root = builder.subject().root();
+    auto& block = builder.add_block(root);
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& D = builder.add_access(block, "D");
+    auto& E = builder.add_access(block, "E");
+    auto& C1 = builder.add_access(block, "C");
+    auto& C2 = builder.add_access(block, "C");
+    auto& libnode =
+        builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                 const std::vector<std::string>&,
+                                 std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                 data_flow::Subset, std::vector<data_flow::Subset>,
+                                 const std::vector<std::vector<size_t>>&>(
+            block, DebugInfo(), {"_out"}, {"_out", "_in1", "_in2", "_in3", "_in4"},
+            {{i, symbolic::symbol("I")}, {j, symbolic::symbol("J")}, {k, symbolic::symbol("K")}},
+            {i, k}, {{i, k}, {i, j}, {j, k}, {i, j}, {j, k}}, {{1, 2}, {3, 4}});
+    builder.add_memlet(block, C1, "void", libnode, "_out", {});
+    builder.add_memlet(block, A, "void", libnode, "_in1", {});
+    builder.add_memlet(block, B, "void", libnode, "_in2", {});
+    builder.add_memlet(block, D, "void", libnode, "_in3", {});
+    builder.add_memlet(block, E, "void", libnode, "_in4", {});
+    builder.add_memlet(block, libnode, "_out", C2, "void", {});
+
+    return std::make_pair(builder.move(), dynamic_cast<einsum::EinsumNode*>(&libnode));
+}
+
+inline std::pair<std::unique_ptr<StructuredSDFG>, einsum::EinsumNode*> row_reduction(
+    einsum::ReductionType reduction, bool accumulate,
+    const symbolic::Expression& epilogue = symbolic::Expression()) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+    builder.add_container("j", sym_desc);
+    builder.add_container("J", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("m", desc, true);
+
+    auto i = symbolic::symbol("i");
+    auto j = symbolic::symbol("j");
+
+    std::vector<std::string> inputs = {"_in"};
+    std::vector<data_flow::Subset> in_indices = {{i, j}};
+    if (accumulate) {
+        inputs.push_back("_out");
+        in_indices.push_back({i});
+    }
+
+    auto& root = builder.subject().root();
+    auto& block = builder.add_block(root);
+    auto& A = builder.add_access(block, "A");
+    auto& m = builder.add_access(block, "m");
+    auto& libnode =
+        builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                 const std::vector<std::string>&,
+                                 std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                 data_flow::Subset, std::vector<data_flow::Subset>,
+                                 const std::vector<std::vector<size_t>>&, einsum::ReductionType,
+                                 const symbolic::Expression&>(
+            block, DebugInfo(), {"_out"}, inputs,
+            {{i, symbolic::symbol("I")}, {j, symbolic::symbol("J")}}, {i}, in_indices, {},
+            reduction, epilogue);
+    builder.add_memlet(block, A, "void", libnode, "_in", {});
+    if (accumulate) {
+        auto& m_in = builder.add_access(block, "m");
+        builder.add_memlet(block, m_in, "void", libnode, "_out", {});
+    }
+    builder.add_memlet(block, libnode, "_out", m, "void", {});
+
+    return std::make_pair(builder.move(), dynamic_cast<einsum::EinsumNode*>(&libnode));
+}
+
+// y[i] = y[i] + A[i,j] * x[j] followed by z[k] = z[k] + B[k,l] * x[l] in the next block, or both
+// in a single einsum node with two outputs
+inline std::pair<std::unique_ptr<StructuredSDFG>, einsum::EinsumNode*> matrix_vector_mult_pair(
+    bool fused) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+    builder.add_container("j", sym_desc);
+    builder.add_container("J", sym_desc, true);
+    builder.add_container("k", sym_desc);
+    builder.add_container("l", sym_desc);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("B", desc2, true);
+    builder.add_container("x", desc, true);
+    builder.add_container("y", desc, true);
+    builder.add_container("z", desc, true);
+
+    auto i = symbolic::symbol("i");
+    auto j = symbolic::symbol("j");
+    auto k = symbolic::symbol("k");
+    auto l = symbolic::symbol("l");
+
+    auto& root = builder.subject().root();
+    einsum::EinsumNode* first = nullptr;
+    if (fused) {
+        auto& block = builder.add_block(root);
+        auto& A = builder.add_access(block, "A");
+        auto& B = builder.add_access(block, "B");
+        auto& x = builder.add_access(block, "x");
+        auto& y1 = builder.add_access(block, "y");
+        auto& y2 = builder.add_access(block, "y");
+        auto& z1 = builder.add_access(block, "z");
+        auto& z2 = builder.add_access(block, "z");
+        auto& libnode = builder.add_library_node<
+            einsum::EinsumNode, const std::vector<std::string>&, const std::vector<std::string>&,
+            std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>, data_flow::Subset,
+            std::vector<data_flow::Subset>, const std::vector<std::vector<size_t>>&,
+            einsum::ReductionType, const symbolic::Expression&, const std::vector<size_t>&>(
+            block, DebugInfo(), {"_out", "_out_1"},
+            {"_in1", "_in2", "_out", "_in3", "_in4", "_out_1"},
+            {{i, symbolic::symbol("I")}, {j, symbolic::symbol("J")}}, {i},
+            {{i, j}, {j}, {i}, {i, j}, {j}, {i}}, {{0, 1}, {3, 4}}, einsum::ReductionType_Sum,
+            symbolic::Expression(), {0, 1});
+        builder.add_memlet(block, A, "void", libnode, "_in1", {});
+        builder.add_memlet(block, x, "void", libnode, "_in2", {});
+        builder.add_memlet(block, y1, "void", libnode, "_out", {});
+        builder.add_memlet(block, B, "void", libnode, "_in3", {});
+        builder.add_memlet(block, x, "void", libnode, "_in4", {});
+        builder.add_memlet(block, z1, "void", libnode, "_out_1", {});
+        builder.add_memlet(block, libnode, "_out", y2, "void", {});
+        builder.add_memlet(block, libnode, "_out_1", z2, "void", {});
+        first = dynamic_cast<einsum::EinsumNode*>(&libnode);
+    } else {
+        std::vector<std::tuple<std::string, std::string, symbolic::Symbol, symbolic::Symbol>>
+            products = {{"A", "y", i, j}, {"B", "z", k, l}};
+        for (auto& [matrix, vector, row, col] : products) {
+            auto& block = builder.add_block(root);
+            auto& M = builder.add_access(block, matrix);
+            auto& x = builder.add_access(block, "x");
+            auto& v1 = builder.add_access(block, vector);
+            auto& v2 = builder.add_access(block, vector);
+            auto& libnode = builder.add_library_node<
+                einsum::EinsumNode, const std::vector<std::string>&,
+                const std::vector<std::string>&,
+                std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>, data_flow::Subset,
+                std::vector<data_flow::Subset>>(
+                block, DebugInfo(), {"_out"}, {"_in1", "_in2", "_out"},
+                {{row, symbolic::symbol("I")}, {col, symbolic::symbol("J")}}, {row},
+                {{row, col}, {col}, {row}});
+            builder.add_memlet(block, M, "void", libnode, "_in1", {});
+            builder.add_memlet(block, x, "void", libnode, "_in2", {});
+            builder.add_memlet(block, v1, "void", libnode, "_out", {});
+            builder.add_memlet(block, libnode, "_out", v2, "void", {});
+            if (!first) first = dynamic_cast<einsum::EinsumNode*>(&libnode);
+        }
+    }
+
+    return std::make_pair(builder.move(), first);
+}
+
+// y[i] = y[i] + A[i,j] * x[j] followed by z[l] = z[l] + A[k,l] * w[k] in the next block, or both
+// in a single einsum node with two outputs and different out indices
+inline std::pair<std::unique_ptr<StructuredSDFG>, einsum::EinsumNode*>
+matrix_vector_mult_transposed_pair(bool fused) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+    builder.add_container("j", sym_desc);
+    builder.add_container("J", sym_desc, true);
+    builder.add_container("k", sym_desc);
+    builder.add_container("l", sym_desc);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("w", desc, true);
+    builder.add_container("x", desc, true);
+    builder.add_container("y", desc, true);
+    builder.add_container("z", desc, true);
+
+    auto i = symbolic::symbol("i");
+    auto j = symbolic::symbol("j");
+    auto k = symbolic::symbol("k");
+    auto l = symbolic::symbol("l");
+
+    auto& root = builder.subject().root();
+    einsum::EinsumNode* first = nullptr;
+    if (fused) {
+        auto& block = builder.add_block(root);
+        auto& A = builder.add_access(block, "A");
+        auto& w = builder.add_access(block, "w");
+        auto& x = builder.add_access(block, "x");
+        auto& y1 = builder.add_access(block, "y");
+        auto& y2 = builder.add_access(block, "y");
+        auto& z1 = builder.add_access(block, "z");
+        auto& z2 = builder.add_access(block, "z");
+        auto& libnode = builder.add_library_node<
+            einsum::EinsumNode, const std::vector<std::string>&, const std::vector<std::string>&,
+            std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+            std::vector<data_flow::Subset>, std::vector<data_flow::Subset>,
+            const std::vector<std::vector<size_t>>&, einsum::ReductionType,
+            const symbolic::Expression&, const std::vector<size_t>&>(
+            block, DebugInfo(), {"_out", "_out_1"},
+            {"_in1", "_in2", "_out", "_in3", "_in4", "_out_1"},
+            {{i, symbolic::symbol("I")}, {j, symbolic::symbol("J")}}, {{i}, {j}},
+            {{i, j}, {j}, {i}, {i, j}, {i}, {j}}, {{0, 1}, {3, 4}}, einsum::ReductionType_Sum,
+            symbolic::Expression(), {0, 1});
+        builder.add_memlet(block, A, "void", libnode, "_in1", {});
+        builder.add_memlet(block, x, "void", libnode, "_in2", {});
+        builder.add_memlet(block, y1, "void", libnode, "_out", {});
+        builder.add_memlet(block, A, "void", libnode, "_in3", {});
+        builder.add_memlet(block, w, "void", libnode, "_in4", {});
+        builder.add_memlet(block, z1, "void", libnode, "_out_1", {});
+        builder.add_memlet(block, libnode, "_out", y2, "void", {});
+        builder.add_memlet(block, libnode, "_out_1", z2, "void", {});
+        first = dynamic_cast<einsum::EinsumNode*>(&libnode);
+    } else {
+        std::vector<std::tuple<std::string, std::string, symbolic::Symbol, symbolic::Symbol, bool>>
+            products = {{"x", "y", i, j, false}, {"w", "z", k, l, true}};
+        for (auto& [vector_in, vector_out, row, col, transposed] : products) {
+            auto& block = builder.add_block(root);
+            auto& A = builder.add_access(block, "A");
+            auto& v = builder.add_access(block, vector_in);
+            auto& v1 = builder.add_access(block, vector_out);
+            auto& v2 = builder.add_access(block, vector_out);
+            auto& out = transposed ? col : row;
+            auto& in = transposed ? row : col;
+            auto& libnode = builder.add_library_node<
+                einsum::EinsumNode, const std::vector<std::string>&,
+                const std::vector<std::string>&,
+                std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>, data_flow::Subset,
+                std::vector<data_flow::Subset>>(
+                block, DebugInfo(), {"_out"}, {"_in1", "_in2", "_out"},
+                {{row, symbolic::symbol("I")}, {col, symbolic::symbol("J")}}, {out},
+                {{row, col}, {in}, {out}});
+            builder.add_memlet(block, A, "void", libnode, "_in1", {});
+            builder.add_memlet(block, v, "void", libnode, "_in2", {});
+            builder.add_memlet(block, v1, "void", libnode, "_out", {});
+            builder.add_memlet(block, libnode, "_out", v2, "void", {});
+            if (!first) first = dynamic_cast<einsum::EinsumNode*>(&libnode);
+        }
+    }
+
+    return std::make_pair(builder.move(), first);
+}
+
 // scaling
@@ -0,0 +1,210 @@
+#include "sdfg/transformations/blas_residency.h"
+
+#include <gtest/gtest.h>
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/codegen/language_extensions/c_language_extension.h>
+#include <sdfg/codegen/utils.h>
+#include <sdfg/element.h>
+#include <sdfg/function.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/types/pointer.h>
+#include <sdfg/types/scalar.h>
+#include <sdfg/types/type.h>
+
+#include <string>
+
+#include "sdfg/blas/blas_dispatcher_gemm.h"
+#include "sdfg/blas/blas_dispatcher_gemv.h"
+#include "sdfg/blas/blas_node.h"
+#include "sdfg/blas/blas_node_gemm.h"
+#include "sdfg/blas/blas_node_gemv.h"
+
+using namespace sdfg;
+
+inline blas::BLASNodeGemm& add_gemm(builder::StructuredSDFGBuilder& builder, const std::string& A,
+                                    const std::string& B, const std::string& C,
+                                    bool overwrite = false) {
+    auto& block = builder.add_block(builder.subject().root());
+    auto& A_access = builder.add_access(block, A);
+    auto& B_access = builder.add_access(block, B);
+    auto& C2 = builder.add_access(block, C);
+    auto& libnode =
+        builder.add_library_node<blas::BLASNodeGemm, const blas::BLASType, blas::BLASTranspose,
+                                 blas::BLASTranspose, symbolic::Expression, symbolic::Expression,
+                                 symbolic::Expression, std::string, std::string, std::string,
+                                 std::string, symbolic::Expression, symbolic::Expression,
+                                 symbolic::Expression, std::string>(
+            block, DebugInfo(), blas::BLASType_real, blas::BLASTranspose_No,
+            blas::BLASTranspose_No, symbolic::symbol("m"), symbolic::symbol("n"),
+            symbolic::symbol("k"), "1.0f", "_A", "_B", "_C", symbolic::Expression(),
+            symbolic::Expression(), symbolic::Expression(), overwrite ? "0.0f" : "1.0f");
+    builder.add_memlet(block, A_access, "void", libnode, "_A", {});
+    builder.add_memlet(block, B_access, "void", libnode, "_B", {});
+    if (!overwrite) {
+        auto& C1 = builder.add_access(block, C);
+        builder.add_memlet(block, C1, "void", libnode, "_C", {});
+    }
+    builder.add_memlet(block, libnode, "_C", C2, "void", {});
+    return dynamic_cast<blas::BLASNodeGemm&>(libnode);
+}
+
+inline void add_containers(builder::StructuredSDFGBuilder& builder) {
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("m", sym_desc, true);
+    builder.add_container("n", sym_desc, true);
+    builder.add_container("k", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    for (auto name : {"A", "B", "B2", "C"}) builder.add_container(name, desc2, true);
+    builder.add_container("x", desc, true);
+    builder.add_container("y", desc, true);
+}
+
+inline size_t count(const std::string& str, const std::string& pattern) {
+    size_t result = 0;
+    for (size_t pos = str.find(pattern); pos != std::string::npos;
+         pos = str.find(pattern, pos + 1))
+        ++result;
+    return result;
+}
+
+TEST(BLASResidency, gemm_gemm) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+    add_containers(builder);
+    auto& gemm1 = add_gemm(builder, "A", "B", "C");
+    auto& gemm2 = add_gemm(builder, "A", "B2", "C");
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::BLASResidency transformation(builder_opt.subject().root());
+    EXPECT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    EXPECT_FALSE(gemm1.resident_input("_A"));
+    EXPECT_FALSE(gemm1.resident_input("_B"));
+    EXPECT_FALSE(gemm1.resident_input("_C"));
+    EXPECT_TRUE(gemm1.resident_output("_C"));
+    EXPECT_TRUE(gemm2.resident_input("_A"));
+    EXPECT_FALSE(gemm2.resident_input("_B"));
+    EXPECT_TRUE(gemm2.resident_input("_C"));
+    EXPECT_FALSE(gemm2.resident_output("_C"));
+
+    codegen::CLanguageExtension language_extension;
+    blas::BLASDispatcherGemm dispatcher1(language_extension, builder_opt.subject(),
+                                         gemm1.get_parent(), gemm1,
+                                         blas::BLASImplementation_CUBLAS);
+    codegen::PrettyPrinter stream1;
+    dispatcher1.dispatch(stream1);
+    EXPECT_EQ(count(stream1.str(), "cublasSetMatrix"), 3);
+    EXPECT_EQ(count(stream1.str(), "cublasGetMatrix"), 0);
+    EXPECT_EQ(count(stream1.str(), "cudaDeviceSynchronize"), 0);
+
+    blas::BLASDispatcherGemm dispatcher2(language_extension, builder_opt.subject(),
+                                         gemm2.get_parent(), gemm2,
+                                         blas::BLASImplementation_CUBLAS);
+    codegen::PrettyPrinter stream2;
+    dispatcher2.dispatch(stream2);
+    EXPECT_EQ(count(stream2.str(), "cublasSetMatrix"), 1);
+    EXPECT_NE(stream2.str().find("cublasSetMatrix(k, n, sizeof(float ), _B, k, d_B, k)"),
+              std::string::npos);
+    EXPECT_EQ(count(stream2.str(), "cublasGetMatrix"), 1);
+}
+
+TEST(BLASResidency, gemm_gemv) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+    add_containers(builder);
+    auto& gemm = add_gemm(builder, "A", "B", "C");
+
+    auto& block = builder.add_block(builder.subject().root());
+    auto& C = builder.add_access(block, "C");
+    auto& x = builder.add_access(block, "x");
+    auto& y1 = builder.add_access(block, "y");
+    auto& y2 = builder.add_access(block, "y");
+    auto& libnode =
+        builder.add_library_node<blas::BLASNodeGemv, const blas::BLASType, blas::BLASTranspose,
+                                 symbolic::Expression, symbolic::Expression, std::string,
+                                 std::string, std::string, std::string>(
+            block, DebugInfo(), blas::BLASType_real, blas::BLASTranspose_No,
+            symbolic::symbol("m"), symbolic::symbol("n"), "1.0f", "_A", "_x", "_y");
+    builder.add_memlet(block, C, "void", libnode, "_A", {});
+    builder.add_memlet(block, x, "void", libnode, "_x", {});
+    builder.add_memlet(block, y1, "void", libnode, "_y", {});
+    builder.add_memlet(block, libnode, "_y", y2, "void", {});
+    auto& gemv = dynamic_cast<blas::BLASNodeGemv&>(libnode);
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::BLASResidency transformation(builder_opt.subject().root());
+    EXPECT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    // C is read on the host after the run, so the gemm still downloads it
+    EXPECT_FALSE(gemm.resident_output("_C"));
+    EXPECT_TRUE(gemv.resident_input("_A"));
+    EXPECT_FALSE(gemv.resident_input("_x"));
+    EXPECT_FALSE(gemv.resident_input("_y"));
+    EXPECT_FALSE(gemv.resident_output("_y"));
+
+    codegen::CLanguageExtension language_extension;
+    blas::BLASDispatcherGemv dispatcher(language_extension, builder_opt.subject(),
+                                        gemv.get_parent(), gemv, blas::BLASImplementation_CUBLAS);
+    codegen::PrettyPrinter stream;
+    dispatcher.dispatch(stream);
+    EXPECT_EQ(count(stream.str(), "cublasSetMatrix"), 0);
+    EXPECT_EQ(count(stream.str(), "cublasSetVector"), 2);
+    EXPECT_EQ(count(stream.str(), "cublasGetVector"), 1);
+}
+
+TEST(BLASResidency, gemm_gemm_overwrite) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+    add_containers(builder);
+    auto& gemm1 = add_gemm(builder, "A", "B", "C");
+    auto& gemm2 = add_gemm(builder, "A", "B2", "C", true);
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::BLASResidency transformation(builder_opt.subject().root());
+    EXPECT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    // The second gemm does not read C, since beta is zero
+    EXPECT_TRUE(gemm1.resident_output("_C"));
+    EXPECT_TRUE(gemm2.resident_input("_A"));
+    EXPECT_FALSE(gemm2.resident_input("_C"));
+    EXPECT_FALSE(gemm2.resident_output("_C"));
+
+    codegen::CLanguageExtension language_extension;
+    blas::BLASDispatcherGemm dispatcher2(language_extension, builder_opt.subject(),
+                                         gemm2.get_parent(), gemm2,
+                                         blas::BLASImplementation_CUBLAS);
+    codegen::PrettyPrinter stream2;
+    dispatcher2.dispatch(stream2);
+    EXPECT_EQ(count(stream2.str(), "cublasSetMatrix"), 1);
+    EXPECT_EQ(count(stream2.str(), "cublasGetMatrix"), 1);
+}
+
+TEST(BLASResidency, single_node) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+    add_containers(builder);
+    add_gemm(builder, "A", "B", "C");
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::BLASResidency transformation(builder_opt.subject().root());
+    EXPECT_FALSE(transformation.can_be_applied(builder_opt, analysis_manager));
+}
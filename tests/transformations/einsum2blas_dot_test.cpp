@@ -154,4 +154,119 @@ TEST(Einsum2BLASDot, ddot) {
     EXPECT_EQ(blas_node->x(), "_in0");
     EXPECT_EQ(blas_node->y(), "_in1");
     EXPECT_TRUE(symbolic::eq(blas_node->n(), bound_i));
-}
\ No newline at end of file
+}
+TEST(Einsum2BLASDot, sdot_strided) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+    builder.add_container("N", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    builder.add_container("x", desc, true);
+    builder.add_container("y", desc, true);
+    builder.add_container("z", desc, true);
+
+    auto indvar_i = symbolic::symbol("i");
+    auto bound_i = symbolic::symbol("I");
+    auto stride_y = symbolic::symbol("N");
+
+    auto& root = builder.subject().root();
+
+    // z = sum_i x[2 * i] * y[i * N], e.g., a column of a row-major matrix
+    auto& block = builder.add_block(root);
+    auto& x = builder.add_access(block, "x");
+    auto& y = builder.add_access(block, "y");
+    auto& z1 = builder.add_access(block, "z");
+    auto& z2 = builder.add_access(block, "z");
+    auto& libnode =
+        builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                 const std::vector<std::string>&,
+                                 std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                 data_flow::Subset, std::vector<data_flow::Subset>>(
+            block, DebugInfo(), {"_out"}, {"_in0", "_in1", "_out"}, {{indvar_i, bound_i}}, {},
+            {{symbolic::mul(symbolic::integer(2), indvar_i)},
+             {symbolic::mul(indvar_i, stride_y)},
+             {}});
+    builder.add_memlet(block, x, "void", libnode, "_in0", {});
+    builder.add_memlet(block, y, "void", libnode, "_in1", {});
+    builder.add_memlet(block, z1, "void", libnode, "_out", {symbolic::zero()});
+    builder.add_memlet(block, libnode, "_out", z2, "void", {symbolic::zero()});
+
+    auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(&libnode);
+    ASSERT_TRUE(einsum_node);
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::Einsum2BLASDot transformation(*einsum_node);
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    auto& root_opt = builder_opt.subject().root();
+    AT_LEAST(root_opt.size(), 1);
+    auto* block_opt = dynamic_cast<structured_control_flow::Block*>(&root_opt.at(0).first);
+    ASSERT_TRUE(block_opt);
+    data_flow::LibraryNode* libnode_opt = nullptr;
+    for (auto& node : block_opt->dataflow().nodes()) {
+        if ((libnode_opt = dynamic_cast<data_flow::LibraryNode*>(&node))) break;
+    }
+    ASSERT_TRUE(libnode_opt);
+    auto* blas_node = dynamic_cast<blas::BLASNodeDot*>(libnode_opt);
+    ASSERT_TRUE(blas_node);
+    EXPECT_TRUE(symbolic::eq(blas_node->n(), bound_i));
+    EXPECT_TRUE(symbolic::eq(blas_node->incx(), symbolic::integer(2)));
+    EXPECT_TRUE(symbolic::eq(blas_node->incy(), stride_y));
+}
+
+TEST(Einsum2BLASDot, offset_not_applicable) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    builder.add_container("x", desc, true);
+    builder.add_container("y", desc, true);
+    builder.add_container("z", desc, true);
+
+    auto indvar_i = symbolic::symbol("i");
+    auto bound_i = symbolic::symbol("I");
+
+    auto& root = builder.subject().root();
+
+    // z = sum_i x[i + 1] * y[i] cannot be expressed without a pointer offset
+    auto& block = builder.add_block(root);
+    auto& x = builder.add_access(block, "x");
+    auto& y = builder.add_access(block, "y");
+    auto& z1 = builder.add_access(block, "z");
+    auto& z2 = builder.add_access(block, "z");
+    auto& libnode =
+        builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                 const std::vector<std::string>&,
+                                 std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                 data_flow::Subset, std::vector<data_flow::Subset>>(
+            block, DebugInfo(), {"_out"}, {"_in0", "_in1", "_out"}, {{indvar_i, bound_i}}, {},
+            {{symbolic::add(indvar_i, symbolic::one())}, {indvar_i}, {}});
+    builder.add_memlet(block, x, "void", libnode, "_in0", {});
+    builder.add_memlet(block, y, "void", libnode, "_in1", {});
+    builder.add_memlet(block, z1, "void", libnode, "_out", {symbolic::zero()});
+    builder.add_memlet(block, libnode, "_out", z2, "void", {symbolic::zero()});
+
+    auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(&libnode);
+    ASSERT_TRUE(einsum_node);
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::Einsum2BLASDot transformation(*einsum_node);
+    EXPECT_FALSE(transformation.can_be_applied(builder_opt, analysis_manager));
+}
@@ -0,0 +1,237 @@
+#include "sdfg/transformations/einsum2blas.h"
+
+#include <gtest/gtest.h>
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/data_flow/memlet.h>
+#include <sdfg/element.h>
+#include <sdfg/function.h>
+#include <sdfg/structured_control_flow/block.h>
+#include <sdfg/structured_control_flow/if_else.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/types/pointer.h>
+#include <sdfg/types/scalar.h>
+#include <sdfg/types/type.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "helper.h"
+#include "sdfg/blas/blas_node.h"
+#include "sdfg/blas/blas_node_gemm.h"
+#include "sdfg/blas/blas_node_symv.h"
+#include "sdfg/einsum/einsum_node.h"
+
+using namespace sdfg;
+
+inline std::pair<std::unique_ptr<StructuredSDFG>, einsum::EinsumNode*> gemm_sdfg() {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+    builder.add_container("j", sym_desc);
+    builder.add_container("J", sym_desc, true);
+    builder.add_container("k", sym_desc);
+    builder.add_container("K", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("B", desc2, true);
+    builder.add_container("C", desc2, true);
+
+    auto indvar_i = symbolic::symbol("i");
+    auto bound_i = symbolic::symbol("I");
+    auto indvar_j = symbolic::symbol("j");
+    auto bound_j = symbolic::symbol("J");
+    auto indvar_k = symbolic::symbol("k");
+    auto bound_k = symbolic::symbol("K");
+
+    auto& root = builder.subject().root();
+    auto& block = builder.add_block(root);
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& C1 = builder.add_access(block, "C");
+    auto& C2 = builder.add_access(block, "C");
+    auto& libnode =
+        builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                 const std::vector<std::string>&,
+                                 std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                 data_flow::Subset, std::vector<data_flow::Subset>>(
+            block, DebugInfo(), {"_out"}, {"_in0", "_in1", "_out"},
+            {{indvar_i, bound_i}, {indvar_j, bound_j}, {indvar_k, bound_k}}, {indvar_i, indvar_j},
+            {{indvar_i, indvar_k}, {indvar_k, indvar_j}, {indvar_i, indvar_j}});
+    builder.add_memlet(block, A, "void", libnode, "_in0", {});
+    builder.add_memlet(block, B, "void", libnode, "_in1", {});
+    builder.add_memlet(block, C1, "void", libnode, "_out", {});
+    builder.add_memlet(block, libnode, "_out", C2, "void", {});
+
+    auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(&libnode);
+
+    return {builder.move(), einsum_node};
+}
+
+template <typename T>
+inline T* find_node(structured_control_flow::ControlFlowNode& node) {
+    auto* block = dynamic_cast<structured_control_flow::Block*>(&node);
+    if (!block) return nullptr;
+    for (auto& dfg_node : block->dataflow().nodes()) {
+        if (auto* result = dynamic_cast<T*>(&dfg_node)) return result;
+    }
+    return nullptr;
+}
+
+TEST(Einsum2BLAS, sgemmNN) {
+    auto sdfg_and_node = gemm_sdfg();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg_and_node.first);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::Einsum2BLAS transformation(*sdfg_and_node.second);
+    EXPECT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    auto& root_opt = builder_opt.subject().root();
+    ASSERT_EQ(root_opt.size(), 1);
+    EXPECT_TRUE(find_node<blas::BLASNodeGemm>(root_opt.at(0).first));
+    EXPECT_FALSE(find_node<einsum::EinsumNode>(root_opt.at(0).first));
+}
+
+TEST(Einsum2BLAS, sgemmNN_threshold) {
+    auto sdfg_and_node = gemm_sdfg();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg_and_node.first);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::Einsum2BLAS transformation(*sdfg_and_node.second, 16);
+    EXPECT_EQ(transformation.threshold(), 16);
+    EXPECT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    auto& root_opt = builder_opt.subject().root();
+    ASSERT_EQ(root_opt.size(), 1);
+    auto* if_else = dynamic_cast<structured_control_flow::IfElse*>(&root_opt.at(0).first);
+    ASSERT_TRUE(if_else);
+    ASSERT_EQ(if_else->size(), 2);
+
+    // Small sizes keep the einsum node for the loop nest
+    auto& case_loops = if_else->at(0).first;
+    ASSERT_EQ(case_loops.size(), 1);
+    auto* einsum_node = find_node<einsum::EinsumNode>(case_loops.at(0).first);
+    ASSERT_TRUE(einsum_node);
+    EXPECT_FALSE(find_node<blas::BLASNodeGemm>(case_loops.at(0).first));
+
+    // Otherwise the gemm is called
+    auto& case_blas = if_else->at(1).first;
+    ASSERT_EQ(case_blas.size(), 1);
+    auto* blas_node = find_node<blas::BLASNodeGemm>(case_blas.at(0).first);
+    ASSERT_TRUE(blas_node);
+    EXPECT_FALSE(find_node<einsum::EinsumNode>(case_blas.at(0).first));
+    EXPECT_TRUE(symbolic::eq(blas_node->m(), symbolic::symbol("I")));
+    EXPECT_TRUE(symbolic::eq(blas_node->n(), symbolic::symbol("J")));
+    EXPECT_TRUE(symbolic::eq(blas_node->k(), symbolic::symbol("K")));
+}
+
+TEST(Einsum2BLAS, sgemmNN_threshold_two_einsums) {
+    auto sdfg_and_node = gemm_sdfg();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg_and_node.first);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    // d[i] = d[i] + e[i] in the block of the gemm
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    builder_opt.add_container("d", desc, true);
+    builder_opt.add_container("e", desc, true);
+    auto indvar_i = symbolic::symbol("i");
+    auto& block = dynamic_cast<structured_control_flow::Block&>(
+        *sdfg_and_node.second->get_parent().get_parent());
+    auto& e = builder_opt.add_access(block, "e");
+    auto& d1 = builder_opt.add_access(block, "d");
+    auto& d2 = builder_opt.add_access(block, "d");
+    auto& libnode =
+        builder_opt.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                     const std::vector<std::string>&,
+                                     std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                     data_flow::Subset, std::vector<data_flow::Subset>>(
+            block, DebugInfo(), {"_out"}, {"_in0", "_out"}, {{indvar_i, symbolic::symbol("I")}},
+            {indvar_i}, {{indvar_i}, {indvar_i}});
+    builder_opt.add_memlet(block, e, "void", libnode, "_in0", {});
+    builder_opt.add_memlet(block, d1, "void", libnode, "_out", {});
+    builder_opt.add_memlet(block, libnode, "_out", d2, "void", {});
+
+    // The copy of the gemm could not be told apart from the other einsum node
+    transformations::Einsum2BLAS transformation(*sdfg_and_node.second, 16);
+    EXPECT_FALSE(transformation.can_be_applied(builder_opt, analysis_manager));
+
+    transformations::Einsum2BLAS transformation_blas(*sdfg_and_node.second);
+    EXPECT_TRUE(transformation_blas.can_be_applied(builder_opt, analysis_manager));
+}
+
+TEST(Einsum2BLAS, ssymvL_threshold) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+    builder.add_container("j", sym_desc);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("x", desc, true);
+    builder.add_container("y", desc, true);
+
+    // The bound of j depends on i
+    auto indvar_i = symbolic::symbol("i");
+    auto bound_i = symbolic::symbol("I");
+    auto indvar_j = symbolic::symbol("j");
+    auto bound_j = symbolic::add(indvar_i, symbolic::one());
+
+    auto& root = builder.subject().root();
+    auto& block = builder.add_block(root);
+    auto& A = builder.add_access(block, "A");
+    auto& x = builder.add_access(block, "x");
+    auto& y1 = builder.add_access(block, "y");
+    auto& y2 = builder.add_access(block, "y");
+    auto& libnode =
+        builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                 const std::vector<std::string>&,
+                                 std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                 data_flow::Subset, std::vector<data_flow::Subset>>(
+            block, DebugInfo(), {"_out"}, {"_in0", "_in1", "_out"},
+            {{indvar_i, bound_i}, {indvar_j, bound_j}}, {indvar_i},
+            {{indvar_i, indvar_j}, {indvar_j}, {indvar_i}});
+    builder.add_memlet(block, A, "void", libnode, "_in0", {});
+    builder.add_memlet(block, x, "void", libnode, "_in1", {});
+    builder.add_memlet(block, y1, "void", libnode, "_out", {});
+    builder.add_memlet(block, libnode, "_out", y2, "void", {});
+
+    auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(&libnode);
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::Einsum2BLAS transformation(*einsum_node, 16);
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    auto& root_opt = builder_opt.subject().root();
+    ASSERT_EQ(root_opt.size(), 1);
+    auto* if_else = dynamic_cast<structured_control_flow::IfElse*>(&root_opt.at(0).first);
+    ASSERT_TRUE(if_else);
+    ASSERT_EQ(if_else->size(), 2);
+
+    // The guard is evaluated outside of the loop nest and must not read the indvars
+    auto& small = if_else->at(0).second;
+    EXPECT_TRUE(symbolic::uses(small, bound_i));
+    EXPECT_FALSE(symbolic::uses(small, indvar_i));
+    EXPECT_FALSE(symbolic::uses(small, indvar_j));
+    EXPECT_TRUE(find_node<blas::BLASNodeSymv>(if_else->at(1).first.at(0).first));
+}
@@ -0,0 +1,186 @@
+#include "sdfg/transformations/einsum2blas_ttgt.h"
+
+#include <gtest/gtest.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/data_flow/memlet.h>
+#include <sdfg/element.h>
+#include <sdfg/function.h>
+#include <sdfg/structured_sdfg.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/types/pointer.h>
+#include <sdfg/types/scalar.h>
+#include <sdfg/types/type.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "helper.h"
+#include "sdfg/blas/blas_node.h"
+#include "sdfg/blas/blas_node_gemm.h"
+#include "sdfg/einsum/einsum_node.h"
+
+using namespace sdfg;
+
+inline std::pair<std::unique_ptr<StructuredSDFG>, einsum::EinsumNode*> ttgt_sdfg(
+    const data_flow::Subset& A_indices, const data_flow::Subset& B_indices) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    for (auto name : {"a", "b", "c", "k", "l"}) builder.add_container(name, sym_desc);
+    for (auto name : {"A_", "B_", "C_", "K", "L"}) builder.add_container(name, sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    types::Pointer desc3(*desc2.clone());
+    types::Pointer desc4(*desc3.clone());
+    builder.add_container("A", desc3, true);
+    builder.add_container("B", desc4, true);
+    builder.add_container("C", desc3, true);
+
+    auto& root = builder.subject().root();
+    auto& block = builder.add_block(root);
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& C1 = builder.add_access(block, "C");
+    auto& C2 = builder.add_access(block, "C");
+    auto& libnode =
+        builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                 const std::vector<std::string>&,
+                                 std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                 data_flow::Subset, std::vector<data_flow::Subset>>(
+            block, DebugInfo(), {"_out"}, {"_in0", "_in1", "_out"},
+            {{symbolic::symbol("a"), symbolic::symbol("A_")},
+             {symbolic::symbol("b"), symbolic::symbol("B_")},
+             {symbolic::symbol("c"), symbolic::symbol("C_")},
+             {symbolic::symbol("k"), symbolic::symbol("K")},
+             {symbolic::symbol("l"), symbolic::symbol("L")}},
+            {symbolic::symbol("a"), symbolic::symbol("b"), symbolic::symbol("c")},
+            {A_indices, B_indices,
+             {symbolic::symbol("a"), symbolic::symbol("b"), symbolic::symbol("c")}});
+    builder.add_memlet(block, A, "void", libnode, "_in0", {});
+    builder.add_memlet(block, B, "void", libnode, "_in1", {});
+    builder.add_memlet(block, C1, "void", libnode, "_out", {});
+    builder.add_memlet(block, libnode, "_out", C2, "void", {});
+
+    auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(&libnode);
+
+    return {builder.move(), einsum_node};
+}
+
+TEST(Einsum2BLASTTGT, sgemmNN) {
+    auto a = symbolic::symbol("a");
+    auto b = symbolic::symbol("b");
+    auto c = symbolic::symbol("c");
+    auto k = symbolic::symbol("k");
+    auto l = symbolic::symbol("l");
+
+    auto sdfg_and_node = ttgt_sdfg({a, k, l}, {k, l, b, c});
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* einsum_node = sdfg_and_node.second;
+    ASSERT_TRUE(einsum_node);
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::Einsum2BLASTTGT transformation(*einsum_node);
+    EXPECT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    auto& root_opt = builder_opt.subject().root();
+    AT_LEAST(root_opt.size(), 1);
+    auto* block_opt = dynamic_cast<structured_control_flow::Block*>(&root_opt.at(0).first);
+    ASSERT_TRUE(block_opt);
+    data_flow::LibraryNode* libnode_opt = nullptr;
+    for (auto& node : block_opt->dataflow().nodes()) {
+        if ((libnode_opt = dynamic_cast<data_flow::LibraryNode*>(&node))) break;
+    }
+    ASSERT_TRUE(libnode_opt);
+    auto* blas_node = dynamic_cast<blas::BLASNodeGemm*>(libnode_opt);
+    ASSERT_TRUE(blas_node);
+    EXPECT_EQ(blas_node->transA(), blas::BLASTranspose_No);
+    EXPECT_EQ(blas_node->transB(), blas::BLASTranspose_No);
+    EXPECT_EQ(blas_node->A(), "_in0");
+    EXPECT_EQ(blas_node->B(), "_in1");
+    EXPECT_EQ(blas_node->C(), "_out");
+    EXPECT_EQ(blas_node->beta(), "1.0f");
+    EXPECT_TRUE(symbolic::eq(blas_node->m(), symbolic::symbol("A_")));
+    EXPECT_TRUE(symbolic::eq(blas_node->n(),
+                             symbolic::mul(symbolic::symbol("B_"), symbolic::symbol("C_"))));
+    EXPECT_TRUE(symbolic::eq(blas_node->k(),
+                             symbolic::mul(symbolic::symbol("K"), symbolic::symbol("L"))));
+}
+
+TEST(Einsum2BLASTTGT, sgemmTT) {
+    auto a = symbolic::symbol("a");
+    auto b = symbolic::symbol("b");
+    auto c = symbolic::symbol("c");
+    auto k = symbolic::symbol("k");
+    auto l = symbolic::symbol("l");
+
+    auto sdfg_and_node = ttgt_sdfg({k, l, a}, {b, c, k, l});
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* einsum_node = sdfg_and_node.second;
+    ASSERT_TRUE(einsum_node);
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::Einsum2BLASTTGT transformation(*einsum_node);
+    EXPECT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    auto& root_opt = builder_opt.subject().root();
+    AT_LEAST(root_opt.size(), 1);
+    auto* block_opt = dynamic_cast<structured_control_flow::Block*>(&root_opt.at(0).first);
+    ASSERT_TRUE(block_opt);
+    data_flow::LibraryNode* libnode_opt = nullptr;
+    for (auto& node : block_opt->dataflow().nodes()) {
+        if ((libnode_opt = dynamic_cast<data_flow::LibraryNode*>(&node))) break;
+    }
+    ASSERT_TRUE(libnode_opt);
+    auto* blas_node = dynamic_cast<blas::BLASNodeGemm*>(libnode_opt);
+    ASSERT_TRUE(blas_node);
+    EXPECT_EQ(blas_node->transA(), blas::BLASTranspose_Transpose);
+    EXPECT_EQ(blas_node->transB(), blas::BLASTranspose_Transpose);
+}
+
+TEST(Einsum2BLASTTGT, non_contiguous) {
+    auto a = symbolic::symbol("a");
+    auto b = symbolic::symbol("b");
+    auto c = symbolic::symbol("c");
+    auto k = symbolic::symbol("k");
+    auto l = symbolic::symbol("l");
+
+    auto sdfg_and_node = ttgt_sdfg({k, a, l}, {k, l, b, c});
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* einsum_node = sdfg_and_node.second;
+    ASSERT_TRUE(einsum_node);
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::Einsum2BLASTTGT transformation(*einsum_node);
+    EXPECT_FALSE(transformation.can_be_applied(builder_opt, analysis_manager));
+}
+
+TEST(Einsum2BLASTTGT, contracted_order_differs) {
+    auto a = symbolic::symbol("a");
+    auto b = symbolic::symbol("b");
+    auto c = symbolic::symbol("c");
+    auto k = symbolic::symbol("k");
+    auto l = symbolic::symbol("l");
+
+    auto sdfg_and_node = ttgt_sdfg({a, k, l}, {l, k, b, c});
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* einsum_node = sdfg_and_node.second;
+    ASSERT_TRUE(einsum_node);
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::Einsum2BLASTTGT transformation(*einsum_node);
+    EXPECT_FALSE(transformation.can_be_applied(builder_opt, analysis_manager));
+}
@@ -0,0 +1,316 @@
+#include "sdfg/transformations/einsum_contract.h"
+
+#include <gtest/gtest.h>
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/data_flow/library_node.h>
+#include <sdfg/data_flow/memlet.h>
+#include <sdfg/element.h>
+#include <sdfg/function.h>
+#include <sdfg/structured_control_flow/block.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/types/pointer.h>
+#include <sdfg/types/scalar.h>
+#include <sdfg/types/type.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "helper.h"
+#include "sdfg/einsum/einsum_node.h"
+
+using namespace sdfg;
+
+inline std::pair<std::unique_ptr<StructuredSDFG>, einsum::EinsumNode*> matrix_chain(
+    size_t I, size_t J, size_t K, size_t L) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("j", sym_desc);
+    builder.add_container("k", sym_desc);
+    builder.add_container("l", sym_desc);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("B", desc2, true);
+    builder.add_container("C", desc2, true);
+    builder.add_container("D", desc2, true);
+
+    auto i = symbolic::symbol("i");
+    auto j = symbolic::symbol("j");
+    auto k = symbolic::symbol("k");
+    auto l = symbolic::symbol("l");
+
+    auto& root = builder.subject().root();
+    auto& block = builder.add_block(root);
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& C = builder.add_access(block, "C");
+    auto& D1 = builder.add_access(block, "D");
+    auto& D2 = builder.add_access(block, "D");
+    auto& libnode =
+        builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                 const std::vector<std::string>&,
+                                 std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                 data_flow::Subset, std::vector<data_flow::Subset>>(
+            block, DebugInfo(), {"_out"}, {"_in1", "_in2", "_in3", "_out"},
+            {{i, symbolic::integer(I)},
+             {j, symbolic::integer(J)},
+             {k, symbolic::integer(K)},
+             {l, symbolic::integer(L)}},
+            {i, l}, {{i, j}, {j, k}, {k, l}, {i, l}});
+    builder.add_memlet(block, A, "void", libnode, "_in1", {});
+    builder.add_memlet(block, B, "void", libnode, "_in2", {});
+    builder.add_memlet(block, C, "void", libnode, "_in3", {});
+    builder.add_memlet(block, D1, "void", libnode, "_out", {});
+    builder.add_memlet(block, libnode, "_out", D2, "void", {});
+
+    return std::make_pair(builder.move(), dynamic_cast<einsum::EinsumNode*>(&libnode));
+}
+
+inline einsum::EinsumNode* get_einsum_node(structured_control_flow::Block& block) {
+    for (auto& node : block.dataflow().nodes()) {
+        if (auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(&node)) return einsum_node;
+    }
+    return nullptr;
+}
+
+TEST(EinsumContract, MatrixChain_1) {
+    auto sdfg_and_node = matrix_chain(10, 1000, 10, 1000);
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* einsum_node = sdfg_and_node.second;
+    ASSERT_TRUE(einsum_node);
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::EinsumContract transformation(*einsum_node);
+    EXPECT_EQ(transformation.path(),
+              (std::vector<std::pair<size_t, size_t>>{{0, 1}, {0, 1}}));
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    auto i = symbolic::symbol("i");
+    auto j = symbolic::symbol("j");
+    auto k = symbolic::symbol("k");
+    auto l = symbolic::symbol("l");
+
+    auto& root_opt = builder_opt.subject().root();
+    AT_LEAST(root_opt.size(), 3);
+
+    // Initialization of the temporary
+    auto* block_init = dynamic_cast<structured_control_flow::Block*>(&root_opt.at(0).first);
+    ASSERT_TRUE(block_init);
+    auto* einsum_init = get_einsum_node(*block_init);
+    ASSERT_TRUE(einsum_init);
+    EXPECT_EQ(einsum_init->inputs(), std::vector<std::string>({"0.0f"}));
+    AT_LEAST(einsum_init->maps().size(), 2);
+    EXPECT_TRUE(symbolic::eq(einsum_init->indvar(0), i));
+    EXPECT_TRUE(symbolic::eq(einsum_init->indvar(1), k));
+    EXPECT_TRUE(subsets_eq(einsum_init->out_indices(), {i, k}));
+
+    // Contraction of A and B
+    auto* block_AB = dynamic_cast<structured_control_flow::Block*>(&root_opt.at(1).first);
+    ASSERT_TRUE(block_AB);
+    auto* einsum_AB = get_einsum_node(*block_AB);
+    ASSERT_TRUE(einsum_AB);
+    EXPECT_EQ(einsum_AB->inputs(), std::vector<std::string>({"_in1", "_in2", "_out"}));
+    AT_LEAST(einsum_AB->maps().size(), 3);
+    EXPECT_TRUE(symbolic::eq(einsum_AB->indvar(0), i));
+    EXPECT_TRUE(symbolic::eq(einsum_AB->indvar(1), j));
+    EXPECT_TRUE(symbolic::eq(einsum_AB->indvar(2), k));
+    EXPECT_TRUE(subsets_eq(einsum_AB->out_indices(), {i, k}));
+    AT_LEAST(einsum_AB->in_indices().size(), 3);
+    EXPECT_TRUE(subsets_eq(einsum_AB->in_indices(0), {i, j}));
+    EXPECT_TRUE(subsets_eq(einsum_AB->in_indices(1), {j, k}));
+    EXPECT_TRUE(subsets_eq(einsum_AB->in_indices(2), {i, k}));
+    auto conn2cont_AB = get_conn2cont(*block_AB, *einsum_AB);
+    EXPECT_EQ(conn2cont_AB.at("_in1"), "A");
+    EXPECT_EQ(conn2cont_AB.at("_in2"), "B");
+    std::string tmp = conn2cont_AB.at("_out");
+    EXPECT_NE(tmp, "D");
+
+    // Contraction of C and the temporary into D
+    auto* block_D = dynamic_cast<structured_control_flow::Block*>(&root_opt.at(2).first);
+    ASSERT_TRUE(block_D);
+    auto* einsum_D = get_einsum_node(*block_D);
+    ASSERT_TRUE(einsum_D);
+    EXPECT_EQ(einsum_D->inputs(), std::vector<std::string>({"_in1", "_in2", "_out"}));
+    AT_LEAST(einsum_D->maps().size(), 3);
+    EXPECT_TRUE(symbolic::eq(einsum_D->indvar(0), i));
+    EXPECT_TRUE(symbolic::eq(einsum_D->indvar(1), k));
+    EXPECT_TRUE(symbolic::eq(einsum_D->indvar(2), l));
+    EXPECT_TRUE(subsets_eq(einsum_D->out_indices(), {i, l}));
+    AT_LEAST(einsum_D->in_indices().size(), 3);
+    EXPECT_TRUE(subsets_eq(einsum_D->in_indices(0), {k, l}));
+    EXPECT_TRUE(subsets_eq(einsum_D->in_indices(1), {i, k}));
+    EXPECT_TRUE(subsets_eq(einsum_D->in_indices(2), {i, l}));
+    auto conn2cont_D = get_conn2cont(*block_D, *einsum_D);
+    EXPECT_EQ(conn2cont_D.at("_in1"), "C");
+    EXPECT_EQ(conn2cont_D.at("_in2"), tmp);
+    EXPECT_EQ(conn2cont_D.at("_out"), "D");
+    EXPECT_EQ(block_D->dataflow().nodes().size(), 5);
+}
+
+TEST(EinsumContract, MatrixChain_2) {
+    auto sdfg_and_node = matrix_chain(1000, 10, 1000, 10);
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* einsum_node = sdfg_and_node.second;
+    ASSERT_TRUE(einsum_node);
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::EinsumContract transformation(*einsum_node);
+    EXPECT_EQ(transformation.path(),
+              (std::vector<std::pair<size_t, size_t>>{{1, 2}, {0, 1}}));
+    EXPECT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+}
+
+TEST(EinsumContract, MatrixChain_greedy) {
+    auto sdfg_and_node = matrix_chain(10, 1000, 10, 1000);
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* einsum_node = sdfg_and_node.second;
+    ASSERT_TRUE(einsum_node);
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::EinsumContract transformation(*einsum_node, true);
+    EXPECT_EQ(transformation.path(),
+              (std::vector<std::pair<size_t, size_t>>{{0, 1}, {0, 1}}));
+    EXPECT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+}
+
+TEST(EinsumContract, MatrixChain_large_temporary) {
+    auto sdfg_and_node = matrix_chain(300, 1000, 300, 1000);
+    auto sdfg = std::move(sdfg_and_node.first);
+    auto* einsum_node = sdfg_and_node.second;
+    ASSERT_TRUE(einsum_node);
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    // The temporary of A and B has 300 x 300 elements, which is too large for the stack
+    transformations::EinsumContract transformation(*einsum_node);
+    EXPECT_EQ(transformation.path(),
+              (std::vector<std::pair<size_t, size_t>>{{0, 1}, {0, 1}}));
+    EXPECT_FALSE(transformation.can_be_applied(builder_opt, analysis_manager));
+}
+
+TEST(EinsumContract, ElementwiseProduct) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    builder.add_container("a", desc, true);
+    builder.add_container("b", desc, true);
+    builder.add_container("c", desc, true);
+    builder.add_container("d", desc, true);
+
+    auto i = symbolic::symbol("i");
+
+    auto& root = builder.subject().root();
+    auto& block = builder.add_block(root);
+    auto& a = builder.add_access(block, "a");
+    auto& b = builder.add_access(block, "b");
+    auto& c = builder.add_access(block, "c");
+    auto& d1 = builder.add_access(block, "d");
+    auto& d2 = builder.add_access(block, "d");
+    auto& libnode =
+        builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                 const std::vector<std::string>&,
+                                 std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                 data_flow::Subset, std::vector<data_flow::Subset>>(
+            block, DebugInfo(), {"_out"}, {"_in1", "_in2", "_in3", "_out"},
+            {{i, symbolic::symbol("I")}}, {i}, {{i}, {i}, {i}, {i}});
+    builder.add_memlet(block, a, "void", libnode, "_in1", {});
+    builder.add_memlet(block, b, "void", libnode, "_in2", {});
+    builder.add_memlet(block, c, "void", libnode, "_in3", {});
+    builder.add_memlet(block, d1, "void", libnode, "_out", {});
+    builder.add_memlet(block, libnode, "_out", d2, "void", {});
+
+    auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(&libnode);
+    ASSERT_TRUE(einsum_node);
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    // Nothing is contracted, so temporaries do not pay off
+    transformations::EinsumContract transformation(*einsum_node);
+    EXPECT_FALSE(transformation.can_be_applied(builder_opt, analysis_manager));
+}
+
+TEST(EinsumContract, MatrixChain_unused_map) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("j", sym_desc);
+    builder.add_container("k", sym_desc);
+    builder.add_container("l", sym_desc);
+    builder.add_container("m", sym_desc);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("B", desc2, true);
+    builder.add_container("C", desc2, true);
+    builder.add_container("D", desc2, true);
+
+    auto i = symbolic::symbol("i");
+    auto j = symbolic::symbol("j");
+    auto k = symbolic::symbol("k");
+    auto l = symbolic::symbol("l");
+    auto m = symbolic::symbol("m");
+
+    // D[i][l] += A[i][j] * B[j][k] * C[k][l] is accumulated 4 times by the map over m
+    auto& root = builder.subject().root();
+    auto& block = builder.add_block(root);
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& C = builder.add_access(block, "C");
+    auto& D1 = builder.add_access(block, "D");
+    auto& D2 = builder.add_access(block, "D");
+    auto& libnode =
+        builder.add_library_node<einsum::EinsumNode, const std::vector<std::string>&,
+                                 const std::vector<std::string>&,
+                                 std::vector<std::pair<symbolic::Symbol, symbolic::Expression>>,
+                                 data_flow::Subset, std::vector<data_flow::Subset>>(
+            block, DebugInfo(), {"_out"}, {"_in1", "_in2", "_in3", "_out"},
+            {{i, symbolic::integer(10)},
+             {j, symbolic::integer(1000)},
+             {k, symbolic::integer(10)},
+             {l, symbolic::integer(1000)},
+             {m, symbolic::integer(4)}},
+            {i, l}, {{i, j}, {j, k}, {k, l}, {i, l}});
+    builder.add_memlet(block, A, "void", libnode, "_in1", {});
+    builder.add_memlet(block, B, "void", libnode, "_in2", {});
+    builder.add_memlet(block, C, "void", libnode, "_in3", {});
+    builder.add_memlet(block, D1, "void", libnode, "_out", {});
+    builder.add_memlet(block, libnode, "_out", D2, "void", {});
+
+    auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(&libnode);
+    ASSERT_TRUE(einsum_node);
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    // The pairwise einsums would drop the map over m and with it the factor 4
+    transformations::EinsumContract transformation(*einsum_node);
+    EXPECT_FALSE(transformation.can_be_applied(builder_opt, analysis_manager));
+}
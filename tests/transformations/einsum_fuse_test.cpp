@@ -0,0 +1,134 @@
+#include "sdfg/transformations/einsum_fuse.h"
+
+#include <gtest/gtest.h>
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/data_flow/access_node.h>
+#include <sdfg/structured_control_flow/block.h>
+#include <sdfg/symbolic/symbolic.h>
+
+#include <nlohmann/json.hpp>
+#include <vector>
+
+#include "fixtures/einsum.h"
+#include "sdfg/einsum/einsum_node.h"
+#include "sdfg/transformations/einsum2blas.h"
+
+using namespace sdfg;
+
+inline einsum::EinsumNode* get_einsum_node(structured_control_flow::ControlFlowNode& node) {
+    auto* block = dynamic_cast<structured_control_flow::Block*>(&node);
+    if (!block) return nullptr;
+    for (auto& dnode : block->dataflow().nodes()) {
+        if (auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(&dnode)) return einsum_node;
+    }
+    return nullptr;
+}
+
+TEST(EinsumFuse, MatrixVectorMultiplicationPair) {
+    auto sdfg_and_node = matrix_vector_mult_pair(false);
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg_and_node.first);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    auto& root = builder_opt.subject().root();
+    ASSERT_EQ(root.size(), 2);
+    auto* first = get_einsum_node(root.at(0).first);
+    auto* second = get_einsum_node(root.at(1).first);
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+
+    transformations::EinsumFuse transformation(*first, *second);
+    nlohmann::json j;
+    transformation.to_json(j);
+    EXPECT_EQ(j["transformation_type"], "EinsumFuse");
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    // One einsum node computes both outputs in the loop nest of the first one
+    ASSERT_EQ(root.size(), 1);
+    auto* einsum_node = get_einsum_node(root.at(0).first);
+    ASSERT_TRUE(einsum_node);
+    EXPECT_EQ(einsum_node->outputs().size(), 2);
+    EXPECT_EQ(einsum_node->term_outputs(), std::vector<size_t>({0, 1}));
+    EXPECT_EQ(einsum_node->getOutInputIndex(1), 5);
+    EXPECT_EQ(einsum_node->toStr(),
+              "_out[i] = _out[i] + _in1[i,j] * _in2[j]; _out_1[i] = _out_1[i] + _in1_1[i,j] * "
+              "_in2_1[j] for i = 0:I for j = 0:J");
+
+    // Both products read x through the same access node
+    auto& dfg = einsum_node->get_parent();
+    EXPECT_EQ(dfg.nodes().size(), 8);
+    EXPECT_EQ(dfg.in_degree(*einsum_node), 6);
+    EXPECT_EQ(dfg.out_degree(*einsum_node), 2);
+
+    // Einsum nodes with several outputs are not lowered to BLAS
+    transformations::Einsum2BLAS blas(*einsum_node);
+    EXPECT_FALSE(blas.can_be_applied(builder_opt, analysis_manager));
+}
+
+TEST(EinsumFuse, Order) {
+    auto sdfg_and_node = matrix_vector_mult_pair(false);
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg_and_node.first);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    auto& root = builder_opt.subject().root();
+    auto* first = get_einsum_node(root.at(0).first);
+    auto* second = get_einsum_node(root.at(1).first);
+
+    // The second einsum node must follow the first one
+    transformations::EinsumFuse reversed(*second, *first);
+    EXPECT_FALSE(reversed.can_be_applied(builder_opt, analysis_manager));
+    transformations::EinsumFuse same(*first, *first);
+    EXPECT_FALSE(same.can_be_applied(builder_opt, analysis_manager));
+}
+
+TEST(EinsumFuse, Dependency) {
+    auto sdfg_and_node = matrix_vector_mult_pair(false);
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg_and_node.first);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    // The second einsum node reads the output of the first one, z[k] = z[k] + B[k,l] * y[l]
+    auto& root = builder_opt.subject().root();
+    auto* first = get_einsum_node(root.at(0).first);
+    auto* second = get_einsum_node(root.at(1).first);
+    for (auto& node : second->get_parent().nodes()) {
+        auto* access = dynamic_cast<data_flow::AccessNode*>(&node);
+        if (access) access->replace(symbolic::symbol("x"), symbolic::symbol("y"));
+    }
+
+    transformations::EinsumFuse transformation(*first, *second);
+    EXPECT_FALSE(transformation.can_be_applied(builder_opt, analysis_manager));
+}
+
+TEST(EinsumFuse, DifferentOutIndices) {
+    auto sdfg_and_node = matrix_vector_mult_transposed_pair(false);
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg_and_node.first);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    auto& root = builder_opt.subject().root();
+    auto* first = get_einsum_node(root.at(0).first);
+    auto* second = get_einsum_node(root.at(1).first);
+
+    // The outputs are indexed by different maps, which must be allowed explicitly
+    transformations::EinsumFuse shared(*first, *second);
+    EXPECT_FALSE(shared.can_be_applied(builder_opt, analysis_manager));
+
+    transformations::EinsumFuse transformation(*first, *second, true);
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    ASSERT_EQ(root.size(), 1);
+    auto* einsum_node = get_einsum_node(root.at(0).first);
+    ASSERT_TRUE(einsum_node);
+    EXPECT_FALSE(einsum_node->shared_out_indices());
+    EXPECT_EQ(einsum_node->toStr(),
+              "_out[i] = _out[i] + _in1[i,j] * _in2[j]; _out_1[j] = _out_1[j] + _in1_1[i,j] * "
+              "_in2_1[i] for i = 0:I for j = 0:J");
+
+    // Both products read A through the same access node
+    EXPECT_EQ(einsum_node->get_parent().nodes().size(), 8);
+}
@@ -309,4 +309,39 @@ TEST(EinsumLiftFail, input_is_indvar) {
 
     transformations::EinsumLift transformation({for_i}, block1);
     EXPECT_FALSE(transformation.can_be_applied(builder_opt, analysis_manager));
-}
\ No newline at end of file
+}
+
+TEST(EinsumLiftFail, index_not_affine) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    builder.add_container("a", desc, true);
+    builder.add_container("b", base_desc, true);
+
+    auto& root = builder.subject().root();
+
+    gen_for(i, I, root);
+
+    auto& block1 = builder.add_block(body_i);
+    auto& a = builder.add_access(block1, "a");
+    auto& b1 = builder.add_access(block1, "b");
+    auto& b2 = builder.add_access(block1, "b");
+    auto& tasklet1 = builder.add_tasklet(block1, data_flow::TaskletCode::add, {"_out", base_desc},
+                                         {{"_in1", base_desc}, {"_in2", base_desc}});
+    builder.add_memlet(block1, a, "void", tasklet1, "_in1", {symbolic::mul(indvar_i, indvar_i)});
+    builder.add_memlet(block1, b1, "void", tasklet1, "_in2", {});
+    builder.add_memlet(block1, tasklet1, "_out", b2, "void", {});
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::EinsumLift transformation({for_i}, block1);
+    EXPECT_FALSE(transformation.can_be_applied(builder_opt, analysis_manager));
+}
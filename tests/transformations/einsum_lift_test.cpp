@@ -15,11 +15,14 @@
 #include <sdfg/types/scalar.h>
 #include <sdfg/types/type.h>
 
+#include <algorithm>
+#include <set>
 #include <string>
 #include <unordered_map>
 
 #include "helper.h"
 #include "sdfg/einsum/einsum_node.h"
+#include "sdfg/transformations/transformation_profile.h"
 
 using namespace sdfg;
 
@@ -3106,4 +3109,599 @@ TEST(EinsumLift, Pow) {
     EXPECT_TRUE(subsets_eq(einsum_node->in_indices(0), {indvar_i}));
     EXPECT_TRUE(subsets_eq(einsum_node->in_indices(1), {indvar_i}));
     EXPECT_TRUE(subsets_eq(einsum_node->in_indices(2), {}));
-}
\ No newline at end of file
+}
+TEST(EinsumLift, StridedLoop) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    builder.add_container("a", desc, true);
+    builder.add_container("b", base_desc, true);
+
+    auto& root = builder.subject().root();
+
+    // for (i = 1; i < 2 * I + 1; i += 2) b += a[i - 1]
+    auto indvar_i = symbolic::symbol("i");
+    auto bound_i = symbolic::symbol("I");
+    auto condition_i =
+        symbolic::Lt(indvar_i, symbolic::add(symbolic::mul(symbolic::integer(2), bound_i),
+                                             symbolic::one()));
+    auto update_i = symbolic::add(indvar_i, symbolic::integer(2));
+    auto& for_i = builder.add_for(root, indvar_i, condition_i, symbolic::one(), update_i);
+    auto& body_i = for_i.root();
+
+    auto& block = builder.add_block(body_i);
+    auto& a = builder.add_access(block, "a");
+    auto& b1 = builder.add_access(block, "b");
+    auto& b2 = builder.add_access(block, "b");
+    auto& tasklet = builder.add_tasklet(block, data_flow::TaskletCode::add, {"_out", base_desc},
+                                        {{"_in1", base_desc}, {"_in2", base_desc}});
+    builder.add_memlet(block, a, "void", tasklet, "_in1",
+                       {symbolic::sub(indvar_i, symbolic::one())});
+    builder.add_memlet(block, b1, "void", tasklet, "_in2", {});
+    builder.add_memlet(block, tasklet, "_out", b2, "void", {});
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::EinsumLift transformation({for_i}, block);
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    auto& root_opt = builder_opt.subject().root();
+    AT_LEAST(root_opt.size(), 1);
+    auto* block_einsum = dynamic_cast<structured_control_flow::Block*>(&root_opt.at(0).first);
+    ASSERT_TRUE(block_einsum);
+    data_flow::LibraryNode* libnode = nullptr;
+    for (auto& node : block_einsum->dataflow().nodes()) {
+        if ((libnode = dynamic_cast<data_flow::LibraryNode*>(&node))) break;
+    }
+    ASSERT_TRUE(libnode);
+    auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(libnode);
+    ASSERT_TRUE(einsum_node);
+
+    // The map counts the iterations from zero and the index becomes 2 * i
+    AT_LEAST(einsum_node->maps().size(), 1);
+    EXPECT_TRUE(symbolic::eq(einsum_node->indvar(0), indvar_i));
+    EXPECT_TRUE(symbolic::eq(einsum_node->num_iteration(0), bound_i));
+    auto conn2cont = get_conn2cont(*block_einsum, *libnode);
+    EXPECT_EQ(conn2cont.at("_in0"), "a");
+    AT_LEAST(einsum_node->in_indices().size(), 2);
+    EXPECT_TRUE(subsets_eq(einsum_node->in_indices(0),
+                           {symbolic::mul(symbolic::integer(2), indvar_i)}));
+}
+
+TEST(EinsumLift, StridedLoop_ceil) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    builder.add_container("a", desc, true);
+    builder.add_container("b", base_desc, true);
+
+    auto& root = builder.subject().root();
+
+    // for (i = 0; i < I; i += 2) b += a[i]
+    auto indvar_i = symbolic::symbol("i");
+    auto bound_i = symbolic::symbol("I");
+    auto condition_i = symbolic::Lt(indvar_i, bound_i);
+    auto update_i = symbolic::add(indvar_i, symbolic::integer(2));
+    auto& for_i = builder.add_for(root, indvar_i, condition_i, symbolic::zero(), update_i);
+    auto& body_i = for_i.root();
+
+    auto& block = builder.add_block(body_i);
+    auto& a = builder.add_access(block, "a");
+    auto& b1 = builder.add_access(block, "b");
+    auto& b2 = builder.add_access(block, "b");
+    auto& tasklet = builder.add_tasklet(block, data_flow::TaskletCode::add, {"_out", base_desc},
+                                        {{"_in1", base_desc}, {"_in2", base_desc}});
+    builder.add_memlet(block, a, "void", tasklet, "_in1", {indvar_i});
+    builder.add_memlet(block, b1, "void", tasklet, "_in2", {});
+    builder.add_memlet(block, tasklet, "_out", b2, "void", {});
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::EinsumLift transformation({for_i}, block);
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    auto& root_opt = builder_opt.subject().root();
+    AT_LEAST(root_opt.size(), 1);
+    auto* block_einsum = dynamic_cast<structured_control_flow::Block*>(&root_opt.at(0).first);
+    ASSERT_TRUE(block_einsum);
+    data_flow::LibraryNode* libnode = nullptr;
+    for (auto& node : block_einsum->dataflow().nodes()) {
+        if ((libnode = dynamic_cast<data_flow::LibraryNode*>(&node))) break;
+    }
+    ASSERT_TRUE(libnode);
+    auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(libnode);
+    ASSERT_TRUE(einsum_node);
+
+    // The stride does not divide I, so the last iteration is partial: (I + 1) / 2
+    AT_LEAST(einsum_node->maps().size(), 1);
+    EXPECT_TRUE(symbolic::eq(einsum_node->num_iteration(0),
+                             symbolic::div(symbolic::add(bound_i, symbolic::one()),
+                                           symbolic::integer(2))));
+    AT_LEAST(einsum_node->in_indices().size(), 2);
+    EXPECT_TRUE(subsets_eq(einsum_node->in_indices(0),
+                           {symbolic::mul(symbolic::integer(2), indvar_i)}));
+}
+
+TEST(EinsumLift, OffsetLoop_clamped) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    builder.add_container("a", desc, true);
+    builder.add_container("b", base_desc, true);
+
+    auto& root = builder.subject().root();
+
+    // for (i = 3; i < I; i++) b += a[i]
+    auto indvar_i = symbolic::symbol("i");
+    auto bound_i = symbolic::symbol("I");
+    auto condition_i = symbolic::Lt(indvar_i, bound_i);
+    auto update_i = symbolic::add(indvar_i, symbolic::one());
+    auto& for_i = builder.add_for(root, indvar_i, condition_i, symbolic::integer(3), update_i);
+    auto& body_i = for_i.root();
+
+    auto& block = builder.add_block(body_i);
+    auto& a = builder.add_access(block, "a");
+    auto& b1 = builder.add_access(block, "b");
+    auto& b2 = builder.add_access(block, "b");
+    auto& tasklet = builder.add_tasklet(block, data_flow::TaskletCode::add, {"_out", base_desc},
+                                        {{"_in1", base_desc}, {"_in2", base_desc}});
+    builder.add_memlet(block, a, "void", tasklet, "_in1", {indvar_i});
+    builder.add_memlet(block, b1, "void", tasklet, "_in2", {});
+    builder.add_memlet(block, tasklet, "_out", b2, "void", {});
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::EinsumLift transformation({for_i}, block);
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    auto& root_opt = builder_opt.subject().root();
+    AT_LEAST(root_opt.size(), 1);
+    auto* block_einsum = dynamic_cast<structured_control_flow::Block*>(&root_opt.at(0).first);
+    ASSERT_TRUE(block_einsum);
+    data_flow::LibraryNode* libnode = nullptr;
+    for (auto& node : block_einsum->dataflow().nodes()) {
+        if ((libnode = dynamic_cast<data_flow::LibraryNode*>(&node))) break;
+    }
+    ASSERT_TRUE(libnode);
+    auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(libnode);
+    ASSERT_TRUE(einsum_node);
+
+    // I - 3 would wrap around for I < 3, so the map runs max(I, 3) - 3 times
+    AT_LEAST(einsum_node->maps().size(), 1);
+    EXPECT_TRUE(symbolic::eq(
+        einsum_node->num_iteration(0),
+        symbolic::sub(symbolic::max(bound_i, symbolic::integer(3)), symbolic::integer(3))));
+    AT_LEAST(einsum_node->in_indices().size(), 2);
+    EXPECT_TRUE(subsets_eq(einsum_node->in_indices(0),
+                           {symbolic::add(indvar_i, symbolic::integer(3))}));
+}
+
+TEST(EinsumLift, TriangularLoop_offset) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("j", sym_desc);
+    builder.add_container("N", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("b", base_desc, true);
+
+    auto& root = builder.subject().root();
+
+    // for (i = 1; i < N; i++) for (j = 0; j < i; j++) b += A[i][j]
+    auto indvar_i = symbolic::symbol("i");
+    auto indvar_j = symbolic::symbol("j");
+    auto bound_n = symbolic::symbol("N");
+    auto& for_i = builder.add_for(root, indvar_i, symbolic::Lt(indvar_i, bound_n), symbolic::one(),
+                                  symbolic::add(indvar_i, symbolic::one()));
+    auto& body_i = for_i.root();
+    auto& for_j = builder.add_for(body_i, indvar_j, symbolic::Lt(indvar_j, indvar_i),
+                                  symbolic::zero(), symbolic::add(indvar_j, symbolic::one()));
+    auto& body_j = for_j.root();
+
+    auto& block = builder.add_block(body_j);
+    auto& A = builder.add_access(block, "A");
+    auto& b1 = builder.add_access(block, "b");
+    auto& b2 = builder.add_access(block, "b");
+    auto& tasklet = builder.add_tasklet(block, data_flow::TaskletCode::add, {"_out", base_desc},
+                                        {{"_in1", base_desc}, {"_in2", base_desc}});
+    builder.add_memlet(block, A, "void", tasklet, "_in1", {indvar_i, indvar_j});
+    builder.add_memlet(block, b1, "void", tasklet, "_in2", {});
+    builder.add_memlet(block, tasklet, "_out", b2, "void", {});
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::EinsumLift transformation({for_i, for_j}, block);
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    auto& root_opt = builder_opt.subject().root();
+    AT_LEAST(root_opt.size(), 1);
+    auto* block_einsum = dynamic_cast<structured_control_flow::Block*>(&root_opt.at(0).first);
+    ASSERT_TRUE(block_einsum);
+    data_flow::LibraryNode* libnode = nullptr;
+    for (auto& node : block_einsum->dataflow().nodes()) {
+        if ((libnode = dynamic_cast<data_flow::LibraryNode*>(&node))) break;
+    }
+    ASSERT_TRUE(libnode);
+    auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(libnode);
+    ASSERT_TRUE(einsum_node);
+
+    // The bound of j is the original i, which is i + 1 after i counts from zero
+    AT_LEAST(einsum_node->maps().size(), 2);
+    EXPECT_TRUE(
+        symbolic::eq(einsum_node->num_iteration(0),
+                     symbolic::sub(symbolic::max(bound_n, symbolic::one()), symbolic::one())));
+    EXPECT_TRUE(symbolic::eq(einsum_node->num_iteration(1),
+                             symbolic::add(indvar_i, symbolic::one())));
+    AT_LEAST(einsum_node->in_indices().size(), 2);
+    EXPECT_TRUE(subsets_eq(einsum_node->in_indices(0),
+                           {symbolic::add(indvar_i, symbolic::one()), indvar_j}));
+}
+
+TEST(EinsumLift, TriangularLoop_strided) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("j", sym_desc);
+    builder.add_container("N", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("b", base_desc, true);
+
+    auto& root = builder.subject().root();
+
+    // for (i = 0; i < N; i += 2) for (j = 0; j < i; j++) b += A[i][j]
+    auto indvar_i = symbolic::symbol("i");
+    auto indvar_j = symbolic::symbol("j");
+    auto bound_n = symbolic::symbol("N");
+    auto& for_i = builder.add_for(root, indvar_i, symbolic::Lt(indvar_i, bound_n), symbolic::zero(),
+                                  symbolic::add(indvar_i, symbolic::integer(2)));
+    auto& body_i = for_i.root();
+    auto& for_j = builder.add_for(body_i, indvar_j, symbolic::Lt(indvar_j, indvar_i),
+                                  symbolic::zero(), symbolic::add(indvar_j, symbolic::one()));
+    auto& body_j = for_j.root();
+
+    auto& block = builder.add_block(body_j);
+    auto& A = builder.add_access(block, "A");
+    auto& b1 = builder.add_access(block, "b");
+    auto& b2 = builder.add_access(block, "b");
+    auto& tasklet = builder.add_tasklet(block, data_flow::TaskletCode::add, {"_out", base_desc},
+                                        {{"_in1", base_desc}, {"_in2", base_desc}});
+    builder.add_memlet(block, A, "void", tasklet, "_in1", {indvar_i, indvar_j});
+    builder.add_memlet(block, b1, "void", tasklet, "_in2", {});
+    builder.add_memlet(block, tasklet, "_out", b2, "void", {});
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::EinsumLift transformation({for_i, for_j}, block);
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    auto& root_opt = builder_opt.subject().root();
+    AT_LEAST(root_opt.size(), 1);
+    auto* block_einsum = dynamic_cast<structured_control_flow::Block*>(&root_opt.at(0).first);
+    ASSERT_TRUE(block_einsum);
+    data_flow::LibraryNode* libnode = nullptr;
+    for (auto& node : block_einsum->dataflow().nodes()) {
+        if ((libnode = dynamic_cast<data_flow::LibraryNode*>(&node))) break;
+    }
+    ASSERT_TRUE(libnode);
+    auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(libnode);
+    ASSERT_TRUE(einsum_node);
+
+    // The bound of j is the original i, which is 2 * i after i counts its iterations
+    AT_LEAST(einsum_node->maps().size(), 2);
+    EXPECT_TRUE(symbolic::eq(einsum_node->num_iteration(0),
+                             symbolic::div(symbolic::add(bound_n, symbolic::one()),
+                                           symbolic::integer(2))));
+    EXPECT_TRUE(symbolic::eq(einsum_node->num_iteration(1),
+                             symbolic::mul(symbolic::integer(2), indvar_i)));
+    AT_LEAST(einsum_node->in_indices().size(), 2);
+    EXPECT_TRUE(subsets_eq(einsum_node->in_indices(0),
+                           {symbolic::mul(symbolic::integer(2), indvar_i), indvar_j}));
+}
+
+TEST(EinsumLift, SumOfProducts) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+    builder.add_container("j", sym_desc);
+    builder.add_container("J", sym_desc, true);
+    builder.add_container("k", sym_desc);
+    builder.add_container("K", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("B", desc2, true);
+    builder.add_container("C", desc2, true);
+    builder.add_container("D", desc2, true);
+    builder.add_container("E", desc2, true);
+    builder.add_container("tmp", base_desc);
+
+    auto& root = builder.subject().root();
+
+    gen_for(i, I, root);
+
+    gen_for(j, J, body_i);
+
+    gen_for(k, K, body_j);
+
+    // C[i][j] += A[i][k] * B[k][j] + D[i][k] * E[k][j]
+    const std::unordered_map<std::string, data_flow::Subset> subsets = {
+        {"A", {indvar_i, indvar_k}}, {"B", {indvar_k, indvar_j}}, {"C", {indvar_i, indvar_j}},
+        {"D", {indvar_i, indvar_k}}, {"E", {indvar_k, indvar_j}}};
+
+    auto& block = builder.add_block(body_k);
+    auto& A = builder.add_access(block, "A");
+    auto& B = builder.add_access(block, "B");
+    auto& D = builder.add_access(block, "D");
+    auto& E = builder.add_access(block, "E");
+    auto& tmp = builder.add_access(block, "tmp");
+    auto& C1 = builder.add_access(block, "C");
+    auto& C2 = builder.add_access(block, "C");
+    auto& tasklet1 =
+        builder.add_tasklet(block, data_flow::TaskletCode::fma, {"_out", base_desc},
+                            {{"_in1", base_desc}, {"_in2", base_desc}, {"_in3", base_desc}});
+    builder.add_memlet(block, A, "void", tasklet1, "_in1", subsets.at("A"));
+    builder.add_memlet(block, B, "void", tasklet1, "_in2", subsets.at("B"));
+    builder.add_memlet(block, C1, "void", tasklet1, "_in3", subsets.at("C"));
+    builder.add_memlet(block, tasklet1, "_out", tmp, "void", {});
+    auto& tasklet2 =
+        builder.add_tasklet(block, data_flow::TaskletCode::fma, {"_out", base_desc},
+                            {{"_in1", base_desc}, {"_in2", base_desc}, {"_in3", base_desc}});
+    builder.add_memlet(block, D, "void", tasklet2, "_in1", subsets.at("D"));
+    builder.add_memlet(block, E, "void", tasklet2, "_in2", subsets.at("E"));
+    builder.add_memlet(block, tmp, "void", tasklet2, "_in3", {});
+    builder.add_memlet(block, tasklet2, "_out", C2, "void", subsets.at("C"));
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::EinsumLift transformation({for_k}, block);
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    auto& body_j_opt = for_j.root();
+    AT_LEAST(body_j_opt.size(), 1);
+    auto* block_einsum = dynamic_cast<structured_control_flow::Block*>(&body_j_opt.at(0).first);
+    ASSERT_TRUE(block_einsum);
+    data_flow::LibraryNode* libnode = nullptr;
+    for (auto& node : block_einsum->dataflow().nodes()) {
+        if ((libnode = dynamic_cast<data_flow::LibraryNode*>(&node))) break;
+    }
+    ASSERT_TRUE(libnode);
+    auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(libnode);
+    ASSERT_TRUE(einsum_node);
+
+    // Both products become terms of one einsum accumulating into C
+    EXPECT_EQ(einsum_node->inputs().size(), 5);
+    EXPECT_EQ(einsum_node->getOutInputIndex(), 4);
+    EXPECT_TRUE(subsets_eq(einsum_node->out_indices(), subsets.at("C")));
+    ASSERT_EQ(einsum_node->terms().size(), 2);
+    auto conn2cont = get_conn2cont(*block_einsum, *libnode);
+    std::set<std::string> products;
+    for (auto& term : einsum_node->terms()) {
+        ASSERT_EQ(term.size(), 2);
+        std::string product;
+        for (size_t input : term) {
+            auto& container = conn2cont.at(einsum_node->input(input));
+            EXPECT_TRUE(subsets_eq(einsum_node->in_indices(input), subsets.at(container)));
+            product += container;
+        }
+        std::sort(product.begin(), product.end());
+        products.insert(product);
+    }
+    EXPECT_EQ(products, std::set<std::string>({"AB", "DE"}));
+}
+
+TEST(EinsumLift, RowMax) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+    builder.add_container("j", sym_desc);
+    builder.add_container("J", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("m", desc, true);
+
+    auto& root = builder.subject().root();
+
+    gen_for(i, I, root);
+
+    gen_for(j, J, body_i);
+
+    // m[i] = max(m[i], A[i][j])
+    auto& block = builder.add_block(body_j);
+    auto& A = builder.add_access(block, "A");
+    auto& m1 = builder.add_access(block, "m");
+    auto& m2 = builder.add_access(block, "m");
+    auto& tasklet = builder.add_tasklet(block, data_flow::TaskletCode::max, {"_out", base_desc},
+                                        {{"_in1", base_desc}, {"_in2", base_desc}});
+    builder.add_memlet(block, m1, "void", tasklet, "_in1", {indvar_i});
+    builder.add_memlet(block, A, "void", tasklet, "_in2", {indvar_i, indvar_j});
+    builder.add_memlet(block, tasklet, "_out", m2, "void", {indvar_i});
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::EinsumLift transformation({for_j}, block);
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    auto& body_i_opt = for_i.root();
+    AT_LEAST(body_i_opt.size(), 1);
+    auto* block_einsum = dynamic_cast<structured_control_flow::Block*>(&body_i_opt.at(0).first);
+    ASSERT_TRUE(block_einsum);
+    data_flow::LibraryNode* libnode = nullptr;
+    for (auto& node : block_einsum->dataflow().nodes()) {
+        if ((libnode = dynamic_cast<data_flow::LibraryNode*>(&node))) break;
+    }
+    ASSERT_TRUE(libnode);
+    auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(libnode);
+    ASSERT_TRUE(einsum_node);
+
+    EXPECT_EQ(einsum_node->reduction(), einsum::ReductionType_Max);
+    EXPECT_EQ(einsum_node->inputs(), std::vector<std::string>({"_in0", "_out"}));
+    EXPECT_TRUE(subsets_eq(einsum_node->out_indices(), {indvar_i}));
+    auto conn2cont = get_conn2cont(*block_einsum, *libnode);
+    EXPECT_EQ(conn2cont.at("_in0"), "A");
+    AT_LEAST(einsum_node->in_indices().size(), 2);
+    EXPECT_TRUE(subsets_eq(einsum_node->in_indices(0), {indvar_i, indvar_j}));
+}
+
+TEST(EinsumLift, Profile) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("b", desc, true);
+
+    auto& root = builder.subject().root();
+
+    gen_for(i, I, root);
+
+    auto& block = builder.add_block(body_i);
+    auto& A = builder.add_access(block, "A");
+    auto& b1 = builder.add_access(block, "b");
+    auto& b2 = builder.add_access(block, "b");
+    auto& tasklet = builder.add_tasklet(block, data_flow::TaskletCode::add, {"_out", base_desc},
+                                        {{"_in1", base_desc}, {"_in2", base_desc}});
+    builder.add_memlet(block, A, "void", tasklet, "_in1", {indvar_i, indvar_i});
+    builder.add_memlet(block, b1, "void", tasklet, "_in2", {indvar_i});
+    builder.add_memlet(block, tasklet, "_out", b2, "void", {indvar_i});
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::TransformationProfile::reset();
+    transformations::TransformationProfile::enable();
+    transformations::EinsumLift transformation({}, block);
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+    transformations::TransformationProfile::enable(false);
+
+    // The capture and the simplification run once for the loop nest
+    using transformations::TransformationProfile;
+    EXPECT_EQ(TransformationProfile::phase("EinsumLift.can_be_applied").calls, 2);
+    EXPECT_EQ(TransformationProfile::phase("EinsumLift.apply").calls, 1);
+    EXPECT_EQ(TransformationProfile::phase("EinsumLift.capture").calls, 1);
+    EXPECT_EQ(TransformationProfile::phase("EinsumLift.fixed_point").calls, 1);
+    EXPECT_EQ(TransformationProfile::phase("EinsumLift.simplify").calls, 1);
+    EXPECT_EQ(TransformationProfile::phase("EinsumLift.capture_cache_hit").calls, 2);
+    EXPECT_GT(TransformationProfile::phase("EinsumLift.checks").calls, 0);
+    EXPECT_NE(TransformationProfile::toStr().find("EinsumLift.simplify: 1 calls"),
+              std::string::npos);
+    TransformationProfile::reset();
+}
+
+TEST(EinsumLift, Profile_subset_changed) {
+    builder::StructuredSDFGBuilder builder("sdfg_1", FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("b", desc, true);
+
+    auto& root = builder.subject().root();
+
+    gen_for(i, I, root);
+
+    auto& block = builder.add_block(body_i);
+    auto& A = builder.add_access(block, "A");
+    auto& b1 = builder.add_access(block, "b");
+    auto& b2 = builder.add_access(block, "b");
+    auto& tasklet = builder.add_tasklet(block, data_flow::TaskletCode::add, {"_out", base_desc},
+                                        {{"_in1", base_desc}, {"_in2", base_desc}});
+    builder.add_memlet(block, A, "void", tasklet, "_in1", {indvar_i, indvar_i});
+    builder.add_memlet(block, b1, "void", tasklet, "_in2", {indvar_i});
+    builder.add_memlet(block, tasklet, "_out", b2, "void", {indvar_i});
+
+    auto sdfg = builder.move();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::TransformationProfile::reset();
+    transformations::TransformationProfile::enable();
+    transformations::EinsumLift transformation({}, block);
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+
+    // The memlets keep their element ids when their subsets are rewritten
+    block.replace(indvar_i, symbolic::zero());
+    transformation.can_be_applied(builder_opt, analysis_manager);
+    transformations::TransformationProfile::enable(false);
+
+    using transformations::TransformationProfile;
+    EXPECT_EQ(TransformationProfile::phase("EinsumLift.capture").calls, 2);
+    EXPECT_EQ(TransformationProfile::phase("EinsumLift.capture_cache_hit").calls, 0);
+    TransformationProfile::reset();
+}
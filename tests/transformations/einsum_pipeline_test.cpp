@@ -0,0 +1,183 @@
+#include "sdfg/transformations/einsum_pipeline.h"
+
+#include <gtest/gtest.h>
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/data_flow/access_node.h>
+#include <sdfg/data_flow/library_node.h>
+#include <sdfg/data_flow/memlet.h>
+#include <sdfg/data_flow/tasklet.h>
+#include <sdfg/function.h>
+#include <sdfg/structured_control_flow/block.h>
+#include <sdfg/structured_control_flow/for.h>
+#include <sdfg/structured_control_flow/if_else.h>
+#include <sdfg/symbolic/symbolic.h>
+#include <sdfg/types/pointer.h>
+#include <sdfg/types/scalar.h>
+#include <sdfg/types/type.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "fixtures/einsum.h"
+#include "helper.h"
+#include "sdfg/blas/blas_node.h"
+#include "sdfg/einsum/einsum_node.h"
+
+using namespace sdfg;
+
+inline std::unique_ptr<StructuredSDFG> pipeline_sdfg(const std::string& name) {
+    builder::StructuredSDFGBuilder builder(name, FunctionType_CPU);
+
+    types::Scalar sym_desc(types::PrimitiveType::UInt64);
+    builder.add_container("i", sym_desc);
+    builder.add_container("I", sym_desc, true);
+    builder.add_container("j", sym_desc);
+    builder.add_container("J", sym_desc, true);
+    builder.add_container("k", sym_desc);
+    builder.add_container("K", sym_desc, true);
+
+    types::Scalar base_desc(types::PrimitiveType::Float);
+    types::Pointer desc(base_desc);
+    types::Pointer desc2(*desc.clone());
+    builder.add_container("A", desc2, true);
+    builder.add_container("B", desc2, true);
+    builder.add_container("C", desc2, true);
+    builder.add_container("tmp", base_desc);
+
+    auto& root = builder.subject().root();
+
+    gen_for(i, I, root);
+
+    gen_for(k, K, body_i);
+
+    auto& block1 = builder.add_block(body_k);
+    auto& C1 = builder.add_access(block1, "C");
+    auto& tasklet1 = builder.add_tasklet(block1, data_flow::TaskletCode::assign,
+                                         {"_out", base_desc}, {{"0.0", base_desc}});
+    builder.add_memlet(block1, tasklet1, "_out", C1, "void", {indvar_i, indvar_k});
+
+    gen_for(j, J, body_k);
+
+    auto& block2 = builder.add_block(body_j);
+    auto& A = builder.add_access(block2, "A");
+    auto& B = builder.add_access(block2, "B");
+    auto& tmp = builder.add_access(block2, "tmp");
+    auto& C2 = builder.add_access(block2, "C");
+    auto& C3 = builder.add_access(block2, "C");
+    auto& tasklet2 = builder.add_tasklet(block2, data_flow::TaskletCode::mul, {"_out", base_desc},
+                                         {{"_in1", base_desc}, {"_in2", base_desc}});
+    builder.add_memlet(block2, A, "void", tasklet2, "_in1", {indvar_i, indvar_j});
+    builder.add_memlet(block2, B, "void", tasklet2, "_in2", {indvar_j, indvar_k});
+    builder.add_memlet(block2, tasklet2, "_out", tmp, "void", {});
+    auto& tasklet3 = builder.add_tasklet(block2, data_flow::TaskletCode::add, {"_out", base_desc},
+                                         {{"_in1", base_desc}, {"_in2", base_desc}});
+    builder.add_memlet(block2, C2, "void", tasklet3, "_in1", {indvar_i, indvar_k});
+    builder.add_memlet(block2, tmp, "void", tasklet3, "_in2", {});
+    builder.add_memlet(block2, tasklet3, "_out", C3, "void", {indvar_i, indvar_k});
+
+    return builder.move();
+}
+
+TEST(EinsumPipeline, lift_and_expand) {
+    auto sdfg = pipeline_sdfg("sdfg_1");
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::EinsumPipelineOptions options;
+    options.blas = false;
+    transformations::EinsumPipeline pipeline(options);
+    auto report = pipeline.run(builder_opt, analysis_manager);
+    EXPECT_EQ(report.lifted, 1);
+    EXPECT_EQ(report.expanded, 2);
+    EXPECT_EQ(report.lowered, 0);
+    EXPECT_EQ(report.fused, 0);
+    EXPECT_EQ(report.toStr(), "lifted: 1, expanded: 2, lowered: 0, fused: 0");
+
+    // The initialization stays in the loops and the einsum node covers the whole nest
+    auto& root_opt = builder_opt.subject().root();
+    ASSERT_EQ(root_opt.size(), 2);
+    EXPECT_TRUE(dynamic_cast<structured_control_flow::For*>(&root_opt.at(0).first));
+    auto* block_einsum = dynamic_cast<structured_control_flow::Block*>(&root_opt.at(1).first);
+    ASSERT_TRUE(block_einsum);
+    einsum::EinsumNode* einsum_node = nullptr;
+    for (auto& node : block_einsum->dataflow().nodes()) {
+        if ((einsum_node = dynamic_cast<einsum::EinsumNode*>(&node))) break;
+    }
+    ASSERT_TRUE(einsum_node);
+    EXPECT_EQ(einsum_node->maps().size(), 3);
+}
+
+TEST(EinsumPipeline, functions) {
+    std::vector<std::unique_ptr<StructuredSDFG>> sdfgs;
+    sdfgs.push_back(pipeline_sdfg("sdfg_1"));
+    sdfgs.push_back(pipeline_sdfg("sdfg_2"));
+
+    transformations::EinsumPipeline pipeline;
+    auto report = pipeline.run(sdfgs, 1);
+    EXPECT_EQ(report.lifted, 2);
+    EXPECT_EQ(report.expanded, 4);
+    EXPECT_EQ(report.lowered, 2);
+    EXPECT_EQ(report.routines["Einsum2BLASGemm"], 2);
+
+    for (auto& sdfg : sdfgs) {
+        ASSERT_TRUE(sdfg);
+        auto& root = sdfg->root();
+        ASSERT_EQ(root.size(), 2);
+        auto* block = dynamic_cast<structured_control_flow::Block*>(&root.at(1).first);
+        ASSERT_TRUE(block);
+        bool blas_node = false;
+        for (auto& node : block->dataflow().nodes()) {
+            if (dynamic_cast<blas::BLASNode*>(&node)) blas_node = true;
+        }
+        EXPECT_TRUE(blas_node);
+    }
+}
+
+TEST(EinsumPipeline, fuse) {
+    auto sdfg_and_node = matrix_vector_mult_pair(false);
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg_and_node.first);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    // Einsum nodes which stay loop nests are fused
+    transformations::EinsumPipelineOptions options;
+    options.blas = false;
+    transformations::EinsumPipeline pipeline(options);
+    auto report = pipeline.run(builder_opt, analysis_manager);
+    EXPECT_EQ(report.fused, 1);
+    EXPECT_EQ(builder_opt.subject().root().size(), 1);
+
+    // Fusion can be disabled
+    auto unfused = matrix_vector_mult_pair(false);
+    builder::StructuredSDFGBuilder builder_unfused(unfused.first);
+    analysis::AnalysisManager analysis_manager_unfused(builder_unfused.subject());
+    options.fuse = false;
+    transformations::EinsumPipeline pipeline_unfused(options);
+    EXPECT_EQ(pipeline_unfused.run(builder_unfused, analysis_manager_unfused).fused, 0);
+    EXPECT_EQ(builder_unfused.subject().root().size(), 2);
+}
+
+TEST(EinsumPipeline, threshold) {
+    auto sdfg_and_node = matrix_vector_mult_pair(false);
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg_and_node.first);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    // Every block is replaced by an if-else, whose loop case keeps a copy of the einsum node
+    transformations::EinsumPipelineOptions options;
+    options.threshold = 16;
+    options.fuse = false;
+    transformations::EinsumPipeline pipeline(options);
+    auto report = pipeline.run(builder_opt, analysis_manager);
+    EXPECT_EQ(report.lowered, 2);
+    EXPECT_EQ(report.routines["Einsum2BLASGemv"], 2);
+
+    auto& root_opt = builder_opt.subject().root();
+    ASSERT_EQ(root_opt.size(), 2);
+    EXPECT_TRUE(dynamic_cast<structured_control_flow::IfElse*>(&root_opt.at(0).first));
+    EXPECT_TRUE(dynamic_cast<structured_control_flow::IfElse*>(&root_opt.at(1).first));
+}
@@ -0,0 +1,69 @@
+#include "sdfg/transformations/einsum_split.h"
+
+#include <gtest/gtest.h>
+#include <sdfg/analysis/analysis.h>
+#include <sdfg/builder/structured_sdfg_builder.h>
+#include <sdfg/data_flow/access_node.h>
+#include <sdfg/structured_control_flow/block.h>
+
+#include <string>
+#include <vector>
+
+#include "fixtures/einsum.h"
+#include "sdfg/einsum/einsum_node.h"
+#include "sdfg/transformations/einsum2blas_gemm.h"
+
+using namespace sdfg;
+
+inline einsum::EinsumNode* get_einsum_node(structured_control_flow::Block& block) {
+    for (auto& node : block.dataflow().nodes()) {
+        if (auto* einsum_node = dynamic_cast<einsum::EinsumNode*>(&node)) return einsum_node;
+    }
+    return nullptr;
+}
+
+TEST(EinsumSplit, MatrixMatrixMultiplicationSum) {
+    auto sdfg_and_node = matrix_matrix_mult_sum();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg_and_node.first);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::EinsumSplit transformation(*sdfg_and_node.second);
+    ASSERT_TRUE(transformation.can_be_applied(builder_opt, analysis_manager));
+    transformation.apply(builder_opt, analysis_manager);
+
+    // One accumulating gemm per term
+    auto& root = builder_opt.subject().root();
+    ASSERT_EQ(root.size(), 2);
+    std::vector<std::string> containers = {"A", "D"};
+    for (size_t i = 0; i < root.size(); ++i) {
+        auto* block = dynamic_cast<structured_control_flow::Block*>(&root.at(i).first);
+        ASSERT_TRUE(block);
+        auto* einsum_node = get_einsum_node(*block);
+        ASSERT_TRUE(einsum_node);
+        EXPECT_EQ(einsum_node->terms().size(), 1);
+        EXPECT_EQ(einsum_node->inputs().size(), 3);
+        EXPECT_GE(einsum_node->getOutInputIndex(), 0);
+
+        bool reads_container = false;
+        for (auto& iedge : block->dataflow().in_edges(*einsum_node)) {
+            auto& src = dynamic_cast<const data_flow::AccessNode&>(iedge.src());
+            if (src.data() == containers[i]) reads_container = true;
+        }
+        EXPECT_TRUE(reads_container);
+        EXPECT_EQ(block->dataflow().nodes().size(), 5);
+
+        transformations::Einsum2BLASGemm gemm(*einsum_node);
+        EXPECT_TRUE(gemm.can_be_applied(builder_opt, analysis_manager));
+    }
+}
+
+TEST(EinsumSplit, SingleTerm) {
+    auto sdfg_and_node = matrix_matrix_mult();
+
+    builder::StructuredSDFGBuilder builder_opt(sdfg_and_node.first);
+    analysis::AnalysisManager analysis_manager(builder_opt.subject());
+
+    transformations::EinsumSplit transformation(*sdfg_and_node.second);
+    EXPECT_FALSE(transformation.can_be_applied(builder_opt, analysis_manager));
+}